@@ -0,0 +1,109 @@
+# Compares the execution of the queries of a folder with the operators returning one result per call (row mode)
+# and returning batches of results (--batch-execution). Checks both modes return the same bindings and prints
+# a CSV with the average time of each query in each mode.
+#
+# Usage: python3 scripts/batch_execution/compare_modes.py [queries_folder] [database_folder]
+#
+# The queries folder can be the one used by scripts/hash_join/do_tests.sh or scripts/leapfrog/test_consistency.py
+# with the database they were written for (e.g. the one created by scripts/hash_join/hash_join_db_generator.py)
+import glob
+import os
+import signal
+import subprocess
+import sys
+from time import sleep
+
+aux_filename = '.out_query.tmp'
+
+port = 8080
+repetitions = 10
+warming_repetitions = 3
+server_launch_delay = 5
+
+modes = {
+    'row':   [],
+    'batch': ['--batch-execution'],
+}
+
+
+def start_server(db_path: str, port: int, options: list):
+    server_process = subprocess.Popen(
+                    ['build/Release/bin/server', '-d', db_path, '-p', f'{port}'] + options,
+                    stdout=subprocess.DEVNULL,
+                    stderr=subprocess.DEVNULL,
+                    preexec_fn=os.setsid)
+    return server_process
+
+
+def run_query(query_file: str, output):
+    query_execution = subprocess.Popen(
+        ['./build/Release/bin/query', '-p', f'{port}'],
+        stdin=open(query_file),
+        stdout=output,
+        stderr=subprocess.DEVNULL)
+    query_execution.wait()
+
+
+def run(queries_folder: str, mode: str, results: dict):
+    for query_file in sorted(glob.glob(f'{queries_folder}/*.txt')):
+        if query_file not in results:
+            results[query_file] = dict()
+
+        for _ in range(warming_repetitions):
+            run_query(query_file, subprocess.DEVNULL)
+
+        # the time is the execution time reported by the server, it does not include parsing and optimizing
+        execution_times = []
+        for _ in range(repetitions):
+            with open(aux_filename, 'w') as file:
+                run_query(query_file, file)
+            with open(aux_filename, 'r') as file:
+                for line in file:
+                    if line.startswith('Execution time:'):
+                        execution_times.append(float(line.split()[2]))
+
+        # the bindings are between the first two lines of '-'
+        bindings = []
+        separators = 0
+        with open(aux_filename, 'r') as file:
+            for line in file:
+                if line.startswith('---'):
+                    separators += 1
+                elif separators == 1:
+                    bindings.append(line.strip())
+        bindings.sort()
+
+        results[query_file][mode] = {
+            'avg': round(sum(execution_times) / len(execution_times), 2) if execution_times else None,
+            'bindings': bindings,
+        }
+
+
+if len(sys.argv) < 3:
+    print('Wrong number of arguments.')
+    print('Usage: python3 compare_modes.py [queries_folder] [database_folder]')
+    sys.exit()
+
+queries_folder = sys.argv[1]
+db_path        = sys.argv[2]
+
+results = dict()
+for mode, options in modes.items():
+    server_process = start_server(db_path, port, options)
+    sleep(server_launch_delay)
+    run(queries_folder, mode, results)
+    os.killpg(server_process.pid, signal.SIGINT)
+    server_process.wait()
+
+for query in results:
+    if results[query]['row']['bindings'] != results[query]['batch']['bindings']:
+        print(f'Error in {os.path.basename(query)}: bindings are different.')
+
+print('query,row avg (ms),batch avg (ms),result count')
+for query in results:
+    print(os.path.basename(query), end='')
+    for mode in modes:
+        print(f',{results[query][mode]["avg"]}', end='')
+    print(f',{len(results[query]["row"]["bindings"])}')
+
+os.remove(aux_filename)
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "base/binding/binding_id.h"
+
+/* BindingBatch holds up to CAPACITY results of a BindingIdIter, stored by columns (one column for each variable
+ * of the BindingId). The results of the batch are the rows in the selection vector, so operators that discard
+ * results (like a distinct) only have to remove rows from the selection.
+ * The batch is created with the BindingId given to begin(), variables not written by the iterator are copied
+ * from there.
+ */
+class BindingBatch {
+public:
+    static constexpr uint_fast32_t CAPACITY = 1024;
+
+    BindingId& binding;
+
+    // rows written in the columns
+    uint_fast32_t size = 0;
+
+    // rows that are results: selection[0], ..., selection[selected - 1]
+    uint_fast32_t selected = 0;
+    std::unique_ptr<uint16_t[]> selection;
+
+    BindingBatch(BindingId& binding) :
+        binding   (binding),
+        selection (std::make_unique<uint16_t[]>(CAPACITY)),
+        columns   (std::make_unique<ObjectId[]>(binding.size * CAPACITY)) { }
+
+    inline ObjectId* column(VarId var_id) noexcept {
+        return columns.get() + var_id.id * CAPACITY;
+    }
+
+    inline const ObjectId* column(VarId var_id) const noexcept {
+        return columns.get() + var_id.id * CAPACITY;
+    }
+
+    inline bool full() const noexcept {
+        return size == CAPACITY;
+    }
+
+    inline void clear() noexcept {
+        size = 0;
+        selected = 0;
+    }
+
+    // Appends a row (and selects it) with the current values of the binding
+    inline void append_binding() noexcept {
+        for (uint_fast32_t i = 0; i < binding.size; i++) {
+            columns[i * CAPACITY + size] = binding[VarId(i)];
+        }
+        selection[selected++] = size++;
+    }
+
+    // Writes the current values of the binding in the rows [begin, end) of every column
+    inline void fill_rows(uint_fast32_t begin, uint_fast32_t end) noexcept {
+        for (uint_fast32_t i = 0; i < binding.size; i++) {
+            auto value = binding[VarId(i)];
+            std::fill(columns.get() + i * CAPACITY + begin, columns.get() + i * CAPACITY + end, value);
+        }
+    }
+
+    // Selects all the rows written
+    inline void select_all() noexcept {
+        for (uint_fast32_t i = 0; i < size; i++) {
+            selection[i] = i;
+        }
+        selected = size;
+    }
+
+    // Writes the values of the row in the binding
+    inline void load_row(uint_fast32_t row) noexcept {
+        for (uint_fast32_t i = 0; i < binding.size; i++) {
+            binding.add(VarId(i), columns[i * CAPACITY + row]);
+        }
+    }
+
+private:
+    std::unique_ptr<ObjectId[]> columns;
+};
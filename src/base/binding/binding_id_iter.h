@@ -1,9 +1,13 @@
 #pragma once
 
 #include <ostream>
+#include <vector>
 
+#include "base/binding/binding_batch.h"
 #include "base/binding/binding_id.h"
 
+class JoinKeyFilter;
+
 // Abstract class
 class BindingIdIter {
 public:
@@ -21,6 +25,29 @@ public:
     // It modifies the parent_binding to include the new results.
     virtual bool next() = 0;
 
+    // Clears the batch and writes the next results in it (at most BindingBatch::CAPACITY), returns false if there
+    // are no more results. The batch must use the parent_binding given to begin(), and its values after the call
+    // are undefined. next() and next_batch() must not be mixed between calls to begin() or reset().
+    // The default implementation calls next() for each result.
+    virtual bool next_batch(BindingBatch& batch) {
+        batch.clear();
+        while (!batch.full() && next()) {
+            batch.append_binding();
+        }
+        return batch.selected > 0;
+    }
+
+    // Gives the iter the values that `var` can have in the results that its parent can use (a hash join gives
+    // the keys of its build side to its probe side). Returns true if the iter will discard some of the results
+    // whose value of var is not in the filter, the parent must not assume that all of them are discarded.
+    // The filter must live while the iter is used, and its content may change before begin() or reset().
+    virtual bool push_filter(VarId /*var*/, const JoinKeyFilter& /*filter*/) { return false; }
+
+    // Appends the vars of the parent binding that begin() and reset() read to search the results, the first one
+    // is the most significant (e.g. the order of the columns of an index). An IndexNestedLoopJoin sorts its
+    // lookups by them.
+    virtual void get_lookup_vars(std::vector<VarId>& /*vars*/) const { }
+
     // Every var that the iter sets in the binding_id when next() returns true is setted to null
     virtual void assign_nulls() = 0;
 
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// Counters of the work done by the current thread. They are always incremented (a thread local increment is
+// cheap compared with the work counted) and ProfiledBindingIdIter reads them before and after calling an
+// operator to know the work done by it.
+struct ThreadCounters {
+    // pages returned by BufferManager::get_page
+    inline static thread_local uint64_t page_pins = 0;
+
+    // searches of a record in a B+Tree (a scan or a leapfrog seek)
+    inline static thread_local uint64_t index_seeks = 0;
+};
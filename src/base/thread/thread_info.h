@@ -2,10 +2,45 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
+
+class QueryProfile;
 
 struct ThreadInfo {
     bool interruption_requested = false;
     bool finished               = false;
 
+    // threads used to execute a LeapfrogJoin that is not inside another join, 1 disables ParallelLeapfrogJoin
+    uint_fast32_t leapfrog_workers = 1;
+
+    // the results of the BindingIdIter are obtained with next_batch() instead of next()
+    bool batch_execution = false;
+
+    // the comparisons of the WHERE between a variable and a constant are evaluated on the ObjectIds below the
+    // joins instead of by the Where, see IdFilter
+    bool id_filters = true;
+
+    // the IndexNestedLoopJoins sort batches of their lhs results by the lookup vars of rhs, changing the order
+    // of the results. Off by default: each join reads a whole batch of lhs results before returning the first
+    // one, so queries with a LIMIT may do many more lookups
+    bool sorted_lookups = false;
+
+    // bytes that the hash joins and the DistinctIdHash of the query can keep in memory, the rest is written to
+    // temp files
+    uint64_t hash_join_memory = 1024ULL * 1024 * 1024;
+
+    // bytes kept in memory by the hash joins and the DistinctIdHash of the query
+    uint64_t hash_join_memory_used = 0;
+
+    // the hash joins give a filter of the keys of their build side to their probe side, see JoinKeyFilter
+    bool hash_join_filters = true;
+
+    // bytes that each OrderBy of the query can keep in memory, see TupleSorter. It is not shared: a server running
+    // many queries with ORDER BY can use this amount for each of them
+    uint64_t sort_memory = 64ULL * 1024 * 1024;
+
+    // not null if the query is profiled
+    std::shared_ptr<QueryProfile> profile;
+
     std::chrono::system_clock::time_point timeout;
 };
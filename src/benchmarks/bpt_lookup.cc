@@ -0,0 +1,143 @@
+/*
+ * bpt_lookup measures the latency of point lookups in every B+Tree of a quad model database, descending the
+ * directory through the buffer manager (BPlusTreeDir::search_leaf, pinning every directory page of the path)
+ * and through the copy of the directory in memory (BPlusTree::search_leaf, pinning only the leaf).
+ *
+ * The database is opened like the server does. For every B+Tree `lookups` records are sampled with a full scan,
+ * then each one is searched once to load the pages in the buffer and the mean latency of searching all of them
+ * with each descent is reported.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "query_optimizer/quad_model/quad_model.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+// mean latency in microseconds of searching every record of `samples`
+template <std::size_t N, typename SearchLeaf>
+double lookups_us(const vector<Record<N>>& samples, SearchLeaf search_leaf) {
+    uint64_t found = 0;
+    auto start_time = chrono::steady_clock::now();
+    for (auto& sample : samples) {
+        auto leaf_and_pos = search_leaf(sample);
+        if (leaf_and_pos.result_index < leaf_and_pos.leaf->get_value_count()) {
+            found += leaf_and_pos.leaf->get_record(leaf_and_pos.result_index).ids == sample.ids;
+        }
+    }
+    chrono::duration<double, std::micro> duration = chrono::steady_clock::now() - start_time;
+    if (found != samples.size()) {
+        cerr << "expected " << samples.size() << " records found, got " << found << "\n";
+    }
+    return duration.count() / samples.size();
+}
+
+
+template <std::size_t N>
+void run(const string& name, const BPlusTree<N>& bpt, uint_fast32_t lookups) {
+    bool interruption_requested = false;
+    array<uint64_t, N> min;
+    array<uint64_t, N> max;
+    min.fill(0);
+    max.fill(UINT64_MAX);
+
+    // reservoir sampling of the records
+    vector<Record<N>> samples;
+    std::mt19937_64 rng(0);
+    uint64_t records = 0;
+    auto iter = bpt.get_range(&interruption_requested, Record<N>(min), Record<N>(max));
+    for (auto record = iter->next(); record != nullptr; record = iter->next()) {
+        if (samples.size() < lookups) {
+            samples.push_back(*record);
+        } else {
+            auto pos = rng() % (records + 1);
+            if (pos < lookups) {
+                samples[pos] = *record;
+            }
+        }
+        records++;
+    }
+    iter.reset();
+
+    cout << setw(26) << name << setw(4) << N << setw(14) << records << setw(8) << bpt.get_height();
+    if (samples.empty()) {
+        cout << "\n";
+        return;
+    }
+    std::shuffle(samples.begin(), samples.end(), rng);
+
+    auto search_pages = [&](const Record<N>& record) {
+        return bpt.get_root()->search_leaf(record);
+    };
+    auto search_cache = [&](const Record<N>& record) {
+        return bpt.search_leaf(record);
+    };
+    lookups_us<N>(samples, search_pages);
+    const auto pages_us = lookups_us<N>(samples, search_pages);
+    const auto cache_us = lookups_us<N>(samples, search_cache);
+    cout << setw(16) << std::fixed << std::setprecision(3) << pages_us << setw(16) << cache_us << "\n";
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int lookups;
+    int buffer_mb;
+
+    cxxopts::Options options("bpt_lookup", "Latency of point lookups in the B+Trees of a quad model database");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "quad model database folder", cxxopts::value<string>(db_folder))
+        ("lookups", "number of records searched in every B+Tree", cxxopts::value<int>(lookups)->default_value("100000"))
+        ("buffer-mb", "size of the shared buffer in MB", cxxopts::value<int>(buffer_mb)->default_value("4096"))
+    ;
+    options.positional_help("db-folder");
+    options.parse_positional({"db-folder"});
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (db_folder.empty()) {
+        cerr << "Must specify a db-folder.\n";
+        return 1;
+    }
+
+    if (lookups <= 0 || buffer_mb <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    const auto buffer_pages = static_cast<uint_fast32_t>(buffer_mb * 1024ULL * 1024 / Page::MDB_PAGE_SIZE);
+    auto model_destroyer = QuadModel::init(db_folder, buffer_pages, 1, 1);
+
+    cout << setw(26) << "B+Tree" << setw(4) << "N" << setw(14) << "records" << setw(8) << "height"
+         << setw(16) << "pages (us)" << setw(16) << "in memory (us)" << "\n";
+
+    run("nodes",                    *quad_model.nodes,                    lookups);
+    run("node_label",               *quad_model.node_label,               lookups);
+    run("label_node",               *quad_model.label_node,               lookups);
+    run("object_key_value",         *quad_model.object_key_value,         lookups);
+    run("key_value_object",         *quad_model.key_value_object,         lookups);
+    run("from_to_type_edge",        *quad_model.from_to_type_edge,        lookups);
+    run("to_type_from_edge",        *quad_model.to_type_from_edge,        lookups);
+    run("type_from_to_edge",        *quad_model.type_from_to_edge,        lookups);
+    run("type_to_from_edge",        *quad_model.type_to_from_edge,        lookups);
+    run("equal_from_to",            *quad_model.equal_from_to,            lookups);
+    run("equal_from_type",          *quad_model.equal_from_type,          lookups);
+    run("equal_to_type",            *quad_model.equal_to_type,            lookups);
+    run("equal_from_to_type",       *quad_model.equal_from_to_type,       lookups);
+    run("equal_from_to_inverted",   *quad_model.equal_from_to_inverted,   lookups);
+    run("equal_from_type_inverted", *quad_model.equal_from_type_inverted, lookups);
+    run("equal_to_type_inverted",   *quad_model.equal_to_type_inverted,   lookups);
+    return 0;
+}
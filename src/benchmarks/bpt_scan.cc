@@ -0,0 +1,157 @@
+/*
+ * bpt_scan measures the throughput (records per second) of full scans of a B+Tree that is already in the buffer.
+ *
+ * A BPlusTree<4> with `records` records is written with the bulk import writers and the BufferManager is created
+ * with room for all its pages, so after a first scan that loads the leaves the measured scans don't do any I/O.
+ * The scan is done with BptIter::next(), reading the records directly from the pinned leaves, with
+ * BptIter::next_block(), that returns all the records of a leaf in the range at once, and also copying every
+ * record into a new heap allocated Record<4> as the iterator did before, to show the cost of an allocation per record.
+ * The best of `repetitions` scans is reported.
+ */
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "storage/page.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+static const string BENCHMARK_BPT = "bpt_scan";
+
+// writes the leaves and directory like Import::DiskVector does after sorting
+void create_bpt(uint64_t records) {
+    BPTLeafWriter<4> leaf_writer(file_manager.get_file_path(BENCHMARK_BPT + ".leaf"));
+    BPTDirWriter<4> dir_writer(file_manager.get_file_path(BENCHMARK_BPT + ".dir"));
+
+    const auto max_records = BPTLeafWriter<4>::max_records();
+    const uint32_t last_block = (records / max_records) + (records % max_records != 0);
+    vector<array<uint64_t, 4>> block(max_records);
+
+    uint32_t current_block = 0;
+    uint64_t i = 0;
+    while (i < records) {
+        uint32_t block_size = 0;
+        for (; block_size < max_records && i < records; block_size++, i++) {
+            block[block_size] = { i, i % 7, i % 13, i % 31 };
+        }
+        // the first leaf has no key in the directory
+        if (current_block > 0) {
+            dir_writer.bulk_insert(block.data(), 0, current_block);
+        }
+        ++current_block;
+        leaf_writer.process_block(reinterpret_cast<char*>(block.data()),
+                                  block_size,
+                                  current_block < last_block ? current_block : 0);
+    }
+}
+
+
+enum class ScanMode {
+    next,
+    block,
+    copy, // every record is copied into a new unique_ptr<Record<4>>
+};
+
+
+// scans the whole tree and returns the records read per second
+double scan(const BPlusTree<4>& bpt, uint64_t records, ScanMode mode) {
+    bool interruption_requested = false;
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+
+    auto start_time = chrono::steady_clock::now();
+    auto iter = bpt.get_range(&interruption_requested,
+                              Record<4>({ 0, 0, 0, 0 }),
+                              Record<4>({ UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX }));
+    switch (mode) {
+    case ScanMode::next:
+        for (auto record = iter->next(); record != nullptr; record = iter->next()) {
+            checksum += record->ids[3];
+            count++;
+        }
+        break;
+    case ScanMode::block:
+        for (auto block = iter->next_block(); !block.empty(); block = iter->next_block()) {
+            for (auto& record : block) {
+                checksum += record.ids[3];
+            }
+            count += block.count;
+        }
+        break;
+    case ScanMode::copy:
+        for (auto record = iter->next(); record != nullptr; record = iter->next()) {
+            auto record_copy = make_unique<Record<4>>(*record);
+            checksum += record_copy->ids[3];
+            count++;
+        }
+        break;
+    }
+    chrono::duration<double> duration = chrono::steady_clock::now() - start_time;
+
+    if (count != records || checksum == 0) {
+        cerr << "expected " << records << " records, got " << count << "\n";
+    }
+    return count / duration.count();
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t records;
+    int repetitions;
+
+    cxxopts::Options options("bpt_scan", "Throughput of B+Tree scans with the leaves in the buffer");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Tree will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_bpt_scan"))
+        ("records", "number of records in the B+Tree", cxxopts::value<int64_t>(records)->default_value("20000000"))
+        ("repetitions", "number of scans measured for each mode", cxxopts::value<int>(repetitions)->default_value("5"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (records <= 0 || repetitions <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    create_bpt(records);
+
+    // every leaf and directory page fits in the buffer
+    const auto leaves = records / BPlusTree<4>::leaf_max_records() + 1;
+    BufferManager::init(2 * leaves + 1024, 1, 1);
+    {
+        BPlusTree<4> bpt(BENCHMARK_BPT);
+        scan(bpt, records, ScanMode::next);
+
+        cout << "records: " << records << "\n";
+        cout << setw(16) << "mode" << setw(16) << "records/s" << "\n";
+        for (auto mode : { ScanMode::next, ScanMode::block, ScanMode::copy }) {
+            double best = 0;
+            for (int i = 0; i < repetitions; i++) {
+                best = std::max(best, scan(bpt, records, mode));
+            }
+            const char* name = mode == ScanMode::next  ? "next"
+                             : mode == ScanMode::block ? "next_block"
+                                                       : "unique_ptr copy";
+            cout << setw(16) << name
+                 << setw(16) << std::fixed << std::setprecision(0) << best << "\n";
+        }
+    }
+    buffer_manager.~BufferManager();
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * bpt_seek measures the throughput (seeks per second) of the search of a record inside a B+Tree page and in a whole
+ * B+Tree, as done by the leapfrog seek, for BPlusTree<2>, BPlusTree<3> and BPlusTree<4> and every search
+ * implementation of BPTSearch supported by the CPU.
+ *
+ * The records have few distinct values in the first column, like the permutations of the edges starting with
+ * the type, so the search of the first column finds ties that need to compare the rest of the columns.
+ *  - leaf: BPTSearch::lower_bound over the records of a full leaf.
+ *  - dir:  BPTSearch::upper_bound over the keys of a full directory page.
+ *  - tree: BPlusTree::get_range and the first record, with `records` records and all the pages in the buffer.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "storage/index/bplus_tree/bpt_search.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+template <std::size_t N>
+vector<array<uint64_t, N>> generate_records(uint64_t count, uint64_t first_column_values, std::mt19937_64& rng) {
+    vector<array<uint64_t, N>> records(count);
+    for (auto& record : records) {
+        record[0] = rng() % first_column_values;
+        for (size_t i = 1; i < N; i++) {
+            record[i] = rng();
+        }
+    }
+    std::sort(records.begin(), records.end());
+    records.erase(std::unique(records.begin(), records.end()), records.end());
+    return records;
+}
+
+
+template <std::size_t N>
+double page_seeks(const vector<array<uint64_t, N>>& records,
+                  const vector<Record<N>>& keys,
+                  bool dir)
+{
+    const auto data  = reinterpret_cast<const uint64_t*>(records.data());
+    const auto count = static_cast<uint_fast32_t>(records.size());
+    uint64_t checksum = 0;
+
+    auto start_time = chrono::steady_clock::now();
+    for (auto& key : keys) {
+        checksum += dir ? BPTSearch::upper_bound<N>(data, count, key)
+                        : BPTSearch::lower_bound<N>(data, count, key);
+    }
+    chrono::duration<double> duration = chrono::steady_clock::now() - start_time;
+    if (checksum == 0) {
+        cerr << "unexpected checksum\n";
+    }
+    return keys.size() / duration.count();
+}
+
+
+template <std::size_t N>
+double tree_seeks(const BPlusTree<N>& bpt, const vector<Record<N>>& keys) {
+    bool interruption_requested = false;
+    array<uint64_t, N> max;
+    max.fill(UINT64_MAX);
+    uint64_t found = 0;
+
+    auto start_time = chrono::steady_clock::now();
+    for (auto& key : keys) {
+        auto iter = bpt.get_range(&interruption_requested, key, Record<N>(max));
+        found += iter->next() != nullptr;
+    }
+    chrono::duration<double> duration = chrono::steady_clock::now() - start_time;
+    if (found == 0) {
+        cerr << "no record was found\n";
+    }
+    return keys.size() / duration.count();
+}
+
+
+template <std::size_t N>
+void run(uint64_t records, uint64_t seeks) {
+    std::mt19937_64 rng(N);
+    // about 8 records per value of the first column in a leaf and about 100 in the tree
+    const auto leaf_records = generate_records<N>(BPlusTree<N>::leaf_max_records(),
+                                                  BPlusTree<N>::leaf_max_records() / 8, rng);
+    const auto dir_records  = generate_records<N>(BPlusTree<N>::dir_max_records(),
+                                                  BPlusTree<N>::dir_max_records() / 8, rng);
+    const auto tree_records = generate_records<N>(records, records / 100, rng);
+
+    auto make_keys = [&](const vector<array<uint64_t, N>>& source) {
+        vector<Record<N>> keys;
+        keys.reserve(seeks);
+        for (uint64_t i = 0; i < seeks; i++) {
+            // half of the keys are in the records, the other half are between them
+            auto record = source[rng() % source.size()];
+            if (i % 2 == 1) {
+                record[N - 1]++;
+            }
+            keys.emplace_back(record);
+        }
+        return keys;
+    };
+    const auto leaf_keys = make_keys(leaf_records);
+    const auto dir_keys  = make_keys(dir_records);
+    const auto tree_keys = make_keys(tree_records);
+
+    const auto bpt_name = "bpt_seek_" + to_string(N);
+    {
+        BPTLeafWriter<N> leaf_writer(file_manager.get_file_path(bpt_name + ".leaf"));
+        BPTDirWriter<N> dir_writer(file_manager.get_file_path(bpt_name + ".dir"));
+        for (auto& record : tree_records) {
+            leaf_writer.append(record, dir_writer);
+        }
+        leaf_writer.finish(dir_writer);
+    }
+
+    BufferManager::init(2 * (tree_records.size() / BPlusTree<N>::leaf_max_records()) + 1024, 1, 1);
+    {
+        BPlusTree<N> bpt(bpt_name);
+        tree_seeks(bpt, tree_keys); // loads the pages in the buffer
+
+        const auto best = BPTSearch::get_best_isa();
+        for (auto isa : { BPTSearch::Isa::scalar, BPTSearch::Isa::avx2, BPTSearch::Isa::avx512 }) {
+            if (isa > best) {
+                break;
+            }
+            BPTSearch::set_isa(isa);
+            cout << setw(4) << N
+                 << setw(10) << BPTSearch::get_isa_name(isa)
+                 << setw(16) << std::fixed << std::setprecision(0) << page_seeks<N>(leaf_records, leaf_keys, false)
+                 << setw(16) << page_seeks<N>(dir_records, dir_keys, true)
+                 << setw(16) << tree_seeks(bpt, tree_keys) << "\n";
+        }
+        BPTSearch::set_isa(best);
+    }
+    buffer_manager.~BufferManager();
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t records;
+    int64_t seeks;
+
+    cxxopts::Options options("bpt_seek", "Throughput of the search in B+Tree pages and B+Trees");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Trees will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_bpt_seek"))
+        ("records", "number of records in the B+Trees", cxxopts::value<int64_t>(records)->default_value("10000000"))
+        ("seeks", "number of seeks measured", cxxopts::value<int64_t>(seeks)->default_value("5000000"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (records < 100 || seeks <= 0) {
+        cerr << "records must be at least 100 and seeks must be positive.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+
+    cout << "page size: " << Page::get_size() << ", records: " << records << ", seeks: " << seeks << "\n";
+    cout << setw(4) << "N" << setw(10) << "search"
+         << setw(16) << "leaf seeks/s" << setw(16) << "dir seeks/s" << setw(16) << "tree seeks/s" << "\n";
+    run<2>(records, seeks);
+    run<3>(records, seeks);
+    run<4>(records, seeks);
+    return 0;
+}
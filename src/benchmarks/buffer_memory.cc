@@ -0,0 +1,140 @@
+/*
+ * buffer_memory is a microbenchmark for the memory backing the shared buffer of the BufferManager.
+ *
+ * A file with `pages` pages is created and loaded into the shared buffer, then `threads` threads call
+ * get_page/unpin on random pages of that file and read a random word of each page. With a big buffer most
+ * of these accesses miss the TLB, so the throughput shows the effect of backing the buffer with huge pages
+ * and of placing it in the NUMA nodes. Every combination of the huge pages modes and NUMA policies is measured,
+ * when explicit huge pages are not reserved the mode actually used is shown.
+ */
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/page.h"
+#include "storage/page_memory.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+static const string BENCHMARK_FILE = "buffer_memory.dat";
+
+// returns the number of page fetches per second
+double run(FileId file_id, uint_fast32_t pages, uint_fast32_t thread_count, uint_fast32_t fetches_per_thread) {
+    std::atomic<bool> start(false);
+    std::atomic<uint64_t> checksum(0);
+    vector<thread> threads;
+
+    for (uint_fast32_t t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<uint_fast32_t> page_dist(0, pages - 1);
+            std::uniform_int_distribution<uint_fast32_t> word_dist(0, Page::get_size() / sizeof(uint64_t) - 1);
+            uint64_t local_checksum = 0;
+            while (!start) {
+                std::this_thread::yield();
+            }
+            for (uint_fast32_t i = 0; i < fetches_per_thread; i++) {
+                auto& page = buffer_manager.get_page(file_id, page_dist(rng));
+                local_checksum += reinterpret_cast<uint64_t*>(page.get_bytes())[word_dist(rng)];
+                buffer_manager.unpin(page);
+            }
+            checksum += local_checksum;
+        });
+    }
+
+    auto start_time = chrono::steady_clock::now();
+    start = true;
+    for (auto& th : threads) {
+        th.join();
+    }
+    chrono::duration<double> duration = chrono::steady_clock::now() - start_time;
+
+    if (checksum == 0) {
+        cerr << "unexpected checksum\n";
+    }
+    return (static_cast<double>(thread_count) * fetches_per_thread) / duration.count();
+}
+
+
+const char* to_string(NumaPolicy numa_policy) {
+    switch (numa_policy) {
+    case NumaPolicy::none:        return "none";
+    case NumaPolicy::interleave:  return "interleave";
+    case NumaPolicy::partitioned: return "partitioned";
+    }
+    return "";
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int pages;
+    int threads;
+    int fetches_per_thread;
+
+    cxxopts::Options options("buffer_memory", "Huge pages and NUMA placement benchmark for the shared buffer");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark file will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_buffer_memory"))
+        ("pages", "number of different pages fetched", cxxopts::value<int>(pages)->default_value("65536"))
+        ("threads", "threads fetching pages", cxxopts::value<int>(threads)->default_value(
+            std::to_string(std::max(1u, std::thread::hardware_concurrency()))))
+        ("fetches", "page fetches done by each thread", cxxopts::value<int>(fetches_per_thread)->default_value("2000000"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (pages <= 0 || threads <= 0 || fetches_per_thread <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    auto file_id = file_manager.get_file_id(BENCHMARK_FILE);
+
+    cout << "pages: " << pages << ", threads: " << threads
+         << ", NUMA nodes: " << PageMemory::numa_node_count() << "\n";
+    cout << setw(12) << "huge pages" << setw(12) << "used" << setw(13) << "NUMA" << setw(16) << "fetches/s" << "\n";
+
+    bool file_created = false;
+    for (auto huge_pages : { HugePages::none, HugePages::transparent, HugePages::huge_2mb, HugePages::huge_1gb }) {
+        for (auto numa_policy : { NumaPolicy::none, NumaPolicy::interleave, NumaPolicy::partitioned }) {
+            // the buffer has room for every page, so all the measured fetches are hits
+            BufferManager::init(2 * pages, 1, 1, false, ReplacementPolicyType::two_queue, huge_pages, numa_policy);
+
+            for (int i = 0; i < pages; i++) {
+                auto& page = buffer_manager.get_page(file_id, i);
+                if (!file_created) {
+                    auto words = reinterpret_cast<uint64_t*>(page.get_bytes());
+                    for (uint_fast32_t w = 0; w < Page::get_size() / sizeof(uint64_t); w++) {
+                        words[w] = i + w + 1;
+                    }
+                    page.make_dirty();
+                }
+                buffer_manager.unpin(page);
+            }
+            file_created = true;
+
+            auto throughput = run(file_id, pages, threads, fetches_per_thread);
+            cout << setw(12) << PageMemory::to_string(huge_pages)
+                 << setw(12) << PageMemory::to_string(buffer_manager.get_huge_pages())
+                 << setw(13) << to_string(numa_policy)
+                 << setw(16) << std::fixed << std::setprecision(0) << throughput << "\n";
+
+            buffer_manager.~BufferManager();
+        }
+    }
+    return 0;
+}
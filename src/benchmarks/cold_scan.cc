@@ -0,0 +1,153 @@
+/*
+ * cold_scan measures full scans of a B+Tree whose pages are neither in the BufferManager nor in the OS page cache.
+ *
+ * A BPlusTree<4> with `records` records is written with the bulk import writers, then it is scanned once
+ * without read-ahead and once for every value given in `read-ahead`. Before each scan the BufferManager is
+ * recreated and the OS page cache of the tree files is dropped (posix_fadvise DONTNEED), so every leaf must
+ * be read from disk.
+ */
+#include <array>
+#include <chrono>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+static const string BENCHMARK_BPT = "cold_scan";
+
+// writes the leaves and directory like Import::DiskVector does after sorting
+void create_bpt(uint64_t records) {
+    BPTLeafWriter<4> leaf_writer(file_manager.get_file_path(BENCHMARK_BPT + ".leaf"));
+    BPTDirWriter<4> dir_writer(file_manager.get_file_path(BENCHMARK_BPT + ".dir"));
+
+    const auto max_records = BPTLeafWriter<4>::max_records();
+    const uint32_t last_block = (records / max_records) + (records % max_records != 0);
+    vector<array<uint64_t, 4>> block(max_records);
+
+    uint32_t current_block = 0;
+    uint64_t i = 0;
+    while (i < records) {
+        uint32_t block_size = 0;
+        for (; block_size < max_records && i < records; block_size++, i++) {
+            block[block_size] = { i, i % 7, i % 13, i % 31 };
+        }
+        // the first leaf has no key in the directory
+        if (current_block > 0) {
+            dir_writer.bulk_insert(block.data(), 0, current_block);
+        }
+        ++current_block;
+        leaf_writer.process_block(reinterpret_cast<char*>(block.data()),
+                                  block_size,
+                                  current_block < last_block ? current_block : 0);
+    }
+}
+
+
+void drop_os_cache(const string& filename) {
+    auto fd = open(file_manager.get_file_path(filename).c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+
+// returns the number of leaves read per second
+double run(uint64_t records, uint_fast32_t buffer_size, uint_fast32_t read_ahead_pages) {
+    drop_os_cache(BENCHMARK_BPT + ".leaf");
+    drop_os_cache(BENCHMARK_BPT + ".dir");
+    BufferManager::init(buffer_size, 1, 1);
+    buffer_manager.set_read_ahead_pages(read_ahead_pages);
+
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+    chrono::duration<double> duration;
+    {
+        BPlusTree<4> bpt(BENCHMARK_BPT);
+        bool interruption_requested = false;
+
+        auto start_time = chrono::steady_clock::now();
+        auto iter = bpt.get_range(&interruption_requested,
+                                  Record<4>({ 0, 0, 0, 0 }),
+                                  Record<4>({ UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX }));
+        for (auto record = iter->next(); record != nullptr; record = iter->next()) {
+            checksum += record->ids[1];
+            count++;
+        }
+        duration = chrono::steady_clock::now() - start_time;
+    }
+    buffer_manager.~BufferManager();
+
+    if (count != records) {
+        cerr << "expected " << records << " records, got " << count << " (checksum " << checksum << ")\n";
+    }
+    const auto leaves = (records / BPlusTree<4>::leaf_max_records()) + (records % BPlusTree<4>::leaf_max_records() != 0);
+    return leaves / duration.count();
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t records;
+    int buffer_size;
+    string read_ahead_values;
+
+    cxxopts::Options options("cold_scan", "Full B+Tree scan with cold caches, with and without read-ahead");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Tree will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_cold_scan"))
+        ("records", "number of records in the B+Tree", cxxopts::value<int64_t>(records)->default_value("20000000"))
+        ("b,buffer-size", "set shared buffer pool size",
+            cxxopts::value<int>(buffer_size)->default_value(std::to_string(BufferManager::DEFAULT_SHARED_BUFFER_POOL_SIZE)))
+        ("read-ahead", "comma separated read-ahead values compared against no read-ahead",
+            cxxopts::value<string>(read_ahead_values)->default_value("4,16,64"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (records <= 0 || buffer_size <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    vector<uint_fast32_t> read_ahead_pages = { 0 };
+    stringstream ss(read_ahead_values);
+    for (string value; getline(ss, value, ','); ) {
+        read_ahead_pages.push_back(std::stoul(value));
+    }
+
+    FileManager::init(db_folder);
+    create_bpt(records);
+
+    cout << "records: " << records << ", buffer size: " << buffer_size << "\n";
+    cout << setw(12) << "read-ahead" << setw(16) << "leaves/s" << setw(10) << "speedup" << "\n";
+
+    double baseline_throughput = 0;
+    for (auto pages : read_ahead_pages) {
+        auto throughput = run(records, buffer_size, pages);
+        if (pages == 0) {
+            baseline_throughput = throughput;
+        }
+        cout << setw(12) << pages
+             << setw(16) << std::fixed << std::setprecision(0) << throughput
+             << setw(10) << std::setprecision(2) << (throughput / baseline_throughput) << "\n";
+    }
+    return 0;
+}
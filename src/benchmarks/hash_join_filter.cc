@@ -0,0 +1,162 @@
+/*
+ * hash_join_filter measures a HashJoinHybrid between two scans with and without the JoinKeyFilter of its build
+ * side pushed to the probe side, the workload of the queries MATCH (?x)-[:ta]->(?y)-[:tb]->(?z) of
+ * scripts/hash_join/hash_join_db_generator.py where a fraction of the nodes joins.
+ *
+ * The relations are B+Trees with random edges between `nodes` nodes:
+ *  - A(x, y) with `nodes` edges, the build side is the scan of the edges with x < nodes * fraction.
+ *  - B(y, z) with `edges` edges, the probe side is the scan of all of them.
+ *
+ * For every fraction the join runs `repetitions` times after a first run that loads the pages, and the mean time
+ * is reported with the output of HashJoinHybrid::analyze. With small fractions the filter is a Bloom filter and
+ * with bigger ones it is a bitmap, as the keys are denser.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/hash_join/hash_join_hybrid.h"
+#include "execution/binding_id_iter/index_scan.h"
+#include "execution/binding_id_iter/scan_ranges/bounded_var.h"
+#include "execution/binding_id_iter/scan_ranges/unassigned_var.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+vector<array<uint64_t, 2>> random_edges(uint64_t nodes, uint64_t edge_count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    vector<array<uint64_t, 2>> edges(edge_count);
+    for (auto& edge : edges) {
+        edge[0] = rng() % nodes;
+        edge[1] = rng() % nodes;
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+
+void create_bpt(const string& name, const vector<array<uint64_t, 2>>& edges) {
+    BPTLeafWriter<2> leaf_writer(file_manager.get_file_path(name + ".leaf"));
+    BPTDirWriter<2> dir_writer(file_manager.get_file_path(name + ".dir"));
+    for (auto& edge : edges) {
+        leaf_writer.append(edge, dir_writer);
+    }
+    leaf_writer.finish(dir_writer);
+}
+
+
+void run(BPlusTree<2>& a, BPlusTree<2>& b, uint64_t nodes, double fraction, int repetitions) {
+    const VarId x(0);
+    const VarId y(1);
+    const VarId z(2);
+
+    for (bool filters : { false, true }) {
+        ThreadInfo thread_info;
+        thread_info.hash_join_filters = filters;
+
+        uint64_t results = 0;
+        string analysis;
+        auto hash_join = [&]() {
+            const uint64_t max_x = static_cast<uint64_t>(nodes * fraction);
+            array<unique_ptr<ScanRange>, 2> lhs_ranges {
+                make_unique<BoundedVar>(x, 0, max_x > 0 ? max_x - 1 : 0),
+                make_unique<UnassignedVar>(y)
+            };
+            array<unique_ptr<ScanRange>, 2> rhs_ranges {
+                make_unique<UnassignedVar>(y),
+                make_unique<UnassignedVar>(z)
+            };
+            HashJoinHybrid join(make_unique<IndexScan<2>>(a, &thread_info, move(lhs_ranges)),
+                                make_unique<IndexScan<2>>(b, &thread_info, move(rhs_ranges)),
+                                { x },
+                                { y },
+                                { z },
+                                &thread_info);
+            BindingId binding(3);
+            join.begin(binding);
+            results = 0;
+            while (join.next()) {
+                results++;
+            }
+            stringstream ss;
+            join.analyze(ss);
+            analysis = ss.str();
+        };
+
+        hash_join(); // loads the pages in the buffer
+        auto start_time = chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            hash_join();
+        }
+        chrono::duration<double, std::milli> duration = chrono::steady_clock::now() - start_time;
+
+        cout << setw(10) << fraction << setw(10) << (filters ? "yes" : "no") << setw(12) << results
+             << setw(12) << std::fixed << std::setprecision(2) << duration.count() / repetitions
+             << std::defaultfloat << "\n" << analysis << "\n\n";
+    }
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t nodes;
+    int64_t edges;
+    int repetitions;
+
+    cxxopts::Options options("hash_join_filter", "Time of a hash join with and without join key filters");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Trees will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_hash_join_filter"))
+        ("nodes", "nodes of the graph and edges of the build relation",
+            cxxopts::value<int64_t>(nodes)->default_value("1000000"))
+        ("edges", "edges of the probe relation", cxxopts::value<int64_t>(edges)->default_value("10000000"))
+        ("repetitions", "times each join is measured", cxxopts::value<int>(repetitions)->default_value("3"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (nodes <= 0 || edges <= 0 || repetitions <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    {
+        const auto a_edges = random_edges(nodes, nodes, 1);
+        create_bpt("a", a_edges);
+    }
+    {
+        const auto b_edges = random_edges(nodes, edges, 2);
+        create_bpt("b", b_edges);
+    }
+    const auto leaves = (nodes + edges) / BPlusTree<2>::leaf_max_records();
+    BufferManager::init(2 * leaves + 1024, 1, 1);
+
+    {
+        BPlusTree<2> a("a");
+        BPlusTree<2> b("b");
+        cout << setw(10) << "fraction" << setw(10) << "filter" << setw(12) << "results" << setw(12) << "time (ms)"
+             << "\n";
+        for (double fraction : { 0.01, 0.1, 0.3, 0.5, 0.9 }) {
+            run(a, b, nodes, fraction, repetitions);
+        }
+    }
+    buffer_manager.~BufferManager();
+    return 0;
+}
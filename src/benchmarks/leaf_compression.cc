@@ -0,0 +1,203 @@
+/*
+ * leaf_compression compares the size and the scan and lookup times of B+Trees with regular and compressed leaves.
+ *
+ * A graph with `nodes` nodes and `edges` edges is generated: the type of an edge follows a skewed distribution
+ * over `types` types and its nodes are chosen at random. The ids use the masks of ObjectId like an imported
+ * database. The permutations type_from_to_edge and from_to_type_edge are sorted and written with BPTLeafWriter::append
+ * as the import does, once with each leaf format. For every tree the size of its files, the time of a full scan with
+ * the OS page cache dropped (cold) and with the leaves in the buffer (warm), and the mean latency of `lookups`
+ * random searches of an edge are reported.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#include "base/ids/object_id.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/filesystem.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+using Edge = array<uint64_t, 4>;
+
+vector<Edge> generate_edges(uint64_t nodes, uint64_t edges, uint64_t types) {
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<uint64_t> node_dist(1, nodes);
+    // a few types are used by most of the edges
+    std::geometric_distribution<uint64_t> type_dist(4.0 / types);
+
+    vector<Edge> res;
+    res.reserve(edges);
+    for (uint64_t i = 1; i <= edges; i++) {
+        res.push_back({ ObjectId::MASK_NAMED_NODE_EXTERN | (1 + type_dist(rng) % types),
+                        ObjectId::MASK_ANON | node_dist(rng),
+                        ObjectId::MASK_ANON | node_dist(rng),
+                        ObjectId::MASK_EDGE | i });
+    }
+    return res;
+}
+
+
+void drop_os_cache(const string& filename) {
+    auto fd = open(file_manager.get_file_path(filename).c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+
+struct Result {
+    uint64_t size;       // bytes of the leaf and dir files
+    double cold_scan_ms;
+    double warm_scan_ms;
+    double lookup_us;
+};
+
+
+double scan(const BPlusTree<4>& bpt, uint64_t expected) {
+    bool interruption_requested = false;
+    uint64_t count = 0;
+    auto start_time = chrono::steady_clock::now();
+    auto iter = bpt.get_range(&interruption_requested,
+                              Record<4>({ 0, 0, 0, 0 }),
+                              Record<4>({ UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX }));
+    for (auto block = iter->next_block(); !block.empty(); block = iter->next_block()) {
+        count += block.count;
+    }
+    chrono::duration<double, std::milli> duration = chrono::steady_clock::now() - start_time;
+    if (count != expected) {
+        cerr << "expected " << expected << " records, got " << count << "\n";
+    }
+    return duration.count();
+}
+
+
+Result run(const string& name, const vector<Edge>& sorted_edges, uint_fast32_t buffer_size, uint_fast32_t lookups) {
+    Result res;
+    res.size = Filesystem::file_size(file_manager.get_file_path(name + ".leaf"))
+             + Filesystem::file_size(file_manager.get_file_path(name + ".dir"));
+
+    drop_os_cache(name + ".leaf");
+    drop_os_cache(name + ".dir");
+    BufferManager::init(buffer_size, 1, 1);
+    {
+        BPlusTree<4> bpt(name);
+        res.cold_scan_ms = scan(bpt, sorted_edges.size());
+        res.warm_scan_ms = scan(bpt, sorted_edges.size());
+
+        bool interruption_requested = false;
+        std::mt19937_64 rng(1);
+        std::uniform_int_distribution<uint64_t> dist(0, sorted_edges.size() - 1);
+        uint64_t found = 0;
+        auto start_time = chrono::steady_clock::now();
+        for (uint_fast32_t i = 0; i < lookups; i++) {
+            const auto& edge = sorted_edges[dist(rng)];
+            auto iter = bpt.get_range(&interruption_requested, Record<4>(edge), Record<4>(edge));
+            if (iter->next() != nullptr) {
+                found++;
+            }
+        }
+        chrono::duration<double, std::micro> lookup_duration = chrono::steady_clock::now() - start_time;
+        if (found != lookups) {
+            cerr << "expected " << lookups << " records found, got " << found << "\n";
+        }
+        res.lookup_us = lookup_duration.count() / lookups;
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t nodes;
+    int64_t edges;
+    int types;
+    int lookups;
+    int buffer_mb;
+
+    cxxopts::Options options("leaf_compression", "Size and speed of B+Trees with compressed leaves");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Trees will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_leaf_compression"))
+        ("nodes", "number of nodes of the graph", cxxopts::value<int64_t>(nodes)->default_value("1000000"))
+        ("edges", "number of edges of the graph", cxxopts::value<int64_t>(edges)->default_value("10000000"))
+        ("types", "number of edge types", cxxopts::value<int>(types)->default_value("100"))
+        ("lookups", "number of random searches", cxxopts::value<int>(lookups)->default_value("100000"))
+        ("buffer-mb", "size of the shared buffer in MB", cxxopts::value<int>(buffer_mb)->default_value("1024"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (nodes <= 0 || edges <= 0 || types <= 0 || lookups <= 0 || buffer_mb <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    const auto buffer_size = static_cast<uint_fast32_t>(buffer_mb * 1024ULL * 1024 / Page::get_size());
+
+    auto graph_edges = generate_edges(nodes, edges, types);
+
+    cout << "nodes: " << nodes << ", edges: " << edges << ", types: " << types << "\n";
+    cout << setw(20) << "permutation" << setw(12) << "leaves" << setw(12) << "size (MB)" << setw(8) << "ratio"
+         << setw(16) << "cold scan (ms)" << setw(16) << "warm scan (ms)" << setw(14) << "lookup (us)" << "\n";
+
+    const vector<pair<string, array<size_t, 4>>> permutations = {
+        { "type_from_to_edge", { 0, 1, 2, 3 } },
+        { "from_to_type_edge", { 1, 2, 0, 3 } },
+    };
+    for (auto& [permutation_name, permutation] : permutations) {
+        vector<Edge> sorted_edges;
+        sorted_edges.reserve(graph_edges.size());
+        for (auto& edge : graph_edges) {
+            sorted_edges.push_back({ edge[permutation[0]], edge[permutation[1]],
+                                     edge[permutation[2]], edge[permutation[3]] });
+        }
+        std::sort(sorted_edges.begin(), sorted_edges.end());
+
+        uint64_t regular_size = 0;
+        for (auto compressed : { false, true }) {
+            const auto name = permutation_name + (compressed ? "_compressed" : "");
+            {
+                BPTLeafWriter<4> leaf_writer(file_manager.get_file_path(name + ".leaf"), compressed);
+                BPTDirWriter<4> dir_writer(file_manager.get_file_path(name + ".dir"));
+                for (auto& edge : sorted_edges) {
+                    leaf_writer.append(edge, dir_writer);
+                }
+                leaf_writer.finish(dir_writer);
+            }
+
+            auto res = run(name, sorted_edges, buffer_size, lookups);
+            if (!compressed) {
+                regular_size = res.size;
+            }
+            cout << setw(20) << permutation_name
+                 << setw(12) << (compressed ? "compressed" : "regular")
+                 << setw(12) << std::fixed << std::setprecision(1) << res.size / (1024.0 * 1024.0)
+                 << setw(8)  << std::setprecision(2) << static_cast<double>(regular_size) / res.size
+                 << setw(16) << std::setprecision(1) << res.cold_scan_ms
+                 << setw(16) << res.warm_scan_ms
+                 << setw(14) << std::setprecision(2) << res.lookup_us << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * leapfrog_triangles measures a LeapfrogJoin of LeapfrogBptIter<2> listing the triangles R(x,y), S(y,z), T(x,z)
+ * of a graph, the worst-case optimal join workload of scripts/triangle_query.py.
+ *
+ * Two graphs are generated and every edge is in the three relations:
+ *  - skew:   the graph of triangle_query.py, R = S = T = {(1,i)} U {(i,n)}. Any binary join of two relations has
+ *            about n^2 results but there are about 3n triangles.
+ *  - random: `edges` random edges between `nodes` nodes, most seeks land close to the cursor.
+ *
+ * All the pages are in the buffer. For every graph the join runs `repetitions` times after a first run that loads
+ * the pages, and the mean time is reported with the output of LeapfrogJoin::analyze (results found and seeks).
+ * With `threads` greater than 1 the join is a ParallelLeapfrogJoin with that many workers.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "execution/binding_id_iter/leapfrog_join.h"
+#include "execution/binding_id_iter/parallel_leapfrog_join.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "storage/index/leapfrog/leapfrog_bpt_iter.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+vector<array<uint64_t, 2>> skew_graph(uint64_t n) {
+    vector<array<uint64_t, 2>> edges;
+    for (uint64_t i = 1; i <= n; i++) {
+        edges.push_back({ 1, i });
+        edges.push_back({ i, n });
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+
+vector<array<uint64_t, 2>> random_graph(uint64_t nodes, uint64_t edge_count) {
+    std::mt19937_64 rng(0);
+    vector<array<uint64_t, 2>> edges(edge_count);
+    for (auto& edge : edges) {
+        edge[0] = rng() % nodes;
+        edge[1] = rng() % nodes;
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+
+void run(const string& name, const vector<array<uint64_t, 2>>& edges, int repetitions, int threads) {
+    {
+        BPTLeafWriter<2> leaf_writer(file_manager.get_file_path(name + ".leaf"));
+        BPTDirWriter<2> dir_writer(file_manager.get_file_path(name + ".dir"));
+        for (auto& edge : edges) {
+            leaf_writer.append(edge, dir_writer);
+        }
+        leaf_writer.finish(dir_writer);
+    }
+    BPlusTree<2> bpt(name);
+
+    bool interruption_requested = false;
+    const VarId x(0);
+    const VarId y(1);
+    const VarId z(2);
+
+    uint64_t triangles = 0;
+    string analysis;
+    auto make_join = [&]() {
+        vector<unique_ptr<LeapfrogIter>> leapfrog_iters;
+        auto add_relation = [&](VarId first, VarId second) {
+            leapfrog_iters.push_back(make_unique<LeapfrogBptIter<2>>(&interruption_requested,
+                                                                     bpt,
+                                                                     vector<unique_ptr<ScanRange>>(),
+                                                                     vector<VarId> { first, second },
+                                                                     vector<VarId>()));
+        };
+        add_relation(x, y); // R
+        add_relation(y, z); // S
+        add_relation(x, z); // T
+        return make_unique<LeapfrogJoin>(move(leapfrog_iters), vector<VarId> { x, y, z }, 3);
+    };
+
+    auto triangle_join = [&]() {
+        unique_ptr<BindingIdIter> join;
+        if (threads == 1) {
+            join = make_join();
+        } else {
+            vector<unique_ptr<LeapfrogJoin>> joins;
+            for (int i = 0; i < threads; i++) {
+                joins.push_back(make_join());
+            }
+            join = make_unique<ParallelLeapfrogJoin>(move(joins));
+        }
+        BindingId binding(3);
+        join->begin(binding);
+        triangles = 0;
+        while (join->next()) {
+            triangles++;
+        }
+        stringstream ss;
+        join->analyze(ss);
+        analysis = ss.str();
+    };
+
+    triangle_join(); // loads the pages in the buffer
+    auto start_time = chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+        triangle_join();
+    }
+    chrono::duration<double, std::milli> duration = chrono::steady_clock::now() - start_time;
+
+    cout << setw(8) << name << setw(12) << edges.size() << setw(12) << triangles
+         << setw(12) << std::fixed << std::setprecision(2) << duration.count() / repetitions
+         << "  " << analysis << "\n";
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t skew_n;
+    int64_t nodes;
+    int64_t edges;
+    int repetitions;
+    int threads;
+
+    cxxopts::Options options("leapfrog_triangles", "Time of listing triangles with LeapfrogJoin");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Trees will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_leapfrog_triangles"))
+        ("skew-n", "N of the skew graph", cxxopts::value<int64_t>(skew_n)->default_value("1000000"))
+        ("nodes", "nodes of the random graph", cxxopts::value<int64_t>(nodes)->default_value("100000"))
+        ("edges", "edges of the random graph", cxxopts::value<int64_t>(edges)->default_value("2000000"))
+        ("repetitions", "times each join is measured", cxxopts::value<int>(repetitions)->default_value("3"))
+        ("threads", "workers of the join", cxxopts::value<int>(threads)->default_value("1"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (skew_n <= 0 || nodes <= 0 || edges <= 0 || repetitions <= 0 || threads <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    const auto skew_edges   = skew_graph(skew_n);
+    const auto random_edges = random_graph(nodes, edges);
+    const auto max_edges    = std::max(skew_edges.size(), random_edges.size());
+    BufferManager::init(2 * (max_edges / BPlusTree<2>::leaf_max_records()) + 1024, 1, 1);
+
+    cout << setw(8) << "graph" << setw(12) << "edges" << setw(12) << "triangles" << setw(12) << "time (ms)" << "\n";
+    run("skew",   skew_edges,   repetitions, threads);
+    run("random", random_edges, repetitions, threads);
+
+    buffer_manager.~BufferManager();
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * mmap_lookup compares reading a B+Tree through the shared buffer against reading it from memory mappings
+ * (BufferManager mmap mode) when the whole tree is already in memory.
+ *
+ * A BPlusTree<2> with `records` records is written with the bulk import writers. For each mode the tree is
+ * scanned once to warm the caches, then `lookups` random point searches and a full scan are measured.
+ */
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+static const string BENCHMARK_BPT = "mmap_lookup";
+
+// writes the leaves and directory like Import::DiskVector does after sorting, record i is (2*i, i)
+void create_bpt(uint64_t records) {
+    BPTLeafWriter<2> leaf_writer(file_manager.get_file_path(BENCHMARK_BPT + ".leaf"));
+    BPTDirWriter<2> dir_writer(file_manager.get_file_path(BENCHMARK_BPT + ".dir"));
+
+    const auto max_records = BPTLeafWriter<2>::max_records();
+    const uint32_t last_block = (records / max_records) + (records % max_records != 0);
+    vector<array<uint64_t, 2>> block(max_records);
+
+    uint32_t current_block = 0;
+    uint64_t i = 0;
+    while (i < records) {
+        uint32_t block_size = 0;
+        for (; block_size < max_records && i < records; block_size++, i++) {
+            block[block_size] = { 2*i, i };
+        }
+        // the first leaf has no key in the directory
+        if (current_block > 0) {
+            dir_writer.bulk_insert(block.data(), 0, current_block);
+        }
+        ++current_block;
+        leaf_writer.process_block(reinterpret_cast<char*>(block.data()),
+                                  block_size,
+                                  current_block < last_block ? current_block : 0);
+    }
+}
+
+
+uint64_t scan(BPlusTree<2>& bpt) {
+    bool interruption_requested = false;
+    uint64_t count = 0;
+    auto iter = bpt.get_range(&interruption_requested,
+                              Record<2>({ 0, 0 }),
+                              Record<2>({ UINT64_MAX, UINT64_MAX }));
+    for (auto record = iter->next(); record != nullptr; record = iter->next()) {
+        count++;
+    }
+    return count;
+}
+
+
+struct Result {
+    double lookups_per_second;
+    double records_scanned_per_second;
+};
+
+
+Result run(uint64_t records, uint_fast32_t buffer_size, uint_fast32_t lookups, bool mmap_enabled) {
+    BufferManager::init(buffer_size, 1, 1, mmap_enabled);
+    Result res;
+    {
+        BPlusTree<2> bpt(BENCHMARK_BPT);
+        bool interruption_requested = false;
+
+        // warm up
+        if (scan(bpt) != records) {
+            cerr << "unexpected record count\n";
+        }
+
+        std::mt19937_64 rng(0);
+        std::uniform_int_distribution<uint64_t> dist(0, records - 1);
+        uint64_t found = 0;
+        auto start_time = chrono::steady_clock::now();
+        for (uint_fast32_t i = 0; i < lookups; i++) {
+            auto key = 2 * dist(rng);
+            auto iter = bpt.get_range(&interruption_requested, Record<2>({ key, 0 }), Record<2>({ key, UINT64_MAX }));
+            if (iter->next() != nullptr) {
+                found++;
+            }
+        }
+        chrono::duration<double> lookup_duration = chrono::steady_clock::now() - start_time;
+        if (found != lookups) {
+            cerr << "expected " << lookups << " records found, got " << found << "\n";
+        }
+
+        start_time = chrono::steady_clock::now();
+        scan(bpt);
+        chrono::duration<double> scan_duration = chrono::steady_clock::now() - start_time;
+
+        res.lookups_per_second         = lookups / lookup_duration.count();
+        res.records_scanned_per_second = records / scan_duration.count();
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t records;
+    int lookups;
+
+    cxxopts::Options options("mmap_lookup", "B+Tree lookups and scans using the shared buffer or mmap");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Tree will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_mmap_lookup"))
+        ("records", "number of records in the B+Tree", cxxopts::value<int64_t>(records)->default_value("10000000"))
+        ("lookups", "number of random point searches", cxxopts::value<int>(lookups)->default_value("1000000"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (records <= 0 || lookups <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    create_bpt(records);
+
+    // the buffer can hold the whole tree
+    const auto leaves = (records / BPlusTree<2>::leaf_max_records()) + 1;
+    const auto buffer_size = 2 * leaves + 1024;
+
+    cout << "records: " << records << ", lookups: " << lookups << "\n";
+    cout << setw(8) << "mode" << setw(16) << "lookups/s" << setw(20) << "scanned records/s" << "\n";
+    for (auto mmap_enabled : { false, true }) {
+        auto res = run(records, buffer_size, lookups, mmap_enabled);
+        cout << setw(8) << (mmap_enabled ? "mmap" : "buffer")
+             << setw(16) << std::fixed << std::setprecision(0) << res.lookups_per_second
+             << setw(20) << res.records_scanned_per_second << "\n";
+    }
+    return 0;
+}
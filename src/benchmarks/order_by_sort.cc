@@ -0,0 +1,140 @@
+/*
+ * order_by_sort measures an OrderBy of `bindings` bindings with two integer vars, ORDER BY ?key, ?value, with the
+ * whole input in memory, with memory budgets that make it write sorted runs to temp files, and with a LIMIT so
+ * only the first bindings are kept in a heap. The keys are random and the values are the position of the binding.
+ *
+ * Each case reports the time to consume the OrderBy and its analyze() output, that says if the tuples were sorted
+ * in memory, how many runs were written or the size of the heap. The results are checked to be ordered.
+ */
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "base/thread/thread_info.h"
+#include "execution/binding_iter/order_by.h"
+#include "execution/graph_object/graph_object_factory.h"
+#include "execution/graph_object/graph_object_manager.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+const VarId KEY(0);
+const VarId VALUE(1);
+
+// returns `count` bindings (key, value) with random keys
+class RandomBindings : public BindingIter {
+public:
+    RandomBindings(uint64_t count) : count (count) { }
+
+    void begin(std::ostream&) override {
+        rng.seed(1);
+        pos = 0;
+    }
+
+    bool next() override {
+        if (pos == count) {
+            return false;
+        }
+        key = GraphObjectFactory::make_int(rng() % 1000000000);
+        value = GraphObjectFactory::make_int(pos);
+        pos++;
+        return true;
+    }
+
+    GraphObject operator[](VarId var_id) const override {
+        return var_id == KEY ? key : value;
+    }
+
+    void analyze(std::ostream& os, int indent = 0) const override {
+        os << std::string(indent, ' ') << "RandomBindings(" << count << ")\n";
+    }
+
+private:
+    const uint64_t count;
+    std::mt19937_64 rng;
+    uint64_t pos;
+    GraphObject key;
+    GraphObject value;
+};
+
+
+void run(uint64_t bindings, uint64_t sort_memory_mb, uint64_t limit) {
+    ThreadInfo thread_info;
+    thread_info.sort_memory = sort_memory_mb * 1024 * 1024;
+    OrderBy order_by(&thread_info,
+                     make_unique<RandomBindings>(bindings),
+                     { KEY, VALUE },
+                     { KEY, VALUE },
+                     { true, true },
+                     limit);
+
+    auto start_time = chrono::steady_clock::now();
+    stringstream ss;
+    order_by.begin(ss);
+    uint64_t results = 0;
+    bool ordered = true;
+    int64_t last_key = -1;
+    while (order_by.next()) {
+        const auto key = GraphObjectInterpreter::get<int64_t>(order_by[KEY]);
+        ordered = ordered && key >= last_key;
+        last_key = key;
+        results++;
+    }
+    chrono::duration<double, std::milli> duration = chrono::steady_clock::now() - start_time;
+
+    order_by.analyze(ss);
+    auto analysis = ss.str();
+    analysis.erase(0, analysis.find("OrderBy"));
+    cout << setw(12) << sort_memory_mb << setw(12) << (limit == UINT64_MAX ? "-" : to_string(limit))
+         << setw(12) << results << setw(12) << std::fixed << std::setprecision(2) << duration.count()
+         << std::defaultfloat << "  " << analysis;
+    if (!ordered) {
+        cout << "ERROR: the results are not ordered\n";
+    }
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t bindings;
+
+    cxxopts::Options options("order_by_sort", "Time of an OrderBy with different memory budgets and limits");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder of the benchmark database, only its temp files are used",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_order_by_sort"))
+        ("bindings", "bindings sorted", cxxopts::value<int64_t>(bindings)->default_value("10000000"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (bindings <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    BufferManager::init(1024, BufferManager::DEFAULT_PRIVATE_BUFFER_POOL_SIZE, 1);
+    GraphObject::graph_object_cmp = GraphObjectManager::compare;
+
+    cout << setw(12) << "memory (MB)" << setw(12) << "limit" << setw(12) << "results" << setw(12) << "time (ms)"
+         << "\n";
+    for (uint64_t sort_memory_mb : { 1024, 64, 16 }) {
+        run(bindings, sort_memory_mb, UINT64_MAX);
+    }
+    for (uint64_t limit : { 10, 10000 }) {
+        run(bindings, 16, limit);
+    }
+    buffer_manager.~BufferManager();
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * page_fetch is a microbenchmark for the shared buffer of the BufferManager.
+ *
+ * A file with `pages` pages is created and loaded into the shared buffer, then for 1, 2, 4, ..., `max-threads`
+ * threads every thread calls get_page/unpin on random pages of that file. As all pages are resident in the
+ * buffer, every call is a buffer hit and the reported throughput only depends on the BufferManager
+ * synchronization. Ideally the throughput grows linearly with the number of threads.
+ */
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/page.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+static const string BENCHMARK_FILE = "page_fetch.dat";
+
+// returns the number of page fetches per second using `thread_count` threads
+double run(FileId file_id, uint_fast32_t pages, uint_fast32_t thread_count, uint_fast32_t fetches_per_thread) {
+    std::atomic<bool> start(false);
+    std::atomic<uint64_t> checksum(0);
+    vector<thread> threads;
+
+    for (uint_fast32_t t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<uint_fast32_t> dist(0, pages - 1);
+            uint64_t local_checksum = 0;
+            while (!start) {
+                std::this_thread::yield();
+            }
+            for (uint_fast32_t i = 0; i < fetches_per_thread; i++) {
+                auto& page = buffer_manager.get_page(file_id, dist(rng));
+                local_checksum += *reinterpret_cast<uint32_t*>(page.get_bytes());
+                buffer_manager.unpin(page);
+            }
+            checksum += local_checksum;
+        });
+    }
+
+    auto start_time = chrono::steady_clock::now();
+    start = true;
+    for (auto& th : threads) {
+        th.join();
+    }
+    chrono::duration<double> duration = chrono::steady_clock::now() - start_time;
+
+    if (checksum == 0 && pages > 1) {
+        cerr << "unexpected checksum\n";
+    }
+    return (static_cast<double>(thread_count) * fetches_per_thread) / duration.count();
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int pages;
+    int buffer_size;
+    int max_threads;
+    int fetches_per_thread;
+
+    cxxopts::Options options("page_fetch", "Multi-threaded page fetch benchmark for the shared buffer");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark file will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_page_fetch"))
+        ("pages", "number of different pages fetched", cxxopts::value<int>(pages)->default_value("16384"))
+        ("b,buffer-size", "set shared buffer pool size (0 means twice the number of pages)",
+            cxxopts::value<int>(buffer_size)->default_value("0"))
+        ("max-threads", "max threads", cxxopts::value<int>(max_threads)->default_value(
+            std::to_string(std::max(1u, std::thread::hardware_concurrency()))))
+        ("fetches", "page fetches done by each thread", cxxopts::value<int>(fetches_per_thread)->default_value("2000000"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (pages <= 0 || max_threads <= 0 || fetches_per_thread <= 0 || buffer_size < 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+    if (buffer_size == 0) {
+        buffer_size = 2 * pages;
+    }
+    if (buffer_size < pages) {
+        cerr << "Buffer size must be at least the number of pages, otherwise the benchmark measures disk reads.\n";
+        return 1;
+    }
+
+    FileManager::init(db_folder);
+    BufferManager::init(buffer_size, 1, 1);
+
+    auto file_id = file_manager.get_file_id(BENCHMARK_FILE);
+    // create the file and load every page into the buffer
+    for (int i = 0; i < pages; i++) {
+        auto& page = buffer_manager.get_page(file_id, i);
+        *reinterpret_cast<uint32_t*>(page.get_bytes()) = i + 1;
+        page.make_dirty();
+        buffer_manager.unpin(page);
+    }
+    buffer_manager.flush();
+
+    cout << "pages: " << pages << ", buffer size: " << buffer_size
+         << ", partitions: " << buffer_manager.get_shared_buffer_partitions() << "\n";
+    cout << setw(8) << "threads" << setw(16) << "fetches/s" << setw(10) << "speedup" << "\n";
+
+    double single_thread_throughput = 0;
+    for (int threads = 1; ; threads *= 2) {
+        threads = std::min(threads, max_threads);
+        auto throughput = run(file_id, pages, threads, fetches_per_thread);
+        if (threads == 1) {
+            single_thread_throughput = throughput;
+        }
+        cout << setw(8) << threads
+             << setw(16) << std::fixed << std::setprecision(0) << throughput
+             << setw(10) << std::setprecision(2) << (throughput / single_thread_throughput) << "\n";
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+    buffer_manager.~BufferManager();
+    return 0;
+}
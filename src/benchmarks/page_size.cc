@@ -0,0 +1,194 @@
+/*
+ * page_size compares B+Tree scans and point lookups for different database page sizes.
+ *
+ * For every page size a BPlusTree<2> with `records` records is written with the bulk import writers. Then,
+ * with the OS page cache of the tree files dropped (posix_fadvise DONTNEED) and a new BufferManager using
+ * `buffer-mb` MB, `lookups` random point searches are done and their mean latency is reported. Finally the
+ * whole tree is scanned, also starting with cold caches. The leaves are read from disk in both cases, so the
+ * results show the trade-off between the tree height and the bytes read for each page.
+ */
+#include <array>
+#include <chrono>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stack>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "storage/page.h"
+#include "third_party/cxxopts/cxxopts.h"
+
+using namespace std;
+
+// records are (2*i, i), so lookups of odd keys don't find anything
+void create_bpt(const string& name, uint64_t records) {
+    BPTLeafWriter<2> leaf_writer(file_manager.get_file_path(name + ".leaf"));
+    BPTDirWriter<2> dir_writer(file_manager.get_file_path(name + ".dir"));
+
+    const auto max_records = BPTLeafWriter<2>::max_records();
+    const uint32_t last_block = (records / max_records) + (records % max_records != 0);
+    vector<array<uint64_t, 2>> block(max_records);
+
+    uint32_t current_block = 0;
+    uint64_t i = 0;
+    while (i < records) {
+        uint32_t block_size = 0;
+        for (; block_size < max_records && i < records; block_size++, i++) {
+            block[block_size] = { 2 * i, i };
+        }
+        // the first leaf has no key in the directory
+        if (current_block > 0) {
+            dir_writer.bulk_insert(block.data(), 0, current_block);
+        }
+        ++current_block;
+        leaf_writer.process_block(reinterpret_cast<char*>(block.data()),
+                                  block_size,
+                                  current_block < last_block ? current_block : 0);
+    }
+}
+
+
+void drop_os_cache(const string& filename) {
+    auto fd = open(file_manager.get_file_path(filename).c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+
+struct Result {
+    double lookup_us;  // mean latency of a point lookup in microseconds
+    double scan_ms;    // duration of the full scan in milliseconds
+    uint32_t height;   // directory levels above the leaves
+};
+
+
+Result run(const string& name, uint64_t records, uint_fast32_t buffer_mb, uint_fast32_t lookups) {
+    const auto buffer_size = std::max<uint_fast32_t>(1, buffer_mb * 1024 * 1024 / Page::get_size());
+    Result res;
+
+    drop_os_cache(name + ".leaf");
+    drop_os_cache(name + ".dir");
+    BufferManager::init(buffer_size, 1, 1);
+    {
+        BPlusTree<2> bpt(name);
+        bool interruption_requested = false;
+
+        // directories in the path from the root to the first leaf
+        std::stack<std::unique_ptr<BPlusTreeDir<2>>> dirs;
+        bpt.get_root()->search_leaf(dirs, Record<2>({ 0, 0 }));
+        res.height = 1 + dirs.size();
+
+        std::mt19937_64 rng(0);
+        std::uniform_int_distribution<uint64_t> dist(0, records - 1);
+        uint64_t found = 0;
+        auto start_time = chrono::steady_clock::now();
+        for (uint_fast32_t i = 0; i < lookups; i++) {
+            auto key = 2 * dist(rng);
+            auto iter = bpt.get_range(&interruption_requested, Record<2>({ key, 0 }), Record<2>({ key, UINT64_MAX }));
+            if (iter->next() != nullptr) {
+                found++;
+            }
+        }
+        chrono::duration<double, std::micro> lookup_duration = chrono::steady_clock::now() - start_time;
+        if (found != lookups) {
+            cerr << "expected " << lookups << " records found, got " << found << "\n";
+        }
+        res.lookup_us = lookup_duration.count() / lookups;
+    }
+    buffer_manager.~BufferManager();
+
+    drop_os_cache(name + ".leaf");
+    drop_os_cache(name + ".dir");
+    BufferManager::init(buffer_size, 1, 1);
+    {
+        BPlusTree<2> bpt(name);
+        bool interruption_requested = false;
+
+        uint64_t count = 0;
+        auto start_time = chrono::steady_clock::now();
+        auto iter = bpt.get_range(&interruption_requested,
+                                  Record<2>({ 0, 0 }),
+                                  Record<2>({ UINT64_MAX, UINT64_MAX }));
+        while (iter->next() != nullptr) {
+            count++;
+        }
+        chrono::duration<double, std::milli> scan_duration = chrono::steady_clock::now() - start_time;
+        if (count != records) {
+            cerr << "expected " << records << " records, got " << count << "\n";
+        }
+        res.scan_ms = scan_duration.count();
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
+
+
+int main(int argc, char **argv) {
+    string db_folder;
+    int64_t records;
+    int lookups;
+    int buffer_mb;
+    string page_sizes;
+
+    cxxopts::Options options("page_size", "B+Tree lookups and scans with cold caches for different page sizes");
+    options.add_options()
+        ("h,help", "Print usage")
+        ("d,db-folder", "folder where the benchmark B+Trees will be created",
+            cxxopts::value<string>(db_folder)->default_value("benchmark_page_size"))
+        ("records", "number of records in the B+Tree", cxxopts::value<int64_t>(records)->default_value("10000000"))
+        ("lookups", "number of random point searches", cxxopts::value<int>(lookups)->default_value("10000"))
+        ("buffer-mb", "size of the shared buffer in MB", cxxopts::value<int>(buffer_mb)->default_value("64"))
+        ("page-sizes", "comma separated page sizes in KB", cxxopts::value<string>(page_sizes)->default_value("4,16,64"))
+    ;
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (records <= 0 || lookups <= 0 || buffer_mb <= 0) {
+        cerr << "Parameters must be positive numbers.\n";
+        return 1;
+    }
+
+    vector<size_t> sizes;
+    stringstream ss(page_sizes);
+    for (string value; getline(ss, value, ','); ) {
+        sizes.push_back(std::stoul(value) * 1024);
+        if (!Page::is_valid_size(sizes.back())) {
+            cerr << "Invalid page size: " << value << " KB\n";
+            return 1;
+        }
+    }
+
+    FileManager::init(db_folder);
+
+    cout << "records: " << records << ", lookups: " << lookups << ", buffer: " << buffer_mb << " MB\n";
+    cout << setw(10) << "page size" << setw(8) << "height" << setw(14) << "lookup (us)" << setw(12) << "scan (ms)" << "\n";
+
+    for (auto size : sizes) {
+        // every page size uses its own files, as the files opened keep the page count computed with their page size
+        Page::set_size(size);
+        const auto name = "page_size_" + std::to_string(size / 1024);
+        create_bpt(name, records);
+
+        auto res = run(name, records, buffer_mb, lookups);
+        cout << setw(7) << (size / 1024) << " KB"
+             << setw(8) << res.height
+             << setw(14) << std::fixed << std::setprecision(2) << res.lookup_us
+             << setw(12) << std::setprecision(1) << res.scan_ms << "\n";
+    }
+    return 0;
+}
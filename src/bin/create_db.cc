@@ -2,6 +2,7 @@
 
 #include "import/quad_model/import.h"
 #include "storage/filesystem.h"
+#include "storage/page.h"
 #include "storage/file_manager.h"
 #include "third_party/cxxopts/cxxopts.h"
 
@@ -18,6 +19,8 @@ int main(int argc, char **argv) {
     string input_filename;
     string db_folder;
     int buffer_size;
+    int page_size;
+    bool compress_leaves;
 
 	try {
         cxxopts::Options options("create_db", "Import a database from a text file");
@@ -26,6 +29,10 @@ int main(int argc, char **argv) {
             ("d,db-folder", "path to the database folder to be created", cxxopts::value<string>(db_folder))
             ("b,buffer-size", "set memory buffer size (in GB)", cxxopts::value<int>(buffer_size)->default_value("1"))
             ("f,file", "file path to be imported", cxxopts::value<string>(input_filename))
+            ("page-size", "size of the pages of the database (in KB): 4, 8, 16, 32 or 64",
+                cxxopts::value<int>(page_size)->default_value("4"))
+            ("compress-leaves", "store the B+Tree leaves compressed, the database will be read only",
+                cxxopts::value<bool>(compress_leaves)->default_value("false"))
         ;
 
         options.positional_help("import-file db-folder");
@@ -41,15 +48,20 @@ int main(int argc, char **argv) {
         exit_if(input_filename.empty(), "Must specify an import file");
         exit_if(db_folder.empty(), "Must specify a db-folder");
         exit_if(input_filename.empty(), "Buffer size must be a positive number");
+        exit_if(page_size <= 0 || !Page::is_valid_size(page_size * 1024ULL),
+                "Page size must be 4, 8, 16, 32 or 64");
         exit_if(Filesystem::exists(db_folder) && !Filesystem::is_empty(db_folder),
                 "Database folder already exists and it's not empty\n");
 
         cout << "Creating new database\n";
         cout << "  input file:  " << input_filename << "\n";
         cout << "  db folder:   " << db_folder << "\n";
+        cout << "  page size:   " << page_size << " KB\n";
+        cout << "  compressed:  " << (compress_leaves ? "yes" : "no") << "\n";
 
+        Page::set_size(page_size * 1024ULL);
         FileManager::init(db_folder);
-        Import::OnDiskImport importer(db_folder, buffer_size);
+        Import::OnDiskImport importer(db_folder, buffer_size, compress_leaves);
         importer.start_import(input_filename);
 
         return EXIT_SUCCESS;
@@ -24,6 +24,7 @@
  *   attribute and the physical plan is the responsable to check that attribute.
  */
 
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -33,6 +34,7 @@
 #include <mutex>
 #include <ostream>
 #include <random>
+#include <sstream>
 #include <thread>
 #include <unordered_map>
 
@@ -41,6 +43,7 @@
 #include "base/binding/binding_iter.h"
 #include "base/exceptions.h"
 #include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/profiled_binding_id_iter.h"
 #include "network/tcp_buffer.h"
 #include "parser/query/grammar/error_listener.h"
 #include "parser/query/sparql_query_parser.h"
@@ -57,9 +60,27 @@ using boost::asio::ip::tcp;
 std::queue<std::shared_ptr<ThreadInfo>> running_threads_queue;
 std::mutex running_threads_queue_mutex;
 
-bool shutdown_server = false;
+std::atomic<bool> shutdown_server(false);
 
-void execute_query(ostream& os, unique_ptr<BindingIter> physical_plan) {
+// threads used by a LeapfrogJoin of a query, see ThreadInfo::leapfrog_workers
+uint_fast32_t leapfrog_workers = 1;
+
+// profile every query, not only the ones with the PROFILE prefix
+bool profile_queries = false;
+
+// see ThreadInfo::batch_execution
+bool batch_execution = false;
+
+// see ThreadInfo::sorted_lookups
+bool sorted_lookups = false;
+
+// see ThreadInfo::hash_join_memory
+uint64_t hash_join_memory = 1024ULL * 1024 * 1024;
+
+// see ThreadInfo::sort_memory
+uint64_t sort_memory = 64ULL * 1024 * 1024;
+
+void execute_query(ostream& os, unique_ptr<BindingIter> physical_plan, const ThreadInfo& thread_info) {
     uint64_t result_count = 0;
     auto execution_start = chrono::system_clock::now();
     try {
@@ -72,16 +93,18 @@ void execute_query(ostream& os, unique_ptr<BindingIter> physical_plan) {
 
         chrono::duration<float, std::milli> execution_duration = chrono::system_clock::now() - execution_start;
 
-        // print execution stats in server console
-        cout << "\nPlan Executed:\n";
-        physical_plan->analyze(cout);
-        cout << "\nResults: " << result_count << "\n";
-        cout.flush();
-
         // write execution stats in output stream
         os << "---------------------------------------\n";
         os << "Found " << result_count << " results.\n";
         os << "Execution time: " << execution_duration.count() << " ms.\n";
+
+        if (thread_info.profile != nullptr) {
+            stringstream plan;
+            physical_plan->analyze(plan);
+            os << "Profile: ";
+            thread_info.profile->write_json(os, plan.str());
+            os << "\n";
+        }
     }
     catch (const InterruptedException& e) {
         cerr << "QueryInterrupted" << endl;
@@ -107,11 +130,7 @@ void session(chrono::seconds timeout_duration, tcp::socket sock) {
         std::string query;
         query.resize(query_size);
         boost::asio::read(sock, boost::asio::buffer(query.data(), query_size));
-        cout << "---------------------------------------\n";
-        cout << " Query received:\n";
-        cout << "---------------------------------------\n";
-        cout << query << "\n";
-        cout << "---------------------------------------\n";
+        const bool profile = QueryProfile::remove_prefix(query) || profile_queries;
 
         TcpBuffer tcp_buffer = TcpBuffer(sock);
         std::ostream os(&tcp_buffer);
@@ -131,6 +150,14 @@ void session(chrono::seconds timeout_duration, tcp::socket sock) {
             parser_duration = chrono::system_clock::now() - start_parser;
 
             auto thread_info = std::make_shared<ThreadInfo>();
+            thread_info->leapfrog_workers = leapfrog_workers;
+            thread_info->batch_execution  = batch_execution;
+            thread_info->hash_join_memory = hash_join_memory;
+            thread_info->sorted_lookups   = sorted_lookups;
+            thread_info->sort_memory      = sort_memory;
+            if (profile) {
+                thread_info->profile = make_shared<QueryProfile>();
+            }
             auto start_optimizer = chrono::system_clock::now();
             physical_plan = rdf_model.exec(*logical_plan, thread_info.get());
             optimizer_duration = chrono::system_clock::now() - start_optimizer;
@@ -142,7 +169,7 @@ void session(chrono::seconds timeout_duration, tcp::socket sock) {
                 running_threads_queue.push(thread_info);
             }
 
-            execute_query(os, move(physical_plan));
+            execute_query(os, move(physical_plan), *thread_info);
             os << "Optimizer time: " << optimizer_duration.count() << " ms.\n";
             thread_info->finished = true;
             tcp_buffer.set_status(CommunicationProtocol::StatusCodes::success);
@@ -214,6 +241,31 @@ void interruption_handler(const boost::system::error_code& error, int /*signal_n
 }
 
 
+void warm_up_buffer(const vector<BufferManager::SnapshotRead>& reads, int threads) {
+    auto start = chrono::steady_clock::now();
+    auto pages_loaded = buffer_manager.load_snapshot(reads, threads);
+    auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    cout << "Buffer warm-up: " << pages_loaded << " pages loaded in " << duration.count() << " ms" << endl;
+}
+
+
+void dump_buffer_snapshots(chrono::seconds interval) {
+    auto next_dump = chrono::steady_clock::now() + interval;
+    while (!shutdown_server) {
+        this_thread::sleep_for(chrono::seconds(1));
+        if (chrono::steady_clock::now() >= next_dump) {
+            try {
+                buffer_manager.dump_snapshot(file_manager.get_file_path(BufferManager::SNAPSHOT_FILENAME));
+            }
+            catch (exception& e) {
+                cerr << "Exception: " << e.what() << "\n";
+            }
+            next_dump = chrono::steady_clock::now() + interval;
+        }
+    }
+}
+
+
 void server(unsigned short port, chrono::seconds timeout_duration) {
     boost::asio::io_context io_context;
 
@@ -246,6 +298,17 @@ int main(int argc, char **argv) {
     int shared_buffer_size;
     int private_buffer_size;
     int max_threads;
+    int read_ahead_pages;
+    int leapfrog_threads;
+    int hash_join_memory_mb;
+    int sort_memory_mb;
+    bool mmap_enabled;
+    string replacement_policy_name;
+    string huge_pages_name;
+    string numa_policy_name;
+    int snapshot_interval;
+    bool warm_up;
+    bool background_warm_up;
     string db_folder;
     try {
         // Parse arguments
@@ -261,6 +324,36 @@ int main(int argc, char **argv) {
             ("private-buffer-size", "set private buffer pool size for each thread",
                 cxxopts::value<int>(private_buffer_size)->default_value(std::to_string(BufferManager::DEFAULT_PRIVATE_BUFFER_POOL_SIZE)))
             ("max-threads", "set max threads", cxxopts::value<int>(max_threads)->default_value("8"))
+            ("leapfrog-threads", "threads used by each leapfrog join (1 executes them in the query thread)",
+                cxxopts::value<int>(leapfrog_threads)->default_value("1"))
+            ("profile", "return the profile of the operators of every query, not only the ones with the PROFILE prefix",
+                cxxopts::value<bool>(profile_queries)->default_value("false"))
+            ("batch-execution", "execute the operators of the queries with batches of results instead of one by one",
+                cxxopts::value<bool>(batch_execution)->default_value("false"))
+            ("sorted-lookups", "index nested loop joins sort batches of their left results before the lookups "
+                "(changes the order of the results)",
+                cxxopts::value<bool>(sorted_lookups)->default_value("false"))
+            ("hash-join-memory", "MB that the hash joins and the DISTINCT of each query keep in memory before writing to temp files",
+                cxxopts::value<int>(hash_join_memory_mb)->default_value("1024"))
+            ("sort-memory", "MB that each ORDER BY keeps in memory before writing sorted runs to temp files, "
+                "the server can use this amount for every ORDER BY of the queries running at the same time",
+                cxxopts::value<int>(sort_memory_mb)->default_value("64"))
+            ("read-ahead", "pages prefetched ahead of sequential index scans (0 disables it)",
+                cxxopts::value<int>(read_ahead_pages)->default_value(std::to_string(BufferManager::DEFAULT_READ_AHEAD_PAGES)))
+            ("mmap", "read the indexes from read-only memory mappings instead of the buffer (inserts are disabled)",
+                cxxopts::value<bool>(mmap_enabled)->default_value("false"))
+            ("replacement-policy", "page replacement policy of the shared buffer: 2q or clock",
+                cxxopts::value<string>(replacement_policy_name)->default_value("2q"))
+            ("huge-pages", "back the buffers with huge pages: none, thp (transparent), 2mb or 1gb (reserved)",
+                cxxopts::value<string>(huge_pages_name)->default_value("none"))
+            ("numa", "placement of the shared buffer in NUMA nodes: none, interleave or partitioned",
+                cxxopts::value<string>(numa_policy_name)->default_value("none"))
+            ("snapshot-interval", "seconds between dumps of the pages in the shared buffer (0 disables them)",
+                cxxopts::value<int>(snapshot_interval)->default_value("300"))
+            ("warm-up", "load the pages of the last buffer snapshot at startup",
+                cxxopts::value<bool>(warm_up)->default_value("true"))
+            ("background-warm-up", "accept connections while the buffer warm-up is running",
+                cxxopts::value<bool>(background_warm_up)->default_value("false"))
         ;
         options.positional_help("db-folder");
         options.parse_positional({"db-folder"});
@@ -298,6 +391,70 @@ int main(int argc, char **argv) {
             return 1;
         }
 
+        ReplacementPolicyType replacement_policy;
+        if (replacement_policy_name == "2q") {
+            replacement_policy = ReplacementPolicyType::two_queue;
+        } else if (replacement_policy_name == "clock") {
+            replacement_policy = ReplacementPolicyType::clock;
+        } else {
+            cerr << "Replacement policy must be 2q or clock.\n";
+            return 1;
+        }
+
+        HugePages huge_pages;
+        if (huge_pages_name == "none") {
+            huge_pages = HugePages::none;
+        } else if (huge_pages_name == "thp") {
+            huge_pages = HugePages::transparent;
+        } else if (huge_pages_name == "2mb") {
+            huge_pages = HugePages::huge_2mb;
+        } else if (huge_pages_name == "1gb") {
+            huge_pages = HugePages::huge_1gb;
+        } else {
+            cerr << "Huge pages must be none, thp, 2mb or 1gb.\n";
+            return 1;
+        }
+
+        NumaPolicy numa_policy;
+        if (numa_policy_name == "none") {
+            numa_policy = NumaPolicy::none;
+        } else if (numa_policy_name == "interleave") {
+            numa_policy = NumaPolicy::interleave;
+        } else if (numa_policy_name == "partitioned") {
+            numa_policy = NumaPolicy::partitioned;
+        } else {
+            cerr << "NUMA policy must be none, interleave or partitioned.\n";
+            return 1;
+        }
+
+        if (read_ahead_pages < 0) {
+            cerr << "Read ahead must be a non-negative number.\n";
+            return 1;
+        }
+
+        if (leapfrog_threads <= 0) {
+            cerr << "Leapfrog threads must be a positive number.\n";
+            return 1;
+        }
+        leapfrog_workers = leapfrog_threads;
+
+        if (hash_join_memory_mb <= 0) {
+            cerr << "Hash join memory must be a positive number.\n";
+            return 1;
+        }
+        hash_join_memory = hash_join_memory_mb * 1024ULL * 1024;
+
+        if (sort_memory_mb <= 0) {
+            cerr << "Sort memory must be a positive number.\n";
+            return 1;
+        }
+        sort_memory = sort_memory_mb * 1024ULL * 1024;
+
+        if (snapshot_interval < 0) {
+            cerr << "Snapshot interval must be a non-negative number.\n";
+            return 1;
+        }
+
         if (!Filesystem::exists(db_folder)) {
             cerr << "Database folder does not exists.\n";
             return 1;
@@ -307,12 +464,49 @@ int main(int argc, char **argv) {
         }
 
         // Initialize model
-        auto model_destroyer = RdfModel::init(db_folder, shared_buffer_size, private_buffer_size, max_threads);
+        auto model_destroyer = RdfModel::init(db_folder,
+                                              shared_buffer_size,
+                                              private_buffer_size,
+                                              max_threads,
+                                              mmap_enabled,
+                                              replacement_policy,
+                                              huge_pages,
+                                              numa_policy);
+        buffer_manager.set_read_ahead_pages(read_ahead_pages);
+        if (buffer_manager.get_huge_pages() != huge_pages) {
+            cout << "Huge pages " << huge_pages_name << " not available, using "
+                 << PageMemory::to_string(buffer_manager.get_huge_pages()) << "\n";
+        }
 
         cout << "Initializing server...\n";
         rdf_model.catalog().print();
 
+        std::thread warm_up_thread;
+        if (warm_up) {
+            // the files of the snapshot are opened before other threads use the file manager
+            auto reads = buffer_manager.read_snapshot(file_manager.get_file_path(BufferManager::SNAPSHOT_FILENAME));
+            if (background_warm_up) {
+                warm_up_thread = std::thread(warm_up_buffer, move(reads), max_threads);
+            } else {
+                warm_up_buffer(reads, max_threads);
+                // pages loaded by the warm-up are not counted as misses of the queries
+                buffer_manager.reset_stats();
+            }
+        }
+        std::thread snapshot_thread;
+        if (snapshot_interval > 0) {
+            snapshot_thread = std::thread(dump_buffer_snapshots, std::chrono::seconds(snapshot_interval));
+        }
+
         server(port, std::chrono::seconds(seconds_timeout));
+        if (warm_up_thread.joinable()) {
+            warm_up_thread.join();
+        }
+        if (snapshot_thread.joinable()) {
+            // it may be writing a snapshot to the same file
+            snapshot_thread.join();
+            buffer_manager.dump_snapshot(file_manager.get_file_path(BufferManager::SNAPSHOT_FILENAME));
+        }
     }
     catch (exception& e) {
         cerr << "Exception: " << e.what() << "\n";
@@ -2,10 +2,25 @@
 
 using namespace std;
 
-DistinctIdHash::DistinctIdHash(unique_ptr<BindingIdIter> _child_iter, std::vector<VarId> _projected_vars) :
+DistinctIdHash::DistinctIdHash(unique_ptr<BindingIdIter> _child_iter,
+                               std::vector<VarId>         _projected_vars,
+                               ThreadInfo*                thread_info) :
     child_iter       (move(_child_iter)),
     projected_vars   (move(_projected_vars)),
-    extendable_table (DistinctBindingHash<ObjectId>( projected_vars.size() )) { }
+    thread_info      (thread_info),
+    hash_table       (projected_vars.size(), 0),
+    memory_used      (0) { }
+
+
+DistinctIdHash::~DistinctIdHash() {
+    release_memory();
+}
+
+
+void DistinctIdHash::release_memory() {
+    thread_info->hash_join_memory_used -= memory_used;
+    memory_used = 0;
+}
 
 
 void DistinctIdHash::begin(BindingId& parent_binding) {
@@ -17,8 +32,9 @@ void DistinctIdHash::begin(BindingId& parent_binding) {
 
 void DistinctIdHash::reset() {
     child_iter->reset();
-    // TODO: now this method is never called, maybe in the future we may need to clear hash table
-    // extendable_table.reset();
+    hash_table.clear();
+    release_memory();
+    disk_hash.reset();
 }
 
 
@@ -36,13 +52,53 @@ bool DistinctIdHash::next() {
 }
 
 
+bool DistinctIdHash::next_batch(BindingBatch& batch) {
+    while (child_iter->next_batch(batch)) {
+        // keep the distinct rows in the selection
+        uint_fast32_t distinct_rows = 0;
+        for (uint_fast32_t i = 0; i < batch.selected; i++) {
+            const auto row = batch.selection[i];
+            for (size_t j = 0; j < projected_vars.size(); j++) {
+                current_tuple[j] = batch.column(projected_vars[j])[row];
+            }
+            if (current_tuple_distinct()) {
+                batch.selection[distinct_rows++] = row;
+            }
+        }
+        batch.selected = distinct_rows;
+        if (distinct_rows > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
 void DistinctIdHash::assign_nulls() {
     child_iter->assign_nulls();
 }
 
 
 bool DistinctIdHash::current_tuple_distinct() {
-    bool is_new_tuple = !extendable_table.is_in_or_insert(current_tuple);
+    if (disk_hash != nullptr) {
+        if (hash_table.contains(current_tuple.data())) {
+            return false;
+        }
+        bool is_new_tuple = !disk_hash->is_in_or_insert(current_tuple);
+        disk_tuples += is_new_tuple;
+        return is_new_tuple;
+    }
+
+    bool is_new_tuple = !hash_table.find_or_insert(current_tuple.data());
+    if (is_new_tuple) {
+        memory_tuples++;
+        const auto bytes = hash_table.memory_bytes();
+        thread_info->hash_join_memory_used += bytes - memory_used;
+        memory_used = bytes;
+        if (thread_info->hash_join_memory_used > thread_info->hash_join_memory) {
+            disk_hash = make_unique<DistinctBindingHash<ObjectId>>(projected_vars.size());
+        }
+    }
     return is_new_tuple;
 }
 
@@ -51,5 +107,5 @@ void DistinctIdHash::analyze(std::ostream& os, int indent) const {
     child_iter->analyze(os, indent);
     os << "\n";
     os << std::string(indent, ' ');
-    os << "DistinctIdHash()";
+    os << "DistinctIdHash(distinct in memory: " << memory_tuples << ", on disk: " << disk_tuples << ")";
 }
@@ -3,15 +3,24 @@
 #include <memory>
 
 #include "base/binding/binding_id_iter.h"
+#include "base/thread/thread_info.h"
 #include "storage/index/hash/distinct_binding_hash/distinct_binding_hash.h"
+#include "storage/index/hash/object_id_hash/object_id_hash_table.h"
 
+// The distinct tuples are kept in an in-memory hash table while it fits in the memory of the hash tables of the
+// query (ThreadInfo::hash_join_memory). After that the table stops growing and the tuples that are not in it
+// are inserted in an on-disk extendible hash.
 class DistinctIdHash : public BindingIdIter {
 public:
-    DistinctIdHash(std::unique_ptr<BindingIdIter> child_iter, std::vector<VarId> projected_vars);
+    DistinctIdHash(std::unique_ptr<BindingIdIter> child_iter,
+                   std::vector<VarId>             projected_vars,
+                   ThreadInfo*                    thread_info);
+    ~DistinctIdHash();
 
     void begin(BindingId& parent_binding) override;
     void reset() override;
     bool next() override;
+    bool next_batch(BindingBatch& batch) override;
     void assign_nulls() override;
 
     void analyze(std::ostream&, int indent = 0) const override;
@@ -21,8 +30,21 @@ public:
 private:
     std::unique_ptr<BindingIdIter> child_iter;
     std::vector<VarId> projected_vars;
-    DistinctBindingHash<ObjectId> extendable_table;
+    ThreadInfo* thread_info;
+    ObjectIdHashTable hash_table;
+
+    // not null when hash_table exceeded the memory
+    std::unique_ptr<DistinctBindingHash<ObjectId>> disk_hash;
+
+    // bytes of hash_table counted in thread_info->hash_join_memory_used
+    uint64_t memory_used;
 
     std::vector<ObjectId> current_tuple;
     BindingId* parent_binding;
+
+    // tuples found in each table, for analyze
+    uint64_t memory_tuples = 0;
+    uint64_t disk_tuples = 0;
+
+    void release_memory();
 };
@@ -10,13 +10,19 @@ EdgeTableLookup::EdgeTableLookup(RandomAccessTable<3>& table,
                                  Id edge,
                                  Id from,
                                  Id to,
-                                 Id type) :
-    table       (table),
-    thread_info (thread_info),
-    edge        (edge),
-    from        (from),
-    to          (to),
-    type        (type) { }
+                                 Id type,
+                                 bool from_assigned,
+                                 bool to_assigned,
+                                 bool type_assigned) :
+    table         (table),
+    thread_info   (thread_info),
+    edge          (edge),
+    from          (from),
+    to            (to),
+    type          (type),
+    from_assigned (from_assigned),
+    to_assigned   (to_assigned),
+    type_assigned (type_assigned) { }
 
 
 void EdgeTableLookup::analyze(std::ostream& os, int indent) const {
@@ -53,9 +59,9 @@ bool EdgeTableLookup::next() {
         auto edge_id = ObjectId::VALUE_MASK & edge_assignation.id;
         assert(edge_id > 0);
 
-        auto record = table[edge_id - 1]; // first edge has the id 1, and its inserted at pos 0 in the table
-
-        if (record == nullptr) return false;
+        // first edge has the id 1, and its inserted at pos 0 in the table
+        Record<3> record(std::array<uint64_t, 3>{});
+        if (!table.get_record(edge_id - 1, record)) return false;
 
         auto check_id = [] (BindingId& binding, Id id, ObjectId obj_id) -> bool {
             if (std::holds_alternative<VarId>(id)) {
@@ -74,10 +80,20 @@ bool EdgeTableLookup::next() {
             return true;
         };
 
+        // the variables assigned by this lookup still have the values of the previous lookup
+        auto clear_unassigned = [] (BindingId& binding, Id id, bool assigned) {
+            if (!assigned && std::holds_alternative<VarId>(id)) {
+                binding.add(std::get<VarId>(id), ObjectId::get_null());
+            }
+        };
+        clear_unassigned(*parent_binding, from, from_assigned);
+        clear_unassigned(*parent_binding, to,   to_assigned);
+        clear_unassigned(*parent_binding, type, type_assigned);
+
         // check if assigned variables (not null) have the same value
-        if (   check_id(*parent_binding, from, ObjectId(record->ids[0]))
-            && check_id(*parent_binding, to,   ObjectId(record->ids[1]))
-            && check_id(*parent_binding, type, ObjectId(record->ids[2])))
+        if (   check_id(*parent_binding, from, ObjectId(record.ids[0]))
+            && check_id(*parent_binding, to,   ObjectId(record.ids[1]))
+            && check_id(*parent_binding, type, ObjectId(record.ids[2])))
         {
             ++results;
             return true;
@@ -93,6 +109,14 @@ void EdgeTableLookup::reset() {
 }
 
 
+void EdgeTableLookup::get_lookup_vars(std::vector<VarId>& vars) const {
+    // the table is read by edge id, sorted lookups read it sequentially
+    if (std::holds_alternative<VarId>(edge)) {
+        vars.push_back(std::get<VarId>(edge));
+    }
+}
+
+
 void EdgeTableLookup::assign_nulls() {
     if (std::holds_alternative<VarId>(edge)) {
         parent_binding->add(std::get<VarId>(edge), ObjectId::get_null());
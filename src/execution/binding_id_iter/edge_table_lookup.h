@@ -17,6 +17,12 @@ private:
     Id from;
     Id to;
     Id type;
+
+    // false if the variable is assigned by this lookup
+    bool from_assigned;
+    bool to_assigned;
+    bool type_assigned;
+
     uint64_t lookups = 0;
     uint64_t results = 0;
 
@@ -27,7 +33,15 @@ private:
     BindingId* parent_binding;
 
 public:
-    EdgeTableLookup(RandomAccessTable<3>& table, ThreadInfo*, Id edge, Id from, Id to, Id type);
+    EdgeTableLookup(RandomAccessTable<3>& table,
+                    ThreadInfo*,
+                    Id edge,
+                    Id from,
+                    Id to,
+                    Id type,
+                    bool from_assigned,
+                    bool to_assigned,
+                    bool type_assigned);
     ~EdgeTableLookup() = default;
 
     void analyze(std::ostream&, int indent = 0) const override;
@@ -35,4 +49,5 @@ public:
     bool next() override;
     void reset() override;
     void assign_nulls() override;
+    void get_lookup_vars(std::vector<VarId>& vars) const override;
 };
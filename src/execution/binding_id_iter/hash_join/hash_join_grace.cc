@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "base/ids/var_id.h"
+#include "execution/binding_id_iter/hash_join/hash_join_stats.h"
 
 using namespace std;
 
@@ -11,13 +12,15 @@ HashJoinGrace::HashJoinGrace(unique_ptr<BindingIdIter> lhs,
                              vector<VarId> left_vars,
                              vector<VarId> common_vars,
                              vector<VarId> right_vars) :
-    lhs         (move(lhs)),
-    rhs         (move(rhs)),
-    left_vars   (left_vars),
-    common_vars (common_vars),
-    right_vars  (right_vars),
-    lhs_hash    (KeyValueHash<ObjectId, ObjectId>(common_vars.size(), left_vars.size())),
-    rhs_hash    (KeyValueHash<ObjectId, ObjectId>(common_vars.size(), right_vars.size()))
+    lhs              (move(lhs)),
+    rhs              (move(rhs)),
+    left_vars        (left_vars),
+    common_vars      (common_vars),
+    right_vars       (right_vars),
+    lhs_hash         (KeyValueHash<ObjectId, ObjectId>(common_vars.size(), left_vars.size())),
+    rhs_hash         (KeyValueHash<ObjectId, ObjectId>(common_vars.size(), right_vars.size())),
+    left_small_hash  (common_vars.size(), left_vars.size()),
+    right_small_hash (common_vars.size(), right_vars.size())
     { }
 
 
@@ -27,31 +30,13 @@ void HashJoinGrace::begin(BindingId& _parent_binding) {
     lhs->begin(_parent_binding);
     rhs->begin(_parent_binding);
 
+    child_batch = make_unique<BindingBatch>(_parent_binding);
     saved_pair = make_pair(vector<ObjectId>(common_vars.size()), vector<ObjectId>(left_vars.size()));
     lhs_hash.begin();
-    while (lhs->next()){
-        // save left keys and value
-        for (size_t i = 0; i < common_vars.size(); i++) {
-            saved_pair.first[i] = (*parent_binding)[common_vars[i]];
-        }
-        for (size_t i = 0; i < left_vars.size(); i++) {
-            saved_pair.second[i] = (*parent_binding)[left_vars[i]];
-        }
-        lhs_hash.insert(saved_pair.first, saved_pair.second);
-    }
-    // recycle current_value for saving right hash
-    saved_pair.second.resize(right_vars.size());
+    build_hash(*lhs, lhs_hash, left_vars);
     auto left_depth = lhs_hash.get_depth();
     rhs_hash.begin(left_depth);
-    while (rhs->next()) {
-        for (size_t i = 0; i < common_vars.size(); i++) {
-            saved_pair.first[i] = (*parent_binding)[common_vars[i]];
-        }
-        for (size_t i = 0; i < right_vars.size(); i++) {
-            saved_pair.second[i] = (*parent_binding)[right_vars[i]];
-        }
-        rhs_hash.insert(saved_pair.first, saved_pair.second);
-    }
+    build_hash(*rhs, rhs_hash, right_vars);
     auto right_depth = rhs_hash.get_depth();
     // split if different size
     while (right_depth > left_depth) {
@@ -66,62 +51,85 @@ void HashJoinGrace::begin(BindingId& _parent_binding) {
 }
 
 
+void HashJoinGrace::build_hash(BindingIdIter& child,
+                               KeyValueHash<ObjectId, ObjectId>& hash,
+                               const vector<VarId>& value_vars)
+{
+    saved_pair.first.resize(common_vars.size());
+    saved_pair.second.resize(value_vars.size());
+    while (child.next_batch(*child_batch)) {
+        for (uint_fast32_t i = 0; i < child_batch->selected; i++) {
+            const auto row = child_batch->selection[i];
+            for (size_t j = 0; j < common_vars.size(); j++) {
+                saved_pair.first[j] = child_batch->column(common_vars[j])[row];
+            }
+            for (size_t j = 0; j < value_vars.size(); j++) {
+                saved_pair.second[j] = child_batch->column(value_vars[j])[row];
+            }
+            hash.insert(saved_pair.first, saved_pair.second);
+        }
+    }
+}
+
+
 bool HashJoinGrace::next() {
     // TODO: should check for interruption?
     while (true) {
         switch (current_state)
         {
             case State::ENUM_WITH_SECOND_HASH_ITER: {
-                assert(current_pair_iter != end_range_iter);
+                assert(remaining_matches > 0);
                 if (left_min) {
-                    assign_left_binding((*current_pair_iter).second);
+                    assign_left_binding(current_match);
+                    current_match += left_vars.size();
                 }
                 else {
-                    assign_right_binding((*current_pair_iter).second);
+                    assign_right_binding(current_match);
+                    current_match += right_vars.size();
                 }
-                ++current_pair_iter;
-                if (current_pair_iter == end_range_iter) {
+                remaining_matches--;
+                if (remaining_matches == 0) {
                     current_state = State::ENUM_WITH_SECOND_HASH;
                 }
                 return true;
             }
             case State::ENUM_WITH_SECOND_HASH: {
+                const auto start = chrono::steady_clock::now();
                 if (left_min) {
-                    // Sets the iterator for left hash (small one)
+                    // Looks up the right tuples in the left hash (small one)
                     while (current_pos_right < rhs_hash.get_bucket_size(current_bucket)) {
                         saved_pair = rhs_hash.get_pair(current_bucket, current_pos_right);
                         current_pos_right++;  // after get pair and before posible return
-                        auto range = small_hash.equal_range(saved_pair.first);
-                        current_pair_iter = range.first;
-                        end_range_iter    = range.second;
+                        probe_rows++;
+                        remaining_matches = left_small_hash.find(saved_pair.first.data(), &current_match);
 
-                        if (current_pair_iter != end_range_iter) {
+                        if (remaining_matches > 0) {
                             current_state = State::ENUM_WITH_SECOND_HASH_ITER;
                             //assign right pair, saved key
-                            assign_right_binding(saved_pair.second);
-                            assign_key_binding(saved_pair.first);
+                            assign_right_binding(saved_pair.second.data());
+                            assign_key_binding(saved_pair.first.data());
                             break;
                         }
                     }
                 }
                 else {
-                    // Sets the iterator for right hash (small one)
+                    // Looks up the left tuples in the right hash (small one)
                     while (current_pos_left < lhs_hash.get_bucket_size(current_bucket)) {
                         saved_pair = lhs_hash.get_pair(current_bucket, current_pos_left);
                         current_pos_left++;  // after get pair and before posible return
-                        auto range = small_hash.equal_range(saved_pair.first);
-                        current_pair_iter = range.first;
-                        end_range_iter    = range.second;
+                        probe_rows++;
+                        remaining_matches = right_small_hash.find(saved_pair.first.data(), &current_match);
 
-                        if (current_pair_iter != end_range_iter) {
+                        if (remaining_matches > 0) {
                             current_state = State::ENUM_WITH_SECOND_HASH_ITER;
                             // assign left pair, saved key
-                            assign_left_binding(saved_pair.second);
-                            assign_key_binding(saved_pair.first);
+                            assign_left_binding(saved_pair.second.data());
+                            assign_key_binding(saved_pair.first.data());
                             break;
                         }
                     }
                 }
+                probe_time += chrono::steady_clock::now() - start;
                 if (current_state == State::ENUM_WITH_SECOND_HASH) {
                     // if reaches here, there is no match in the current bucket
                     current_state = State::NOT_ENUM;
@@ -190,12 +198,16 @@ bool HashJoinGrace::next() {
                         //if (false) {
                         if (left_size < MAX_SIZE_SMALL_HASH) {
                             // Add lhs results to small hash
-                            small_hash.clear();
+                            const auto start = chrono::steady_clock::now();
+                            left_small_hash.clear();
                             while (current_pos_left < lhs_hash.get_bucket_size(current_bucket)) {
                                 auto pair = lhs_hash.get_pair(current_bucket, current_pos_left);
-                                small_hash.insert(pair);
+                                left_small_hash.insert(pair.first.data(), pair.second.data());
                                 current_pos_left++;
                             }
+                            left_small_hash.finish_build();
+                            build_rows += left_small_hash.size();
+                            build_time += chrono::steady_clock::now() - start;
                             current_state = State::ENUM_WITH_SECOND_HASH;
                         }
                         else {
@@ -206,13 +218,17 @@ bool HashJoinGrace::next() {
                     else {
                         // if (false) {
                         if (right_size < MAX_SIZE_SMALL_HASH) {
-                            // Add lhs results to small hash
-                            small_hash.clear();
+                            // Add rhs results to small hash
+                            const auto start = chrono::steady_clock::now();
+                            right_small_hash.clear();
                             while (current_pos_right < rhs_hash.get_bucket_size(current_bucket)) {
                                 auto pair = rhs_hash.get_pair(current_bucket, current_pos_right);
-                                small_hash.insert(pair);
+                                right_small_hash.insert(pair.first.data(), pair.second.data());
                                 current_pos_right++;
                             }
+                            right_small_hash.finish_build();
+                            build_rows += right_small_hash.size();
+                            build_time += chrono::steady_clock::now() - start;
                             current_state = State::ENUM_WITH_SECOND_HASH;
                         }
                         else {
@@ -232,19 +248,19 @@ bool HashJoinGrace::next() {
 }
 
 
-void HashJoinGrace::assign_left_binding(const vector<ObjectId>& left_value) {
+void HashJoinGrace::assign_left_binding(const ObjectId* left_value) {
     for (uint_fast32_t i = 0; i < left_vars.size(); i++) {
         parent_binding->add(left_vars[i], left_value[i]);
     }
 }
 
-void HashJoinGrace::assign_right_binding(const vector<ObjectId>& right_value) {
+void HashJoinGrace::assign_right_binding(const ObjectId* right_value) {
     for (uint_fast32_t i = 0; i < right_vars.size(); i++) {
         parent_binding->add(right_vars[i], right_value[i]);
     }
 }
 
-void HashJoinGrace::assign_key_binding(const vector<ObjectId>& my_key) {
+void HashJoinGrace::assign_key_binding(const ObjectId* my_key) {
     for (uint_fast32_t i = 0; i < common_vars.size(); i++) {
         parent_binding->add(common_vars[i], my_key[i]);
     }
@@ -256,29 +272,11 @@ void HashJoinGrace::reset() {
     lhs->reset();
     rhs->reset();
 
-    saved_pair.second.resize(left_vars.size());
     lhs_hash.reset();
-    while (lhs->next()) {
-        for (size_t i = 0; i < common_vars.size(); i++) {
-            saved_pair.first[i] = (*parent_binding)[common_vars[i]];
-        }
-        for (size_t i = 0; i < left_vars.size(); i++) {
-            saved_pair.second[i] = (*parent_binding)[left_vars[i]];
-        }
-        lhs_hash.insert(saved_pair.first, saved_pair.second);
-    }
+    build_hash(*lhs, lhs_hash, left_vars);
     auto left_depth = lhs_hash.get_depth();
     rhs_hash.reset(left_depth);
-    saved_pair.second.resize(right_vars.size());
-    while (rhs->next()) {
-        for (size_t i = 0; i < common_vars.size(); i++) {
-            saved_pair.first[i] = (*parent_binding)[common_vars[i]];
-        }
-        for (size_t i = 0; i < right_vars.size(); i++) {
-            saved_pair.second[i] = (*parent_binding)[right_vars[i]];
-        }
-        rhs_hash.insert(saved_pair.first, saved_pair.second);
-    }
+    build_hash(*rhs, rhs_hash, right_vars);
     auto right_depth = rhs_hash.get_depth();
     // split if different size
     while (right_depth > left_depth) {
@@ -301,7 +299,9 @@ void HashJoinGrace::assign_nulls() {
 
 void HashJoinGrace::analyze(std::ostream& os, int indent) const {
     os << std::string(indent, ' ');
-    os << "HashJoinGrace(\n";
+    os << "HashJoinGrace(";
+    HashJoinStats::print(os, build_rows, build_time.count(), probe_rows, probe_time.count());
+    os << ",\n";
     lhs->analyze(os, indent + 2);
     os << ",\n";
     rhs->analyze(os, indent + 2);
@@ -1,13 +1,13 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <vector>
-#include <unordered_map>
 
 #include "base/ids/var_id.h"
 #include "base/binding/binding_id_iter.h"
 #include "storage/index/hash/key_value_hash/key_value_hash.h"
-#include "storage/index/hash/key_value_hash/key_value_pair_hasher.h"
+#include "storage/index/hash/object_id_hash/object_id_hash_table.h"
 #include "storage/page.h"
 
 
@@ -54,31 +54,42 @@ private:
 
     BindingId* parent_binding;
 
+    // used to read the results of lhs and rhs
+    std::unique_ptr<BindingBatch> child_batch;
+
     KeyValueHash<ObjectId, ObjectId> lhs_hash;
     KeyValueHash<ObjectId, ObjectId> rhs_hash;
     uint_fast32_t total_buckets;
 
     State current_state = State::NOT_ENUM;
     bool left_min = false;
-    std::unordered_multimap<std::vector<ObjectId>,
-                            std::vector<ObjectId>,
-                            KeyValuePairHasher> small_hash;
+
+    // in-memory hash of the smallest side of the current bucket, with the values of the left or the right vars
+    ObjectIdHashTable left_small_hash;
+    ObjectIdHashTable right_small_hash;
 
     uint_fast32_t current_pos_left;   // for nested loop
     uint_fast32_t current_pos_right;
     uint_fast32_t current_bucket;
-    std::unordered_multimap<std::vector<ObjectId>,
-                            std::vector<ObjectId>,
-                            KeyValuePairHasher>::iterator current_pair_iter;  // for small hash
-    std::unordered_multimap<std::vector<ObjectId>,
-                            std::vector<ObjectId>,
-                            KeyValuePairHasher>::iterator end_range_iter;
+
+    // matches in the small hash that were not returned yet
+    const ObjectId* current_match;
+    uint_fast32_t   remaining_matches;
 
     //std::vector<ObjectId> current_key;
     //std::vector<ObjectId> current_value;
     std::pair<std::vector<ObjectId>, std::vector<ObjectId>> saved_pair;
 
-    void assign_left_binding(const std::vector<ObjectId>& lhs_value);
-    void assign_key_binding(const std::vector<ObjectId>& my_key);
-    void assign_right_binding(const std::vector<ObjectId>& rhs_value);
+    // inserts all the results of `child` in `hash`, with the common_vars as key and `value_vars` as value
+    void build_hash(BindingIdIter& child, KeyValueHash<ObjectId, ObjectId>& hash, const std::vector<VarId>& value_vars);
+
+    void assign_left_binding(const ObjectId* lhs_value);
+    void assign_key_binding(const ObjectId* my_key);
+    void assign_right_binding(const ObjectId* rhs_value);
+
+    // statistics
+    uint64_t build_rows = 0;
+    uint64_t probe_rows = 0;
+    std::chrono::duration<double, std::milli> build_time { 0 };
+    std::chrono::duration<double, std::milli> probe_time { 0 };
 };
@@ -0,0 +1,366 @@
+#include "hash_join_hybrid.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "execution/binding_id_iter/hash_join/hash_join_stats.h"
+#include "third_party/xxhash/xxhash.h"
+
+using namespace std;
+
+HashJoinHybrid::HashJoinHybrid(unique_ptr<BindingIdIter> lhs,
+                               unique_ptr<BindingIdIter> rhs,
+                               vector<VarId> left_vars,
+                               vector<VarId> common_vars,
+                               vector<VarId> right_vars,
+                               ThreadInfo* thread_info) :
+    lhs         (move(lhs)),
+    rhs         (move(rhs)),
+    left_vars   (left_vars),
+    common_vars (common_vars),
+    right_vars  (right_vars),
+    thread_info (thread_info),
+    memory_used (0)
+    { }
+
+
+HashJoinHybrid::~HashJoinHybrid() {
+    clear();
+}
+
+
+uint_fast32_t HashJoinHybrid::partition_of(const ObjectId* key, uint_fast32_t depth) const {
+    // a different seed for each depth, so a partition is split again when it is repartitioned
+    // (the hash tables use the hash without seed)
+    return XXH3_64bits_withSeed(key, common_vars.size() * sizeof(ObjectId), depth + 1) % PARTITIONS;
+}
+
+
+void HashJoinHybrid::reserve_memory(uint64_t bytes) {
+    memory_used += bytes;
+    thread_info->hash_join_memory_used += bytes;
+}
+
+
+void HashJoinHybrid::release_memory(uint64_t bytes) {
+    assert(bytes <= memory_used);
+    memory_used -= bytes;
+    thread_info->hash_join_memory_used -= bytes;
+}
+
+
+void HashJoinHybrid::clear() {
+    release_memory(memory_used);
+    partitions.clear();
+    pending_pairs.clear();
+    current_pair = SpilledPair();
+    pair_table.reset();
+    remaining_matches = 0;
+}
+
+
+void HashJoinHybrid::begin(BindingId& _parent_binding) {
+    this->parent_binding = &_parent_binding;
+
+    lhs->begin(_parent_binding);
+    rhs->begin(_parent_binding);
+
+    key_filter.clear();
+    child_batch = make_unique<BindingBatch>(_parent_binding);
+    current_row = vector<ObjectId>(common_vars.size() + max(left_vars.size(), right_vars.size()));
+    build_partitions();
+}
+
+
+void HashJoinHybrid::build_partitions() {
+    const auto start = chrono::steady_clock::now();
+    clear();
+    partitions.resize(PARTITIONS);
+
+    const auto row_size   = common_vars.size() + left_vars.size();
+    // the rows in memory count as the hash table they will become, that needs about twice their bytes
+    const auto row_bytes  = 2 * row_size * sizeof(ObjectId);
+    const bool use_filter = thread_info->hash_join_filters && !common_vars.empty();
+    key_filter.clear(thread_info->hash_join_memory / FILTER_MEMORY_SHARE);
+    uint64_t filter_bytes = 0;
+    uint64_t lhs_rows = 0;
+    while (lhs->next_batch(*child_batch)) {
+        for (uint_fast32_t i = 0; i < child_batch->selected; i++) {
+            const auto row = child_batch->selection[i];
+            for (size_t j = 0; j < common_vars.size(); j++) {
+                current_row[j] = child_batch->column(common_vars[j])[row];
+            }
+            for (size_t j = 0; j < left_vars.size(); j++) {
+                current_row[common_vars.size() + j] = child_batch->column(left_vars[j])[row];
+            }
+            lhs_rows++;
+            if (use_filter) {
+                key_filter.add(current_row[0].id);
+                const auto bytes = key_filter.pending_bytes();
+                if (bytes != filter_bytes) {
+                    reserve_memory(bytes);
+                    release_memory(filter_bytes);
+                    filter_bytes = bytes;
+                }
+            }
+
+            auto& partition = partitions[partition_of(current_row.data(), 0)];
+            if (partition.file != nullptr) {
+                partition.file->append(current_row.data());
+                spilled_rows++;
+            } else {
+                partition.rows.insert(partition.rows.end(), current_row.begin(), current_row.begin() + row_size);
+                reserve_memory(row_bytes);
+                if (thread_info->hash_join_memory_used > thread_info->hash_join_memory) {
+                    spill_largest_partition();
+                }
+            }
+        }
+    }
+
+    filter_pushed = false;
+    if (use_filter) {
+        release_memory(filter_bytes);
+        key_filter.finish_build();
+        reserve_memory(key_filter.memory_bytes());
+        if (key_filter.get_type() != JoinKeyFilter::Type::NONE) {
+            filter_pushed = rhs->push_filter(common_vars[0], key_filter);
+        }
+    }
+
+    for (auto& partition : partitions) {
+        if (partition.file != nullptr || partition.rows.empty()) {
+            continue;
+        }
+        partition.table = make_unique<ObjectIdHashTable>(common_vars.size(), left_vars.size());
+        for (size_t i = 0; i < partition.rows.size(); i += row_size) {
+            partition.table->insert(&partition.rows[i], &partition.rows[i + common_vars.size()]);
+        }
+        partition.table->finish_build();
+        release_memory(2 * partition.rows.size() * sizeof(ObjectId));
+        reserve_memory(partition.table->memory_bytes());
+        vector<ObjectId>().swap(partition.rows);
+
+        // the table may be larger than estimated, the partitions not built yet go to temp files until it fits
+        while (thread_info->hash_join_memory_used > thread_info->hash_join_memory && spill_largest_partition()) { }
+    }
+
+    // without lhs rows there are no results, rhs is not read
+    current_state = lhs_rows > 0 ? State::PROBE_RHS : State::NEXT_PARTITION;
+    build_rows += lhs_rows;
+    probe_start = chrono::steady_clock::now();
+    build_time += probe_start - start;
+}
+
+
+bool HashJoinHybrid::spill_largest_partition() {
+    auto largest = max_element(partitions.begin(), partitions.end(), [](const auto& a, const auto& b) {
+        return a.rows.size() < b.rows.size();
+    });
+    if (largest->rows.empty()) {
+        return false;
+    }
+    const auto row_size = common_vars.size() + left_vars.size();
+    largest->file     = make_unique<TupleFile>(row_size);
+    largest->rhs_file = make_unique<TupleFile>(common_vars.size() + right_vars.size());
+    for (size_t i = 0; i < largest->rows.size(); i += row_size) {
+        largest->file->append(&largest->rows[i]);
+    }
+    spilled_partitions++;
+    spilled_rows += largest->file->size();
+    release_memory(2 * largest->rows.size() * sizeof(ObjectId));
+    vector<ObjectId>().swap(largest->rows);
+    return true;
+}
+
+
+bool HashJoinHybrid::prepare_pair(SpilledPair&& pair) {
+    if (pair.lhs_file->size() == 0 || pair.rhs_file->size() == 0) {
+        return false;
+    }
+    max_depth = max(max_depth, pair.depth);
+
+    // the actual sizes are known now, the hash table is built with the smaller side
+    const bool swap = pair.rhs_file->size() < pair.lhs_file->size();
+    auto& build = swap ? pair.rhs_file : pair.lhs_file;
+
+    // while it is built the table needs about twice the bytes of the rows
+    const auto available = thread_info->hash_join_memory > thread_info->hash_join_memory_used
+                         ? thread_info->hash_join_memory - thread_info->hash_join_memory_used
+                         : 0;
+    if (2 * build->bytes() > available && pair.depth < MAX_DEPTH && pair.can_split) {
+        repartitions++;
+        vector<SpilledPair> children(PARTITIONS);
+        for (auto& child : children) {
+            child.lhs_file = make_unique<TupleFile>(common_vars.size() + left_vars.size());
+            child.rhs_file = make_unique<TupleFile>(common_vars.size() + right_vars.size());
+            child.depth    = pair.depth + 1;
+        }
+        pair.lhs_file->begin_read();
+        while (auto row = pair.lhs_file->next()) {
+            children[partition_of(row, pair.depth + 1)].lhs_file->append(row);
+        }
+        pair.rhs_file->begin_read();
+        while (auto row = pair.rhs_file->next()) {
+            children[partition_of(row, pair.depth + 1)].rhs_file->append(row);
+        }
+        const auto build_size = build->size();
+        pair = SpilledPair();
+        for (auto& child : children) {
+            const auto child_build_size = swap ? child.rhs_file->size() : child.lhs_file->size();
+            if (child_build_size == build_size) {
+                // all the rows have the same key, partitioning again won't make them smaller
+                child.can_split = false;
+            }
+            if (child.lhs_file->size() > 0 && child.rhs_file->size() > 0) {
+                pending_pairs.push_back(move(child));
+            }
+        }
+        return false;
+    }
+
+    if (swap) {
+        swapped_pairs++;
+    }
+    current_pair = move(pair);
+    build_file = swap ? current_pair.rhs_file.get() : current_pair.lhs_file.get();
+    probe_file = swap ? current_pair.lhs_file.get() : current_pair.rhs_file.get();
+    build_vars = swap ? &right_vars : &left_vars;
+    probe_vars = swap ? &left_vars : &right_vars;
+
+    pair_table = make_unique<ObjectIdHashTable>(common_vars.size(), build_vars->size());
+    build_file->begin_read();
+    while (auto row = build_file->next()) {
+        pair_table->insert(row, row + common_vars.size());
+    }
+    pair_table->finish_build();
+    reserve_memory(pair_table->memory_bytes());
+    probe_file->begin_read();
+    return true;
+}
+
+
+bool HashJoinHybrid::next() {
+    while (true) {
+        if (remaining_matches > 0) {
+            for (uint_fast32_t i = 0; i < match_vars->size(); i++) {
+                parent_binding->add((*match_vars)[i], current_match[i]);
+            }
+            current_match += match_vars->size();
+            remaining_matches--;
+            return true;
+        }
+
+        switch (current_state) {
+            case State::PROBE_RHS: {
+                if (rhs->next()) {
+                    probe_rows++;
+                    for (size_t i = 0; i < common_vars.size(); i++) {
+                        current_row[i] = (*parent_binding)[common_vars[i]];
+                    }
+                    if (!filter_pushed && !common_vars.empty() && !key_filter.contains(current_row[0].id)) {
+                        filtered_rows++;
+                        break;
+                    }
+                    auto& partition = partitions[partition_of(current_row.data(), 0)];
+                    if (partition.table != nullptr) {
+                        // the binding of common and right vars was set by rhs
+                        remaining_matches = partition.table->find(current_row.data(), &current_match);
+                        match_vars = &left_vars;
+                    } else if (partition.file != nullptr) {
+                        for (size_t i = 0; i < right_vars.size(); i++) {
+                            current_row[common_vars.size() + i] = (*parent_binding)[right_vars[i]];
+                        }
+                        partition.rhs_file->append(current_row.data());
+                        spilled_rows++;
+                    }
+                } else {
+                    // the partitions in memory are finished, free them before joining the spilled ones
+                    for (auto& partition : partitions) {
+                        if (partition.file != nullptr) {
+                            pending_pairs.push_back({ move(partition.file), move(partition.rhs_file), 0 });
+                        }
+                    }
+                    partitions.clear();
+                    // the filter is kept until the next build
+                    release_memory(memory_used - key_filter.memory_bytes());
+                    current_state = State::NEXT_PARTITION;
+                }
+                break;
+            }
+            case State::NEXT_PARTITION: {
+                if (pending_pairs.empty()) {
+                    probe_time += chrono::steady_clock::now() - probe_start;
+                    return false;
+                }
+                auto pair = move(pending_pairs.back());
+                pending_pairs.pop_back();
+
+                const auto start = chrono::steady_clock::now();
+                probe_time += start - probe_start;
+                if (prepare_pair(move(pair))) {
+                    current_state = State::PROBE_PARTITION;
+                }
+                probe_start = chrono::steady_clock::now();
+                build_time += probe_start - start;
+                break;
+            }
+            case State::PROBE_PARTITION: {
+                auto row = probe_file->next();
+                if (row == nullptr) {
+                    release_memory(pair_table->memory_bytes());
+                    pair_table.reset();
+                    current_pair = SpilledPair();
+                    current_state = State::NEXT_PARTITION;
+                    break;
+                }
+                for (size_t i = 0; i < common_vars.size(); i++) {
+                    parent_binding->add(common_vars[i], row[i]);
+                }
+                for (size_t i = 0; i < probe_vars->size(); i++) {
+                    parent_binding->add((*probe_vars)[i], row[common_vars.size() + i]);
+                }
+                remaining_matches = pair_table->find(row, &current_match);
+                match_vars = build_vars;
+                break;
+            }
+        }
+    }
+}
+
+
+void HashJoinHybrid::reset() {
+    // rhs is reset before the new filter is built, meanwhile it must not discard anything
+    key_filter.clear();
+    lhs->reset();
+    rhs->reset();
+    build_partitions();
+}
+
+
+void HashJoinHybrid::assign_nulls() {
+    rhs->assign_nulls();
+    lhs->assign_nulls();
+}
+
+
+void HashJoinHybrid::analyze(std::ostream& os, int indent) const {
+    os << std::string(indent, ' ');
+    os << "HashJoinHybrid(";
+    HashJoinStats::print(os, build_rows, build_time.count(), probe_rows, probe_time.count());
+    os << ", spilled partitions: " << spilled_partitions
+       << ", spilled rows: "       << spilled_rows
+       << ", repartitions: "       << repartitions
+       << ", max depth: "          << max_depth
+       << ", swapped build sides: " << swapped_pairs
+       << ", join filter: "        << key_filter.type_name()
+       << " (" << key_filter.memory_bytes() << " bytes" << (filter_pushed ? ", pushed to rhs)" : ")")
+       << ", filtered rows: "      << filtered_rows;
+    os << ",\n";
+    lhs->analyze(os, indent + 2);
+    os << ",\n";
+    rhs->analyze(os, indent + 2);
+    os << "\n";
+    os << std::string(indent, ' ');
+    os << ")";
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "base/binding/binding_batch.h"
+#include "base/binding/binding_id_iter.h"
+#include "base/ids/var_id.h"
+#include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/hash_join/join_key_filter.h"
+#include "storage/index/hash/object_id_hash/object_id_hash_table.h"
+#include "storage/index/tuple_buffer/tuple_file.h"
+
+// HashJoinHybrid reads lhs into PARTITIONS in-memory partitions by the hash of the common vars. While the rows fit
+// in the memory of the query (ThreadInfo::hash_join_memory) it works as an in-memory hash join and rhs only probes.
+// The rows count as the hash table they will become, twice their bytes. When the memory runs out the largest
+// partition is written to a temp file, and the following lhs rows of that partition go directly to the file. If
+// the tables of the partitions in memory turn out larger, the ones not built yet are spilled too. Then the rhs
+// rows of the partitions in memory probe immediately, and the ones of the spilled partitions are written to temp
+// files.
+//
+// Each pair of spilled partitions is joined at the end, building the hash table with the side that has fewer rows.
+// If the smaller side still doesn't fit it is partitioned again with another hash function, unless a partition
+// doesn't get smaller when split (a single key with many rows) or MAX_DEPTH is reached, then it is built anyway.
+//
+// If ThreadInfo::hash_join_filters is set, the values of the first common var in lhs are a JoinKeyFilter given to
+// rhs with push_filter(), so the scans of rhs skip the rows without a match. If rhs can't use it the join checks
+// it before probing or spilling a row. The filter counts in the memory of the query, the lhs values it collects
+// use at most 1/FILTER_MEMORY_SHARE of it, with more distinct values there is no filter. When lhs has no rows rhs
+// is not read.
+class HashJoinHybrid : public BindingIdIter {
+public:
+    static constexpr uint_fast32_t PARTITIONS = 32;
+    static constexpr uint_fast32_t MAX_DEPTH  = 4;
+    static constexpr uint_fast32_t FILTER_MEMORY_SHARE = 16;
+
+    HashJoinHybrid(std::unique_ptr<BindingIdIter> lhs,
+                   std::unique_ptr<BindingIdIter> rhs,
+                   std::vector<VarId>             left_vars,
+                   std::vector<VarId>             common_vars,
+                   std::vector<VarId>             right_vars,
+                   ThreadInfo*                    thread_info);
+
+    ~HashJoinHybrid();
+
+    void analyze(std::ostream& os, int indent = 0) const override;
+    void begin(BindingId& parent_binding) override;
+    bool next() override;
+    void reset() override;
+    void assign_nulls() override;
+
+private:
+    enum class State {
+        PROBE_RHS,        // probing with the rows of rhs
+        NEXT_PARTITION,   // take the next pair of spilled partitions
+        PROBE_PARTITION,  // probing with the rows of a spilled partition
+    };
+
+    // rows of a partition in memory, each one has the key followed by the left vars
+    struct MemoryPartition {
+        std::vector<ObjectId> rows;
+        std::unique_ptr<TupleFile> file; // not null if the partition was spilled
+        std::unique_ptr<TupleFile> rhs_file;
+        std::unique_ptr<ObjectIdHashTable> table;
+    };
+
+    // a pair of spilled partitions that still have to be joined
+    struct SpilledPair {
+        std::unique_ptr<TupleFile> lhs_file;
+        std::unique_ptr<TupleFile> rhs_file;
+        uint_fast32_t depth;
+        bool can_split = true;
+    };
+
+    std::unique_ptr<BindingIdIter> lhs;
+    std::unique_ptr<BindingIdIter> rhs;
+    std::vector<VarId> left_vars;
+    std::vector<VarId> common_vars;
+    std::vector<VarId> right_vars;
+
+    ThreadInfo* thread_info;
+
+    BindingId* parent_binding;
+
+    std::unique_ptr<BindingBatch> child_batch;
+
+    State current_state;
+
+    std::vector<MemoryPartition> partitions;
+
+    std::vector<SpilledPair> pending_pairs;
+
+    // the pair being joined, the table is built with the rows of build_file
+    SpilledPair current_pair;
+    TupleFile* build_file;
+    TupleFile* probe_file;
+    const std::vector<VarId>* build_vars;
+    const std::vector<VarId>* probe_vars;
+    std::unique_ptr<ObjectIdHashTable> pair_table;
+
+    // matches of the current key that were not returned yet, with match_vars.size() ObjectIds each
+    const ObjectId* current_match;
+    uint_fast32_t   remaining_matches;
+    const std::vector<VarId>* match_vars;
+
+    std::vector<ObjectId> current_row;
+
+    // values of common_vars[0] in lhs
+    JoinKeyFilter key_filter;
+
+    // true if rhs uses key_filter
+    bool filter_pushed;
+
+    // bytes of this join counted in thread_info->hash_join_memory_used
+    uint64_t memory_used;
+
+    uint_fast32_t partition_of(const ObjectId* key, uint_fast32_t depth) const;
+
+    void reserve_memory(uint64_t bytes);
+    void release_memory(uint64_t bytes);
+
+    void build_partitions();
+
+    // writes the in-memory rows of the largest partition to a temp file, returns false if there are no rows
+    bool spill_largest_partition();
+
+    // returns true when the table of the pair was built, false if the pair was repartitioned or empty
+    bool prepare_pair(SpilledPair&& pair);
+
+    void clear();
+
+    // statistics
+    uint64_t build_rows          = 0;
+    uint64_t probe_rows          = 0;
+    uint64_t spilled_partitions  = 0;
+    uint64_t spilled_rows        = 0;
+    uint64_t repartitions        = 0;
+    uint64_t swapped_pairs       = 0;
+    uint64_t filtered_rows       = 0;
+    uint_fast32_t max_depth      = 0;
+    std::chrono::duration<double, std::milli> build_time { 0 };
+    std::chrono::duration<double, std::milli> probe_time { 0 };
+    std::chrono::steady_clock::time_point     probe_start;
+};
@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "base/ids/var_id.h"
+#include "execution/binding_id_iter/hash_join/hash_join_stats.h"
 
 using namespace std;
 
@@ -15,7 +16,8 @@ HashJoinInMemory::HashJoinInMemory(unique_ptr<BindingIdIter> lhs,
     rhs         (move(rhs)),
     left_vars   (left_vars),
     common_vars (common_vars),
-    right_vars  (right_vars)
+    right_vars  (right_vars),
+    lhs_hash    (common_vars.size(), left_vars.size())
     { }
 
 
@@ -25,8 +27,15 @@ void HashJoinInMemory::begin(BindingId& _parent_binding) {
     lhs->begin(_parent_binding);
     rhs->begin(_parent_binding);
 
-    current_key = std::vector<ObjectId>(common_vars.size());
-    current_value = std::vector<ObjectId>(left_vars.size());
+    current_key   = vector<ObjectId>(common_vars.size());
+    current_value = vector<ObjectId>(left_vars.size());
+    build_hash();
+}
+
+
+void HashJoinInMemory::build_hash() {
+    const auto start = chrono::steady_clock::now();
+    lhs_hash.clear();
     while (lhs->next()) {
         // save left keys and value
         for (size_t i = 0; i < common_vars.size(); i++) {
@@ -35,55 +44,38 @@ void HashJoinInMemory::begin(BindingId& _parent_binding) {
         for (size_t i = 0; i < left_vars.size(); i++) {
             current_value[i] = (*parent_binding)[left_vars[i]];
         }
-        lhs_hash.insert(std::make_pair(current_key, current_value));
+        lhs_hash.insert(current_key.data(), current_value.data());
     }
+    lhs_hash.finish_build();
 
-    current_value.resize(right_vars.size());
-    // saved_pair = make_pair(current_key, current_value);  // init sizes
-
-    current_pair_iter = lhs_hash.end();
-    end_range_iter = lhs_hash.end();
-    enumerating = false;
+    remaining_matches = 0;
+    probe_start = chrono::steady_clock::now();
+    build_time += probe_start - start;
 }
 
 
 bool HashJoinInMemory::next() {
     while (true) {
-        if (enumerating) {
-            assert(current_pair_iter != end_range_iter);
+        if (remaining_matches > 0) {
             // set binding from lhs
             for (uint_fast32_t i = 0; i < left_vars.size(); i++) {
-                parent_binding->add(left_vars[i], current_pair_iter->second[i]);
-            }
-            ++current_pair_iter;
-            if (current_pair_iter == end_range_iter) {
-                enumerating = false;
+                parent_binding->add(left_vars[i], current_match[i]);
             }
+            current_match += left_vars.size();
+            remaining_matches--;
             return true;
         }
         else {
             if (rhs->next()) {
+                probe_rows++;
                 for (size_t i = 0; i < common_vars.size(); i++) {
                     current_key[i] = (*parent_binding)[common_vars[i]];
                 }
-                for (size_t i = 0; i < right_vars.size(); i++) {
-                    current_value[i] = (*parent_binding)[right_vars[i]];
-                }
-                auto range = lhs_hash.equal_range(current_key);
-                current_pair_iter = range.first;
-                end_range_iter = range.second;
-                if (current_pair_iter != end_range_iter) {
-                    // set binding from rhs
-                    for (uint_fast32_t i = 0; i < common_vars.size(); i++) {
-                        parent_binding->add(common_vars[i], current_key[i]);
-                    }
-                    for (uint_fast32_t i = 0; i < right_vars.size(); i++) {
-                        parent_binding->add(right_vars[i], current_value[i]);
-                    }
-                    enumerating = true;
-                }
+                // the binding of common and right vars was set by rhs
+                remaining_matches = lhs_hash.find(current_key.data(), &current_match);
             }
             else {
+                probe_time += chrono::steady_clock::now() - probe_start;
                 return false;
             }
         }
@@ -94,25 +86,7 @@ bool HashJoinInMemory::next() {
 void HashJoinInMemory::reset() {
     lhs->reset();
     rhs->reset();
-
-    current_value = std::vector<ObjectId>(left_vars.size());
-    lhs_hash.clear();
-    while (lhs->next()){
-        // save left keys and value
-        for (size_t i = 0; i < common_vars.size(); i++) {
-            current_key[i] = (*parent_binding)[common_vars[i]];
-        }
-        for (size_t i = 0; i < left_vars.size(); i++) {
-            current_value[i] = (*parent_binding)[left_vars[i]];
-        }
-        lhs_hash.insert(std::make_pair(current_key, current_value));
-    }
-
-    current_value = std::vector<ObjectId>(right_vars.size());
-
-    current_pair_iter = lhs_hash.end();
-    end_range_iter = lhs_hash.end();
-    enumerating = false;
+    build_hash();
 }
 
 
@@ -124,7 +98,9 @@ void HashJoinInMemory::assign_nulls() {
 
 void HashJoinInMemory::analyze(std::ostream& os, int indent) const {
     os << std::string(indent, ' ');
-    os << "HashJoinInMemoryInMemory(\n";
+    os << "HashJoinInMemory(";
+    HashJoinStats::print(os, lhs_hash.size(), build_time.count(), probe_rows, probe_time.count());
+    os << ",\n";
     lhs->analyze(os, indent + 2);
     os << ",\n";
     rhs->analyze(os, indent + 2);
@@ -1,12 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <vector>
-#include <unordered_map>
 
 #include "base/ids/var_id.h"
 #include "base/binding/binding_id_iter.h"
-#include "storage/index/hash/key_value_hash/key_value_pair_hasher.h"
+#include "storage/index/hash/object_id_hash/object_id_hash_table.h"
 
 
 class HashJoinInMemory : public BindingIdIter {
@@ -32,17 +32,20 @@ private:
 
     BindingId* parent_binding;
 
-    bool enumerating;
-    std::unordered_multimap<std::vector<ObjectId>,
-                            std::vector<ObjectId>,
-                            KeyValuePairHasher> lhs_hash;  // asume left is the smallest one (from execution plan)
-    std::unordered_multimap<std::vector<ObjectId>,
-                            std::vector<ObjectId>,
-                            KeyValuePairHasher>::iterator current_pair_iter;
-    std::unordered_multimap<std::vector<ObjectId>,
-                            std::vector<ObjectId>,
-                            KeyValuePairHasher>::iterator end_range_iter;
+    ObjectIdHashTable lhs_hash;  // asume left is the smallest one (from execution plan)
+
+    // matches of the current rhs key that were not returned yet
+    const ObjectId* current_match;
+    uint_fast32_t   remaining_matches;
 
     std::vector<ObjectId> current_key;
     std::vector<ObjectId> current_value;
+
+    void build_hash();
+
+    // statistics
+    uint64_t probe_rows = 0;
+    std::chrono::duration<double, std::milli> build_time { 0 };
+    std::chrono::duration<double, std::milli> probe_time { 0 };
+    std::chrono::steady_clock::time_point     probe_start;
 };
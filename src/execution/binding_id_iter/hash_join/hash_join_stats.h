@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+namespace HashJoinStats {
+    inline double rows_per_second(uint64_t rows, double ms) {
+        return ms > 0 ? rows * 1000.0 / ms : 0;
+    }
+
+    // prints the rows inserted in the hash table and the rows looked up in it, with their rates
+    inline void print(std::ostream& os, uint64_t build_rows, double build_ms, uint64_t probe_rows, double probe_ms) {
+        os << "build rows: "   << build_rows << ", build ms: " << build_ms
+           << ", build rows/s: " << static_cast<uint64_t>(rows_per_second(build_rows, build_ms))
+           << ", probe rows: " << probe_rows << ", probe ms: " << probe_ms
+           << ", probe rows/s: " << static_cast<uint64_t>(rows_per_second(probe_rows, probe_ms));
+    }
+}
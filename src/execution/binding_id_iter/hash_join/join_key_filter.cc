@@ -0,0 +1,91 @@
+#include "join_key_filter.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void JoinKeyFilter::clear(uint64_t max_pending_bytes) {
+    type = Type::NONE;
+    min  = 0;
+    max  = UINT64_MAX;
+    bits.clear();
+    bits.shrink_to_fit();
+    keys.clear();
+    keys.shrink_to_fit();
+    block_mask = 0;
+    max_keys   = std::max<uint64_t>(max_pending_bytes / sizeof(uint64_t), 1);
+    abandoned  = false;
+}
+
+
+void JoinKeyFilter::remove_duplicates() {
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+}
+
+
+void JoinKeyFilter::make_room() {
+    remove_duplicates();
+    if (keys.size() > max_keys / 2) {
+        abandoned = true;
+        keys.clear();
+        keys.shrink_to_fit();
+    }
+}
+
+
+void JoinKeyFilter::finish_build() {
+    bits.clear();
+    if (abandoned) {
+        type = Type::NONE;
+        return;
+    }
+    // the size of the filter depends on the distinct ids
+    remove_duplicates();
+    if (keys.empty()) {
+        // no value can match, min > max discards every id
+        type = Type::BITMAP;
+        min  = 1;
+        max  = 0;
+        return;
+    }
+    const auto [min_it, max_it] = minmax_element(keys.begin(), keys.end());
+    min = *min_it;
+    max = *max_it;
+
+    const auto range = max - min;
+    if (range / BITS_PER_KEY < keys.size()) {
+        type = Type::BITMAP;
+        bits.assign(range / 64 + 1, 0);
+        for (auto id : keys) {
+            const auto pos = id - min;
+            bits[pos / 64] |= 1ULL << (pos % 64);
+        }
+    } else {
+        type = Type::BLOOM;
+        uint64_t blocks = 1;
+        while (blocks * BLOCK_WORDS * 64 < keys.size() * BITS_PER_KEY) {
+            blocks *= 2;
+        }
+        block_mask = blocks - 1;
+        bits.assign(blocks * BLOCK_WORDS, 0);
+        for (auto id : keys) {
+            const auto hash  = mix(id);
+            const auto block = &bits[((hash >> 32) & block_mask) * BLOCK_WORDS];
+            for (uint_fast32_t i = 0; i < BLOCK_WORDS; i++) {
+                block[i] |= 1ULL << bit_of(hash, i);
+            }
+        }
+    }
+    keys.clear();
+    keys.shrink_to_fit();
+}
+
+
+const char* JoinKeyFilter::type_name() const noexcept {
+    switch (type) {
+        case Type::BITMAP: return "bitmap";
+        case Type::BLOOM:  return "bloom";
+        default:           return abandoned ? "too many keys" : "none";
+    }
+}
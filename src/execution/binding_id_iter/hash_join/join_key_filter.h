@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// JoinKeyFilter has the values of a join variable in the build side of a hash join, and the iters of the probe
+// side use it to discard the rows that can't have a match before they reach the join. It may have false
+// positives but never false negatives.
+//
+// When the values are dense (the range between the minimum and the maximum has at most BITS_PER_KEY ids per
+// value) it is an exact bitmap of the range. Otherwise it is a blocked Bloom filter: each value sets 8 bits in a
+// single block of 64 bytes, so a lookup reads one cache line. Both discard the ids outside [min, max] with two
+// comparisons, so a scan ordered by the variable can skip the ids out of that range.
+//
+// The ids added are kept until finish_build(), removing the duplicates when they reach the maximum bytes. If
+// the distinct ids don't fit in that space the filter is abandoned and it will contain every id.
+class JoinKeyFilter {
+public:
+    static constexpr uint64_t BITS_PER_KEY = 16;
+
+    enum class Type {
+        NONE,   // not built yet, contains every id
+        BITMAP,
+        BLOOM,
+    };
+
+    JoinKeyFilter() { clear(); }
+
+    // the filter contains every id until finish_build() is called. The ids added before it use at most
+    // max_pending_bytes
+    void clear(uint64_t max_pending_bytes = UINT64_MAX);
+
+    inline void add(uint64_t id) {
+        if (abandoned) {
+            return;
+        }
+        if (keys.size() == max_keys) {
+            make_room();
+        }
+        keys.push_back(id);
+    }
+
+    // bytes of the ids added and not built yet
+    inline uint64_t pending_bytes() const noexcept { return keys.capacity() * sizeof(uint64_t); }
+
+    void finish_build();
+
+    inline bool contains(uint64_t id) const noexcept {
+        if (id < min || id > max) {
+            return false;
+        }
+        switch (type) {
+            case Type::BITMAP: {
+                const auto pos = id - min;
+                return (bits[pos / 64] >> (pos % 64)) & 1;
+            }
+            case Type::BLOOM: {
+                const auto hash  = mix(id);
+                const auto block = &bits[((hash >> 32) & block_mask) * BLOCK_WORDS];
+                for (uint_fast32_t i = 0; i < BLOCK_WORDS; i++) {
+                    if (((block[i] >> bit_of(hash, i)) & 1) == 0) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            default:
+                return true;
+        }
+    }
+
+    inline Type get_type() const noexcept { return type; }
+
+    // every id in the filter is in [get_min(), get_max()]
+    inline uint64_t get_min() const noexcept { return min; }
+    inline uint64_t get_max() const noexcept { return max; }
+
+    inline uint64_t memory_bytes() const noexcept { return bits.size() * sizeof(uint64_t); }
+
+    const char* type_name() const noexcept;
+
+private:
+    static constexpr uint_fast32_t BLOCK_WORDS = 8;
+
+    Type type;
+
+    uint64_t min;
+    uint64_t max;
+
+    // bitmap of [min, max] or the blocks of the Bloom filter
+    std::vector<uint64_t> bits;
+
+    // blocks - 1, the number of blocks is a power of two
+    uint64_t block_mask;
+
+    // ids added before finish_build()
+    std::vector<uint64_t> keys;
+
+    // keys.size() that makes add() remove the duplicates
+    uint64_t max_keys;
+
+    // the distinct ids didn't fit in max_keys
+    bool abandoned;
+
+    // removes the duplicated keys, abandons the filter if more than half of max_keys remain
+    void make_room();
+
+    // sorts the keys without duplicates
+    void remove_duplicates();
+
+    // the ids of similar objects are consecutive, so they are mixed before using their bits
+    static inline uint64_t mix(uint64_t id) noexcept {
+        id ^= id >> 33;
+        id *= 0xFF51AFD7ED558CCDULL;
+        id ^= id >> 33;
+        id *= 0xC4CEB9FE1A85EC53ULL;
+        id ^= id >> 33;
+        return id;
+    }
+
+    // bit of the word i of the block set by a hash, each word uses a different multiplier
+    static inline uint_fast32_t bit_of(uint64_t hash, uint_fast32_t i) noexcept {
+        static constexpr uint32_t SALT[BLOCK_WORDS] = {
+            0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+            0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U
+        };
+        return (static_cast<uint32_t>(hash) * SALT[i]) >> 26;
+    }
+};
@@ -0,0 +1,140 @@
+#include "id_filter.h"
+
+#include "query_optimizer/quad_model/quad_model.h"
+#include "query_optimizer/quad_model/query_element_to_graph_object.h"
+
+using namespace std;
+
+namespace {
+    inline bool is_int(ObjectId object_id) {
+        const auto mask = object_id.id & ObjectId::TYPE_MASK;
+        return mask == ObjectId::MASK_POSITIVE_INT || mask == ObjectId::MASK_NEGATIVE_INT;
+    }
+}
+
+
+IdFilter::IdFilter(unique_ptr<BindingIdIter> child, vector<Condition> conditions) :
+    child      (move(child)),
+    conditions (move(conditions))
+{
+    QueryElementToGraphObject visitor;
+    for (const auto& condition : this->conditions) {
+        constants.push_back(visitor(condition.constant));
+    }
+}
+
+
+bool IdFilter::eval(uint_fast32_t condition_index, ObjectId value) const {
+    const auto& constant_id = conditions[condition_index].constant_id;
+    const auto op = conditions[condition_index].op;
+    switch (op) {
+    case Operator::EQUALS:
+        return value == constant_id;
+    case Operator::NOT_EQUALS:
+        return value != constant_id;
+    default:
+        break;
+    }
+
+    int cmp;
+    if (is_int(value) && is_int(constant_id)) {
+        cmp = value < constant_id ? -1 : (value > constant_id ? 1 : 0);
+    } else {
+        cmp = GraphObject::graph_object_cmp(quad_model.get_graph_object(value), constants[condition_index]);
+    }
+
+    switch (op) {
+    case Operator::LESS:              return cmp < 0;
+    case Operator::LESS_OR_EQUALS:    return cmp <= 0;
+    case Operator::GREATER:           return cmp > 0;
+    case Operator::GREATER_OR_EQUALS: return cmp >= 0;
+    default:                          return false;
+    }
+}
+
+
+void IdFilter::begin(BindingId& _parent_binding) {
+    parent_binding = &_parent_binding;
+    child->begin(_parent_binding);
+}
+
+
+void IdFilter::reset() {
+    child->reset();
+}
+
+
+bool IdFilter::next() {
+    while (child->next()) {
+        checked++;
+        bool satisfied = true;
+        for (uint_fast32_t i = 0; i < conditions.size(); i++) {
+            if (!eval(i, (*parent_binding)[conditions[i].var])) {
+                satisfied = false;
+                break;
+            }
+        }
+        if (satisfied) {
+            found++;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool IdFilter::next_batch(BindingBatch& batch) {
+    while (child->next_batch(batch)) {
+        checked += batch.selected;
+        // every condition removes from the selection the rows that don't satisfy it
+        for (uint_fast32_t c = 0; c < conditions.size(); c++) {
+            const auto column = batch.column(conditions[c].var);
+            uint_fast32_t selected = 0;
+            for (uint_fast32_t i = 0; i < batch.selected; i++) {
+                const auto row = batch.selection[i];
+                if (eval(c, column[row])) {
+                    batch.selection[selected++] = row;
+                }
+            }
+            batch.selected = selected;
+        }
+        found += batch.selected;
+        if (batch.selected > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void IdFilter::assign_nulls() {
+    child->assign_nulls();
+}
+
+
+void IdFilter::get_lookup_vars(std::vector<VarId>& vars) const {
+    child->get_lookup_vars(vars);
+}
+
+
+const char* IdFilter::to_string(Operator op) {
+    switch (op) {
+    case Operator::EQUALS:            return "==";
+    case Operator::NOT_EQUALS:        return "!=";
+    case Operator::LESS:              return "<";
+    case Operator::LESS_OR_EQUALS:    return "<=";
+    case Operator::GREATER:           return ">";
+    case Operator::GREATER_OR_EQUALS: return ">=";
+    default:                          return "?";
+    }
+}
+
+
+void IdFilter::analyze(std::ostream& os, int indent) const {
+    os << std::string(indent, ' ');
+    os << "IdFilter(conditions: " << conditions.size() << ", checked: " << checked << ", found: " << found << ",\n";
+    child->analyze(os, indent + 2);
+    os << "\n";
+    os << std::string(indent, ' ');
+    os << ")";
+}
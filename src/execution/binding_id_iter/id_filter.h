@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "base/binding/binding_id_iter.h"
+#include "base/graph_object/graph_object.h"
+#include "base/ids/var_id.h"
+#include "base/query/query_element.h"
+
+/* IdFilter returns the results of its child that satisfy all the conditions. A condition compares a variable
+ * with a constant, and it is decided on the ObjectIds when possible:
+ *  - equality compares the ids, an id represents only one object.
+ *  - integers are encoded preserving the order, so they are compared by their ids.
+ * Other comparisons (strings, floats, values of different types) decode the value with the GraphObject
+ * comparison used by the Where of the query.
+ */
+class IdFilter : public BindingIdIter {
+public:
+    enum class Operator {
+        EQUALS,
+        NOT_EQUALS,
+        LESS,
+        LESS_OR_EQUALS,
+        GREATER,
+        GREATER_OR_EQUALS
+    };
+
+    // var <op> constant
+    struct Condition {
+        VarId var;
+
+        Operator op;
+
+        QueryElement constant;
+
+        // ObjectId::OBJECT_ID_NOT_FOUND if the constant is not in the database
+        ObjectId constant_id;
+    };
+
+    IdFilter(std::unique_ptr<BindingIdIter> child, std::vector<Condition> conditions);
+
+    void analyze(std::ostream& os, int indent = 0) const override;
+    void begin(BindingId& parent_binding) override;
+    bool next() override;
+    bool next_batch(BindingBatch& batch) override;
+    void reset() override;
+    void assign_nulls() override;
+    void get_lookup_vars(std::vector<VarId>& vars) const override;
+
+    static const char* to_string(Operator op);
+
+private:
+    std::unique_ptr<BindingIdIter> child;
+
+    std::vector<Condition> conditions;
+
+    // conditions[i].constant as a GraphObject, used when the ids are not enough to decide a comparison.
+    // Long strings point to the QueryElement of the condition, so they are created after conditions is moved.
+    std::vector<GraphObject> constants;
+
+    BindingId* parent_binding;
+
+    bool eval(uint_fast32_t condition_index, ObjectId value) const;
+
+    // statistics
+    uint64_t checked = 0;
+    uint64_t found   = 0;
+};
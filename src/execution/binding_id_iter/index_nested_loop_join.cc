@@ -8,16 +8,27 @@
 using namespace std;
 
 IndexNestedLoopJoin::IndexNestedLoopJoin(unique_ptr<BindingIdIter> _lhs,
-                                         unique_ptr<BindingIdIter> _rhs) :
+                                         unique_ptr<BindingIdIter> _rhs,
+                                         bool sorted_lookups) :
     lhs          (move(_lhs)),
-    original_rhs (move(_rhs)) { }
+    original_rhs (move(_rhs))
+{
+    if (sorted_lookups) {
+        original_rhs->get_lookup_vars(lookup_vars);
+    }
+}
 
 
 void IndexNestedLoopJoin::begin(BindingId& parent_binding) {
     this->parent_binding = &parent_binding;
 
     lhs->begin(parent_binding);
-    if (lhs->next()) {
+    if (!lookup_vars.empty()) {
+        lhs_batch = make_unique<BindingBatch>(parent_binding);
+        lhs_batch->clear();
+        batch_pos = 0;
+    }
+    if (next_lhs()) {
         rhs = original_rhs.get();
     } else {
         rhs = &EmptyBindingIdIter::instance;
@@ -25,12 +36,53 @@ void IndexNestedLoopJoin::begin(BindingId& parent_binding) {
     original_rhs->begin(parent_binding);
 }
 
+
+bool IndexNestedLoopJoin::next_lhs() {
+    if (lookup_vars.empty()) {
+        return lhs->next();
+    }
+    while (batch_pos == lhs_batch->selected) {
+        batch_pos = 0;
+        // iters that produce the batch with next() continue from the binding of their last result, which was
+        // overwritten loading the rows. The last row written in the batch is that binding.
+        if (lhs_batch->size > 0) {
+            lhs_batch->load_row(lhs_batch->size - 1);
+        }
+        if (!lhs->next_batch(*lhs_batch)) {
+            // next_batch() cleared the batch, so next calls will also ask lhs
+            return false;
+        }
+
+        // sort the rows by the values of the lookup vars, unless they already are
+        vector<const ObjectId*> columns;
+        for (auto var : lookup_vars) {
+            columns.push_back(lhs_batch->column(var));
+        }
+        auto less = [&columns](uint16_t a, uint16_t b) {
+            for (auto column : columns) {
+                if (column[a] != column[b]) {
+                    return column[a] < column[b];
+                }
+            }
+            return false;
+        };
+        auto selection = lhs_batch->selection.get();
+        if (!std::is_sorted(selection, selection + lhs_batch->selected, less)) {
+            std::sort(selection, selection + lhs_batch->selected, less);
+            ++sorted_batches;
+        }
+    }
+    lhs_batch->load_row(lhs_batch->selection[batch_pos++]);
+    return true;
+}
+
+
 bool IndexNestedLoopJoin::next() {
     while (true) {
         if (rhs->next()) {
             return true;
         } else {
-            if (lhs->next())
+            if (next_lhs())
                 rhs->reset();
             else
                 return false;
@@ -38,9 +90,14 @@ bool IndexNestedLoopJoin::next() {
     }
 }
 
+
 void IndexNestedLoopJoin::reset() {
     lhs->reset();
-    if (lhs->next()) {
+    if (lhs_batch != nullptr) {
+        lhs_batch->clear();
+        batch_pos = 0;
+    }
+    if (next_lhs()) {
         rhs = original_rhs.get();
         rhs->reset();
     } else {
@@ -55,9 +112,21 @@ void IndexNestedLoopJoin::assign_nulls() {
 }
 
 
+bool IndexNestedLoopJoin::push_filter(VarId var, const JoinKeyFilter& filter) {
+    // the var is written by one of the children, the other one doesn't have it or has it assigned
+    const bool lhs_filtered = lhs->push_filter(var, filter);
+    const bool rhs_filtered = original_rhs->push_filter(var, filter);
+    return lhs_filtered || rhs_filtered;
+}
+
+
 void IndexNestedLoopJoin::analyze(std::ostream& os, int indent) const {
     os << std::string(indent, ' ');
-    os << "IndexNestedLoopJoin(\n";
+    os << "IndexNestedLoopJoin(";
+    if (!lookup_vars.empty()) {
+        os << "sorted batches: " << sorted_batches;
+    }
+    os << "\n";
     lhs->analyze(os, indent + 2);
     os << "\n";
     original_rhs->analyze(os, indent + 2);
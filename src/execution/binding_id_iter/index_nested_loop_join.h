@@ -1,20 +1,30 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "base/ids/var_id.h"
+#include "base/binding/binding_batch.h"
 #include "base/binding/binding_id_iter.h"
 
+/* IndexNestedLoopJoin resets rhs with every result of lhs. With sorted_lookups (and if rhs has lookup vars, see
+ * BindingIdIter::get_lookup_vars) the results of lhs are read in batches of BindingBatch::CAPACITY, and each batch
+ * is sorted by the lookup vars before resetting rhs with its rows. Consecutive lookups of an IndexScan are then
+ * close in the index, often in the same leaf, instead of being in random positions. The results are the same
+ * but the order is different.
+ */
 class IndexNestedLoopJoin : public BindingIdIter {
 public:
     IndexNestedLoopJoin(std::unique_ptr<BindingIdIter> lhs,
-                        std::unique_ptr<BindingIdIter> rhs);
+                        std::unique_ptr<BindingIdIter> rhs,
+                        bool sorted_lookups);
 
     void analyze(std::ostream& os, int indent = 0) const override;
     void begin(BindingId& parent_binding) override;
     bool next() override;
     void reset() override;
     void assign_nulls() override;
+    bool push_filter(VarId var, const JoinKeyFilter& filter) override;
 
 private:
     std::unique_ptr<BindingIdIter> lhs;
@@ -23,4 +33,17 @@ private:
     BindingIdIter* rhs; // will point to original_rhs or a EmptyBindingIdIter
 
     BindingId* parent_binding;
+
+    // vars of lhs read by rhs, empty if the lookups are not sorted
+    std::vector<VarId> lookup_vars;
+
+    // results of lhs, the rows not used yet are selection[batch_pos], ..., selection[selected - 1]
+    std::unique_ptr<BindingBatch> lhs_batch;
+    uint_fast32_t batch_pos;
+
+    // statistics
+    uint64_t sorted_batches = 0;
+
+    // writes the next result of lhs in the binding, returns false if there are no more
+    bool next_lhs();
 };
@@ -1,5 +1,6 @@
 #include "index_scan.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -14,7 +15,14 @@ template <std::size_t N>
 IndexScan<N>::IndexScan(BPlusTree<N>& bpt, ThreadInfo* thread_info, std::array<std::unique_ptr<ScanRange>, N> ranges) :
     bpt         (bpt),
     thread_info (thread_info),
-    ranges      (move(ranges)) { }
+    ranges      (move(ranges))
+{
+    for (uint_fast32_t i = 0; i < N; ++i) {
+        if (auto var = this->ranges[i]->get_assigned_var()) {
+            assigned_columns.emplace_back(i, *var);
+        }
+    }
+}
 
 
 template <std::size_t N>
@@ -22,56 +30,170 @@ void IndexScan<N>::begin(BindingId& parent_binding) {
     assert(ranges.size() == N && "Inconsistent size of ranges and bpt");
 
     this->parent_binding = &parent_binding;
+    search();
+}
+
+
+template <std::size_t N>
+void IndexScan<N>::search() {
     std::array<uint64_t, N> min_ids;
     std::array<uint64_t, N> max_ids;
 
     for (uint_fast32_t i = 0; i < N; ++i) {
         assert(ranges[i] != nullptr);
-        min_ids[i] = ranges[i]->get_min(parent_binding);
-        max_ids[i] = ranges[i]->get_max(parent_binding);
+        min_ids[i] = ranges[i]->get_min(*parent_binding);
+        max_ids[i] = ranges[i]->get_max(*parent_binding);
+    }
+
+    if (filter != nullptr) {
+        // the records of the range are ordered by the first column with different min and max, if the filter is
+        // of that column the ids out of the bounds of the filter are not searched (min > max is an empty range)
+        uint_fast32_t first_unbound = 0;
+        while (first_unbound < N && min_ids[first_unbound] == max_ids[first_unbound]) {
+            ++first_unbound;
+        }
+        if (first_unbound == filter_pos) {
+            min_ids[filter_pos] = std::max(min_ids[filter_pos], filter->get_min());
+            max_ids[filter_pos] = std::min(max_ids[filter_pos], filter->get_max());
+        }
     }
 
-    it = bpt.get_range(
-        &thread_info->interruption_requested,
-        Record<N>(std::move(min_ids)),
-        Record<N>(std::move(max_ids))
-    );
+    // when the lookups come sorted (see IndexNestedLoopJoin) the next range often starts in the leaf of the
+    // previous one, and it is searched there without going through the directory
+    if (it != nullptr && it->seek_in_leaf(Record<N>(min_ids), Record<N>(max_ids))) {
+        ++leaf_reuses;
+    } else if (it != nullptr) {
+        const Record<N> min(std::move(min_ids));
+        it->seek(bpt.search_leaf_number(min), min, Record<N>(std::move(max_ids)));
+    } else {
+        it = bpt.get_range(
+            &thread_info->interruption_requested,
+            Record<N>(std::move(min_ids)),
+            Record<N>(std::move(max_ids))
+        );
+    }
+    current_block = { nullptr, 0 };
+    current_block_pos = 0;
+    block_read = false;
     ++bpt_searches;
 }
 
 
 template <std::size_t N>
-bool IndexScan<N>::next() {
+const Record<N>* IndexScan<N>::next_record() {
     assert(it != nullptr);
-    auto next = it->next();
-    if (next != nullptr) {
-        for (uint_fast32_t i = 0; i < N; ++i) {
-            ranges[i]->try_assign(*parent_binding, ObjectId(next->ids[i]));
+    while (true) {
+        if (current_block_pos == current_block.count) {
+            current_block = it->next_block();
+            current_block_pos = 0;
+            block_read = true;
+            if (current_block.empty()) {
+                return nullptr;
+            }
         }
-        ++results_found;
-        return true;
-    } else {
+        const auto& record = current_block[current_block_pos++];
+        if (filter == nullptr || filter->contains(record.ids[filter_pos])) {
+            return &record;
+        }
+        ++filtered_records;
+    }
+}
+
+
+template <std::size_t N>
+bool IndexScan<N>::next() {
+    auto next = next_record();
+    if (next == nullptr) {
         return false;
     }
+    for (uint_fast32_t i = 0; i < N; ++i) {
+        ranges[i]->try_assign(*parent_binding, ObjectId(next->ids[i]));
+    }
+    ++results_found;
+    return true;
+}
+
+
+template <std::size_t N>
+bool IndexScan<N>::next_batch(BindingBatch& batch) {
+    assert(it != nullptr);
+    batch.clear();
+    if (filter != nullptr) {
+        // the records are copied one by one, skipping the ones that are not in the filter
+        while (!batch.full()) {
+            auto record = next_record();
+            if (record == nullptr) {
+                break;
+            }
+            batch.fill_rows(batch.size, batch.size + 1);
+            for (auto [record_pos, var] : assigned_columns) {
+                batch.column(var)[batch.size] = ObjectId(record->ids[record_pos]);
+            }
+            batch.size++;
+        }
+        batch.select_all();
+        results_found += batch.size;
+        return batch.size > 0;
+    }
+    while (!batch.full()) {
+        if (current_block_pos == current_block.count) {
+            current_block = it->next_block();
+            current_block_pos = 0;
+            block_read = true;
+            if (current_block.empty()) {
+                break;
+            }
+        }
+        const auto rows = std::min<uint_fast32_t>(current_block.count - current_block_pos,
+                                                  BindingBatch::CAPACITY - batch.size);
+        batch.fill_rows(batch.size, batch.size + rows);
+        const auto records = &current_block[current_block_pos];
+        for (auto [record_pos, var] : assigned_columns) {
+            auto column = batch.column(var) + batch.size;
+            for (uint_fast32_t i = 0; i < rows; ++i) {
+                column[i] = ObjectId(records[i].ids[record_pos]);
+            }
+        }
+        current_block_pos += rows;
+        batch.size += rows;
+    }
+    batch.select_all();
+    results_found += batch.size;
+    return batch.size > 0;
 }
 
 
 template <std::size_t N>
 void IndexScan<N>::reset() {
-    std::array<uint64_t, N> min_ids;
-    std::array<uint64_t, N> max_ids;
+    search();
+}
 
-    for (uint_fast32_t i = 0; i < N; ++i) {
-        min_ids[i] = ranges[i]->get_min(*parent_binding);
-        max_ids[i] = ranges[i]->get_max(*parent_binding);
+
+template <std::size_t N>
+bool IndexScan<N>::push_filter(VarId var, const JoinKeyFilter& _filter) {
+    for (auto [record_pos, assigned_var] : assigned_columns) {
+        if (assigned_var == var) {
+            filter     = &_filter;
+            filter_pos = record_pos;
+            if (!block_read) {
+                // nothing was returned since the last search, it can be repeated with the bounds of the filter
+                search();
+                --bpt_searches;
+            }
+            return true;
+        }
     }
+    return false;
+}
 
-    it = bpt.get_range(
-        &thread_info->interruption_requested,
-        Record<N>(std::move(min_ids)),
-        Record<N>(std::move(max_ids))
-    );
-    ++bpt_searches;
+
+template <std::size_t N>
+void IndexScan<N>::get_lookup_vars(std::vector<VarId>& vars) const {
+    for (auto& range : ranges) {
+        if (auto var = range->get_input_var()) {
+            vars.push_back(*var);
+        }
+    }
 }
 
 
@@ -88,7 +210,14 @@ void IndexScan<N>::analyze(std::ostream& os, int indent) const {
     os << std::string(indent, ' ');
     auto real_factor = static_cast<double>(results_found) / static_cast<double>(bpt_searches);
     os << "IndexScan(bpt_searches: " << bpt_searches << ", found: " << results_found
-       << ", factor: " << real_factor << ")";
+       << ", factor: " << real_factor;
+    if (leaf_reuses > 0) {
+        os << ", leaf reuses: " << leaf_reuses;
+    }
+    if (filter != nullptr) {
+        os << ", join filter: " << filter->type_name() << ", filtered: " << filtered_records;
+    }
+    os << ")";
 }
 
 template class IndexScan<1>;
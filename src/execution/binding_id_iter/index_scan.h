@@ -2,10 +2,13 @@
 
 #include <array>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/binding/binding_id_iter.h"
 #include "base/thread/thread_info.h"
 #include "storage/index/bplus_tree/bplus_tree.h"
+#include "execution/binding_id_iter/hash_join/join_key_filter.h"
 #include "execution/binding_id_iter/scan_ranges/scan_range.h"
 
 template <std::size_t N>
@@ -15,12 +18,34 @@ private:
     ThreadInfo* thread_info;
     std::unique_ptr<BptIter<N>> it;
 
+    // records of the current leaf obtained with next_block(), current_block_pos is the next one to return
+    RecordSpan<N> current_block = { nullptr, 0 };
+    uint_fast32_t current_block_pos = 0;
+
     BindingId* parent_binding;
     std::array<std::unique_ptr<ScanRange>, N> ranges;
 
+    // (position in the record, variable) of the ranges that assign a variable, used by next_batch()
+    std::vector<std::pair<uint_fast32_t, VarId>> assigned_columns;
+
+    // given by push_filter(), the records whose id in the position filter_pos is not in the filter are skipped
+    const JoinKeyFilter* filter = nullptr;
+    uint_fast32_t filter_pos;
+
+    // false until the first block of the current search is read
+    bool block_read = false;
+
     // statistics
     uint_fast32_t results_found = 0;
     uint_fast32_t bpt_searches = 0;
+    uint_fast32_t leaf_reuses = 0;
+    uint64_t filtered_records = 0;
+
+    // searches the range of the ranges in the bpt, and starts the iteration
+    void search();
+
+    // returns the next record, or nullptr when there are no more
+    const Record<N>* next_record();
 
 public:
     IndexScan(BPlusTree<N>& bpt, ThreadInfo*, std::array<std::unique_ptr<ScanRange>, N> ranges);
@@ -28,6 +53,9 @@ public:
     void analyze(std::ostream& os, int indent = 0) const override;
     void begin(BindingId& parent_binding) override;
     bool next() override;
+    bool next_batch(BindingBatch& batch) override;
     void reset() override;
     void assign_nulls() override;
+    bool push_filter(VarId var, const JoinKeyFilter& filter) override;
+    void get_lookup_vars(std::vector<VarId>& vars) const override;
 };
@@ -1,7 +1,6 @@
 #include "leapfrog_join.h"
 
 #include <cassert>
-#include <iostream>
 
 #include "base/exceptions.h"
 #include "storage/index/tuple_buffer/tuple_buffer.h"
@@ -49,21 +48,13 @@ void LeapfrogJoin::begin(BindingId& _parent_binding) {
         }
     }
 
-    cout << "enumeration_level: " << enumeration_level << "\n";
-
     if (open_terms) {
-        cout << "open_terms successfully\n";
         down();
-    } else {
-        cout << "open_terms failed\n";
     }
-    cout << "level: " << level << "\n";
 }
 
 
 bool LeapfrogJoin::next() {
-    // cout << "next called\n";
-    // cout << "level: " << level << "\n";
     if (__builtin_expect(!!(*leapfrog_iters[0]->interruption_requested), 0)) {
         throw InterruptedException();
     }
@@ -154,6 +145,18 @@ void LeapfrogJoin::down() {
             iters_for_var[level][i]->down();
         }
 
+        if (level == 0) {
+            first_var_range_empty = false;
+            if (first_var_min > 0) {
+                for (auto iter : iters_for_var[0]) {
+                    if (!iter->seek(first_var_min)) {
+                        first_var_range_empty = true;
+                        break;
+                    }
+                }
+            }
+        }
+
         // sort the corresponding iterators using insertion sort
         for (int_fast32_t i = 1; i < (int_fast32_t) iters_for_var[level].size(); i++) {
             auto aux = iters_for_var[level][i];
@@ -176,16 +179,16 @@ void LeapfrogJoin::down() {
 
 
 bool LeapfrogJoin::find_intersection_for_current_level() {
-    // cout << "trying to find intersection at level " << level << "\n";
     uint_fast32_t p = 0;
 
     auto min = iters_for_var[level][p]->get_key();
     auto max = iters_for_var[level][iters_for_var[level].size() - 1]->get_key();
 
-    // cout << "min: " << min << "\n";
-    // cout << "max: " << max << "\n";
-    // cout << "min: " << ((min & GraphModel::TYPE_MASK) >> 56) << ", " << (min & GraphModel::VALUE_MASK) << "\n";
-    // cout << "max: " << ((max & GraphModel::TYPE_MASK) >> 56) << ", " << (max & GraphModel::VALUE_MASK) << "\n";
+    // keys of the first variable greater than first_var_max are left to other parts of the join
+    const auto level_max = level == 0 ? first_var_max : UINT64_MAX;
+    if (level == 0 && (first_var_range_empty || max > level_max)) {
+        return false;
+    }
 
     while (min != max) { // min = max means all are equal
         if (__builtin_expect(!!(*leapfrog_iters[0]->interruption_requested), 0)) {
@@ -195,26 +198,41 @@ bool LeapfrogJoin::find_intersection_for_current_level() {
         if (iters_for_var[level][p]->seek(max)) {
             // after the seek, the previous min is the max
             max = iters_for_var[level][p]->get_key();
+            if (max > level_max) {
+                return false;
+            }
 
             // update the min
             p = (p + 1) % iters_for_var[level].size();
             min = iters_for_var[level][p]->get_key();
-            // cout << "new min: " << ((min & GraphModel::TYPE_MASK) >> 56) << ", " << (min & GraphModel::VALUE_MASK) << "\n";
-            // cout << "new max: " << ((max & GraphModel::TYPE_MASK) >> 56) << ", " << (max & GraphModel::VALUE_MASK) << "\n";
-
         } else {
-            // cout << "new min: " << ((min & GraphModel::TYPE_MASK) >> 56) << ", " << (min & GraphModel::VALUE_MASK) << "\n";
-            // cout << "new max: " << ((max & GraphModel::TYPE_MASK) >> 56) << ", " << (max & GraphModel::VALUE_MASK) << "\n";
-            // cout << "failed to find intersection at level " << level << "\n";
             return false;
         }
     }
     parent_binding->add(var_order[level], ObjectId(min));
-    // cout << "found intersection at level " << level << "\n";
     return true;
 }
 
 
+bool LeapfrogJoin::get_split_keys(BindingId& input_binding, uint_fast32_t count, vector<uint64_t>& split_keys) {
+    uint64_t smallest_records = UINT64_MAX;
+    vector<uint64_t> iter_split_keys;
+    for (auto& leapfrog_iter : leapfrog_iters) {
+        const auto& intersection_vars = leapfrog_iter->get_intersection_vars();
+        if (intersection_vars.empty() || intersection_vars[0] != var_order[0]) {
+            continue;
+        }
+        iter_split_keys.clear();
+        const auto records = leapfrog_iter->get_split_keys(input_binding, count, iter_split_keys);
+        if (records > 0 && records < smallest_records) {
+            smallest_records = records;
+            split_keys.swap(iter_split_keys);
+        }
+    }
+    return smallest_records != UINT64_MAX;
+}
+
+
 void LeapfrogJoin::analyze(std::ostream& os, int indent) const {
     os << std::string(indent, ' ');
     os << "LeapfrogJoin(found: " << results_found << ", seeks: " << seeks << ")";
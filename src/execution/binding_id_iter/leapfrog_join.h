@@ -23,6 +23,23 @@ public:
     void reset() override;
     void assign_nulls() override;
 
+    // Only the values of var_order[0] in [min, max] are joined, used to split the join in independent parts.
+    // Must be called before begin() or reset()
+    void set_first_var_range(uint64_t min, uint64_t max) noexcept {
+        first_var_min = min;
+        first_var_max = max;
+    }
+
+    // Writes in `split_keys` values of var_order[0] that split the join in about `count` parts, taken from the
+    // iterator with less records. Returns false if no iterator can give split keys
+    bool get_split_keys(BindingId& input_binding, uint_fast32_t count, std::vector<uint64_t>& split_keys);
+
+    inline const std::vector<VarId>& get_var_order() const noexcept { return var_order; }
+
+    inline uint64_t get_results_found() const noexcept { return results_found; }
+
+    inline uint64_t get_seeks() const noexcept { return seeks; }
+
 private:
     std::vector<std::unique_ptr<LeapfrogIter>> leapfrog_iters;
 
@@ -44,6 +61,13 @@ private:
     uint_fast32_t results_found = 0;
     uint_fast32_t seeks = 0;
 
+    // range of var_order[0] set with set_first_var_range
+    uint64_t first_var_min = 0;
+    uint64_t first_var_max = UINT64_MAX;
+
+    // true when no iterator at the first level has a key in [first_var_min, first_var_max]
+    bool first_var_range_empty = false;
+
     void up();
     void down();
     bool find_intersection_for_current_level();
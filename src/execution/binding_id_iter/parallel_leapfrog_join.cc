@@ -0,0 +1,205 @@
+#include "parallel_leapfrog_join.h"
+
+#include <cassert>
+
+using namespace std;
+
+ParallelLeapfrogJoin::ParallelLeapfrogJoin(vector<unique_ptr<LeapfrogJoin>> _joins) :
+    joins     (move(_joins)),
+    var_order (joins[0]->get_var_order()),
+    stop      (false)
+{
+    assert(!joins.empty());
+}
+
+
+ParallelLeapfrogJoin::~ParallelLeapfrogJoin() {
+    stop_workers();
+}
+
+
+void ParallelLeapfrogJoin::begin(BindingId& _parent_binding) {
+    parent_binding = &_parent_binding;
+    worker_bindings.clear();
+    for (size_t i = 0; i < joins.size(); i++) {
+        worker_bindings.push_back(make_unique<BindingId>(parent_binding->size));
+    }
+    start();
+}
+
+
+void ParallelLeapfrogJoin::reset() {
+    start();
+}
+
+
+void ParallelLeapfrogJoin::start() {
+    stop_workers();
+
+    // the split keys define the ranges [0, k0-1], [k0, k1-1], ... [kn, UINT64_MAX]
+    const auto range_count = joins.size() * RANGES_PER_WORKER;
+    vector<uint64_t> split_keys;
+    joins[0]->get_split_keys(*parent_binding, range_count, split_keys);
+    if (split_keys.size() > range_count) {
+        vector<uint64_t> even_split_keys;
+        for (size_t i = 1; i < range_count; i++) {
+            even_split_keys.push_back(split_keys[i * split_keys.size() / range_count]);
+        }
+        split_keys.swap(even_split_keys);
+    }
+    ranges.clear();
+    uint64_t range_min = 0;
+    for (auto key : split_keys) {
+        if (key > range_min) {
+            ranges.emplace_back(range_min, key - 1);
+            range_min = key;
+        }
+    }
+    ranges.emplace_back(range_min, UINT64_MAX);
+
+    next_range        = 0;
+    stop              = false;
+    worker_exception  = nullptr;
+    current_batch_pos = 0;
+    current_batch.clear();
+    running_workers   = joins.size();
+    for (uint_fast32_t i = 0; i < joins.size(); i++) {
+        worker_bindings[i]->add_all(*parent_binding);
+        workers.emplace_back(&ParallelLeapfrogJoin::work, this, i);
+    }
+}
+
+
+void ParallelLeapfrogJoin::stop_workers() {
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stop = true;
+    }
+    queue_not_full.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    while (!full_batches.empty()) {
+        free_batches.push_back(move(full_batches.front()));
+        full_batches.pop();
+    }
+}
+
+
+void ParallelLeapfrogJoin::work(uint_fast32_t worker) {
+    auto& join    = *joins[worker];
+    auto& binding = *worker_bindings[worker];
+
+    vector<ObjectId> batch;
+    batch.reserve(BATCH_SIZE * var_order.size());
+    try {
+        bool first_range = true;
+        for (auto range = next_range++; range < ranges.size() && !stop; range = next_range++) {
+            join.set_first_var_range(ranges[range].first, ranges[range].second);
+            if (first_range) {
+                join.begin(binding);
+                first_range = false;
+            } else {
+                join.reset();
+            }
+            while (join.next()) {
+                for (auto var : var_order) {
+                    batch.push_back(binding[var]);
+                }
+                if (batch.size() == BATCH_SIZE * var_order.size() && !push_batch(batch)) {
+                    break;
+                }
+            }
+        }
+        if (!batch.empty()) {
+            push_batch(batch);
+        }
+    }
+    catch (...) {
+        lock_guard<mutex> lock(queue_mutex);
+        if (worker_exception == nullptr) {
+            worker_exception = current_exception();
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        running_workers--;
+    }
+    queue_not_empty.notify_one();
+}
+
+
+bool ParallelLeapfrogJoin::push_batch(vector<ObjectId>& batch) {
+    unique_lock<mutex> lock(queue_mutex);
+    queue_not_full.wait(lock, [&] { return stop || full_batches.size() < MAX_QUEUED_BATCHES; });
+    if (stop) {
+        return false;
+    }
+    full_batches.push(move(batch));
+    if (free_batches.empty()) {
+        batch = vector<ObjectId>();
+        batch.reserve(BATCH_SIZE * var_order.size());
+    } else {
+        batch = move(free_batches.back());
+        free_batches.pop_back();
+        batch.clear();
+    }
+    lock.unlock();
+    queue_not_empty.notify_one();
+    return true;
+}
+
+
+bool ParallelLeapfrogJoin::next() {
+    while (current_batch_pos == current_batch.size()) {
+        unique_lock<mutex> lock(queue_mutex);
+        if (!current_batch.empty()) {
+            free_batches.push_back(move(current_batch));
+            current_batch.clear();
+        }
+        queue_not_empty.wait(lock, [&] {
+            return !full_batches.empty() || running_workers == 0 || worker_exception != nullptr;
+        });
+        if (worker_exception != nullptr) {
+            auto exception = worker_exception;
+            lock.unlock();
+            stop_workers();
+            rethrow_exception(exception);
+        }
+        if (full_batches.empty()) {
+            return false;
+        }
+        current_batch = move(full_batches.front());
+        full_batches.pop();
+        current_batch_pos = 0;
+        lock.unlock();
+        queue_not_full.notify_one();
+    }
+
+    for (auto var : var_order) {
+        parent_binding->add(var, current_batch[current_batch_pos++]);
+    }
+    results_found++;
+    return true;
+}
+
+
+void ParallelLeapfrogJoin::assign_nulls() {
+    for (auto var : var_order) {
+        parent_binding->add(var, ObjectId::get_null());
+    }
+}
+
+
+void ParallelLeapfrogJoin::analyze(std::ostream& os, int indent) const {
+    os << std::string(indent, ' ');
+    os << "ParallelLeapfrogJoin(workers: " << joins.size() << ", ranges: " << ranges.size()
+       << ", found: " << results_found;
+    for (const auto& join : joins) {
+        os << "\n";
+        join->analyze(os, indent + 2);
+    }
+    os << "\n" << std::string(indent, ' ') << ")";
+}
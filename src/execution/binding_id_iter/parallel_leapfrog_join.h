@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "base/binding/binding_id_iter.h"
+#include "base/ids/object_id.h"
+#include "base/ids/var_id.h"
+#include "execution/binding_id_iter/leapfrog_join.h"
+
+/* ParallelLeapfrogJoin executes a LeapfrogJoin with many threads. Disjoint ranges of values of the first
+ * variable of the join are independent parts of the join, so every worker thread has its own LeapfrogJoin
+ * (with its own LeapfrogIters and BindingId) and joins one range at a time.
+ *
+ * The ranges are split with keys of the directory of the smallest iterator of the first variable. There are
+ * RANGES_PER_WORKER ranges for each worker and a worker takes the next range not taken when it finishes one,
+ * so a worker with a range with many results doesn't leave the others idle.
+ *
+ * The workers send the results in batches through a bounded queue, next() is called by the thread that
+ * called begin() and copies them into the parent binding. The order of the results is not the same as
+ * the order of LeapfrogJoin.
+ */
+class ParallelLeapfrogJoin : public BindingIdIter {
+public:
+    static constexpr uint_fast32_t RANGES_PER_WORKER = 16;
+
+    // results in a batch sent by a worker
+    static constexpr uint_fast32_t BATCH_SIZE = 1024;
+
+    // batches in the queue before a worker waits
+    static constexpr uint_fast32_t MAX_QUEUED_BATCHES = 64;
+
+    // one join for every worker, all of them must join the same relations with the same var_order
+    ParallelLeapfrogJoin(std::vector<std::unique_ptr<LeapfrogJoin>> joins);
+
+    ~ParallelLeapfrogJoin();
+
+    void analyze(std::ostream& os, int indent = 0) const override;
+    void begin(BindingId& parent_binding) override;
+    bool next() override;
+    void reset() override;
+    void assign_nulls() override;
+
+private:
+    std::vector<std::unique_ptr<LeapfrogJoin>> joins;
+
+    const std::vector<VarId> var_order;
+
+    BindingId* parent_binding;
+
+    // binding of each worker, the input variables are copied from parent_binding
+    std::vector<std::unique_ptr<BindingId>> worker_bindings;
+
+    // inclusive ranges of values of var_order[0]
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+
+    std::atomic<uint_fast32_t> next_range;
+
+    std::vector<std::thread> workers;
+
+    // protects the members below until worker_exception
+    std::mutex queue_mutex;
+
+    std::condition_variable queue_not_empty;
+
+    std::condition_variable queue_not_full;
+
+    // a batch has the values of var_order for every result, one result after the other
+    std::queue<std::vector<ObjectId>> full_batches;
+
+    // batches already read, reused by the workers
+    std::vector<std::vector<ObjectId>> free_batches;
+
+    uint_fast32_t running_workers;
+
+    std::atomic<bool> stop;
+
+    // first exception thrown by a worker, it is thrown again by next()
+    std::exception_ptr worker_exception;
+
+    std::vector<ObjectId> current_batch;
+
+    // position in current_batch of the next result
+    uint_fast32_t current_batch_pos;
+
+    uint64_t results_found = 0;
+
+    // splits the ranges and starts the workers
+    void start();
+
+    void stop_workers();
+
+    void work(uint_fast32_t worker);
+
+    // sends `batch` to the queue and replaces it with an empty batch, returns false if the workers must stop
+    bool push_batch(std::vector<ObjectId>& batch);
+};
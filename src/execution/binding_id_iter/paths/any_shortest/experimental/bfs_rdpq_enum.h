@@ -45,7 +45,7 @@ private:
 
     // Stores the children of state in expansion
     std::unique_ptr<BptIter<4>> iter;
-    std::unique_ptr<Record<4UL>> child_record;
+    const Record<4UL>* child_record;
 
     // The index of the transitions that are currently being explored
     uint32_t current_data_transition;
@@ -53,16 +53,18 @@ bool UnfixedComposite::next() {
             results_found++;
             return true;
         } else {
+            // current_start_record points to the leaf of start_iter, so it is not valid after calling next()
+            const auto last_start_node = current_start_record != nullptr ? current_start_record->ids[1] : 0;
             auto new_start_record = start_iter->next();
             while (new_start_record != nullptr) {
-                if (new_start_record->ids[1] != current_start_record->ids[1]) {
+                if (new_start_record->ids[1] != last_start_node) {
                     break;
                 } else {
                     new_start_record = start_iter->next();
                 }
             }
 
-            current_start_record = move(new_start_record);
+            current_start_record = new_start_record;
 
             if (current_start_record != nullptr) {
                 auto has_not_been_visited = visited.emplace(current_start_record->ids[1]).second;
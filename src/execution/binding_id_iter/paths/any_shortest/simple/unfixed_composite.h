@@ -43,7 +43,7 @@ private:
 
     std::unique_ptr<BptIter<4>> start_iter;
 
-    std::unique_ptr<Record<4>> current_start_record = nullptr;
+    const Record<4>* current_start_record = nullptr;
 
     // Only to remember the start nodes, in order to not repeat it
     robin_hood::unordered_node_set<uint64_t> visited;
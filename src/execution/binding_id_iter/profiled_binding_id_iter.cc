@@ -0,0 +1,256 @@
+#include "profiled_binding_id_iter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <typeinfo>
+#include <x86intrin.h>
+
+#include "base/thread/thread_counters.h"
+
+using namespace std;
+
+thread_local ProfiledBindingIdIter* ProfiledBindingIdIter::current = nullptr;
+
+namespace {
+    void write_json_string(ostream& os, const string& str) {
+        os << '"';
+        for (char c : str) {
+            switch (c) {
+            case '"':  os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n";  break;
+            case '\t': os << "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    os << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec << setfill(' ');
+                } else {
+                    os << c;
+                }
+            }
+        }
+        os << '"';
+    }
+
+
+    string demangle(const char* name) {
+        int status;
+        auto demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status != 0) {
+            return name;
+        }
+        string res(demangled);
+        free(demangled);
+        return res;
+    }
+}
+
+
+QueryProfile::QueryProfile() :
+    start_cycles (__rdtsc()),
+    start_time   (chrono::steady_clock::now()) { }
+
+
+bool QueryProfile::remove_prefix(string& query) {
+    const string prefix = "PROFILE";
+    auto start = query.find_first_not_of(" \t\r\n");
+    if (start == string::npos || query.size() - start <= prefix.size()
+        || !isspace(static_cast<unsigned char>(query[start + prefix.size()])))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); i++) {
+        if (toupper(static_cast<unsigned char>(query[start + i])) != prefix[i]) {
+            return false;
+        }
+    }
+    query.erase(0, start + prefix.size());
+    return true;
+}
+
+
+void QueryProfile::write_json(ostream& os, const string& plan) const {
+    const chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start_time;
+    const auto cycles = __rdtsc() - start_cycles;
+    const double ns_per_cycle = cycles > 0 ? elapsed.count() / cycles : 0;
+
+    os << "{\"plan\": ";
+    write_json_string(os, plan);
+    os << ", \"operators\": [";
+    for (size_t i = 0; i < roots.size(); i++) {
+        if (i > 0) {
+            os << ", ";
+        }
+        roots[i]->write_json(os, ns_per_cycle);
+    }
+    os << "]}";
+}
+
+
+unique_ptr<BindingIdIter> ProfiledBindingIdIter::wrap(unique_ptr<BindingIdIter> iter, ThreadInfo* thread_info) {
+    if (thread_info->profile == nullptr) {
+        return iter;
+    }
+    return make_unique<ProfiledBindingIdIter>(move(iter), *thread_info->profile);
+}
+
+
+ProfiledBindingIdIter::ProfiledBindingIdIter(unique_ptr<BindingIdIter> iter, QueryProfile& profile) :
+    iter    (move(iter)),
+    profile (profile) { }
+
+
+void ProfiledBindingIdIter::register_in_tree() {
+    registered = true;
+    if (current == nullptr) {
+        profile.roots.push_back(this);
+    } else {
+        current->children.push_back(this);
+    }
+}
+
+
+void ProfiledBindingIdIter::begin(BindingId& parent_binding) {
+    if (!registered) {
+        register_in_tree();
+    }
+    auto parent = current;
+    current = this;
+    const auto start_pins  = ThreadCounters::page_pins;
+    const auto start_seeks = ThreadCounters::index_seeks;
+    const auto start = __rdtsc();
+
+    iter->begin(parent_binding);
+
+    begin_cycles += __rdtsc() - start;
+    page_pins += ThreadCounters::page_pins - start_pins;
+    seeks += ThreadCounters::index_seeks - start_seeks;
+    rows_in++;
+    current = parent;
+}
+
+
+void ProfiledBindingIdIter::reset() {
+    auto parent = current;
+    current = this;
+    const auto start_pins  = ThreadCounters::page_pins;
+    const auto start_seeks = ThreadCounters::index_seeks;
+    const auto start = __rdtsc();
+
+    iter->reset();
+
+    begin_cycles += __rdtsc() - start;
+    page_pins += ThreadCounters::page_pins - start_pins;
+    seeks += ThreadCounters::index_seeks - start_seeks;
+    rows_in++;
+    current = parent;
+}
+
+
+bool ProfiledBindingIdIter::next() {
+    auto parent = current;
+    current = this;
+    const auto start_pins  = ThreadCounters::page_pins;
+    const auto start_seeks = ThreadCounters::index_seeks;
+    const bool sampled = next_calls++ % SAMPLE_PERIOD == 0;
+    const auto start = sampled ? __rdtsc() : 0;
+
+    const bool res = iter->next();
+
+    if (sampled) {
+        sampled_cycles += __rdtsc() - start;
+        sampled_calls++;
+    }
+    page_pins += ThreadCounters::page_pins - start_pins;
+    seeks += ThreadCounters::index_seeks - start_seeks;
+    rows_out += res;
+    current = parent;
+    return res;
+}
+
+
+bool ProfiledBindingIdIter::next_batch(BindingBatch& batch) {
+    auto parent = current;
+    current = this;
+    const auto start_pins  = ThreadCounters::page_pins;
+    const auto start_seeks = ThreadCounters::index_seeks;
+    const bool sampled = next_calls++ % SAMPLE_PERIOD == 0;
+    const auto start = sampled ? __rdtsc() : 0;
+
+    const bool res = iter->next_batch(batch);
+
+    if (sampled) {
+        sampled_cycles += __rdtsc() - start;
+        sampled_calls++;
+    }
+    page_pins += ThreadCounters::page_pins - start_pins;
+    seeks += ThreadCounters::index_seeks - start_seeks;
+    rows_out += res ? batch.selected : 0;
+    current = parent;
+    return res;
+}
+
+
+void ProfiledBindingIdIter::assign_nulls() {
+    iter->assign_nulls();
+}
+
+
+bool ProfiledBindingIdIter::push_filter(VarId var, const JoinKeyFilter& filter) {
+    return iter->push_filter(var, filter);
+}
+
+
+void ProfiledBindingIdIter::get_lookup_vars(std::vector<VarId>& vars) const {
+    iter->get_lookup_vars(vars);
+}
+
+
+void ProfiledBindingIdIter::analyze(ostream& os, int indent) const {
+    iter->analyze(os, indent);
+}
+
+
+uint64_t ProfiledBindingIdIter::get_cycles() const noexcept {
+    if (sampled_calls == 0) {
+        return begin_cycles;
+    }
+    return begin_cycles + sampled_cycles * next_calls / sampled_calls;
+}
+
+
+void ProfiledBindingIdIter::write_json(ostream& os, double ns_per_cycle) const {
+    // the counters include the work of the children, the self counters don't
+    auto self_cycles = static_cast<int64_t>(get_cycles());
+    auto self_seeks  = static_cast<int64_t>(seeks);
+    auto self_pins   = static_cast<int64_t>(page_pins);
+    for (auto child : children) {
+        self_cycles -= child->get_cycles();
+        self_seeks  -= child->seeks;
+        self_pins   -= child->page_pins;
+    }
+    auto ms = [ns_per_cycle](int64_t cycles) { return std::max<int64_t>(0, cycles) * ns_per_cycle / 1'000'000; };
+
+    os << "{\"operator\": ";
+    const auto& profiled_iter = *iter;
+    write_json_string(os, demangle(typeid(profiled_iter).name()));
+    os << ", \"rows_in\": "        << rows_in
+       << ", \"rows_out\": "       << rows_out
+       << ", \"next_calls\": "     << next_calls
+       << ", \"seeks\": "          << seeks
+       << ", \"self_seeks\": "     << std::max<int64_t>(0, self_seeks)
+       << ", \"page_pins\": "      << page_pins
+       << ", \"self_page_pins\": " << std::max<int64_t>(0, self_pins)
+       << ", \"time_ms\": "        << ms(get_cycles())
+       << ", \"self_time_ms\": "   << ms(self_cycles)
+       << ", \"children\": [";
+    for (size_t i = 0; i < children.size(); i++) {
+        if (i > 0) {
+            os << ", ";
+        }
+        children[i]->write_json(os, ns_per_cycle);
+    }
+    os << "]}";
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/binding/binding_id_iter.h"
+#include "base/thread/thread_info.h"
+
+class ProfiledBindingIdIter;
+
+/* QueryProfile collects the counters of the operators of a profiled query (a query with the PROFILE prefix or
+ * every query if the server was started with --profile). The optimizer wraps every BindingIdIter in a
+ * ProfiledBindingIdIter, they form a tree like the one printed by analyze() and write_json() prints it.
+ * Queries that are not profiled have no ProfiledBindingIdIter, so the cost is only the thread local
+ * counters of ThreadCounters.
+ */
+class QueryProfile {
+public:
+    QueryProfile();
+
+    // Removes the PROFILE prefix (case insensitive) of `query`, returns true if it had it
+    static bool remove_prefix(std::string& query);
+
+    // operators that were not called from another profiled operator
+    std::vector<const ProfiledBindingIdIter*> roots;
+
+    // Writes the tree of operators as a JSON object, `plan` is the output of analyze()
+    void write_json(std::ostream& os, const std::string& plan) const;
+
+private:
+    // used to convert the cycles of the TSC to nanoseconds
+    const uint64_t start_cycles;
+    const std::chrono::steady_clock::time_point start_time;
+};
+
+
+/* ProfiledBindingIdIter calls another BindingIdIter and counts the work done by it (including the work of
+ * its children):
+ *  - rows_in:    bindings received (calls to begin() and reset())
+ *  - rows_out:   results returned
+ *  - next_calls: calls to next() or next_batch()
+ *  - seeks and page_pins: see ThreadCounters
+ *  - time: every call to begin() and reset() is timed with the TSC, but only one of SAMPLE_PERIOD calls to
+ *          next() or next_batch() is, and the time of all of them is estimated from them.
+ */
+class ProfiledBindingIdIter : public BindingIdIter {
+public:
+    static constexpr uint64_t SAMPLE_PERIOD = 16;
+
+    // returns `iter` inside a ProfiledBindingIdIter if the query is profiled, or `iter` otherwise
+    static std::unique_ptr<BindingIdIter> wrap(std::unique_ptr<BindingIdIter> iter, ThreadInfo* thread_info);
+
+    ProfiledBindingIdIter(std::unique_ptr<BindingIdIter> iter, QueryProfile& profile);
+
+    void analyze(std::ostream& os, int indent = 0) const override;
+    void begin(BindingId& parent_binding) override;
+    bool next() override;
+    bool next_batch(BindingBatch& batch) override;
+    void reset() override;
+    void assign_nulls() override;
+    bool push_filter(VarId var, const JoinKeyFilter& filter) override;
+    void get_lookup_vars(std::vector<VarId>& vars) const override;
+
+    void write_json(std::ostream& os, double ns_per_cycle) const;
+
+private:
+    std::unique_ptr<BindingIdIter> iter;
+
+    QueryProfile& profile;
+
+    bool registered = false;
+
+    std::vector<const ProfiledBindingIdIter*> children;
+
+    uint64_t rows_in        = 0;
+    uint64_t rows_out       = 0;
+    uint64_t next_calls     = 0;
+    uint64_t seeks          = 0;
+    uint64_t page_pins      = 0;
+    uint64_t begin_cycles   = 0;
+    uint64_t sampled_calls  = 0;
+    uint64_t sampled_cycles = 0;
+
+    // the operator being called in this thread, it is the parent of the operators it calls
+    static thread_local ProfiledBindingIdIter* current;
+
+    // adds this operator to the children of `current`
+    void register_in_tree();
+
+    // estimation of the cycles spent in this operator and its children
+    uint64_t get_cycles() const noexcept;
+};
@@ -20,4 +20,8 @@ public:
     }
 
     void try_assign(BindingId&, ObjectId) override { }
+
+    std::optional<VarId> get_input_var() const override {
+        return var_id;
+    }
 };
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "execution/binding_id_iter/scan_ranges/scan_range.h"
+
+// An unassigned variable whose value is only searched between min and max (inclusive). Used for comparisons
+// with values whose ObjectIds preserve the order (e.g. integers)
+class BoundedVar : public ScanRange {
+private:
+    VarId var_id;
+    uint64_t min;
+    uint64_t max;
+
+public:
+    BoundedVar(VarId var_id, uint64_t min, uint64_t max) :
+        var_id (var_id),
+        min    (min),
+        max    (max) { }
+
+    uint64_t get_min(BindingId&) override {
+        return min;
+    }
+
+    uint64_t get_max(BindingId&) override {
+        return max;
+    }
+
+    void try_assign(BindingId& binding, ObjectId obj_id) override {
+        binding.add(var_id, obj_id);
+    }
+
+    std::optional<VarId> get_assigned_var() const override {
+        return var_id;
+    }
+};
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <variant>
 
 #include "base/binding/binding_id.h"
@@ -14,5 +15,11 @@ public:
     virtual uint64_t get_max(BindingId& input) = 0;
     virtual void try_assign(BindingId& my_binding, ObjectId) = 0;
 
+    // the variable written by try_assign(), if any
+    virtual std::optional<VarId> get_assigned_var() const { return std::nullopt; }
+
+    // the variable of the input binding read by get_min() and get_max(), if any
+    virtual std::optional<VarId> get_input_var() const { return std::nullopt; }
+
     static std::unique_ptr<ScanRange> get(Id id, bool assigned);
 };
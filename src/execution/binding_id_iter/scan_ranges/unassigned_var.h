@@ -21,4 +21,8 @@ public:
     void try_assign(BindingId& binding, ObjectId obj_id) override {
         binding.add(var_id, obj_id);
     }
+
+    std::optional<VarId> get_assigned_var() const override {
+        return var_id;
+    }
 };
@@ -9,7 +9,7 @@
 #include "base/binding/binding_iter.h"
 #include "base/thread/thread_info.h"
 #include "storage/file_id.h"
-#include "storage/tuple_collection/tuple_collection.h"
+#include "storage/tuple_collection/tuple_sorter.h"
 
 class GroupBy : public BindingIter {
 public:
@@ -10,7 +10,8 @@ class Match : public BindingIter {
 public:
     Match(std::unique_ptr<BindingIdIter> root,
           uint_fast32_t                  binding_size,
-          std::map<VarId, ObjectId>&     fixed_vars);
+          std::map<VarId, ObjectId>&     fixed_vars,
+          bool                           batch_execution = false);
 
     void begin(std::ostream&) override;
 
@@ -24,4 +25,12 @@ private:
     std::unique_ptr<BindingIdIter> root;
 
     BindingId binding_id;
+
+    // not null if the results of root are obtained with next_batch()
+    std::unique_ptr<BindingBatch> batch;
+
+    // position in the selection of batch of the next result
+    uint_fast32_t batch_pos;
+
+    const bool batch_execution;
 };
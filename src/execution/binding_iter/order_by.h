@@ -8,17 +8,18 @@
 #include "base/binding/binding_id.h"
 #include "base/binding/binding_iter.h"
 #include "base/thread/thread_info.h"
-#include "storage/file_id.h"
-#include "storage/tuple_collection/tuple_collection.h"
+#include "storage/tuple_collection/tuple_sorter.h"
 
+// OrderBy saves the vars `saved_vars` of the bindings of child and returns them ordered, see TupleSorter.
+// When only the first `limit` bindings will be read they are the only ones kept, UINT64_MAX keeps all of them.
 class OrderBy : public BindingIter {
 public:
     OrderBy(ThreadInfo*                  thread_info,
             std::unique_ptr<BindingIter> child,
             const std::set<VarId>&       saved_vars,
             std::vector<VarId>           order_vars,
-            std::vector<bool>            ascending);
-    ~OrderBy();
+            std::vector<bool>            ascending,
+            uint64_t                     limit);
 
     void begin(std::ostream&) override;
 
@@ -37,17 +38,10 @@ private:
     std::vector<VarId> order_vars;
     std::vector<bool> ascending;
 
-    TmpFileId first_file_id;
-    TmpFileId second_file_id;
+    uint64_t limit;
 
-    std::unique_ptr<TupleCollection> run;
-    TmpFileId* output_file_id;
-    uint_fast32_t total_pages = 0;
-    uint_fast32_t current_page = 0;
-    uint64_t page_position = 0;
+    std::unique_ptr<TupleSorter> sorter;
 
-    std::vector<GraphObject> saved_objects;
-
-    std::unique_ptr<TupleCollection> get_run(Page& run_page);
-    void merge_sort(const std::vector<VarId>& order_var_ids);
+    // the tuple of saved_vars returned by the sorter
+    const GraphObject* current_tuple = nullptr;
 };
@@ -5,15 +5,34 @@
 using namespace std;
 using namespace SPARQL;
 
-Where::Where(std::unique_ptr<BindingIdIter> root, uint_fast32_t binding_size) :
-    root(move(root)), binding_id(BindingId(binding_size)) { }
+Where::Where(std::unique_ptr<BindingIdIter> root, uint_fast32_t binding_size, bool batch_execution) :
+    root(move(root)), binding_id(BindingId(binding_size)), batch_execution(batch_execution) { }
 
 void Where::begin(std::ostream&) {
     root->begin(binding_id);
+    if (batch_execution) {
+        batch = make_unique<BindingBatch>(binding_id);
+        batch_pos = 0;
+    }
 }
 
 bool Where::next() {
-    return root->next();
+    if (batch == nullptr) {
+        return root->next();
+    }
+    while (batch_pos == batch->selected) {
+        batch_pos = 0;
+        // iters that produce the batch with next() continue from the binding of their last result, which may
+        // not be the last row loaded if it was not selected
+        if (batch->size > 0) {
+            batch->load_row(batch->size - 1);
+        }
+        if (!root->next_batch(*batch)) {
+            return false;
+        }
+    }
+    batch->load_row(batch->selection[batch_pos++]);
+    return true;
 }
 
 GraphObject Where::operator[](VarId var_id) const {
@@ -10,7 +10,7 @@ namespace SPARQL {
 
 class Where : public BindingIter {
 public:
-    Where(std::unique_ptr<BindingIdIter> root, uint_fast32_t binding_size);
+    Where(std::unique_ptr<BindingIdIter> root, uint_fast32_t binding_size, bool batch_execution = false);
 
     void begin(std::ostream&) override;
 
@@ -23,5 +23,13 @@ public:
 private:
     std::unique_ptr<BindingIdIter> root;
     BindingId                      binding_id;
+
+    // not null if the results of root are obtained with next_batch()
+    std::unique_ptr<BindingBatch> batch;
+
+    // position in the selection of batch of the next result
+    uint_fast32_t batch_pos;
+
+    const bool batch_execution;
 };
 } // namespace SPARQL
\ No newline at end of file
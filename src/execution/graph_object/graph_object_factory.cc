@@ -58,8 +58,9 @@ private:
     GraphObjectUnion(StringInlined n) : str_inlined(n) { }
     GraphObjectUnion(StringExternal n) : str_external(n) { }
     GraphObjectUnion(StringTmp n) : str_tmp(n) { }
-    GraphObjectUnion(bool n) : b(n) { }
-    GraphObjectUnion(float n) : f(n) { }
+    // bool and float don't fill the 8 bytes read as encoded_value, the rest must be zero to compare equal objects
+    GraphObjectUnion(bool n) : i(0) { b = n; }
+    GraphObjectUnion(float n) : i(0) { f = n; }
     GraphObjectUnion(IriInlined n) : iri_inlined(n) { }
     GraphObjectUnion(IriExternal n) : iri_external(n) { }
     GraphObjectUnion(IriTmp n) : iri_tmp(n) { }
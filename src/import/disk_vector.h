@@ -62,10 +62,13 @@ public:
         total_tuples = file_length / (N*sizeof(uint64_t));
     }
 
+    // if `compressed_leaves` is true the B+Trees are created with compressed leaves
     void start_indexing(char* new_buffer,
                         size_t max_buffer_size,
-                        std::array<size_t, N> original_permutation)
+                        std::array<size_t, N> original_permutation,
+                        bool compressed_leaves = false)
     {
+        this->compressed_leaves = compressed_leaves;
         // free append buffer
         free(buffer);
         current_permutation = original_permutation;
@@ -123,7 +126,7 @@ private:
     }
 
     void merge_sort(const std::string& base_name, StatsProcessor<N>& stat_processor) {
-        BPTLeafWriter<N> leaf_writer(base_name + ".leaf");
+        BPTLeafWriter<N> leaf_writer(base_name + ".leaf", compressed_leaves);
         BPTDirWriter<N> dir_writer(base_name + ".dir");
 
         file.seekg(0, file.end);
@@ -155,41 +158,23 @@ private:
                                             ? max_blocks_per_run
                                             : (total_blocks % max_blocks_per_run);
 
-        assert(total_runs*block_size + (BPTLeafWriter<N>::max_records*N*sizeof(uint64_t)) <= buffer_size);
+        assert(total_runs*block_size <= buffer_size);
         file.seekg(0, file.beg);
 
         if (total_runs == 1) {
-            uint32_t leaf_current_block = 0;
+            const size_t tuples_per_read = BPTLeafWriter<N>::max_records();
             size_t current_tuple = 0;
             while (current_tuple < total_tuples) {
-                file.read(buffer, N*sizeof(uint64_t)*BPTLeafWriter<N>::max_records);
-
-                // skip first leaf from going into bulk_import
-                if (current_tuple > 0) {
-                    dir_writer.bulk_insert(reinterpret_cast<std::array<uint64_t, N>*>(buffer),
-                                           0,
-                                           leaf_current_block);
-                }
-
-                if (current_tuple + leaf_writer.max_records < total_tuples) {
-                    current_tuple += leaf_writer.max_records;
-                    leaf_writer.process_block(buffer,
-                                              leaf_writer.max_records,
-                                              ++leaf_current_block);
-                    for (size_t i = 0; i < leaf_writer.max_records; i++) {
-                        stat_processor.process_tuple(*(reinterpret_cast<std::array<uint64_t, N>*>(buffer) + i));
-                    }
-                } else {
-                    auto remaining_tuples = total_tuples - current_tuple;
-                    leaf_writer.process_block(buffer,
-                                              remaining_tuples,
-                                              0);
-                    for (size_t i = 0; i < remaining_tuples; i++) {
-                        stat_processor.process_tuple(*(reinterpret_cast<std::array<uint64_t, N>*>(buffer) + i));
-                    }
-                    break;
+                file.read(buffer, N*sizeof(uint64_t)*tuples_per_read);
+                const auto tuples = std::min(tuples_per_read, total_tuples - current_tuple);
+                auto block = reinterpret_cast<std::array<uint64_t, N>*>(buffer);
+                for (size_t i = 0; i < tuples; i++) {
+                    leaf_writer.append(block[i], dir_writer);
+                    stat_processor.process_tuple(block[i]);
                 }
+                current_tuple += tuples;
             }
+            leaf_writer.finish(dir_writer);
             file.clear();
             return;
         }
@@ -226,33 +211,12 @@ private:
             end_pos[last_run] = start_pos[last_run] + tuples_in_last_block;
         }
 
-        auto output_block = reinterpret_cast<std::array<uint64_t, N>*>(
-            buffer + (total_runs*block_size));
-
-        auto output_block_curr = 0;
-
-        uint32_t leaf_current_block = 0;
-        uint32_t leaf_last_block = division_round_up(total_tuples, BPTLeafWriter<N>::max_records);
         // Merge runs
         while (!queue.empty()) {
             const auto pair = queue.top();
             queue.pop();
-            if (output_block_curr == BPTLeafWriter<N>::max_records) {
-                // skip first leaf
-                if (leaf_current_block > 0) {
-                    dir_writer.bulk_insert(output_block, 0, leaf_current_block);
-                }
-                ++leaf_current_block;
-                uint32_t next_bpt_block = leaf_current_block < leaf_last_block ? leaf_current_block : 0;
-                leaf_writer.process_block((char*)output_block,
-                                          leaf_writer.max_records,
-                                          next_bpt_block);
-                output_block_curr = 0;
-            }
             stat_processor.process_tuple(pair.first);
-
-            output_block[output_block_curr] = pair.first;
-            output_block_curr++;
+            leaf_writer.append(pair.first, dir_writer);
 
             const auto min_run = pair.second;
             current_pos[min_run]++;
@@ -281,14 +245,7 @@ private:
             queue.push(std::make_pair(*current_pos[min_run],
                                       min_run));
         }
-        // write remaining output_block
-        if (output_block_curr != 0) {
-            // skip first leaf
-            if (leaf_current_block > 0) {
-                dir_writer.bulk_insert(output_block, 0, leaf_current_block);
-            }
-            leaf_writer.process_block((char*)output_block, output_block_curr, 0);
-        }
+        leaf_writer.finish(dir_writer);
 
         // delete aux arrays
         delete[](start_pos);
@@ -456,5 +413,7 @@ private:
     size_t iter_buffer_offset;
 
     char* buffer;
+
+    bool compressed_leaves = false;
 };
 } // namespace Import
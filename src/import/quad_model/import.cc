@@ -128,7 +128,7 @@ void OnDiskImport::start_import(const std::string& input_filename) {
 
         NoStat<1> no_stat;
 
-        declared_nodes.start_indexing(buffer, buffer_size, original_permutation);
+        declared_nodes.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
         declared_nodes.create_bpt(db_folder + "/nodes",
                                   { COL_NODE },
                                    no_stat);
@@ -146,7 +146,7 @@ void OnDiskImport::start_import(const std::string& input_filename) {
         NoStat<2> no_stat;
         LabelStat label_stat;
 
-        labels.start_indexing(buffer, buffer_size, original_permutation);
+        labels.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
         catalog.label_count = labels.total_tuples;
         labels.create_bpt(db_folder + "/node_label",
                           { COL_NODE, COL_LABEL },
@@ -169,25 +169,31 @@ void OnDiskImport::start_import(const std::string& input_filename) {
         size_t COL_OBJ = 0, COL_KEY = 1, COL_VALUE = 2;
         std::array<size_t, 3> original_permutation = { COL_OBJ, COL_KEY, COL_VALUE };
 
-        NoStat<3> no_stat;
+        // the histograms of key_value_object need the count of each key, computed in the first pass
+        ColumnCountStat<3> key_count_stat(COL_KEY);
         PropStat prop_stat;
+        PropValueStat prop_value_stat(key_count_stat.dict);
+        MultiStat<3> key_value_object_stat({ &prop_stat, &prop_value_stat });
 
-        properties.start_indexing(buffer, buffer_size, original_permutation);
+        properties.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
         catalog.properties_count = properties.total_tuples;
         properties.create_bpt(db_folder + "/object_key_value",
                               { COL_OBJ, COL_KEY, COL_VALUE },
-                              no_stat);
+                              key_count_stat);
 
         properties.create_bpt(db_folder + "/key_value_object",
                               { COL_KEY, COL_VALUE, COL_OBJ },
-                              prop_stat);
+                              key_value_object_stat);
         prop_stat.end();
+        prop_value_stat.end();
 
         properties.finish_indexing();
 
         catalog.key2distinct    = move(prop_stat.map_distinct_values);
         catalog.key2total_count = move(prop_stat.map_key_count);
         catalog.distinct_keys   = catalog.key2total_count.size();
+        catalog.key2histogram   = move(prop_value_stat.map_histogram);
+        catalog.key2top_values  = move(prop_value_stat.map_top_values);
 
     }
     auto end_prop_index = std::chrono::system_clock::now();
@@ -198,30 +204,43 @@ void OnDiskImport::start_import(const std::string& input_filename) {
         size_t COL_FROM = 0, COL_TO = 1, COL_TYPE = 2, COL_EDGE = 3;
         std::array<size_t, 4> original_permutation = { COL_FROM, COL_TO, COL_TYPE, COL_EDGE };
 
-        edges.start_indexing(buffer, buffer_size, original_permutation);
+        edges.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
-        NoStat<4> no_stat;
         DistinctStat<4> distinct_from_stat;
         DistinctStat<4> distinct_to_stat;
+        TopKStat<4> top_from_stat;
+        TopKStat<4> top_to_stat;
+        MultiStat<4> from_stat({ &distinct_from_stat, &top_from_stat });
+        MultiStat<4> to_stat({ &distinct_to_stat, &top_to_stat });
+        GroupDistinctStat<4> type_distinct_from_stat;
+        GroupDistinctStat<4> type_distinct_to_stat;
 
         catalog.connections_count = edges.total_tuples;
         edges.create_bpt(db_folder + "/from_to_type_edge",
                          { COL_FROM, COL_TO, COL_TYPE, COL_EDGE },
-                         distinct_from_stat);
+                         from_stat);
+        top_from_stat.end();
         catalog.distinct_from = distinct_from_stat.distinct;
+        catalog.top_from      = std::move(top_from_stat.top_values);
 
         edges.create_bpt(db_folder + "/to_type_from_edge",
                          { COL_TO, COL_TYPE, COL_FROM, COL_EDGE },
-                         distinct_to_stat);
+                         to_stat);
+        top_to_stat.end();
         catalog.distinct_to = distinct_to_stat.distinct;
+        catalog.top_to     = std::move(top_to_stat.top_values);
 
         edges.create_bpt(db_folder + "/type_from_to_edge",
                          { COL_TYPE, COL_FROM, COL_TO, COL_EDGE },
-                         no_stat);
+                         type_distinct_from_stat);
+        type_distinct_from_stat.end();
+        catalog.type2distinct_from = move(type_distinct_from_stat.dict);
 
         edges.create_bpt(db_folder + "/type_to_from_edge",
                          { COL_TYPE, COL_TO, COL_FROM, COL_EDGE },
-                         no_stat);
+                         type_distinct_to_stat);
+        type_distinct_to_stat.end();
+        catalog.type2distinct_to = move(type_distinct_to_stat.dict);
 
         // set distinct_type, may be a redundant stat
         catalog.distinct_type = catalog.type2total_count.size();
@@ -236,7 +255,7 @@ void OnDiskImport::start_import(const std::string& input_filename) {
     {   // FROM=TO=TYPE EDGE
         size_t COL_FROM_TO_TYPE = 0, COL_EDGE = 1;
         std::array<size_t, 2> original_permutation = { COL_FROM_TO_TYPE, COL_EDGE };
-        equal_from_to_type.start_indexing(buffer, buffer_size, original_permutation);
+        equal_from_to_type.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         DictCountStat<2> stat;
         catalog.equal_from_to_type_count = equal_from_to_type.total_tuples;
@@ -252,7 +271,7 @@ void OnDiskImport::start_import(const std::string& input_filename) {
     {   // FROM=TO TYPE EDGE
         size_t COL_FROM_TO = 0, COL_TYPE = 1, COL_EDGE = 2;
         std::array<size_t, 3> original_permutation = { COL_FROM_TO, COL_TYPE, COL_EDGE };
-        equal_from_to.start_indexing(buffer, buffer_size, original_permutation);
+        equal_from_to.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         NoStat<3> no_stat;
         catalog.equal_from_to_count = equal_from_to.total_tuples;
@@ -274,7 +293,7 @@ void OnDiskImport::start_import(const std::string& input_filename) {
     {   // FROM=TYPE TO EDGE
         size_t COL_FROM_TYPE = 0, COL_TO = 1, COL_EDGE = 2;
         std::array<size_t, 3> original_permutation = { COL_FROM_TYPE, COL_TO, COL_EDGE };
-        equal_from_type.start_indexing(buffer, buffer_size, original_permutation);
+        equal_from_type.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         DictCountStat<3> stat;
         catalog.equal_from_type_count = equal_from_type.total_tuples;
@@ -295,7 +314,7 @@ void OnDiskImport::start_import(const std::string& input_filename) {
     {   // TO=TYPE FROM EDGE
         size_t COL_TO_TYPE = 0, COL_FROM = 1, COL_EDGE = 2;
         std::array<size_t, 3> original_permutation = { COL_TO_TYPE, COL_FROM, COL_EDGE };
-        equal_to_type.start_indexing(buffer, buffer_size, original_permutation);
+        equal_to_type.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         DictCountStat<3> stat;
         catalog.equal_to_type_count = equal_to_type.total_tuples;
@@ -15,7 +15,8 @@
 namespace Import {
 class OnDiskImport {
 public:
-    OnDiskImport(const std::string& db_folder, size_t buffer_size_in_GB) :
+    // `compressed_leaves` selects the leaf format of the B+Trees, see BPTLeafCodec
+    OnDiskImport(const std::string& db_folder, size_t buffer_size_in_GB, bool compressed_leaves = false) :
         buffer_size_in_GB   (buffer_size_in_GB),
         db_folder           (db_folder),
         catalog             (QuadCatalog("catalog.dat")),
@@ -28,6 +29,7 @@ public:
         equal_to_type       (db_folder + "/tmp_equal_to_type"),
         equal_from_to_type  (db_folder + "/tmp_equal_from_to_type")
     {
+        catalog.compressed_leaves = compressed_leaves;
         state_transitions = new int[Token::TOTAL_TOKENS*State::TOTAL_STATES];
         create_automata();
     }
@@ -171,26 +171,40 @@ void OnDiskImport::start_import(const std::string& input_filename, const std::st
         size_t COL_SUBJ = 0, COL_PRED = 1, COL_OBJ = 2;
         std::array<size_t, 3> original_permutation = { COL_SUBJ, COL_PRED, COL_OBJ };
 
-        triples.start_indexing(buffer, buffer_size, original_permutation);
-
-        Import::DistinctStat<3> subject_stat;
-        Import::PredicateStat   predicate_stat;
-        Import::DistinctStat<3> object_stat;
-        Import::NoStat<3>       no_stat;
+        triples.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
+
+        Import::DistinctStat<3>      subject_stat;
+        Import::TopKStat<3>          top_subject_stat;
+        Import::MultiStat<3>         spo_stat({ &subject_stat, &top_subject_stat });
+        Import::PredicateStat        predicate_stat;
+        Import::GroupDistinctStat<3> predicate_objects_stat;
+        Import::MultiStat<3>         pos_stat({ &predicate_stat, &predicate_objects_stat });
+        Import::DistinctStat<3>      object_stat;
+        Import::TopKStat<3>          top_object_stat;
+        Import::MultiStat<3>         osp_stat({ &object_stat, &top_object_stat });
+        Import::GroupDistinctStat<3> predicate_subjects_stat;
 
         catalog.triples_count = triples.total_tuples;
-        triples.create_bpt(db_folder + "/spo", { COL_SUBJ, COL_PRED, COL_OBJ }, subject_stat);
+        triples.create_bpt(db_folder + "/spo", { COL_SUBJ, COL_PRED, COL_OBJ }, spo_stat);
+        top_subject_stat.end();
         catalog.distinct_subjects = subject_stat.distinct;
+        catalog.top_subjects      = std::move(top_subject_stat.top_values);
 
-        triples.create_bpt(db_folder + "/pos", { COL_PRED, COL_OBJ, COL_SUBJ }, predicate_stat);
+        triples.create_bpt(db_folder + "/pos", { COL_PRED, COL_OBJ, COL_SUBJ }, pos_stat);
         predicate_stat.end();
+        predicate_objects_stat.end();
         catalog.distinct_predicates = predicate_stat.distinct_values;
         catalog.predicate2total_count = move(predicate_stat.map_predicate_count);
+        catalog.predicate2distinct_objects = move(predicate_objects_stat.dict);
 
-        triples.create_bpt(db_folder + "/osp", { COL_OBJ, COL_SUBJ, COL_PRED }, object_stat);
+        triples.create_bpt(db_folder + "/osp", { COL_OBJ, COL_SUBJ, COL_PRED }, osp_stat);
+        top_object_stat.end();
         catalog.distinct_objects = object_stat.distinct;
+        catalog.top_objects     = std::move(top_object_stat.top_values);
 
-        triples.create_bpt(db_folder + "/pso", { COL_PRED, COL_SUBJ, COL_OBJ }, no_stat);
+        triples.create_bpt(db_folder + "/pso", { COL_PRED, COL_SUBJ, COL_OBJ }, predicate_subjects_stat);
+        predicate_subjects_stat.end();
+        catalog.predicate2distinct_subjects = move(predicate_subjects_stat.dict);
 
         triples.finish_indexing();
     }
@@ -202,7 +216,7 @@ void OnDiskImport::start_import(const std::string& input_filename, const std::st
     { // SUBJECT=PREDICATE=OBJECT
         size_t COL_SUBJ_PRED_OBJ = 0;
         std::array<size_t, 1> original_permutation = { COL_SUBJ_PRED_OBJ };
-        equal_spo.start_indexing(buffer, buffer_size, original_permutation);
+        equal_spo.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         Import::NoStat<1> no_stat;
         catalog.equal_spo_count = equal_spo.total_tuples;
@@ -216,7 +230,7 @@ void OnDiskImport::start_import(const std::string& input_filename, const std::st
     { // SUBJECT=PREDICATE OBJECT
         size_t COL_SUBJ_PRED = 0, COL_OBJ = 1;
         std::array<size_t, 2> original_permutation = { COL_SUBJ_PRED, COL_OBJ };
-        equal_sp.start_indexing(buffer, buffer_size, original_permutation);
+        equal_sp.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         Import::NoStat<2> no_stat;
         catalog.equal_sp_count = equal_sp.total_tuples;
@@ -235,7 +249,7 @@ void OnDiskImport::start_import(const std::string& input_filename, const std::st
     { // SUBJECT=OBJECT PREDICATE
         size_t COL_SUBJ_OBJ = 0, COL_PRED = 1;
         std::array<size_t, 2> original_permutation = { COL_SUBJ_OBJ, COL_PRED };
-        equal_so.start_indexing(buffer, buffer_size, original_permutation);
+        equal_so.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         Import::NoStat<2> no_stat;
         catalog.equal_so_count = equal_so.total_tuples;
@@ -253,7 +267,7 @@ void OnDiskImport::start_import(const std::string& input_filename, const std::st
     { // PREDICATE=OBJECT SUBJECT
         size_t COL_PRED_OBJ = 0, COL_SUBJ = 1;
         std::array<size_t, 2> original_permutation = { COL_PRED_OBJ, COL_SUBJ };
-        equal_po.start_indexing(buffer, buffer_size, original_permutation);
+        equal_po.start_indexing(buffer, buffer_size, original_permutation, catalog.compressed_leaves);
 
         Import::NoStat<2> no_stat;
         catalog.equal_po_count = equal_po.total_tuples;
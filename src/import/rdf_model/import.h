@@ -20,7 +20,8 @@
 namespace ImportRdf {
 class OnDiskImport {
 public:
-    OnDiskImport(const std::string& db_folder, size_t buffer_size_in_GB) :
+    // `compressed_leaves` selects the leaf format of the B+Trees, see BPTLeafCodec
+    OnDiskImport(const std::string& db_folder, size_t buffer_size_in_GB, bool compressed_leaves = false) :
         buffer_size_in_GB (buffer_size_in_GB),
         db_folder         (db_folder),
         catalog           (RdfCatalog("catalog.dat")),
@@ -28,7 +29,10 @@ public:
         equal_spo         (db_folder + "/tmp_equal_spo"),
         equal_sp          (db_folder + "/tmp_equal_sp"),
         equal_so          (db_folder + "/tmp_equal_so"),
-        equal_po          (db_folder + "/tmp_equal_po") { }
+        equal_po          (db_folder + "/tmp_equal_po")
+    {
+        catalog.compressed_leaves = compressed_leaves;
+    }
 
     // Serd reader
     SerdReader* reader;
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdlib>
+#include <functional>
+#include <initializer_list>
+#include <queue>
+#include <vector>
 
+#include "storage/catalog/column_stats.h"
 #include "third_party/robin_hood/robin_hood.h"
 
 namespace Import {
@@ -63,6 +69,207 @@ public:
     }
 };
 
+template<size_t N>
+class MultiStat : public StatsProcessor<N> {
+    // passes the tuples to many processors, to compute many stats with the same ordering
+public:
+    std::vector<StatsProcessor<N>*> processors;
+
+    MultiStat(std::initializer_list<StatsProcessor<N>*> processors) :
+        processors (processors) { }
+
+    void process_tuple(const std::array<uint64_t, N>& tuple) override {
+        for (auto processor : processors) {
+            processor->process_tuple(tuple);
+        }
+    }
+};
+
+// keeps the k pairs (value, count) with the greatest counts
+class TopKHeap {
+public:
+    TopKHeap(size_t k) : k (k) { }
+
+    void push(uint64_t value, uint64_t count) {
+        if (heap.size() < k) {
+            heap.push({ count, value });
+        } else if (k > 0 && count > heap.top().first) {
+            heap.pop();
+            heap.push({ count, value });
+        }
+    }
+
+    // empties the heap
+    TopValues get_top_values() {
+        std::vector<std::pair<uint64_t, uint64_t>> values;
+        while (!heap.empty()) {
+            values.push_back({ heap.top().second, heap.top().first });
+            heap.pop();
+        }
+        TopValues res;
+        res.set(std::move(values));
+        return res;
+    }
+
+private:
+    size_t k;
+
+    // min-heap of pairs (count, value)
+    std::priority_queue<std::pair<uint64_t, uint64_t>,
+                        std::vector<std::pair<uint64_t, uint64_t>>,
+                        std::greater<std::pair<uint64_t, uint64_t>>> heap;
+};
+
+template<size_t N>
+class TopKStat : public StatsProcessor<N> {
+    // computes the k most frequent values of the first column, assuming it is ordered
+public:
+    static constexpr size_t DEFAULT_K = 100;
+
+    TopValues top_values;
+
+    TopKStat(size_t k = DEFAULT_K) : heap (k) { }
+
+    void process_tuple(const std::array<uint64_t, N>& tuple) override {
+        if (tuple[0] == current) {
+            ++count;
+        } else {
+            if (current != 0) {
+                heap.push(current, count);
+            }
+            current = tuple[0];
+            count   = 1;
+        }
+    }
+
+    void end() {
+        if (current != 0) {
+            heap.push(current, count);
+        }
+        top_values = heap.get_top_values();
+    }
+
+private:
+    TopKHeap heap;
+    uint64_t current = 0;
+    uint64_t count   = 0;
+};
+
+template<size_t N>
+class GroupDistinctStat : public StatsProcessor<N> {
+    // computes how many different values of the second column has each value of the first column,
+    // assuming they are ordered
+public:
+    uint64_t current_group  = 0;
+    uint64_t current_value  = 0;
+    uint64_t distinct_count = 0;
+
+    robin_hood::unordered_map<uint64_t, uint64_t> dict;
+
+    void process_tuple(const std::array<uint64_t, N>& tuple) override {
+        if (tuple[0] == current_group) {
+            if (tuple[1] != current_value) {
+                ++distinct_count;
+                current_value = tuple[1];
+            }
+        } else {
+            if (current_group != 0) {
+                dict.insert({ current_group, distinct_count });
+            }
+            current_group  = tuple[0];
+            current_value  = tuple[1];
+            distinct_count = 1;
+        }
+    }
+
+    void end() {
+        if (current_group != 0) {
+            dict.insert({ current_group, distinct_count });
+        }
+    }
+};
+
+template<size_t N>
+class ColumnCountStat : public StatsProcessor<N> {
+    // computes how many elements have each one of the values of a column, the column doesn't need to be ordered
+public:
+    robin_hood::unordered_map<uint64_t, uint64_t> dict;
+
+    ColumnCountStat(size_t column) : column (column) { }
+
+    void process_tuple(const std::array<uint64_t, N>& tuple) override {
+        ++dict[tuple[column]];
+    }
+
+private:
+    size_t column;
+};
+
+class PropValueStat : public StatsProcessor<3> {
+    // computes an equi-depth histogram and the most frequent values of each key, assuming the tuples are ordered
+    // by key and value. The number of properties of each key must be known to have buckets of the same size.
+public:
+    static constexpr size_t HISTOGRAM_BUCKETS = 32;
+    static constexpr size_t TOP_VALUES        = 16;
+
+    robin_hood::unordered_map<uint64_t, EquiDepthHistogram> map_histogram;
+    robin_hood::unordered_map<uint64_t, TopValues>          map_top_values;
+
+    PropValueStat(const robin_hood::unordered_map<uint64_t, uint64_t>& key_count) :
+        key_count (key_count),
+        heap      (TOP_VALUES) { }
+
+    void process_tuple(const std::array<uint64_t, 3>& tuple) override {
+        if (tuple[0] != current_key) {
+            end();
+            current_key   = tuple[0];
+            current_value = tuple[1];
+            value_count   = 0;
+            position      = 0;
+
+            auto search = key_count.find(current_key);
+            const uint64_t total = search == key_count.end() ? 0 : search->second;
+            bucket_size = std::max<uint64_t>(1, (total + HISTOGRAM_BUCKETS - 1) / HISTOGRAM_BUCKETS);
+            histogram = EquiDepthHistogram();
+            histogram.min = tuple[1];
+        } else if (tuple[1] != current_value) {
+            heap.push(current_value, value_count);
+            current_value = tuple[1];
+            value_count   = 0;
+        }
+        ++value_count;
+        ++position;
+        if (position % bucket_size == 0) {
+            histogram.bounds.push_back(current_value);
+        }
+    }
+
+    // saves the stats of the last key, must be called after processing all the tuples
+    void end() {
+        if (current_key != 0) {
+            if (position % bucket_size != 0) {
+                histogram.bounds.push_back(current_value);
+            }
+            heap.push(current_value, value_count);
+            map_histogram.insert({ current_key, std::move(histogram) });
+            map_top_values.insert({ current_key, heap.get_top_values() });
+            current_key = 0;
+        }
+    }
+
+private:
+    const robin_hood::unordered_map<uint64_t, uint64_t>& key_count;
+
+    TopKHeap heap;
+    EquiDepthHistogram histogram;
+
+    uint64_t current_key   = 0;
+    uint64_t current_value = 0;
+    uint64_t value_count   = 0;
+    uint64_t position      = 0;
+    uint64_t bucket_size   = 1;
+};
+
 class PropStat : public StatsProcessor<3> {
 public:
     uint64_t current_value   = 0;
@@ -1,9 +1,10 @@
 #include "binding_id_iter_visitor.h"
 
 #include <cassert>
-#include <iostream>
 
+#include "execution/binding_id_iter/id_filter.h"
 #include "execution/binding_id_iter/optional_node.h"
+#include "execution/binding_id_iter/profiled_binding_id_iter.h"
 #include "execution/binding_id_iter/empty_binding_id_iter.h"
 #include "execution/binding_id_iter/single_result_binding_id_iter.h"
 #include "query_optimizer/quad_model/quad_model.h"
@@ -12,6 +13,7 @@
 #include "query_optimizer/quad_model/plan/basic/path_plan.h"
 #include "query_optimizer/quad_model/plan/basic/property_plan.h"
 #include "query_optimizer/quad_model/plan/basic/unjoint_object_plan.h"
+#include "query_optimizer/quad_model/plan/filter_plan.h"
 // #include "query_optimizer/quad_model/plan/join/hash_join_plan.h"
 #include "query_optimizer/quad_model/join_order/greedy_optimizer.h"
 #include "query_optimizer/quad_model/join_order/leapfrog_optimizer.h"
@@ -22,14 +24,64 @@ using namespace std;
 
 constexpr auto MAX_SELINGER_PLANS = 0;
 
+namespace {
+    /* Returns the ranges of ObjectIds that can satisfy the comparisons of value_var with integers. Integers
+     * are encoded preserving the order, so the comparisons give an interval of them. Floats are compared with
+     * integers by their numeric value but their ObjectIds don't preserve the order, so all of them are
+     * included. Other types are never greater than an integer, so if there is a lower bound they are excluded.
+     * Returns an empty vector when there isn't a lower bound.
+     */
+    PropertyPlan::ValueRanges get_value_ranges(const vector<IdCondition>& conditions, const Var& value_var) {
+        uint64_t min = ObjectId::MASK_NEGATIVE_INT;
+        uint64_t max = ObjectId::MASK_POSITIVE_INT | ObjectId::VALUE_MASK;
+        bool lower_bound = false;
+
+        for (auto& condition : conditions) {
+            if (condition.var != value_var || !std::holds_alternative<int64_t>(condition.constant.value)) {
+                continue;
+            }
+            const auto id = quad_model.get_object_id(condition.constant).id;
+            switch (condition.op) {
+            case IdFilter::Operator::GREATER_OR_EQUALS:
+                min = std::max(min, id);
+                lower_bound = true;
+                break;
+            case IdFilter::Operator::GREATER:
+                min = std::max(min, id + 1);
+                lower_bound = true;
+                break;
+            case IdFilter::Operator::LESS_OR_EQUALS:
+                max = std::min(max, id);
+                break;
+            case IdFilter::Operator::LESS:
+                max = std::min(max, id - 1);
+                break;
+            default:
+                break;
+            }
+        }
+
+        PropertyPlan::ValueRanges res;
+        if (lower_bound) {
+            if (min <= max) {
+                res.push_back({ min, max });
+            }
+            res.push_back({ ObjectId::MASK_FLOAT, ObjectId::MASK_FLOAT | ObjectId::VALUE_MASK });
+        }
+        return res;
+    }
+}
+
 BindingIdIterVisitor::BindingIdIterVisitor(ThreadInfo* thread_info,
                                            const map<Var, VarId>& var2var_id,
                                            map<VarId, ObjectId>& fixed_vars,
-                                           const vector<tuple<Var, string, QueryElement>>& where_properties) :
-    var2var_id       (var2var_id),
-    fixed_vars       (fixed_vars),
-    where_properties (where_properties),
-    thread_info      (thread_info) { }
+                                           const vector<tuple<Var, string, QueryElement>>& where_properties,
+                                           const vector<IdCondition>& where_id_conditions) :
+    var2var_id          (var2var_id),
+    fixed_vars          (fixed_vars),
+    where_properties    (where_properties),
+    where_id_conditions (where_id_conditions),
+    thread_info         (thread_info) { }
 
 
 VarId BindingIdIterVisitor::get_var_id(const Var& var) const {
@@ -63,6 +115,25 @@ void BindingIdIterVisitor::visit(OpBasicGraphPattern& op_basic_graph_pattern) {
         op_basic_graph_pattern.add_property(OpProperty(var, key, value));
     }
 
+    // A property compared with > or >= can't be null, so if its object is in the main basic graph pattern the
+    // property is mandatory and it can be searched there instead of in an optional child
+    const bool main_pattern = !main_pattern_visited;
+    main_pattern_visited = true;
+    vector<const IdCondition*> mandatory_properties;
+    if (main_pattern) {
+        for (auto& condition : where_id_conditions) {
+            if (condition.property
+                && (condition.op == IdFilter::Operator::GREATER
+                    || condition.op == IdFilter::Operator::GREATER_OR_EQUALS)
+                && op_basic_graph_pattern.vars.find(condition.property->first) != op_basic_graph_pattern.vars.end()
+                && fixed_vars.find(get_var_id(condition.var)) == fixed_vars.end())
+            {
+                where_vars.insert(condition.property->first);
+                mandatory_properties.push_back(&condition);
+            }
+        }
+    }
+
     vector<unique_ptr<Plan>> base_plans;
 
     // Process Isolated Vars
@@ -111,6 +182,23 @@ void BindingIdIterVisitor::visit(OpBasicGraphPattern& op_basic_graph_pattern) {
         );
     }
 
+    // Process mandatory properties of the where (value is a var)
+    std::set<VarId> mandatory_property_vars;
+    for (auto condition : mandatory_properties) {
+        auto value_var = get_var_id(condition->var);
+        if (fixed_vars.find(value_var) != fixed_vars.end()
+            || !mandatory_property_vars.insert(value_var).second)
+        {
+            continue;
+        }
+        auto obj_id = get_id(QueryElement(condition->property->first));
+        auto key_id = quad_model.get_object_id(QueryElement(condition->property->second));
+
+        base_plans.push_back(
+            make_unique<PropertyPlan>(obj_id, key_id, value_var, get_value_ranges(where_id_conditions, condition->var))
+        );
+    }
+
     // Process connections
     for (auto& op_edge : op_basic_graph_pattern.edges) {
         auto from_id = get_id(op_edge.from);
@@ -149,6 +237,32 @@ void BindingIdIterVisitor::visit(OpBasicGraphPattern& op_basic_graph_pattern) {
         return;
     }
 
+    // Evaluate the comparisons of the where as soon as their variable is assigned
+    vector<IdFilter::Condition> id_filter_conditions;
+    if (main_pattern) {
+        std::set<VarId> pattern_vars;
+        for (auto& plan : base_plans) {
+            for (auto var : plan->get_vars()) {
+                pattern_vars.insert(var);
+            }
+        }
+        for (auto& condition : where_id_conditions) {
+            auto var_id = get_var_id(condition.var);
+            if (pattern_vars.find(var_id) != pattern_vars.end()) {
+                id_filter_conditions.push_back({ var_id,
+                                                 condition.op,
+                                                 condition.constant,
+                                                 quad_model.get_object_id(condition.constant) });
+                id_filtered_vars.insert(var_id);
+            }
+        }
+        if (id_filter_conditions.size() > 0) {
+            for (auto& plan : base_plans) {
+                plan = make_unique<FilterPlan>(move(plan), id_filter_conditions);
+            }
+        }
+    }
+
     // Set input vars
     for (auto& plan : base_plans) {
         plan->set_input_vars(assigned_vars);
@@ -156,7 +270,16 @@ void BindingIdIterVisitor::visit(OpBasicGraphPattern& op_basic_graph_pattern) {
 
     // try to use leapfrog if there is a join
     if (base_plans.size() > 1) {
-        tmp = LeapfrogOptimizer::try_get_iter(thread_info, base_plans, var_names, binding_size);
+        // the join is executed in parallel only when it doesn't receive assigned vars, otherwise it would start
+        // the workers again for every binding of the outer join
+        const auto workers = assigned_vars.empty() ? thread_info->leapfrog_workers : 1;
+        tmp = LeapfrogOptimizer::try_get_iter(thread_info, base_plans, var_names, binding_size, workers);
+
+        // FilterPlan can't evaluate the conditions inside the LeapfrogJoin
+        if (tmp != nullptr && id_filter_conditions.size() > 0) {
+            tmp = make_unique<IdFilter>(ProfiledBindingIdIter::wrap(move(tmp), thread_info),
+                                        move(id_filter_conditions));
+        }
     }
 
     if (tmp == nullptr) {
@@ -168,12 +291,9 @@ void BindingIdIterVisitor::visit(OpBasicGraphPattern& op_basic_graph_pattern) {
             root_plan = GreedyOptimizer::get_plan(base_plans, var_names);
         }
 
-        std::cout << "\nPlan Generated:\n";
-        root_plan->print(std::cout, true, var_names);
-        std::cout << "\nestimated cost: " << root_plan->estimate_cost() << "\n";
-
         tmp = root_plan->get_binding_id_iter(thread_info);
     }
+    tmp = ProfiledBindingIdIter::wrap(move(tmp), thread_info);
 
     // insert new assigned_vars
     for (auto& plan : base_plans) {
@@ -200,7 +320,8 @@ void BindingIdIterVisitor::visit(OpOptional& op_optional) {
     }
 
     assert(tmp == nullptr);
-    tmp = make_unique<OptionalNode>(move(binding_id_iter), move(optional_children));
+    tmp = ProfiledBindingIdIter::wrap(make_unique<OptionalNode>(move(binding_id_iter), move(optional_children)),
+                                      thread_info);
 }
 
 
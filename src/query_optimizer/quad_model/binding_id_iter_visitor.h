@@ -11,6 +11,7 @@
 #include "base/query/var.h"
 #include "base/thread/thread_info.h"
 #include "parser/query/op/mdb/ops.h"
+#include "query_optimizer/quad_model/expr/expr_to_binding_condition.h"
 
 class BindingIdIter;
 class NodeId;
@@ -20,7 +21,8 @@ public:
     BindingIdIterVisitor(ThreadInfo* thread_info,
                          const std::map<Var, VarId>& var2var_id,
                          std::map<VarId, ObjectId>& fixed_vars,
-                         const std::vector<std::tuple<Var, std::string, QueryElement>>& where_properties);
+                         const std::vector<std::tuple<Var, std::string, QueryElement>>& where_properties,
+                         const std::vector<IdCondition>& where_id_conditions);
 
     // const std::vector<query::ast::SelectItem> select_items;
     const std::map<Var, VarId>& var2var_id;
@@ -32,6 +34,13 @@ public:
     // Properties from a where clause that are mandatory (so they are pushed into the basic graph pattern)
     const std::vector<std::tuple<Var, std::string, QueryElement>>& where_properties;
 
+    // Comparisons from a where clause that are evaluated on the ObjectIds (see IdFilter). They are pushed into
+    // the main basic graph pattern when it assigns their variable
+    const std::vector<IdCondition>& where_id_conditions;
+
+    // Variables whose where_id_conditions were evaluated in the main basic graph pattern
+    std::set<VarId> id_filtered_vars;
+
     // Variables that are assigned when evaluating the basic graph pattern, but the optimizer don't know
     // the value (e.g. OPTIONALS)
     std::set<VarId> assigned_vars;
@@ -65,6 +74,9 @@ public:
     void visit(MDB::OpProperty&)     override { }
 
 private:
+    // The first basic graph pattern visited is the main one, the others are optional
+    bool main_pattern_visited = false;
+
     Id get_id(const QueryElement&) const;
 
     bool term_exists(ObjectId) const;
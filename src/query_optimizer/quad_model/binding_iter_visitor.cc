@@ -1,6 +1,7 @@
 #include "binding_iter_visitor.h"
 
 #include "execution/binding_id_iter/distinct_id_hash.h"
+#include "execution/binding_id_iter/id_filter.h"
 #include "execution/binding_id_iter/index_scan.h"
 #include "execution/binding_id_iter/optional_node.h"
 #include "execution/binding_id_iter/paths/path_manager.h"
@@ -18,7 +19,6 @@
 #include "execution/binding_iter/return.h"
 #include "execution/binding_iter/where.h"
 #include "query_optimizer/quad_model/binding_id_iter_visitor.h"
-#include "query_optimizer/quad_model/expr/expr_to_binding_condition.h"
 #include "query_optimizer/quad_model/return_item_visitor_impl.h"
 #include "query_optimizer/quad_model/quad_model.h"
 
@@ -127,6 +127,11 @@ void BindingIterVisitor::visit(OpReturn& op_return) {
 
     distinct_into_id = op_return.distinct; // OpWhere may change this value when accepting visitor
 
+    // the results of an OrderBy are the results of the RETURN only without DISTINCT or aggregations
+    if (!op_return.distinct && aggs.empty()) {
+        order_by_limit = op_return.limit;
+    }
+
     op_return.op->accept_visitor(*this);
 
     // aggs.size will be 0 if GroupBy moved it
@@ -170,11 +175,12 @@ void BindingIterVisitor::visit(OpWhere& op_where) {
     // TODO: push negation inside, simplify constant expressions
 
     // This visitor separates what comes in the Where and what goes into the join
-    Expr2BindingExpr expr2binding_expr(var2var_id);
+    Expr2BindingExpr expr2binding_expr(var2var_id, thread_info->id_filters);
     op_where.expr->accept_visitor(expr2binding_expr);
 
     auto binding_expr = std::move(expr2binding_expr.current_binding_expr);
-    where_properties  = std::move(expr2binding_expr.properties);
+    where_properties    = std::move(expr2binding_expr.properties);
+    where_id_conditions = std::move(expr2binding_expr.id_conditions);
 
     op_where.op->accept_visitor(*this);
 
@@ -185,7 +191,7 @@ void BindingIterVisitor::visit(OpWhere& op_where) {
 
 
 void BindingIterVisitor::visit(OpMatch& op_match) {
-    BindingIdIterVisitor id_visitor(thread_info, var2var_id, fixed_vars, where_properties);
+    BindingIdIterVisitor id_visitor(thread_info, var2var_id, fixed_vars, where_properties, where_id_conditions);
     op_match.op->accept_visitor(id_visitor);
 
     unique_ptr<BindingIdIter> binding_id_iter_current_root = move(id_visitor.tmp);
@@ -203,8 +209,10 @@ void BindingIterVisitor::visit(OpMatch& op_match) {
         auto value_var  = get_var_id(Var(var.name + '.' + prop_name));
         auto key_id     = quad_model.get_object_id(QueryElement(prop_name));
 
-        // Check value_var does not have a constant value
-        if (fixed_vars.find(value_var) == fixed_vars.end()) {
+        // Check value_var does not have a constant value and it is not assigned in the MATCH
+        if (fixed_vars.find(value_var) == fixed_vars.end()
+            && id_visitor.assigned_vars.find(value_var) == id_visitor.assigned_vars.end())
+        {
             array<unique_ptr<ScanRange>, 3> ranges {
                 ScanRange::get(obj_var_id, true),
                 ScanRange::get(key_id, true),
@@ -218,16 +226,38 @@ void BindingIterVisitor::visit(OpMatch& op_match) {
         binding_id_iter_current_root = make_unique<OptionalNode>(move(binding_id_iter_current_root),
                                                                  move(optional_children));
     }
+
+    // Comparisons that could not be evaluated in the MATCH, e.g. properties assigned by the optional children
+    // or variables with a fixed value
+    vector<IdFilter::Condition> id_filter_conditions;
+    for (auto& condition : where_id_conditions) {
+        auto var_id = get_var_id(condition.var);
+        if (id_visitor.id_filtered_vars.find(var_id) == id_visitor.id_filtered_vars.end()) {
+            id_filter_conditions.push_back({ var_id,
+                                             condition.op,
+                                             condition.constant,
+                                             quad_model.get_object_id(condition.constant) });
+        }
+    }
+    if (id_filter_conditions.size() > 0) {
+        binding_id_iter_current_root = make_unique<IdFilter>(move(binding_id_iter_current_root),
+                                                             move(id_filter_conditions));
+    }
     if (distinct_into_id && aggs.size() == 0) {
         std::vector<VarId> projected_var_ids;
         for (const auto& [var, var_id] : projection_vars) {
             projected_var_ids.push_back(var_id);
         }
 
-        binding_id_iter_current_root = make_unique<DistinctIdHash>(move(binding_id_iter_current_root), move(projected_var_ids));
+        binding_id_iter_current_root = make_unique<DistinctIdHash>(move(binding_id_iter_current_root),
+                                                                   move(projected_var_ids),
+                                                                   thread_info);
     }
 
-    tmp = make_unique<Match>(move(binding_id_iter_current_root), binding_size, fixed_vars);
+    tmp = make_unique<Match>(move(binding_id_iter_current_root),
+                             binding_size,
+                             fixed_vars,
+                             thread_info->batch_execution);
 }
 
 
@@ -261,7 +291,16 @@ void BindingIterVisitor::visit(OpOrderBy& op_order_by) {
     // e.g. if we have ORDER BY ?x, ?z, ?y RETURN DISTINCT ?x, ?y we can't use DistinctOrdered
 
     op_order_by.op->accept_visitor(*this);
-    tmp = make_unique<OrderBy>(thread_info, move(tmp), saved_vars, order_vars, op_order_by.ascending_order);
+    // aggregations of the ORDER BY are computed over its results
+    if (!aggs.empty()) {
+        order_by_limit = UINT64_MAX;
+    }
+    tmp = make_unique<OrderBy>(thread_info,
+                               move(tmp),
+                               saved_vars,
+                               order_vars,
+                               op_order_by.ascending_order,
+                               order_by_limit);
 }
 
 
@@ -282,7 +321,12 @@ void BindingIterVisitor::visit(OpGroupBy& op_group_by) {
 
     op_group_by.op->accept_visitor(*this);
 
-    tmp = make_unique<OrderBy>(thread_info, move(tmp), group_saved_vars, move(group_order_vars), move(ascending_order));
+    tmp = make_unique<OrderBy>(thread_info,
+                               move(tmp),
+                               group_saved_vars,
+                               move(group_order_vars),
+                               move(ascending_order),
+                               UINT64_MAX);
     tmp = make_unique<Aggregation>(move(tmp), move(aggs), group_saved_vars, move(group_vars));
 }
 
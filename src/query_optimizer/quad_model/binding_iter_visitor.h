@@ -15,6 +15,7 @@
 #include "base/thread/thread_info.h"
 #include "execution/binding_iter/aggregation/agg.h"
 #include "parser/query/op/mdb/ops.h"
+#include "query_optimizer/quad_model/expr/expr_to_binding_condition.h"
 
 class BindingIterVisitor : public OpVisitor {
 public:
@@ -44,6 +45,9 @@ public:
     // We use QueryElement instead of GraphObject because it is what OpProperty has as value
     std::vector<std::tuple<Var, std::string, QueryElement>> where_properties;
 
+    // Comparisons of variables with constants from WHERE, they are evaluated on the ObjectIds in the BindingId phase
+    std::vector<IdCondition> where_id_conditions;
+
     // When true, DistinctIdHash will be applied in visit(OpMatch&) to remove duplicates
     bool distinct_into_id = false;
 
@@ -54,6 +58,9 @@ public:
     // True if query contains a group by
     bool group = false;
 
+    // how many results of the OrderBy will be read (the LIMIT of the RETURN), UINT64_MAX if all of them
+    uint64_t order_by_limit = UINT64_MAX;
+
     BindingIterVisitor(std::set<Var> var_names, ThreadInfo* thread_info);
 
     VarId get_var_id(const Var& var_name) const;
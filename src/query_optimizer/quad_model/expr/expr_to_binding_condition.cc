@@ -5,8 +5,60 @@
 
 using namespace std;
 
-Expr2BindingExpr::Expr2BindingExpr(const std::map<Var, VarId>& var2var_ids) :
-    var2var_ids (var2var_ids) { }
+Expr2BindingExpr::Expr2BindingExpr(const std::map<Var, VarId>& var2var_ids, bool push_id_conditions) :
+    var2var_ids        (var2var_ids),
+    push_id_conditions (push_id_conditions) { }
+
+
+bool Expr2BindingExpr::try_push_id_condition(Expr& lhs, Expr& rhs, IdFilter::Operator op) {
+    if (!can_push_outside || !push_id_conditions) {
+        return false;
+    }
+    auto constant = dynamic_cast<ExprConstant*>(&rhs);
+    auto var_expr = &lhs;
+    if (constant == nullptr) {
+        // constant <op> var is the same as var <reversed op> constant
+        constant = dynamic_cast<ExprConstant*>(&lhs);
+        var_expr = &rhs;
+        switch (op) {
+        case IdFilter::Operator::LESS:              op = IdFilter::Operator::GREATER;           break;
+        case IdFilter::Operator::LESS_OR_EQUALS:    op = IdFilter::Operator::GREATER_OR_EQUALS; break;
+        case IdFilter::Operator::GREATER:           op = IdFilter::Operator::LESS;              break;
+        case IdFilter::Operator::GREATER_OR_EQUALS: op = IdFilter::Operator::LESS_OR_EQUALS;    break;
+        default: break;
+        }
+    }
+    if (constant == nullptr) {
+        return false;
+    }
+
+    if (auto var_ptr = dynamic_cast<ExprVar*>(var_expr)) {
+        id_conditions.push_back({ var_ptr->var, op, QueryElement::deduce(constant->value), std::nullopt });
+    } else if (auto var_prop_ptr = dynamic_cast<ExprVarProperty*>(var_expr)) {
+        id_conditions.push_back({ var_prop_ptr->property_var,
+                                  op,
+                                  QueryElement::deduce(constant->value),
+                                  std::make_pair(var_prop_ptr->object_var, var_prop_ptr->property_key) });
+    } else {
+        return false;
+    }
+    current_binding_expr = nullptr;
+    return true;
+}
+
+
+void Expr2BindingExpr::visit_comparison_children(Expr& lhs, Expr& rhs,
+                                                 unique_ptr<BindingExpr>& lhs_binding_expr,
+                                                 unique_ptr<BindingExpr>& rhs_binding_expr)
+{
+    auto original_can_push_outside = can_push_outside;
+    can_push_outside = false;
+    lhs.accept_visitor(*this);
+    lhs_binding_expr = std::move(current_binding_expr);
+    rhs.accept_visitor(*this);
+    rhs_binding_expr = std::move(current_binding_expr);
+    can_push_outside = original_can_push_outside;
+}
 
 
 void Expr2BindingExpr::visit(ExprConstant& expr_constant) {
@@ -110,31 +162,39 @@ void Expr2BindingExpr::visit(ExprEquals& expr) {
             return;
         }
     }
+    if (try_push_id_condition(*expr.lhs, *expr.rhs, IdFilter::Operator::EQUALS)) {
+        return;
+    }
 
-    expr.lhs->accept_visitor(*this);
-    auto lhs_binding_expr = std::move(current_binding_expr);
-    expr.rhs->accept_visitor(*this);
-    auto rhs_binding_expr = std::move(current_binding_expr);
+    unique_ptr<BindingExpr> lhs_binding_expr;
+    unique_ptr<BindingExpr> rhs_binding_expr;
+    visit_comparison_children(*expr.lhs, *expr.rhs, lhs_binding_expr, rhs_binding_expr);
 
     current_binding_expr = make_unique<BindingExprEquals>(std::move(lhs_binding_expr), std::move(rhs_binding_expr));
 }
 
 
 void Expr2BindingExpr::visit(ExprGreaterOrEquals& expr) {
-    expr.lhs->accept_visitor(*this);
-    auto lhs_binding_expr = std::move(current_binding_expr);
-    expr.rhs->accept_visitor(*this);
-    auto rhs_binding_expr = std::move(current_binding_expr);
+    if (try_push_id_condition(*expr.lhs, *expr.rhs, IdFilter::Operator::GREATER_OR_EQUALS)) {
+        return;
+    }
+
+    unique_ptr<BindingExpr> lhs_binding_expr;
+    unique_ptr<BindingExpr> rhs_binding_expr;
+    visit_comparison_children(*expr.lhs, *expr.rhs, lhs_binding_expr, rhs_binding_expr);
 
     current_binding_expr = make_unique<BindingExprGreaterOrEquals>(std::move(lhs_binding_expr), std::move(rhs_binding_expr));
 }
 
 
 void Expr2BindingExpr::visit(ExprGreater& expr) {
-    expr.lhs->accept_visitor(*this);
-    auto lhs_binding_expr = std::move(current_binding_expr);
-    expr.rhs->accept_visitor(*this);
-    auto rhs_binding_expr = std::move(current_binding_expr);
+    if (try_push_id_condition(*expr.lhs, *expr.rhs, IdFilter::Operator::GREATER)) {
+        return;
+    }
+
+    unique_ptr<BindingExpr> lhs_binding_expr;
+    unique_ptr<BindingExpr> rhs_binding_expr;
+    visit_comparison_children(*expr.lhs, *expr.rhs, lhs_binding_expr, rhs_binding_expr);
 
     current_binding_expr = make_unique<BindingExprGreater>(std::move(lhs_binding_expr), std::move(rhs_binding_expr));
 }
@@ -147,30 +207,39 @@ void Expr2BindingExpr::visit(ExprIs& expr) {
 
 
 void Expr2BindingExpr::visit(ExprLessOrEquals& expr) {
-    expr.lhs->accept_visitor(*this);
-    auto lhs_binding_expr = std::move(current_binding_expr);
-    expr.rhs->accept_visitor(*this);
-    auto rhs_binding_expr = std::move(current_binding_expr);
+    if (try_push_id_condition(*expr.lhs, *expr.rhs, IdFilter::Operator::LESS_OR_EQUALS)) {
+        return;
+    }
+
+    unique_ptr<BindingExpr> lhs_binding_expr;
+    unique_ptr<BindingExpr> rhs_binding_expr;
+    visit_comparison_children(*expr.lhs, *expr.rhs, lhs_binding_expr, rhs_binding_expr);
 
     current_binding_expr = make_unique<BindingExprLessOrEquals>(std::move(lhs_binding_expr), std::move(rhs_binding_expr));
 }
 
 
 void Expr2BindingExpr::visit(ExprLess& expr) {
-    expr.lhs->accept_visitor(*this);
-    auto lhs_binding_expr = std::move(current_binding_expr);
-    expr.rhs->accept_visitor(*this);
-    auto rhs_binding_expr = std::move(current_binding_expr);
+    if (try_push_id_condition(*expr.lhs, *expr.rhs, IdFilter::Operator::LESS)) {
+        return;
+    }
+
+    unique_ptr<BindingExpr> lhs_binding_expr;
+    unique_ptr<BindingExpr> rhs_binding_expr;
+    visit_comparison_children(*expr.lhs, *expr.rhs, lhs_binding_expr, rhs_binding_expr);
 
     current_binding_expr = make_unique<BindingExprLess>(std::move(lhs_binding_expr), std::move(rhs_binding_expr));
 }
 
 
 void Expr2BindingExpr::visit(ExprNotEquals& expr) {
-    expr.lhs->accept_visitor(*this);
-    auto lhs_binding_expr = std::move(current_binding_expr);
-    expr.rhs->accept_visitor(*this);
-    auto rhs_binding_expr = std::move(current_binding_expr);
+    if (try_push_id_condition(*expr.lhs, *expr.rhs, IdFilter::Operator::NOT_EQUALS)) {
+        return;
+    }
+
+    unique_ptr<BindingExpr> lhs_binding_expr;
+    unique_ptr<BindingExpr> rhs_binding_expr;
+    visit_comparison_children(*expr.lhs, *expr.rhs, lhs_binding_expr, rhs_binding_expr);
 
     current_binding_expr = make_unique<BindingExprNotEquals>(std::move(lhs_binding_expr), std::move(rhs_binding_expr));
 }
@@ -2,14 +2,29 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "base/query/query_element.h"
 #include "base/ids/object_id.h"
 #include "base/query/var.h"
+#include "parser/query/expr/expr.h"
 #include "parser/query/expr/expr_visitor.h"
+#include "execution/binding_id_iter/id_filter.h"
 #include "execution/binding_iter/binding_expr/binding_expr.h"
 
+// A comparison of the WHERE between a variable and a constant, it is evaluated on the ObjectIds (see IdFilter)
+struct IdCondition {
+    Var var; // ?x or ?x.key
+
+    IdFilter::Operator op;
+
+    QueryElement constant;
+
+    // (?x, key) if var is a property
+    std::optional<std::pair<Var, std::string>> property;
+};
+
 // This visitor returns nullptr if condition is pushed outside
 class Expr2BindingExpr : public ExprVisitor {
 public:
@@ -19,11 +34,14 @@ public:
 
     std::vector<std::tuple<Var, std::string, QueryElement>> properties;
 
+    std::vector<IdCondition> id_conditions;
+
     // This is a variable that may change when visiting an Expr, but the visit method
     // must restore the original value before returning
     bool can_push_outside = true;
 
-    Expr2BindingExpr(const std::map<Var, VarId>& var2var_ids);
+    // with push_id_conditions false all the comparisons are left to the Where
+    Expr2BindingExpr(const std::map<Var, VarId>& var2var_ids, bool push_id_conditions);
 
     void visit(ExprVar&) override;
     void visit(ExprVarProperty&) override;
@@ -45,4 +63,15 @@ public:
     void visit(ExprAnd&) override;
     void visit(ExprNot&) override;
     void visit(ExprOr&) override;
+
+private:
+    const bool push_id_conditions;
+
+    // Adds `lhs op rhs` to id_conditions if it can be pushed outside and it compares a variable with a constant
+    bool try_push_id_condition(Expr& lhs, Expr& rhs, IdFilter::Operator op);
+
+    // Visits lhs and rhs of a comparison, a comparison inside them cannot be pushed outside
+    void visit_comparison_children(Expr& lhs, Expr& rhs,
+                                   std::unique_ptr<BindingExpr>& lhs_binding_expr,
+                                   std::unique_ptr<BindingExpr>& rhs_binding_expr);
 };
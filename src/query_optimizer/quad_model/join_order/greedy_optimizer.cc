@@ -1,6 +1,5 @@
 #include "greedy_optimizer.h"
 
-#include <iostream>
 #include <limits>
 
 #include "query_optimizer/quad_model/plan/join/index_nested_loop_plan.h"
@@ -8,7 +7,7 @@
 using namespace std;
 
 unique_ptr<Plan> GreedyOptimizer::get_plan(const vector<unique_ptr<Plan>>& real_base_plans,
-                                           const vector<string>& var_names)
+                                           const vector<string>& /*var_names*/)
 {
     const auto base_plans_size = real_base_plans.size();
 
@@ -25,8 +24,6 @@ unique_ptr<Plan> GreedyOptimizer::get_plan(const vector<unique_ptr<Plan>>& real_
     for (size_t j = 0; j < base_plans_size; j++) {
         // base_plans[j]->set_input_vars(input_vars);
         auto current_element_cost = base_plans[j]->estimate_cost();
-        base_plans[j]->print(std::cout, 0, var_names);
-        std::cout << "\n";
         if (current_element_cost < best_cost) {
             best_cost = current_element_cost;
             best_index = j;
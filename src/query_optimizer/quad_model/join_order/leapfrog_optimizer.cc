@@ -1,17 +1,18 @@
 #include "leapfrog_optimizer.h"
 
 #include <map>
-#include <iostream>
 
 #include "storage/index/leapfrog/leapfrog_iter.h"
 #include "execution/binding_id_iter/leapfrog_join.h"
+#include "execution/binding_id_iter/parallel_leapfrog_join.h"
 
 using namespace std;
 
 unique_ptr<BindingIdIter> LeapfrogOptimizer::try_get_iter(ThreadInfo* thread_info,
                                                           const vector<unique_ptr<Plan>>& base_plans,
-                                                          const vector<string>& var_names,
-                                                          const size_t binding_size)
+                                                          const vector<string>& /*var_names*/,
+                                                          const size_t binding_size,
+                                                          const uint_fast32_t workers)
 {
     map<VarId, vector<Plan*>> var2plans;
     map<VarId, pair<double, std::size_t>> var2cost;
@@ -101,20 +102,21 @@ unique_ptr<BindingIdIter> LeapfrogOptimizer::try_get_iter(ThreadInfo* thread_inf
         var_order.push_back(enumeration_var);
     }
 
-    // TODO: This print should be disabled by default, but being able to print when we want to explain a query.
-    cout << "Var order: [";
-    for (const auto& var : var_order) {
-        cout << " " << var_names[var.id] << "(" << var.id << ")";
-    }
-    cout << " ]\n";
-
-    // second pass on the base_plans, now creating the leapfrog iterators using the variable order constructed
-    vector<unique_ptr<LeapfrogIter>> leapfrog_iters;
-    for (const auto& plan : base_plans) {
-        if (!plan->get_leapfrog_iter(thread_info, leapfrog_iters, var_order, enumeration_level)) {
-            return nullptr;
+    // second pass on the base_plans, now creating the leapfrog iterators using the variable order constructed.
+    // Every worker needs its own iterators
+    vector<unique_ptr<LeapfrogJoin>> joins;
+    for (uint_fast32_t i = 0; i < workers; i++) {
+        vector<unique_ptr<LeapfrogIter>> leapfrog_iters;
+        for (const auto& plan : base_plans) {
+            if (!plan->get_leapfrog_iter(thread_info, leapfrog_iters, var_order, enumeration_level)) {
+                return nullptr;
+            }
         }
+        joins.push_back(make_unique<LeapfrogJoin>(move(leapfrog_iters), var_order, enumeration_level));
     }
 
-    return make_unique<LeapfrogJoin>(move(leapfrog_iters), move(var_order), enumeration_level);
+    if (joins.size() == 1) {
+        return move(joins[0]);
+    }
+    return make_unique<ParallelLeapfrogJoin>(move(joins));
 }
\ No newline at end of file
@@ -16,10 +16,11 @@
 */
 class LeapfrogOptimizer {
 public:
-    // may return nullptr if leapfrog is not possible
+    // may return nullptr if leapfrog is not possible. With more than one worker returns a ParallelLeapfrogJoin
     static std::unique_ptr<BindingIdIter> try_get_iter(
         ThreadInfo* thread_info,
         const std::vector<std::unique_ptr<Plan>>& base_plans,
         const std::vector<std::string>& var_names,
-        const std::size_t binding_size);
+        const std::size_t binding_size,
+        const uint_fast32_t workers = 1);
 };
@@ -2,7 +2,6 @@
 
 #include <cassert>
 #include <iomanip>
-#include <iostream>
 #include <limits>
 
 #include "query_optimizer/quad_model/plan/join/index_nested_loop_plan.h"
@@ -54,20 +53,17 @@ struct CombinationEnumerator {
 
 
 SelingerOptimizer::SelingerOptimizer(const vector<unique_ptr<Plan>>& base_plans,
-                                     const std::vector<std::string>& var_names) :
+                                     const std::vector<std::string>& /*var_names*/) :
     plans_size (base_plans.size())
 {
     assert(plans_size > 0);
     optimal_plans = new unique_ptr<Plan>*[plans_size];
 
-    cout << "\nBase Plans:" << plans_size << "\n";
     for (size_t i = 0; i < plans_size; ++i) {
         auto arr_size = nCr(plans_size, i+1);
 
         optimal_plans[i] = new unique_ptr<Plan>[arr_size];
         optimal_plans[0][i] = base_plans[i]->duplicate();
-        optimal_plans[0][i]->print(std::cout, 0, var_names);
-        cout << "\n";
     }
 }
 
@@ -157,54 +157,48 @@ double EdgePlan::estimate_output_size() const {
             }
         }
     } // end special cases
-    else if (type_assigned) {
+
+    auto& catalog = quad_model.catalog();
+
+    // connections that may have the assigned from/to, and how many different from's and to's they have
+    double connections      = total_connections;
+    double connections_from = distinct_from;
+    double connections_to   = distinct_to;
+    if (type_assigned) {
         if (std::holds_alternative<ObjectId>(type)) {
-            const auto connections_with_type = static_cast<double>(
-                quad_model.catalog().connections_with_type(std::get<ObjectId>(type).id)
-            );
-            if (from_assigned) {
-                if (to_assigned) {
-                    return connections_with_type / (distinct_from * distinct_to);
-                } else {
-                    return connections_with_type / (distinct_from);
-                }
-            } else {
-                if (to_assigned) {
-                    return connections_with_type / (distinct_to);
-                } else {
-                    return connections_with_type;
-                }
+            const auto type_id = std::get<ObjectId>(type).id;
+            connections = static_cast<double>(catalog.connections_with_type(type_id));
+
+            // 0 if the database was imported without these stats
+            const auto type_distinct_from = catalog.distinct_from_with_type(type_id);
+            const auto type_distinct_to   = catalog.distinct_to_with_type(type_id);
+            if (type_distinct_from > 0) {
+                connections_from = static_cast<double>(type_distinct_from);
             }
-        } else {
-            if (from_assigned) {
-                if (to_assigned) {
-                    return total_connections / (distinct_from * distinct_to * distinct_type);
-                } else {
-                    return total_connections / (distinct_from * distinct_type);
-                }
-            } else {
-                if (to_assigned) {
-                    return total_connections / (distinct_to * distinct_type);
-                } else {
-                    return total_connections / distinct_type;
-                }
+            if (type_distinct_to > 0) {
+                connections_to = static_cast<double>(type_distinct_to);
             }
+        } else {
+            connections = total_connections / distinct_type;
         }
-    } else {
-        if (from_assigned) {
-            if (to_assigned) {
-                return total_connections / (distinct_from * distinct_to);
-            } else {
-                return total_connections / distinct_from;
-            }
+    }
+
+    // a constant from/to uses its own count, so the most frequent nodes are not estimated as the average one
+    if (from_assigned) {
+        if (std::holds_alternative<ObjectId>(from)) {
+            connections *= catalog.connections_with_from(std::get<ObjectId>(from).id) / total_connections;
         } else {
-            if (to_assigned) {
-                return total_connections / distinct_to;
-            } else {
-                return total_connections;
-            }
+            connections /= connections_from;
+        }
+    }
+    if (to_assigned) {
+        if (std::holds_alternative<ObjectId>(to)) {
+            connections *= catalog.connections_with_to(std::get<ObjectId>(to).id) / total_connections;
+        } else {
+            connections /= connections_to;
         }
     }
+    return connections;
 }
 
 
@@ -253,7 +247,8 @@ std::set<VarId> EdgePlan::get_vars() const {
 unique_ptr<BindingIdIter> EdgePlan::get_binding_id_iter(ThreadInfo* thread_info) const {
 
     if (edge_assigned) {
-        return make_unique<EdgeTableLookup>(*quad_model.edge_table, thread_info, edge, from, to, type);
+        return make_unique<EdgeTableLookup>(*quad_model.edge_table, thread_info, edge, from, to, type,
+                                            from_assigned, to_assigned, type_assigned);
     }
     // check for special cases
     if (from == to) {
@@ -1,17 +1,24 @@
 #include "property_plan.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "execution/binding_id_iter/index_scan.h"
+#include "execution/binding_id_iter/union.h"
+#include "execution/binding_id_iter/scan_ranges/bounded_var.h"
 #include "query_optimizer/quad_model/quad_model.h"
 #include "storage/index/leapfrog/leapfrog_bpt_iter.h"
 
 using namespace std;
 
-PropertyPlan::PropertyPlan(Id object, Id key, Id value) :
+// selectivity of a comparison used by System R when nothing is known about the values
+constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3.0;
+
+PropertyPlan::PropertyPlan(Id object, Id key, Id value, ValueRanges value_ranges) :
     object          (object),
     key             (key),
     value           (value),
+    value_ranges    (std::move(value_ranges)),
     object_assigned (std::holds_alternative<ObjectId>(object)),
     key_assigned    (std::holds_alternative<ObjectId>(key)),
     value_assigned  (std::holds_alternative<ObjectId>(value)) { }
@@ -38,6 +45,9 @@ void PropertyPlan::print(std::ostream& os, int indent, const std::vector<std::st
         os << ", value: " << quad_model.get_graph_object(std::get<ObjectId>(value));
     } else {
         os << ", value: " <<  var_names[std::get<VarId>(value).id];
+        if (!value_ranges.empty() && !value_assigned && !object_assigned) {
+            os << ", value ranges: " << value_ranges.size();
+        }
     }
 
     os << ")";
@@ -83,16 +93,20 @@ double PropertyPlan::estimate_output_size() const {
             return 0;
         }
         if (value_assigned) {
+            // a constant value uses the frequent values of the key
+            const double value_count = std::holds_alternative<ObjectId>(value)
+                ? quad_model.catalog().properties_with_value(std::get<ObjectId>(key).id, std::get<ObjectId>(value).id)
+                : key_count / distict_values;
             if (object_assigned) {
-                return key_count / (distict_values * total_objects);
+                return value_count / total_objects;
             } else {
-                return key_count / distict_values;
+                return value_count;
             }
         } else {
             if (object_assigned) {
-                return key_count / total_objects;
+                return key_count * value_ranges_selectivity() / total_objects;
             } else {
-                return key_count;
+                return key_count * value_ranges_selectivity();
             }
         }
     } else {
@@ -105,6 +119,25 @@ double PropertyPlan::estimate_output_size() const {
 }
 
 
+double PropertyPlan::value_ranges_selectivity() const {
+    if (value_ranges.empty() || value_assigned) {
+        return 1.0;
+    }
+    if (!std::holds_alternative<ObjectId>(key)) {
+        return DEFAULT_RANGE_SELECTIVITY;
+    }
+    double selectivity = 0;
+    for (auto& [min, max] : value_ranges) {
+        const auto fraction = quad_model.catalog().properties_with_value_between(std::get<ObjectId>(key).id, min, max);
+        if (fraction < 0) { // the database has no histograms
+            return DEFAULT_RANGE_SELECTIVITY;
+        }
+        selectivity += fraction;
+    }
+    return std::min(1.0, selectivity);
+}
+
+
 void PropertyPlan::set_input_vars(const std::set<VarId>& input_vars) {
     set_input_var(input_vars, object, &object_assigned);
     set_input_var(input_vars, key,    &key_assigned);
@@ -147,6 +180,23 @@ unique_ptr<BindingIdIter> PropertyPlan::get_binding_id_iter(ThreadInfo* thread_i
 
     assert((key_assigned || !value_assigned) && "fixed values with open key is not supported");
 
+    // When the object is assigned there are few values to search, so a scan for each range would only add
+    // B+Tree searches. The values outside the ranges are discarded by the filter of the conditions.
+    if (!value_ranges.empty() && !value_assigned && !object_assigned) {
+        // one scan for each range of values
+        vector<unique_ptr<BindingIdIter>> scans;
+        for (auto& [min, max] : value_ranges) {
+            ranges[0] = ScanRange::get(key, key_assigned);
+            ranges[1] = make_unique<BoundedVar>(std::get<VarId>(value), min, max);
+            ranges[2] = ScanRange::get(object, object_assigned);
+            scans.push_back(make_unique<IndexScan<3>>(*quad_model.key_value_object, thread_info, move(ranges)));
+        }
+        if (scans.size() == 1) {
+            return move(scans[0]);
+        }
+        return make_unique<Union>(move(scans));
+    }
+
     if (object_assigned) {
         ranges[0] = ScanRange::get(object, object_assigned);
         ranges[1] = ScanRange::get(key, key_assigned);
@@ -161,6 +211,7 @@ unique_ptr<BindingIdIter> PropertyPlan::get_binding_id_iter(ThreadInfo* thread_i
 }
 
 
+// value_ranges are not used here, the values outside them must be discarded after the LeapfrogJoin
 bool PropertyPlan::get_leapfrog_iter(ThreadInfo*                                 thread_info,
                                      std::vector<std::unique_ptr<LeapfrogIter>>& leapfrog_iters,
                                      vector<VarId>&                              var_order,
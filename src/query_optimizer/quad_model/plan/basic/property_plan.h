@@ -1,15 +1,24 @@
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "query_optimizer/quad_model/plan/plan.h"
 
 class PropertyPlan : public Plan {
 public:
-    PropertyPlan(Id object, Id key, Id value);
+    // [min, max] intervals of ObjectIds
+    using ValueRanges = std::vector<std::pair<uint64_t, uint64_t>>;
+
+    // If value_ranges is not empty, value and object are not assigned, only the values inside the ranges are
+    // searched. Otherwise the ranges are ignored, so values outside them must be discarded by a filter
+    PropertyPlan(Id object, Id key, Id value, ValueRanges value_ranges = {});
 
     PropertyPlan(const PropertyPlan& other) :
         object          (other.object),
         key             (other.key),
         value           (other.value),
+        value_ranges    (other.value_ranges),
         object_assigned (other.object_assigned),
         key_assigned    (other.key_assigned),
         value_assigned  (other.value_assigned) { }
@@ -38,7 +47,12 @@ private:
     Id key;
     Id value;
 
+    ValueRanges value_ranges;
+
     bool object_assigned;
     bool key_assigned;
     bool value_assigned;
+
+    // fraction of the values of the key that are inside value_ranges
+    double value_ranges_selectivity() const;
 };
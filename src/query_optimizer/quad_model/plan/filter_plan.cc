@@ -0,0 +1,58 @@
+#include "filter_plan.h"
+
+#include "execution/binding_id_iter/profiled_binding_id_iter.h"
+
+using namespace std;
+
+FilterPlan::FilterPlan(unique_ptr<Plan> plan, vector<IdFilter::Condition> conditions) :
+    plan       (move(plan)),
+    conditions (move(conditions)) { }
+
+
+vector<IdFilter::Condition> FilterPlan::get_evaluated_conditions() const {
+    const auto vars = plan->get_vars();
+    vector<IdFilter::Condition> res;
+    for (const auto& condition : conditions) {
+        if (vars.find(condition.var) != vars.end() && input_vars.find(condition.var) == input_vars.end()) {
+            res.push_back(condition);
+        }
+    }
+    return res;
+}
+
+
+unique_ptr<BindingIdIter> FilterPlan::get_binding_id_iter(ThreadInfo* thread_info) const {
+    auto evaluated_conditions = get_evaluated_conditions();
+    if (evaluated_conditions.empty()) {
+        return plan->get_binding_id_iter(thread_info);
+    }
+    return make_unique<IdFilter>(ProfiledBindingIdIter::wrap(plan->get_binding_id_iter(thread_info), thread_info),
+                                 move(evaluated_conditions));
+}
+
+
+void FilterPlan::print(std::ostream& os, int indent, const std::vector<std::string>& var_names) const {
+    auto evaluated_conditions = get_evaluated_conditions();
+    if (evaluated_conditions.empty()) {
+        plan->print(os, indent, var_names);
+        return;
+    }
+    for (int i = 0; i < indent; ++i) {
+        os << ' ';
+    }
+    os << "IdFilter(";
+    for (size_t i = 0; i < evaluated_conditions.size(); i++) {
+        const auto& condition = evaluated_conditions[i];
+        if (i > 0) {
+            os << " AND ";
+        }
+        os << var_names[condition.var.id] << ' ' << IdFilter::to_string(condition.op) << ' ' << condition.constant;
+    }
+    os << ",\n";
+    plan->print(os, indent + 2, var_names);
+    os << "\n";
+    for (int i = 0; i < indent; ++i) {
+        os << ' ';
+    }
+    os << ")";
+}
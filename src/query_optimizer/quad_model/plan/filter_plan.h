@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "execution/binding_id_iter/id_filter.h"
+#include "query_optimizer/quad_model/plan/plan.h"
+
+// FilterPlan evaluates conditions of the WHERE on the results of another plan. A condition is evaluated only
+// if its variable is assigned by the plan (and it is not an input var), so in a left deep join the conditions
+// are evaluated by the first plan that assigns their variable.
+class FilterPlan : public Plan {
+public:
+    FilterPlan(std::unique_ptr<Plan> plan, std::vector<IdFilter::Condition> conditions);
+
+    FilterPlan(const FilterPlan& other) :
+        plan       (other.plan->duplicate()),
+        conditions (other.conditions),
+        input_vars (other.input_vars) { }
+
+    std::unique_ptr<Plan> duplicate() const override {
+        return std::make_unique<FilterPlan>(*this);
+    }
+
+    double estimate_cost()        const override { return plan->estimate_cost(); }
+    double estimate_output_size() const override { return plan->estimate_output_size(); }
+
+    std::set<VarId> get_vars() const override { return plan->get_vars(); }
+    void set_input_vars(const std::set<VarId>& input_vars) override {
+        this->input_vars = input_vars;
+        plan->set_input_vars(input_vars);
+    }
+
+    std::unique_ptr<BindingIdIter> get_binding_id_iter(ThreadInfo*) const override;
+
+    // the conditions are not evaluated inside the LeapfrogJoin, they are evaluated after it
+    bool get_leapfrog_iter(ThreadInfo*                                 thread_info,
+                           std::vector<std::unique_ptr<LeapfrogIter>>& leapfrog_iters,
+                           std::vector<VarId>&                         var_order,
+                           uint_fast32_t&                              enumeration_level) const override
+    {
+        return plan->get_leapfrog_iter(thread_info, leapfrog_iters, var_order, enumeration_level);
+    }
+
+    void print(std::ostream& os, int indent, const std::vector<std::string>& var_names) const override;
+
+private:
+    std::unique_ptr<Plan> plan;
+
+    std::vector<IdFilter::Condition> conditions;
+
+    std::set<VarId> input_vars;
+
+    // conditions whose variable is assigned by plan
+    std::vector<IdFilter::Condition> get_evaluated_conditions() const;
+};
@@ -1,18 +1,11 @@
 #include "hash_join_plan.h"
 
-#include <iostream>
-
 #include "base/exceptions.h"
-#include "execution/binding_id_iter/hash_join/hash_join_grace.h"
-#include "execution/binding_id_iter/hash_join/hash_join_in_buffer.h"
-#include "execution/binding_id_iter/hash_join/hash_join_in_memory.h"
+#include "execution/binding_id_iter/hash_join/hash_join_hybrid.h"
+#include "execution/binding_id_iter/profiled_binding_id_iter.h"
 
 using namespace std;
 
-using HashJoin = HashJoinGrace;
-// using HashJoin = HashJoinInMemory;
-// using HashJoin = HashJoinInBuffer;
-
 HashJoinPlan::HashJoinPlan(unique_ptr<Plan> _lhs, unique_ptr<Plan> _rhs) :
     lhs(move(_lhs)), rhs(move(_rhs))
 {
@@ -23,17 +16,17 @@ HashJoinPlan::HashJoinPlan(unique_ptr<Plan> _lhs, unique_ptr<Plan> _rhs) :
 
 void HashJoinPlan::print(std::ostream& os, int indent, const std::vector<std::string>& var_names) const {
     for (int i = 0; i < indent; ++i) {
-        cout << ' ';
+        os << ' ';
     }
-    cout << "HashJoinGrace(\n";
+    os << "HashJoin(\n";
     lhs->print(os, indent + 2, var_names);
-    cout << ",\n";
+    os << ",\n";
     rhs->print(os, indent + 2, var_names);
-    cout << "\n";
+    os << "\n";
     for (int i = 0; i < indent; ++i) {
-        cout << ' ';
+        os << ' ';
     }
-    cout << ")";
+    os << ")";
 }
 
 
@@ -67,15 +60,16 @@ unique_ptr<BindingIdIter> HashJoinPlan::get_binding_id_iter(ThreadInfo* thread_i
         }
     }
     for (auto right_var : rhs_vars) {
-        if (lhs_vars.find(right_var) != lhs_vars.end()){
+        if (lhs_vars.find(right_var) == lhs_vars.end()) {
             only_right_vars.push_back(right_var);
         }
     }
 
-    return make_unique<HashJoin>(
-        lhs->get_binding_id_iter(thread_info),
-        rhs->get_binding_id_iter(thread_info),
+    return make_unique<HashJoinHybrid>(
+        ProfiledBindingIdIter::wrap(lhs->get_binding_id_iter(thread_info), thread_info),
+        ProfiledBindingIdIter::wrap(rhs->get_binding_id_iter(thread_info), thread_info),
         move(only_left_vars),
         move(common_vars),
-        move(only_right_vars));
+        move(only_right_vars),
+        thread_info);
 }
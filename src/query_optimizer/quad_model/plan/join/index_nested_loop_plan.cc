@@ -2,6 +2,7 @@
 
 #include "base/exceptions.h"
 #include "execution/binding_id_iter/index_nested_loop_join.h"
+#include "execution/binding_id_iter/profiled_binding_id_iter.h"
 
 using namespace std;
 
@@ -51,6 +52,8 @@ void IndexNestedLoopPlan::set_input_vars(const std::set<VarId>& /*input_vars*/)
 
 
 unique_ptr<BindingIdIter> IndexNestedLoopPlan::get_binding_id_iter(ThreadInfo* thread_info) const {
-    return make_unique<IndexNestedLoopJoin>(lhs->get_binding_id_iter(thread_info),
-                                            rhs->get_binding_id_iter(thread_info));
+    return make_unique<IndexNestedLoopJoin>(
+        ProfiledBindingIdIter::wrap(lhs->get_binding_id_iter(thread_info), thread_info),
+        ProfiledBindingIdIter::wrap(rhs->get_binding_id_iter(thread_info), thread_info),
+        thread_info->sorted_lookups);
 }
@@ -56,43 +56,61 @@ double TriplePlan::estimate_cost() const {
 
 
 double TriplePlan::estimate_output_size() const {
-    const auto total_triples       = static_cast<double>(rdf_model.catalog().triples_count);
-    const auto distinct_subjects   = static_cast<double>(rdf_model.catalog().distinct_subjects);
-    const auto distinct_predicates = static_cast<double>(rdf_model.catalog().distinct_predicates);
-    const auto distinct_objects    = static_cast<double>(rdf_model.catalog().distinct_objects);
+    auto& catalog = rdf_model.catalog();
+    const auto total_triples       = static_cast<double>(catalog.triples_count);
+    const auto distinct_subjects   = static_cast<double>(catalog.distinct_subjects);
+    const auto distinct_predicates = static_cast<double>(catalog.distinct_predicates);
+    const auto distinct_objects    = static_cast<double>(catalog.distinct_objects);
 
     // Avoid division by zero
     if (distinct_subjects == 0 || distinct_predicates == 0 || distinct_objects == 0) {
         return 0.0;
-        // All elements assigned
-    } else if (subject_assigned && predicate_assigned && object_assigned) {
-        double predicate_count =
-          static_cast<double>(rdf_model.catalog().predicate2total_count[std::get<ObjectId>(predicate).id]);
-        return predicate_count / (distinct_subjects * distinct_objects);
-        // Two elements assigned
-    } else if (subject_assigned && predicate_assigned) {
-        double predicate_count =
-          static_cast<double>(rdf_model.catalog().predicate2total_count[std::get<ObjectId>(predicate).id]);
-        return predicate_count / distinct_subjects;
-    } else if (subject_assigned && object_assigned) {
-        return total_triples / (distinct_subjects * distinct_objects);
-    } else if (predicate_assigned && object_assigned) {
-        double predicate_count =
-          static_cast<double>(rdf_model.catalog().predicate2total_count[std::get<ObjectId>(predicate).id]);
-        return predicate_count / distinct_objects;
-        // One element assigned
-    } else if (subject_assigned) {
-        return total_triples / distinct_subjects;
-    } else if (predicate_assigned) {
-        double predicate_count =
-          static_cast<double>(rdf_model.catalog().predicate2total_count[std::get<ObjectId>(predicate).id]);
-        return predicate_count;
-    } else if (object_assigned) {
-        return total_triples / distinct_objects;
-        // Any element assigned
-    } else {
-        return total_triples;
     }
+
+    // triples that may have the assigned subject/object, and how many different subjects and objects they have
+    double triples          = total_triples;
+    double triples_subjects = distinct_subjects;
+    double triples_objects  = distinct_objects;
+    if (predicate_assigned) {
+        if (std::holds_alternative<ObjectId>(predicate)) {
+            const auto predicate_id = std::get<ObjectId>(predicate).id;
+            auto search = catalog.predicate2total_count.find(predicate_id);
+            triples = search == catalog.predicate2total_count.end() ? 0 : static_cast<double>(search->second);
+
+            // 0 if the database was imported without these stats
+            const auto predicate_subjects = catalog.distinct_subjects_with_predicate(predicate_id);
+            const auto predicate_objects  = catalog.distinct_objects_with_predicate(predicate_id);
+            if (predicate_subjects > 0) {
+                triples_subjects = static_cast<double>(predicate_subjects);
+            }
+            if (predicate_objects > 0) {
+                triples_objects = static_cast<double>(predicate_objects);
+            }
+        } else {
+            triples = total_triples / distinct_predicates;
+        }
+    }
+
+    // a constant subject/object uses its own count, so the most frequent ones are not estimated as the average one
+    if (subject_assigned) {
+        if (std::holds_alternative<ObjectId>(subject)) {
+            const auto subject_id = std::get<ObjectId>(subject).id;
+            triples *= catalog.top_subjects.estimate_count(subject_id, total_triples, distinct_subjects)
+                       / total_triples;
+        } else {
+            triples /= triples_subjects;
+        }
+    }
+    if (object_assigned) {
+        if (std::holds_alternative<ObjectId>(object)) {
+            const auto object_id = std::get<ObjectId>(object).id;
+            triples *= catalog.top_objects.estimate_count(object_id, total_triples, distinct_objects)
+                       / total_triples;
+        } else {
+            triples /= triples_objects;
+        }
+    }
+    return triples;
 }
 
 
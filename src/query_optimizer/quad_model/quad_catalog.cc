@@ -98,6 +98,74 @@ QuadCatalog::QuadCatalog(const std::string& filename) :
             auto count = read_uint64();
             type2equal_to_type_count.insert({ type, count });
         }
+
+        read_storage_settings();
+        read_statistics();
+    }
+}
+
+
+void QuadCatalog::read_statistics() {
+    if (read_finished()) {
+        return;
+    }
+    top_from = read_top_values();
+    top_to   = read_top_values();
+
+    const auto type2distinct_from_size = read_uint64();
+    for (uint_fast32_t i = 0; i < type2distinct_from_size; i++) {
+        auto type  = read_uint64();
+        auto count = read_uint64();
+        type2distinct_from.insert({ type, count });
+    }
+
+    const auto type2distinct_to_size = read_uint64();
+    for (uint_fast32_t i = 0; i < type2distinct_to_size; i++) {
+        auto type  = read_uint64();
+        auto count = read_uint64();
+        type2distinct_to.insert({ type, count });
+    }
+
+    const auto key2histogram_size = read_uint64();
+    for (uint_fast32_t i = 0; i < key2histogram_size; i++) {
+        auto key = read_uint64();
+        key2histogram.insert({ key, read_histogram() });
+    }
+
+    const auto key2top_values_size = read_uint64();
+    for (uint_fast32_t i = 0; i < key2top_values_size; i++) {
+        auto key = read_uint64();
+        key2top_values.insert({ key, read_top_values() });
+    }
+}
+
+
+void QuadCatalog::write_statistics() {
+    write_top_values(top_from);
+    write_top_values(top_to);
+
+    write_uint64(type2distinct_from.size());
+    for (auto&&[k, v] : type2distinct_from) {
+        write_uint64(k);
+        write_uint64(v);
+    }
+
+    write_uint64(type2distinct_to.size());
+    for (auto&&[k, v] : type2distinct_to) {
+        write_uint64(k);
+        write_uint64(v);
+    }
+
+    write_uint64(key2histogram.size());
+    for (auto&&[k, v] : key2histogram) {
+        write_uint64(k);
+        write_histogram(v);
+    }
+
+    write_uint64(key2top_values.size());
+    for (auto&&[k, v] : key2top_values) {
+        write_uint64(k);
+        write_top_values(v);
     }
 }
 
@@ -171,6 +239,9 @@ void QuadCatalog::save_changes() {
         write_uint64(k);
         write_uint64(v);
     }
+
+    write_storage_settings();
+    write_statistics();
 }
 
 
@@ -194,6 +265,11 @@ void QuadCatalog::print() {
     cout << "  equal_from_type_count:    " << equal_from_type_count    << "\n";
     cout << "  equal_to_type_count:      " << equal_to_type_count      << "\n";
     cout << "  equal_from_to_type_count: " << equal_from_to_type_count << "\n";
+    cout << "  page size:                " << page_size                << "\n";
+    cout << "  compressed leaves:        " << (compressed_leaves ? "yes" : "no") << "\n";
+    cout << "  frequent from's:          " << top_from.values.size()   << "\n";
+    cout << "  frequent to's:            " << top_to.values.size()     << "\n";
+    cout << "  key histograms:           " << key2histogram.size()     << "\n";
     cout << "-------------------------------------\n";
 }
 
@@ -247,3 +323,56 @@ uint64_t QuadCatalog::equal_to_type_with_type(uint64_t type_id) {
         return search->second;
     }
 }
+
+
+uint64_t QuadCatalog::distinct_from_with_type(uint64_t type_id) {
+    auto search = type2distinct_from.find(type_id);
+    if (search == type2distinct_from.end()) {
+        return 0;
+    } else {
+        return search->second;
+    }
+}
+
+
+uint64_t QuadCatalog::distinct_to_with_type(uint64_t type_id) {
+    auto search = type2distinct_to.find(type_id);
+    if (search == type2distinct_to.end()) {
+        return 0;
+    } else {
+        return search->second;
+    }
+}
+
+
+double QuadCatalog::connections_with_from(uint64_t from_id) {
+    return top_from.estimate_count(from_id, connections_count, distinct_from);
+}
+
+
+double QuadCatalog::connections_with_to(uint64_t to_id) {
+    return top_to.estimate_count(to_id, connections_count, distinct_to);
+}
+
+
+double QuadCatalog::properties_with_value(uint64_t key_id, uint64_t value_id) {
+    auto key_count = key2total_count.find(key_id);
+    auto distinct  = key2distinct.find(key_id);
+    if (key_count == key2total_count.end() || distinct == key2distinct.end() || distinct->second == 0) {
+        return 0;
+    }
+    auto top_values = key2top_values.find(key_id);
+    if (top_values == key2top_values.end()) {
+        return static_cast<double>(key_count->second) / distinct->second;
+    }
+    return top_values->second.estimate_count(value_id, key_count->second, distinct->second);
+}
+
+
+double QuadCatalog::properties_with_value_between(uint64_t key_id, uint64_t min_id, uint64_t max_id) {
+    auto search = key2histogram.find(key_id);
+    if (search == key2histogram.end()) {
+        return -1;
+    }
+    return search->second.estimate_fraction(min_id, max_id);
+}
@@ -24,6 +24,21 @@ public:
     uint64_t equal_from_type_with_type    (uint64_t type_id);
     uint64_t equal_to_type_with_type      (uint64_t type_id);
 
+    // return 0 if the stats are not present (databases imported before they existed)
+    uint64_t distinct_from_with_type      (uint64_t type_id);
+    uint64_t distinct_to_with_type        (uint64_t type_id);
+
+    // estimated number of connections with the given from/to
+    double connections_with_from (uint64_t from_id);
+    double connections_with_to   (uint64_t to_id);
+
+    // estimated number of properties with the given key and value
+    double properties_with_value (uint64_t key_id, uint64_t value_id);
+
+    // estimated fraction of the properties of the key whose value is between the ids min and max,
+    // returns a negative number if the key has no histogram
+    double properties_with_value_between(uint64_t key_id, uint64_t min_id, uint64_t max_id);
+
 // private:
     uint64_t identifiable_nodes_count; // Does not consider the literals
     uint64_t anonymous_nodes_count;
@@ -54,4 +69,18 @@ public:
     robin_hood::unordered_map<uint64_t, uint64_t> type2equal_from_to_count;
     robin_hood::unordered_map<uint64_t, uint64_t> type2equal_from_type_count;
     robin_hood::unordered_map<uint64_t, uint64_t> type2equal_to_type_count;
+
+    // statistics saved after the storage settings
+    TopValues top_from;
+    TopValues top_to;
+
+    robin_hood::unordered_map<uint64_t, uint64_t> type2distinct_from;
+    robin_hood::unordered_map<uint64_t, uint64_t> type2distinct_to;
+
+    robin_hood::unordered_map<uint64_t, EquiDepthHistogram> key2histogram;
+    robin_hood::unordered_map<uint64_t, TopValues>          key2top_values;
+
+private:
+    void read_statistics();
+    void write_statistics();
 };
@@ -26,12 +26,20 @@ QuadModel& quad_model = reinterpret_cast<QuadModel&>(quad_model_buf);
 QuadModel::Destroyer QuadModel::init(const std::string& db_folder,
                                      uint_fast32_t      shared_buffer_pool_size,
                                      uint_fast32_t      private_buffer_pool_size,
-                                     uint_fast32_t      max_threads)
+                                     uint_fast32_t      max_threads,
+                                     bool               mmap_enabled,
+                                     ReplacementPolicyType replacement_policy,
+                                     HugePages          huge_pages,
+                                     NumaPolicy         numa_policy)
 {
     new (&quad_model) QuadModel(db_folder,
                                 shared_buffer_pool_size,
                                 private_buffer_pool_size,
-                                max_threads);
+                                max_threads,
+                                mmap_enabled,
+                                replacement_policy,
+                                huge_pages,
+                                numa_policy);
     return QuadModel::Destroyer();
 }
 
@@ -44,14 +52,32 @@ QuadModel::Destroyer::~Destroyer() {
 QuadModel::QuadModel(const std::string& db_folder,
                      uint_fast32_t shared_buffer_pool_size,
                      uint_fast32_t private_buffer_pool_size,
-                     uint_fast32_t max_threads)
+                     uint_fast32_t max_threads,
+                     bool          mmap_enabled,
+                     ReplacementPolicyType replacement_policy,
+                     HugePages          huge_pages,
+                     NumaPolicy         numa_policy)
 {
     FileManager::init(db_folder);
-    BufferManager::init(shared_buffer_pool_size, private_buffer_pool_size, max_threads);
-    PathManager::init(max_threads);
-    StringManager::init();
 
+    // the catalog is read first because the buffer needs the page size of the database
     new (&catalog()) QuadCatalog("catalog.dat"); // placement new
+    if (!Page::is_valid_size(catalog().page_size)) {
+        throw std::runtime_error("Invalid page size in catalog: " + std::to_string(catalog().page_size));
+    }
+    Page::set_size(catalog().page_size);
+
+    // buffer sizes are given in pages of Page::MDB_PAGE_SIZE, so the buffers use the same memory for any page size
+    const auto size_ratio = Page::get_size() / Page::MDB_PAGE_SIZE;
+    BufferManager::init(std::max<uint_fast32_t>(1, shared_buffer_pool_size / size_ratio),
+                        std::max<uint_fast32_t>(1, private_buffer_pool_size / size_ratio),
+                        max_threads,
+                        mmap_enabled,
+                        replacement_policy,
+                        huge_pages,
+                        numa_policy);
+    PathManager::init(max_threads);
+    StringManager::init();
 
     Path::path_printer = &path_manager;
 
@@ -236,6 +262,12 @@ ObjectId QuadModel::get_or_create_object_id(const QueryElement& query_element) {
 
 
 void QuadModel::exec_inserts(const MDB::OpInsert& op_insert) {
+    if (buffer_manager.is_mmap_enabled()) {
+        throw QueryException("Inserts are not allowed when the database is mapped as read only");
+    }
+    if (catalog().compressed_leaves) {
+        throw QueryException("Inserts are not allowed in a database imported with compressed leaves");
+    }
     for (auto& op_label : op_insert.labels) {
         auto label_id = get_or_create_object_id(QueryElement(op_label.label));
         auto node_id = get_or_create_object_id(op_label.node);
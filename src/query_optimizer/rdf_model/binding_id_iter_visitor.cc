@@ -1,8 +1,7 @@
 #include "binding_id_iter_visitor.h"
 
-#include <iostream>
-
 #include "execution/binding_id_iter/optional_node.h"
+#include "execution/binding_id_iter/profiled_binding_id_iter.h"
 #include "query_optimizer/rdf_model/rdf_model.h"
 #include "query_optimizer/quad_model/join_order/greedy_optimizer.h"
 #include "query_optimizer/quad_model/join_order/leapfrog_optimizer.h"
@@ -58,17 +57,18 @@ void BindingIdIterVisitor::visit(OpTriples& op_triples) {
 
     // try to use leapfrog if there is a join
     if (base_plans.size() > 1) {
-        tmp = LeapfrogOptimizer::try_get_iter(thread_info, base_plans, var_names, binding_size);
+        // the join is executed in parallel only when it doesn't receive assigned vars, otherwise it would start
+        // the workers again for every binding of the outer join
+        const auto workers = assigned_vars.empty() ? thread_info->leapfrog_workers : 1;
+        tmp = LeapfrogOptimizer::try_get_iter(thread_info, base_plans, var_names, binding_size, workers);
     }
 
     if (tmp == nullptr) {
         unique_ptr<Plan> root_plan = nullptr;
         root_plan = GreedyOptimizer::get_plan(base_plans, var_names);
-        cout << "\nPlan Generated:\n";
-        root_plan->print(cout, true, var_names);
-        cout << "\nestimated cost: " << root_plan->estimate_cost() << "\n";
         tmp = root_plan->get_binding_id_iter(thread_info);
     }
+    tmp = ProfiledBindingIdIter::wrap(move(tmp), thread_info);
 
     // Insert new assigned_vars
     for (auto& plan : base_plans) {
@@ -94,7 +94,8 @@ void BindingIdIterVisitor::visit(OpOptional& op_optional) {
     }
 
     assert(tmp == nullptr);
-    tmp = make_unique<OptionalNode>(move(binding_id_iter), move(optional_children));
+    tmp = ProfiledBindingIdIter::wrap(make_unique<OptionalNode>(move(binding_id_iter), move(optional_children)),
+                                      thread_info);
 }
 
 Id BindingIdIterVisitor::get_id(const SparqlElement& sparql_element) const {
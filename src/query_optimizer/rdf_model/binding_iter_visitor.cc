@@ -41,6 +41,12 @@ void BindingIterVisitor::visit(OpSelect& op_select) {
     // OpWhere may change this value when accepting visitor
     distinct_into_id = op_select.distinct;
 
+    // the results of an OrderBy are the results of the Select only without DISTINCT
+    if (!op_select.distinct && op_select.limit != OpSelect::DEFAULT_LIMIT) {
+        order_by_limit = op_select.limit + op_select.offset < op_select.limit ? UINT64_MAX
+                                                                             : op_select.limit + op_select.offset;
+    }
+
     op_select.op->accept_visitor(*this);
 
     // TODO: Handle this cases of distinct
@@ -78,10 +84,12 @@ void BindingIterVisitor::visit(OpWhere& op_where) {
         for (const auto& [var, var_id] : projection_vars) {
             projected_var_ids.push_back(var_id);
         }
-        binding_id_iter_current_root = make_unique<DistinctIdHash>(move(binding_id_iter_current_root), move(projected_var_ids));
+        binding_id_iter_current_root = make_unique<DistinctIdHash>(move(binding_id_iter_current_root),
+                                                                   move(projected_var_ids),
+                                                                   thread_info);
     }
 
-    tmp = make_unique<Where>(move(binding_id_iter_current_root), binding_size);
+    tmp = make_unique<Where>(move(binding_id_iter_current_root), binding_size, thread_info->batch_execution);
 }
 
 void BindingIterVisitor::visit(OpOrderBy& op_order_by) {
@@ -101,5 +109,10 @@ void BindingIterVisitor::visit(OpOrderBy& op_order_by) {
     // TODO: implement, we could set distinct_ordered_possible=true if the projection vars are in the begining
     // e.g. if we have ORDER BY ?x, ?z, ?y RETURN DISTINCT ?x, ?y we can't use DistinctOrdered
     op_order_by.op->accept_visitor(*this);
-    tmp = make_unique<OrderBy>(thread_info, move(tmp), saved_vars, order_vars, op_order_by.ascending_order);
+    tmp = make_unique<OrderBy>(thread_info,
+                               move(tmp),
+                               saved_vars,
+                               order_vars,
+                               op_order_by.ascending_order,
+                               order_by_limit);
 }
\ No newline at end of file
@@ -33,6 +33,9 @@ public:
 
     bool distinct_ordered_possible = false;
 
+    // how many results of the OrderBy will be read (LIMIT + OFFSET), UINT64_MAX if all of them
+    uint64_t order_by_limit = UINT64_MAX;
+
     BindingIterVisitor(std::set<Var> var_names, ThreadInfo* thread_info);
 
     VarId get_var_id(const Var& var_name) const;
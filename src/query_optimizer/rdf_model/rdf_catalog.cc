@@ -38,6 +38,50 @@ RdfCatalog::RdfCatalog(const std::string& filename) : Catalog(filename) {
             auto predicate_total_count = read_uint64();
             predicate2total_count.insert({ predicate_id, predicate_total_count });
         }
+
+        read_storage_settings();
+        read_statistics();
+    }
+}
+
+
+void RdfCatalog::read_statistics() {
+    if (read_finished()) {
+        return;
+    }
+    top_subjects = read_top_values();
+    top_objects  = read_top_values();
+
+    const auto predicate2distinct_subjects_size = read_uint64();
+    for (uint_fast32_t i = 0; i < predicate2distinct_subjects_size; i++) {
+        auto predicate = read_uint64();
+        auto count     = read_uint64();
+        predicate2distinct_subjects.insert({ predicate, count });
+    }
+
+    const auto predicate2distinct_objects_size = read_uint64();
+    for (uint_fast32_t i = 0; i < predicate2distinct_objects_size; i++) {
+        auto predicate = read_uint64();
+        auto count     = read_uint64();
+        predicate2distinct_objects.insert({ predicate, count });
+    }
+}
+
+
+void RdfCatalog::write_statistics() {
+    write_top_values(top_subjects);
+    write_top_values(top_objects);
+
+    write_uint64(predicate2distinct_subjects.size());
+    for (auto&&[k, v] : predicate2distinct_subjects) {
+        write_uint64(k);
+        write_uint64(v);
+    }
+
+    write_uint64(predicate2distinct_objects.size());
+    for (auto&&[k, v] : predicate2distinct_objects) {
+        write_uint64(k);
+        write_uint64(v);
     }
 }
 
@@ -65,6 +109,9 @@ void RdfCatalog::save_changes() {
         write_uint64(k);
         write_uint64(v);
     }
+
+    write_storage_settings();
+    write_statistics();
 }
 
 void RdfCatalog::print() {
@@ -81,5 +128,29 @@ void RdfCatalog::print() {
     cout << "  equal_sp_count:      " << equal_sp_count << "\n";
     cout << "  equal_so_count:      " << equal_so_count << "\n";
     cout << "  equal_po_count:      " << equal_po_count << "\n";
+    cout << "  page size:           " << page_size << "\n";
+    cout << "  compressed leaves:   " << (compressed_leaves ? "yes" : "no") << "\n";
+    cout << "  frequent subjects:   " << top_subjects.values.size() << "\n";
+    cout << "  frequent objects:    " << top_objects.values.size() << "\n";
     cout << "-------------------------------------\n";
-}
\ No newline at end of file
+}
+
+
+uint64_t RdfCatalog::distinct_subjects_with_predicate(uint64_t predicate_id) {
+    auto search = predicate2distinct_subjects.find(predicate_id);
+    if (search == predicate2distinct_subjects.end()) {
+        return 0;
+    } else {
+        return search->second;
+    }
+}
+
+
+uint64_t RdfCatalog::distinct_objects_with_predicate(uint64_t predicate_id) {
+    auto search = predicate2distinct_objects.find(predicate_id);
+    if (search == predicate2distinct_objects.end()) {
+        return 0;
+    } else {
+        return search->second;
+    }
+}
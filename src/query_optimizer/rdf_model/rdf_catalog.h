@@ -14,6 +14,10 @@ public:
     void print();
     void save_changes();
 
+    // return 0 if the stats are not present (databases imported before they existed)
+    uint64_t distinct_subjects_with_predicate(uint64_t predicate_id);
+    uint64_t distinct_objects_with_predicate(uint64_t predicate_id);
+
     uint64_t blank_nodes_count;
     uint64_t triples_count;
 
@@ -31,4 +35,15 @@ public:
     std::vector<std::string> languages;
 
     robin_hood::unordered_map<uint64_t, uint64_t> predicate2total_count;
+
+    // statistics saved after the storage settings
+    TopValues top_subjects;
+    TopValues top_objects;
+
+    robin_hood::unordered_map<uint64_t, uint64_t> predicate2distinct_subjects;
+    robin_hood::unordered_map<uint64_t, uint64_t> predicate2distinct_objects;
+
+private:
+    void read_statistics();
+    void write_statistics();
 };
\ No newline at end of file
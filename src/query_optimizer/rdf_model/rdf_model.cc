@@ -29,8 +29,19 @@ RdfModel& rdf_model = reinterpret_cast<RdfModel&>(rdf_model_buf);
 RdfModel::Destroyer RdfModel::init(const std::string& db_folder,
                                    uint_fast32_t      shared_buffer_pool_size,
                                    uint_fast32_t      private_buffer_pool_size,
-                                   uint_fast32_t      max_threads) {
-    new (&rdf_model) RdfModel(db_folder, shared_buffer_pool_size, private_buffer_pool_size, max_threads);
+                                   uint_fast32_t      max_threads,
+                                   bool               mmap_enabled,
+                                   ReplacementPolicyType replacement_policy,
+                                   HugePages          huge_pages,
+                                   NumaPolicy         numa_policy) {
+    new (&rdf_model) RdfModel(db_folder,
+                              shared_buffer_pool_size,
+                              private_buffer_pool_size,
+                              max_threads,
+                              mmap_enabled,
+                              replacement_policy,
+                              huge_pages,
+                              numa_policy);
     return RdfModel::Destroyer();
 }
 
@@ -43,14 +54,32 @@ RdfModel::Destroyer::~Destroyer() {
 RdfModel::RdfModel(const std::string& db_folder,
                    uint_fast32_t      shared_buffer_pool_size,
                    uint_fast32_t      private_buffer_pool_size,
-                   uint_fast32_t      max_threads) {
+                   uint_fast32_t      max_threads,
+                   bool               mmap_enabled,
+                   ReplacementPolicyType replacement_policy,
+                   HugePages          huge_pages,
+                   NumaPolicy         numa_policy) {
     FileManager::init(db_folder);
-    BufferManager::init(shared_buffer_pool_size, private_buffer_pool_size, max_threads);
+
+    // the catalog is read first because the buffer needs the page size of the database
+    new (&catalog()) RdfCatalog("catalog.dat"); // placement new
+    if (!Page::is_valid_size(catalog().page_size)) {
+        throw std::runtime_error("Invalid page size in catalog: " + std::to_string(catalog().page_size));
+    }
+    Page::set_size(catalog().page_size);
+
+    // buffer sizes are given in pages of Page::MDB_PAGE_SIZE, so the buffers use the same memory for any page size
+    const auto size_ratio = Page::get_size() / Page::MDB_PAGE_SIZE;
+    BufferManager::init(std::max<uint_fast32_t>(1, shared_buffer_pool_size / size_ratio),
+                        std::max<uint_fast32_t>(1, private_buffer_pool_size / size_ratio),
+                        max_threads,
+                        mmap_enabled,
+                        replacement_policy,
+                        huge_pages,
+                        numa_policy);
     PathManager::init(max_threads);
     StringManager::init();
 
-    new (&catalog())       RdfCatalog("catalog.dat"); // placement new
-
     Path::path_printer = &path_manager;
 
     GraphObject::graph_object_print    = GraphObjectManager::print_rdf;
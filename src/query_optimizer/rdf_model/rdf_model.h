@@ -4,6 +4,8 @@
 
 #include "execution/graph_model.h"
 #include "query_optimizer/rdf_model/rdf_catalog.h"
+#include "storage/page_memory.h"
+#include "storage/replacement_policy/replacement_policy.h"
 
 template <std::size_t N> class BPlusTree;
 
@@ -37,11 +39,18 @@ public:
     std::unique_ptr<BPlusTree<2>> equal_po_inverted;  // (subject,   predicate=object)
 
 
-    // necessary to be called before first usage
+    // necessary to be called before first usage. With `mmap_enabled` the indexes are read from read-only
+    // memory mappings instead of the shared buffer. `replacement_policy`, `huge_pages` and
+    // `numa_policy` are used by the shared buffer. Buffer sizes are given in pages of Page::MDB_PAGE_SIZE bytes,
+    // the page size of the database is read from the catalog
     static RdfModel::Destroyer init(const std::string& db_folder,
                                     uint_fast32_t      shared_buffer_pool_size,
                                     uint_fast32_t      private_buffer_pool_size,
-                                    uint_fast32_t      max_threads);
+                                    uint_fast32_t      max_threads,
+                                    bool               mmap_enabled = false,
+                                    ReplacementPolicyType replacement_policy = ReplacementPolicyType::two_queue,
+                                    HugePages          huge_pages = HugePages::none,
+                                    NumaPolicy         numa_policy = NumaPolicy::none);
 
     std::unique_ptr<BindingIter> exec(Op&, ThreadInfo*) const /*override*/;
 
@@ -65,7 +74,11 @@ private:
     RdfModel(const std::string& db_folder,
              uint_fast32_t      shared_buffer_pool_size,
              uint_fast32_t      private_buffer_pool_size,
-             uint_fast32_t      max_threads);
+             uint_fast32_t      max_threads,
+             bool               mmap_enabled,
+             ReplacementPolicyType replacement_policy,
+             HugePages          huge_pages,
+             NumaPolicy         numa_policy);
 
     ~RdfModel();
 };
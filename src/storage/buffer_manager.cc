@@ -1,11 +1,19 @@
 #include "buffer_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <sys/mman.h>
 #include <new>         // placement new
+#include <stdexcept>
 #include <type_traits> // aligned_storage
 
 #include "base/exceptions.h"
+#include "base/thread/thread_counters.h"
 #include "storage/file_manager.h"
+#include "storage/filesystem.h"
 
 using namespace std;
 
@@ -17,18 +25,28 @@ BufferManager& buffer_manager = reinterpret_cast<BufferManager&>(buffer_manager_
 
 BufferManager::BufferManager(uint_fast32_t shared_buffer_pool_size,
                              uint_fast32_t private_buffer_pool_size,
-                             uint_fast32_t max_threads) :
-    clock_pos                 (0),
+                             uint_fast32_t max_threads,
+                             bool          mmap_enabled,
+                             ReplacementPolicyType replacement_policy,
+                             HugePages     huge_pages,
+                             NumaPolicy    numa_policy) :
     buffer_pool               (new Page[shared_buffer_pool_size]),
     private_buffer_pool       (new Page[private_buffer_pool_size * max_threads]),
-    bytes                     (reinterpret_cast<char*>(std::aligned_alloc(
-                                   Page::MDB_PAGE_SIZE,
-                                   shared_buffer_pool_size * Page::MDB_PAGE_SIZE))),
-    private_bytes             (reinterpret_cast<char*>(std::aligned_alloc(
-                                   Page::MDB_PAGE_SIZE,
-                                   private_buffer_pool_size * max_threads * Page::MDB_PAGE_SIZE))),
+    shared_huge_pages         (huge_pages),
+    private_huge_pages        (huge_pages),
+    numa_policy               (numa_policy),
+    bytes                     (PageMemory::allocate(size_t(shared_buffer_pool_size) * Page::get_size(),
+                                                    shared_huge_pages)),
+    private_bytes             (PageMemory::allocate(size_t(private_buffer_pool_size) * max_threads * Page::get_size(),
+                                                    private_huge_pages)),
+    max_threads               (max_threads),
     shared_buffer_pool_size   (shared_buffer_pool_size),
-    private_buffer_pool_size  (private_buffer_pool_size)
+    private_buffer_pool_size  (private_buffer_pool_size),
+    partition_count           (compute_partition_count(shared_buffer_pool_size)),
+    partitions                (new SharedBufferPartition[partition_count]),
+    mmap_enabled              (mmap_enabled),
+    read_ahead_pages          (DEFAULT_READ_AHEAD_PAGES),
+    stop_prefetch_threads     (false)
 {
     for (uint_fast32_t i=0; i < max_threads; i++) {
         available_private_positions.push(i);
@@ -36,25 +54,198 @@ BufferManager::BufferManager(uint_fast32_t shared_buffer_pool_size,
     private_tmp_pages.resize(max_threads);
     private_clock_pos.resize(max_threads);
 
-    pages.reserve(shared_buffer_pool_size);
+    // frames are split as evenly as possible, the first partitions may get one extra frame
+    const auto frames_per_partition = shared_buffer_pool_size / partition_count;
+    const auto remaining_frames     = shared_buffer_pool_size % partition_count;
+    uint_fast32_t current_frame = 0;
+    for (uint_fast32_t i = 0; i < partition_count; i++) {
+        auto& partition = partitions[i];
+        partition.first_frame = current_frame;
+        partition.frame_count = frames_per_partition + (i < remaining_frames ? 1 : 0);
+        current_frame += partition.frame_count;
+    }
+
+    if (numa_policy == NumaPolicy::interleave) {
+        PageMemory::interleave(bytes, size_t(shared_buffer_pool_size) * Page::get_size());
+    } else if (numa_policy == NumaPolicy::partitioned) {
+        bind_partitions_to_nodes();
+    }
+
+    const auto numa_nodes = PageMemory::numa_node_count();
+    for (uint_fast32_t i = 0; i < partition_count; i++) {
+        auto& partition = partitions[i];
+        // the page table and the replacement policy are allocated in the node of the frames
+        if (numa_policy == NumaPolicy::partitioned) {
+            PageMemory::set_thread_preferred_node(i % numa_nodes);
+        }
+        partition.pages.reserve(partition.frame_count);
+        partition.replacement_policy = ReplacementPolicy::create(replacement_policy,
+                                                                 &buffer_pool[partition.first_frame],
+                                                                 partition.frame_count);
+    }
+    if (numa_policy == NumaPolicy::partitioned) {
+        PageMemory::reset_thread_policy();
+    }
+
+    for (uint_fast32_t i = 0; i < PREFETCH_THREADS; i++) {
+        prefetch_threads.emplace_back(&BufferManager::process_prefetches, this);
+    }
 }
 
 
 BufferManager::~BufferManager() {
+    {
+        std::lock_guard<std::mutex> lck(prefetch_mutex);
+        stop_prefetch_threads = true;
+    }
+    prefetch_queue_not_empty.notify_all();
+    for (auto& prefetch_thread : prefetch_threads) {
+        prefetch_thread.join();
+    }
     flush();
+    for (auto& mapped_file : mapped_files) {
+        if (mapped_file != nullptr) {
+            munmap(mapped_file->bytes, mapped_file->page_count * Page::get_size());
+        }
+    }
     delete[](buffer_pool);
     delete[](private_buffer_pool);
-    free(bytes);
-    free(private_bytes);
+    PageMemory::free(bytes, size_t(shared_buffer_pool_size) * Page::get_size(), shared_huge_pages);
+    PageMemory::free(private_bytes,
+                     size_t(private_buffer_pool_size) * max_threads * Page::get_size(),
+                     private_huge_pages);
 }
 
 
 void BufferManager::init(uint_fast32_t shared_buffer_pool_size,
                          uint_fast32_t private_buffer_pool_size,
-                         uint_fast32_t max_threads)
+                         uint_fast32_t max_threads,
+                         bool          mmap_enabled,
+                         ReplacementPolicyType replacement_policy,
+                         HugePages     huge_pages,
+                         NumaPolicy    numa_policy)
 {
     // placement new
-    new (&buffer_manager) BufferManager(shared_buffer_pool_size, private_buffer_pool_size, max_threads);
+    new (&buffer_manager) BufferManager(shared_buffer_pool_size,
+                                        private_buffer_pool_size,
+                                        max_threads,
+                                        mmap_enabled,
+                                        replacement_policy,
+                                        huge_pages,
+                                        numa_policy);
+}
+
+
+void BufferManager::bind_partitions_to_nodes() {
+    const auto numa_nodes = PageMemory::numa_node_count();
+    // the memory policy is applied to whole (huge) pages, so the boundaries between partitions are rounded down
+    const auto granularity = PageMemory::get_page_size(shared_huge_pages);
+    const auto total_size  = (size_t(shared_buffer_pool_size) * Page::get_size() + granularity - 1)
+                             / granularity * granularity;
+    for (uint_fast32_t i = 0; i < partition_count; i++) {
+        const auto& partition = partitions[i];
+        const auto begin = size_t(partition.first_frame) * Page::get_size() / granularity * granularity;
+        const auto end   = i + 1 == partition_count
+                            ? total_size
+                            : size_t(partition.first_frame + partition.frame_count) * Page::get_size()
+                              / granularity * granularity;
+        if (begin < end) {
+            PageMemory::bind(bytes + begin, end - begin, i % numa_nodes);
+        }
+    }
+}
+
+
+void BufferManager::set_hot_file(FileId file_id) {
+    assert(file_id.id >= 0);
+    if (static_cast<size_t>(file_id.id) >= hot_files.size()) {
+        hot_files.resize(file_id.id + 1, false);
+    }
+    hot_files[file_id.id] = true;
+}
+
+
+std::map<FileId, BufferStats> BufferManager::get_stats() {
+    std::map<FileId, BufferStats> res;
+    for (uint_fast32_t p = 0; p < partition_count; p++) {
+        auto& partition = partitions[p];
+        std::lock_guard<std::mutex> lck(partition.mutex);
+        for (auto& [fd, partition_stats] : partition.file_stats) {
+            auto& stats = res[FileId(fd)];
+            stats.hits      += partition_stats.hits;
+            stats.misses    += partition_stats.misses;
+            stats.evictions += partition_stats.evictions;
+        }
+    }
+    return res;
+}
+
+
+void BufferManager::reset_stats() {
+    for (uint_fast32_t p = 0; p < partition_count; p++) {
+        auto& partition = partitions[p];
+        std::lock_guard<std::mutex> lck(partition.mutex);
+        partition.file_stats.clear();
+    }
+}
+
+
+void BufferManager::print_stats(std::ostream& os) {
+    os << "Shared buffer statistics:\n";
+    for (auto& [file_id, stats] : get_stats()) {
+        const auto requests = stats.hits + stats.misses;
+        os << "  " << file_manager.get_filename(file_id) << ": "
+           << stats.hits << " hits, "
+           << stats.misses << " misses, "
+           << stats.evictions << " evictions";
+        if (requests > 0) {
+            os << " (hit ratio " << (100.0 * stats.hits / requests) << "%)";
+        }
+        os << "\n";
+    }
+}
+
+
+void BufferManager::map_file(FileId file_id, MappedFileAccess access) {
+    assert(file_id.id >= 0);
+    const auto page_count = file_manager.count_pages(file_id);
+    if (page_count == 0 || get_mapped_file(file_id) != nullptr) {
+        return;
+    }
+    const auto size = page_count * Page::get_size();
+    auto bytes = reinterpret_cast<char*>(mmap(NULL, size, PROT_READ, MAP_SHARED, file_id.id, 0));
+    if (bytes == MAP_FAILED) {
+        throw std::runtime_error("Could not map file in memory");
+    }
+    if (access == MappedFileAccess::random) {
+        // avoid the kernel read-ahead, most accesses read a single page
+        madvise(bytes, size, MADV_RANDOM);
+    }
+
+    auto mapped_file = std::make_unique<MappedFile>();
+    mapped_file->bytes      = bytes;
+    mapped_file->page_count = page_count;
+    mapped_file->pages      = std::unique_ptr<Page[]>(new Page[page_count]);
+    for (uint_fast32_t i = 0; i < page_count; i++) {
+        auto& page = mapped_file->pages[i];
+        page.page_id = PageId(file_id, i);
+        page.bytes   = bytes + i * Page::get_size();
+        page.mapped  = true;
+    }
+
+    if (static_cast<size_t>(file_id.id) >= mapped_files.size()) {
+        mapped_files.resize(file_id.id + 1);
+    }
+    mapped_files[file_id.id] = std::move(mapped_file);
+}
+
+
+uint_fast32_t BufferManager::compute_partition_count(uint_fast32_t shared_buffer_pool_size) {
+    uint_fast32_t res = 1;
+    while (res < MAX_SHARED_BUFFER_PARTITIONS && shared_buffer_pool_size / (2*res) >= MIN_PARTITION_SIZE) {
+        res *= 2;
+    }
+    return res;
 }
 
 
@@ -62,14 +253,158 @@ void BufferManager::flush() {
     // flush() is always called at destruction.
     // this is important to check to avoid segfault when program terminates before calling init()
     assert(buffer_pool != nullptr);
-    for (uint_fast32_t i = 0; i < shared_buffer_pool_size; i++) {
-        if (buffer_pool[i].dirty) {
-            file_manager.flush(buffer_pool[i]);
+    // partitions are always locked in the same order
+    std::vector<std::unique_lock<std::mutex>> locks;
+    std::vector<Page*> dirty_pages;
+    for (uint_fast32_t p = 0; p < partition_count; p++) {
+        auto& partition = partitions[p];
+        locks.emplace_back(partition.mutex);
+        for (uint_fast32_t i = partition.first_frame; i < partition.first_frame + partition.frame_count; i++) {
+            if (buffer_pool[i].dirty) {
+                dirty_pages.push_back(&buffer_pool[i]);
+            }
+        }
+    }
+
+    // write in file order so consecutive pages are written with a single syscall
+    std::sort(dirty_pages.begin(), dirty_pages.end(), [](const Page* lhs, const Page* rhs) {
+        return lhs->page_id < rhs->page_id;
+    });
+    uint_fast32_t run_start = 0;
+    for (uint_fast32_t i = 1; i <= dirty_pages.size(); i++) {
+        if (i == dirty_pages.size()
+            || !(dirty_pages[i]->page_id.file_id == dirty_pages[i-1]->page_id.file_id)
+            || dirty_pages[i]->page_id.page_number != dirty_pages[i-1]->page_id.page_number + 1)
+        {
+            file_manager.flush_pages(&dirty_pages[run_start], i - run_start);
+            run_start = i;
         }
     }
 }
 
 
+uint_fast32_t BufferManager::dump_snapshot(const std::string& path) {
+    std::vector<PageId> page_ids;
+    for (uint_fast32_t p = 0; p < partition_count; p++) {
+        auto& partition = partitions[p];
+        std::lock_guard<std::mutex> lck(partition.mutex);
+        for (auto& [page_id, page] : partition.pages) {
+            page_ids.push_back(page_id);
+        }
+    }
+    std::sort(page_ids.begin(), page_ids.end());
+
+    // written in a temporary file so a crash while writing doesn't leave a partial snapshot
+    const auto tmp_path = path + ".tmp";
+    std::ofstream file(tmp_path);
+    uint_fast32_t pages_written = 0;
+    for (size_t i = 0; i < page_ids.size(); ) {
+        auto run_end = i + 1;
+        while (run_end < page_ids.size()
+               && page_ids[run_end].file_id == page_ids[i].file_id
+               && page_ids[run_end].page_number == page_ids[run_end - 1].page_number + 1)
+        {
+            run_end++;
+        }
+        const auto filename = file_manager.get_filename(page_ids[i].file_id);
+        if (!filename.empty()) {
+            file << filename << ' ' << page_ids[i].page_number << ' ' << (run_end - i) << '\n';
+            pages_written += run_end - i;
+        }
+        i = run_end;
+    }
+    file.close();
+    if (file.fail() || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Could not write buffer snapshot " + path);
+    }
+    return pages_written;
+}
+
+
+std::vector<BufferManager::SnapshotRead> BufferManager::read_snapshot(const std::string& path) {
+    // ranges are split in reads of SNAPSHOT_READ_PAGES pages
+    std::vector<SnapshotRead> reads;
+
+    std::ifstream file(path);
+    if (file.fail()) {
+        return reads;
+    }
+
+    uint_fast32_t total_pages = 0;
+    std::string filename;
+    uint_fast32_t first_page;
+    uint_fast32_t count;
+    while (total_pages < shared_buffer_pool_size && file >> filename >> first_page >> count) {
+        if (!Filesystem::exists(file_manager.get_file_path(filename))) {
+            continue;
+        }
+        const auto file_id = file_manager.get_file_id(filename);
+        const auto page_count = file_manager.count_pages(file_id);
+        if (get_mapped_file(file_id) != nullptr || first_page >= page_count) {
+            continue;
+        }
+        count = std::min({ count, page_count - first_page, shared_buffer_pool_size - total_pages });
+        total_pages += count;
+        for (uint_fast32_t i = 0; i < count; i += SNAPSHOT_READ_PAGES) {
+            reads.push_back({ file_id, first_page + i, std::min(SNAPSHOT_READ_PAGES, count - i) });
+        }
+    }
+    return reads;
+}
+
+
+uint_fast32_t BufferManager::load_snapshot(const std::vector<SnapshotRead>& reads, uint_fast32_t threads) {
+    std::atomic<size_t> next_read(0);
+    std::atomic<uint_fast32_t> pages_loaded(0);
+    std::vector<std::thread> loaders;
+    for (uint_fast32_t t = 0; t < std::max<uint_fast32_t>(1, threads); t++) {
+        loaders.emplace_back([&]() {
+            for (auto i = next_read++; i < reads.size(); i = next_read++) {
+                pages_loaded += load_pages(reads[i].file_id, reads[i].first_page, reads[i].count);
+            }
+        });
+    }
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+    return pages_loaded;
+}
+
+
+uint_fast32_t BufferManager::load_pages(FileId file_id, uint_fast32_t first_page, uint_fast32_t count) {
+    std::vector<Page*> claimed_pages;
+    for (auto page_number = first_page; page_number < first_page + count; page_number++) {
+        const PageId page_id(file_id, page_number);
+        auto& partition = get_partition(page_id);
+
+        std::lock_guard<std::mutex> lck(partition.mutex);
+        if (partition.pages.find(page_id) == partition.pages.end()) {
+            claimed_pages.push_back(&claim_frame(partition, page_id));
+        }
+    }
+
+    // pages already in the buffer were skipped, the others are read in consecutive groups
+    std::vector<char*> pages_bytes;
+    for (size_t i = 0; i < claimed_pages.size(); ) {
+        pages_bytes.clear();
+        auto run_end = i;
+        do {
+            pages_bytes.push_back(claimed_pages[run_end]->get_bytes());
+            run_end++;
+        } while (run_end < claimed_pages.size()
+                 && claimed_pages[run_end]->page_id.page_number == claimed_pages[run_end - 1]->page_id.page_number + 1);
+
+        file_manager.read_pages(file_id, claimed_pages[i]->page_id.page_number, pages_bytes.data(), run_end - i);
+        for (auto j = i; j < run_end; j++) {
+            finish_page_read(*claimed_pages[j]);
+            unpin(*claimed_pages[j]);
+        }
+        i = run_end;
+    }
+    return claimed_pages.size();
+}
+
+
 Page& BufferManager::get_last_page(FileId file_id) {
     auto page_count = file_manager.count_pages(file_id);
     if (page_count == 0) {
@@ -85,20 +420,8 @@ Page& BufferManager::append_page(FileId file_id) {
 }
 
 
-uint_fast32_t BufferManager::get_buffer_available() {
-    while (true) {
-        // when pins == 0 the are no synchronization problems with pins and usage
-        if (buffer_pool[clock_pos].pins == 0) {
-            if (buffer_pool[clock_pos].usage == 0) {
-                break;
-            } else {
-                buffer_pool[clock_pos].usage--;
-            }
-        }
-        clock_pos++;
-        clock_pos = clock_pos < shared_buffer_pool_size ? clock_pos : 0;
-    }
-    return clock_pos;
+uint_fast32_t BufferManager::get_buffer_available(SharedBufferPartition& partition) {
+    return partition.first_frame + partition.replacement_policy->choose_victim();
 }
 
 
@@ -120,35 +443,159 @@ uint_fast32_t BufferManager::get_private_buffer_available(uint_fast32_t thread_p
 }
 
 
+Page& BufferManager::claim_frame(SharedBufferPartition& partition, PageId page_id) {
+    const auto buffer_available = get_buffer_available(partition);
+    auto& page = buffer_pool[buffer_available];
+    if (page.page_id.file_id.id != FileId::UNASSIGNED) {
+        partition.pages.erase(page.page_id);
+        partition.file_stats[page.page_id.file_id.id].evictions++;
+    }
+
+    // dirty pages only exist while the database is being modified, so flushing while
+    // the lock is held doesn't affect read-only queries
+    if (page.dirty) {
+        file_manager.flush(page);
+    }
+    page.reassign(page_id, &bytes[buffer_available*Page::get_size()]);
+    page.io_pending = true;
+    partition.pages.insert({page_id, &page});
+    partition.file_stats[page_id.file_id.id].misses++;
+
+    const auto hot = static_cast<size_t>(page_id.file_id.id) < hot_files.size() && hot_files[page_id.file_id.id];
+    partition.replacement_policy->on_insert(buffer_available - partition.first_frame, hot);
+    return page;
+}
+
+
+void BufferManager::finish_page_read(Page& page) {
+    auto& partition = get_partition(page.page_id);
+    {
+        std::lock_guard<std::mutex> lck(partition.mutex);
+        page.io_pending = false;
+    }
+    partition.io_done.notify_all();
+}
+
+
 Page& BufferManager::get_page(FileId file_id, uint_fast32_t page_number) noexcept {
-    const PageId page_id(file_id, page_number);
+    ThreadCounters::page_pins++;
+    auto mapped_file = get_mapped_file(file_id);
+    if (mapped_file != nullptr && page_number < mapped_file->page_count) {
+        return mapped_file->pages[page_number];
+    }
 
-    std::lock_guard<std::mutex> lck(shared_buffer_mutex);
-    auto it = pages.find(page_id);
+    const PageId page_id(file_id, page_number);
+    auto& partition = get_partition(page_id);
 
-    if (it == pages.end()) {
-        const auto buffer_available = get_buffer_available();
-        auto& page = buffer_pool[buffer_available];
-        if (page.page_id.file_id.id != FileId::UNASSIGNED) {
-            pages.erase(page.page_id);
-        }
+    std::unique_lock<std::mutex> lck(partition.mutex);
+    auto it = partition.pages.find(page_id);
 
-        if (page.dirty) {
-            file_manager.flush(page);
-        }
-        page.reassign(page_id, &bytes[buffer_available*Page::MDB_PAGE_SIZE]);
+    if (it == partition.pages.end()) {
+        auto& page = claim_frame(partition, page_id);
+        lck.unlock();
 
+        // the page is pinned and marked as io_pending, so nobody else can reuse the frame or read its bytes
         file_manager.read_page(page_id, page.get_bytes());
-        pages.insert({page_id, &page});
+        finish_page_read(page);
         return page;
     } else { // page is the buffer
-        it->second->pins++;
-        return *it->second;
+        auto& page = *it->second;
+        page.pins++;
+        partition.file_stats[file_id.id].hits++;
+        partition.replacement_policy->on_hit(&page - &buffer_pool[partition.first_frame]);
+        if (page.io_pending) {
+            // other thread is reading the page from disk
+            partition.io_done.wait(lck, [&page] { return !page.io_pending; });
+        }
+        return page;
     }
     // lock is released
 }
 
 
+void BufferManager::prefetch(FileId file_id, uint_fast32_t first_page, uint_fast32_t count) {
+    const auto page_count = file_manager.count_pages(file_id);
+    if (first_page >= page_count) {
+        return;
+    }
+    count = std::min(count, page_count - first_page);
+
+    auto mapped_file = get_mapped_file(file_id);
+    if (mapped_file != nullptr) {
+        // the kernel reads the range in background, no frames are needed
+        madvise(mapped_file->bytes + first_page * Page::get_size(),
+                count * Page::get_size(),
+                MADV_WILLNEED);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lck(prefetch_mutex);
+        if (prefetch_queue.size() >= MAX_PENDING_PREFETCHES) {
+            return;
+        }
+    }
+
+    // the OS starts reading the whole range, so the reads of the prefetch threads are likely to be cached
+    file_manager.advise_will_need(file_id, first_page, count);
+
+    std::vector<Page*> claimed_pages;
+    for (auto page_number = first_page; page_number < first_page + count; page_number++) {
+        const PageId page_id(file_id, page_number);
+        auto& partition = get_partition(page_id);
+
+        std::lock_guard<std::mutex> lck(partition.mutex);
+        if (partition.pages.find(page_id) == partition.pages.end()) {
+            claimed_pages.push_back(&claim_frame(partition, page_id));
+        }
+    }
+
+    if (!claimed_pages.empty()) {
+        {
+            std::lock_guard<std::mutex> lck(prefetch_mutex);
+            for (auto page : claimed_pages) {
+                prefetch_queue.push(page);
+            }
+        }
+        prefetch_queue_not_empty.notify_all();
+    }
+}
+
+
+void BufferManager::process_prefetches() {
+    std::vector<Page*> pages;
+    std::vector<char*> pages_bytes;
+    while (true) {
+        pages.clear();
+        pages_bytes.clear();
+        {
+            std::unique_lock<std::mutex> lck(prefetch_mutex);
+            prefetch_queue_not_empty.wait(lck, [this] { return stop_prefetch_threads || !prefetch_queue.empty(); });
+            if (prefetch_queue.empty()) { // stop_prefetch_threads is true
+                return;
+            }
+            // take the consecutive pages of the same file at the front of the queue, they are read together
+            do {
+                pages.push_back(prefetch_queue.front());
+                pages_bytes.push_back(prefetch_queue.front()->get_bytes());
+                prefetch_queue.pop();
+            } while (!prefetch_queue.empty()
+                     && pages.size() < MAX_PREFETCH_READ
+                     && prefetch_queue.front()->page_id.file_id == pages.back()->page_id.file_id
+                     && prefetch_queue.front()->page_id.page_number == pages.back()->page_id.page_number + 1);
+        }
+        file_manager.read_pages(pages[0]->page_id.file_id,
+                                pages[0]->page_id.page_number,
+                                pages_bytes.data(),
+                                pages.size());
+        for (auto page : pages) {
+            finish_page_read(*page);
+            // the pin was taken by claim_frame, now the page can be evicted as any other page
+            unpin(*page);
+        }
+    }
+}
+
+
 Page& BufferManager::get_tmp_page(TmpFileId tmp_file_id, uint_fast32_t page_number) noexcept {
     const PageId page_id(tmp_file_id.file_id, page_number);
     auto thread_pos = tmp_file_id.private_buffer_pos;
@@ -168,7 +615,7 @@ Page& BufferManager::get_tmp_page(TmpFileId tmp_file_id, uint_fast32_t page_numb
             file_manager.flush(page);
         }
         page.reassign(page_id,
-                      &private_bytes[Page::MDB_PAGE_SIZE * (thread_pos*private_buffer_pool_size + buffer_available)]);
+                      &private_bytes[Page::get_size() * (thread_pos*private_buffer_pool_size + buffer_available)]);
 
         file_manager.read_page(page_id, page.get_bytes());
         private_tmp_pages[thread_pos].insert({page_id, &page});
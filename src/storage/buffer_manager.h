@@ -6,18 +6,47 @@
  * must call the method BufferManager::init(), usually is the responsibility of the model (e.g. QuadModel)
  * to call it.
  *
- * A mutex object is used to prevent conflict between different threads when asking for a page or
- * unpinning a page (shared buffer).
+ * The shared buffer is split in partitions. A page is always stored in the partition given by the hash of
+ * its PageId, and each partition has its own frames, page table, clock and mutex, so threads asking for
+ * pages of different partitions don't block each other. The partition mutex is held only to search the
+ * page table and to choose a frame, the disk read is done outside of it: the frame is marked as
+ * `io_pending` and other threads asking for the same page wait only for that frame.
+ * Pages are unpinned without locking (pins is atomic).
+ *
+ * The page replaced in a partition is chosen by its ReplacementPolicy (2Q by default, so a scan doesn't evict
+ * the frequently used pages). Pages of files marked with set_hot_file() (B+Tree directories) are kept longer.
+ * Each partition counts the hits, misses and evictions of every file, get_stats() returns the totals.
+ *
+ * Pages of the shared buffer can be prefetched: prefetch() asks the OS to start reading the range
+ * (posix_fadvise) and gives the missing pages to a small pool of I/O threads that load them into frames
+ * marked as `io_pending`, so a later get_page() of a prefetched page waits only for the pending read
+ * or finds the page already in the buffer. Scans over B+Tree leaves use it to keep some leaves in flight.
+ *
+ * The list of pages in the shared buffer can be saved with dump_snapshot() and loaded again after a restart
+ * with load_snapshot(), so the buffer doesn't start empty.
+ *
+ * The memory of the frames is allocated with PageMemory, so it can be backed by huge pages to reduce TLB misses.
+ * On NUMA machines it can be interleaved between the nodes, or each partition of the shared buffer can be placed
+ * in one node together with its page table.
+ *
+ * In mmap mode (meant for read-only databases that fit in RAM), files mapped with map_file() are not read into
+ * frames: get_page() returns a page pointing directly to a read-only memory mapping of the file and pin/unpin
+ * do nothing for those pages, so there is no lookup, locking or pin counting. Files not mapped still use the
+ * shared buffer as usual.
  *
  * When asked for a page it can be done with a FileId or a TmpFileId, in the first case, the page returned will be
  * a page from the shared buffer. In the second case, the page will be returned from the private buffer of current thread
- * (that asked for it). Private and shared buffer doesn't need to have the same sizes. All buffers (shared and each private)
- * have the same systems for pages replacement.
+ * (that asked for it). Private and shared buffer doesn't need to have the same sizes. Private buffers always use CLOCK
+ * for pages replacement.
  */
 
 #pragma once
 
 #include <cassert>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <ostream>
 #include <queue>
 #include <mutex>
 #include <string>
@@ -26,21 +55,63 @@
 
 #include "storage/file_id.h"
 #include "storage/page.h"
+#include "storage/page_memory.h"
+#include "storage/replacement_policy/replacement_policy.h"
 #include "third_party/robin_hood/robin_hood.h"
 
 class Page;
 
+// access pattern of a mapped file, used to give hints to the OS
+enum class MappedFileAccess {
+    normal,
+    random,
+};
+
+// counters of the shared buffer for a file
+struct BufferStats {
+    uint64_t hits      = 0;
+    uint64_t misses    = 0;
+    uint64_t evictions = 0; // pages of the file replaced by other page
+};
+
 class BufferManager {
 public:
     static constexpr uint_fast32_t DEFAULT_SHARED_BUFFER_POOL_SIZE  = 1024 * 256; // 1 GB
     static constexpr uint_fast32_t DEFAULT_PRIVATE_BUFFER_POOL_SIZE = 1024 * 16;  // 64 MB
 
+    // the shared buffer will use the greatest power of 2 less or equal than MAX_SHARED_BUFFER_PARTITIONS
+    // such that every partition has at least MIN_PARTITION_SIZE pages
+    static constexpr uint_fast32_t MAX_SHARED_BUFFER_PARTITIONS = 64;
+    static constexpr uint_fast32_t MIN_PARTITION_SIZE           = 1024; // 4 MB
+
+    // how many pages ahead a sequential scan should prefetch, 0 disables the prefetching
+    static constexpr uint_fast32_t DEFAULT_READ_AHEAD_PAGES = 16;
+
+    // threads used to read prefetched pages
+    static constexpr uint_fast32_t PREFETCH_THREADS = 4;
+
+    // prefetch requests are ignored when there are more than this number of pages waiting to be read
+    static constexpr uint_fast32_t MAX_PENDING_PREFETCHES = 1024;
+
+    // max consecutive prefetched pages read by a prefetch thread at once
+    static constexpr uint_fast32_t MAX_PREFETCH_READ = 32;
+
+    // max consecutive pages read at once by load_snapshot()
+    static constexpr uint_fast32_t SNAPSHOT_READ_PAGES = 256; // 1 MB
+
+    // name of the snapshot file in the database folder
+    static constexpr auto SNAPSHOT_FILENAME = "buffer_snapshot.txt";
+
     ~BufferManager();
 
     // necessary to be called before first usage
     static void init(uint_fast32_t shared_buffer_pool_size,
                      uint_fast32_t private_buffer_pool_size,
-                     uint_fast32_t max_threads);
+                     uint_fast32_t max_threads,
+                     bool          mmap_enabled = false,
+                     ReplacementPolicyType replacement_policy = ReplacementPolicyType::two_queue,
+                     HugePages     huge_pages = HugePages::none,
+                     NumaPolicy    numa_policy = NumaPolicy::none);
 
     // Get a page. It will search in the shared buffer and if it is not on it, it will read from disk and put in the buffer.
     // Also it will pin the page, so calling buffer_manager.unpin(page) is expected when the caller doesn't need
@@ -61,18 +132,74 @@ public:
     // so 2 append_page in a row will work as expected.
     Page& append_page(FileId file_id);
 
+    // Asynchronously loads into the shared buffer the pages [first_page, first_page + count) of `file_id`.
+    // Pages already in the buffer and pages beyond the end of the file are ignored.
+    // The pages are not pinned, so they may be evicted before they are used.
+    // For mapped files it only tells the OS that the range will be needed soon.
+    void prefetch(FileId file_id, uint_fast32_t first_page, uint_fast32_t count);
+
+    inline uint_fast32_t get_read_ahead_pages() const noexcept { return read_ahead_pages; }
+
+    inline void set_read_ahead_pages(uint_fast32_t pages) noexcept { read_ahead_pages = pages; }
+
     // write all dirty pages to disk
     void flush();
 
+    // Writes to `path` the list of pages in the shared buffer, excluding pages of temporary files.
+    // Consecutive pages are written as a range. Returns the number of pages written
+    uint_fast32_t dump_snapshot(const std::string& path);
+
+    // consecutive pages of a file read by load_snapshot()
+    struct SnapshotRead {
+        FileId file_id;
+        uint_fast32_t first_page;
+        uint_fast32_t count;
+    };
+
+    // Returns the reads of up to SNAPSHOT_READ_PAGES consecutive pages that load the pages listed in a file
+    // written by dump_snapshot(). Pages of mapped or missing files and pages beyond the end of a file are ignored,
+    // and no more pages than the shared buffer size are read. It opens the files with the FileManager, so it must
+    // be called after the files used by the model are opened and before other threads use the FileManager
+    std::vector<SnapshotRead> read_snapshot(const std::string& path);
+
+    // Loads into the shared buffer the pages of the reads returned by read_snapshot(), using `threads` threads.
+    // Can run while queries use the buffer. Returns the number of pages loaded
+    uint_fast32_t load_snapshot(const std::vector<SnapshotRead>& reads, uint_fast32_t threads);
+
+    // true if the indexes should be read using map_file()
+    inline bool is_mmap_enabled() const noexcept { return mmap_enabled; }
+
+    // Maps the whole file in memory as read only, later calls to get_page for its pages will return pages pointing
+    // to the mapping. Must be called before any page of the file is used and while no other thread uses the
+    // BufferManager. Empty files are not mapped.
+    void map_file(FileId file_id, MappedFileAccess access);
+
+    // Pages of `file_id` will be inserted as hot pages in the replacement policy. Must be called before any page
+    // of the file is used and while no other thread uses the BufferManager.
+    void set_hot_file(FileId file_id);
+
+    // returns the hits, misses and evictions of the shared buffer for each file used since the start or
+    // the last reset_stats()
+    std::map<FileId, BufferStats> get_stats();
+
+    void reset_stats();
+
+    // prints get_stats() using the filenames
+    void print_stats(std::ostream& os);
+
     // increases the count of objects using the page. When you get a page using the methods get_page or get_tmp_page
     // the page is already pinned, so you shouldn't call this method unless you want to pin the page more than once
     void pin(Page& page) {
-        page.pin();
+        if (!page.mapped) {
+            page.pin();
+        }
     }
 
     // reduces the count of objects using the page. Should be called when a object using the page is destroyed.
     void unpin(Page& page) {
-        page.unpin();
+        if (!page.mapped) {
+            page.unpin();
+        }
     }
 
     // invalidates all pages using `file_id` in shared buffer
@@ -83,15 +210,50 @@ public:
 
     constexpr auto get_shared_buffer_pool_size() const noexcept { return shared_buffer_pool_size; }
 
+    inline auto get_shared_buffer_partitions() const noexcept { return partition_count; }
+
+    // huge pages used by the shared buffer, may be different from the requested if they were not available
+    inline HugePages get_huge_pages() const noexcept { return shared_huge_pages; }
+
     uint_fast32_t get_private_buffer_index();
 
 private:
     BufferManager(uint_fast32_t shared_buffer_pool_size,
                   uint_fast32_t private_buffer_pool_size,
-                  uint_fast32_t max_threads);
+                  uint_fast32_t max_threads,
+                  bool          mmap_enabled,
+                  ReplacementPolicyType replacement_policy,
+                  HugePages     huge_pages,
+                  NumaPolicy    numa_policy);
+
+    // a file mapped with map_file(), it has a page object for each page of the file
+    struct MappedFile {
+        char* bytes;
+        uint_fast32_t page_count;
+        std::unique_ptr<Page[]> pages;
+    };
+
+    // A slice of the shared buffer. Aligned to avoid false sharing between the mutexes of different partitions
+    struct alignas(64) SharedBufferPartition {
+        // protects `pages`, `replacement_policy`, `file_stats` and the `io_pending` state of the frames of this partition
+        std::mutex mutex;
+
+        // notified when a page of this partition finishes its disk read
+        std::condition_variable io_done;
 
-    // simple clock used to page replacement in the shared buffer
-    uint_fast32_t clock_pos;
+        // used to search the index in the `buffer_pool` of a certain page
+        robin_hood::unordered_map<PageId, Page*> pages;
+
+        // chooses the frames to replace, works with frame numbers relative to first_frame
+        std::unique_ptr<ReplacementPolicy> replacement_policy;
+
+        // statistics of this partition, indexed by file descriptor
+        robin_hood::unordered_flat_map<int, BufferStats> file_stats;
+
+        // this partition uses the pages [first_frame, first_frame + frame_count) of the `buffer_pool`
+        uint_fast32_t first_frame = 0;
+        uint_fast32_t frame_count = 0;
+    };
 
     // array of `buffer_pool_size` pages
     Page* const buffer_pool;
@@ -99,13 +261,20 @@ private:
     // private buffer pools
     Page* const private_buffer_pool;
 
+    // huge pages used by `bytes` and `private_bytes`, set by PageMemory::allocate()
+    HugePages shared_huge_pages;
+    HugePages private_huge_pages;
+
+    const NumaPolicy numa_policy;
+
     // beginning of the allocated memory for the pages of the shared buffer
     char* const bytes;
 
     // beginning of the allocated memory for the pages of the private buffer
     char* const private_bytes;
 
-    std::mutex shared_buffer_mutex;
+    // number of private buffers
+    const uint_fast32_t max_threads;
 
     // maximum pages the buffer can have
     const uint_fast32_t shared_buffer_pool_size;
@@ -113,8 +282,52 @@ private:
     // maximum pages for each private buffer
     const uint_fast32_t private_buffer_pool_size;
 
-    // used to search the index in the `buffer_pool` of a certain page
-    robin_hood::unordered_map<PageId, Page*> pages;
+    // number of partitions of the shared buffer, always a power of 2
+    const uint_fast32_t partition_count;
+
+    // array of `partition_count` partitions
+    std::unique_ptr<SharedBufferPartition[]> partitions;
+
+    const bool mmap_enabled;
+
+    // indexed by file descriptor, true for files whose pages are inserted as hot
+    std::vector<bool> hot_files;
+
+    // mapped files indexed by file descriptor, nullptr if the file is not mapped
+    std::vector<std::unique_ptr<MappedFile>> mapped_files;
+
+    // returns the mapped file of `file_id` or nullptr if it isn't mapped
+    inline MappedFile* get_mapped_file(FileId file_id) const noexcept {
+        if (static_cast<size_t>(file_id.id) < mapped_files.size()) {
+            return mapped_files[file_id.id].get();
+        }
+        return nullptr;
+    }
+
+    // pages scans will prefetch ahead, 0 means disabled
+    uint_fast32_t read_ahead_pages;
+
+    // pages claimed by prefetch() that are waiting to be read by a prefetch thread.
+    // They are pinned and marked as io_pending until the read is done
+    std::queue<Page*> prefetch_queue;
+
+    // protects `prefetch_queue` and `stop_prefetch_threads`
+    std::mutex prefetch_mutex;
+
+    std::condition_variable prefetch_queue_not_empty;
+
+    bool stop_prefetch_threads;
+
+    std::vector<std::thread> prefetch_threads;
+
+    // reads the pages from `prefetch_queue` until `stop_prefetch_threads` is true and the queue is empty
+    void process_prefetches();
+
+    // marks a page whose read has finished as available
+    void finish_page_read(Page& page);
+
+    // reads the pages of the range that are not in the shared buffer, returns the number of pages read
+    uint_fast32_t load_pages(FileId file_id, uint_fast32_t first_page, uint_fast32_t count);
 
     // available private positions queue
     std::queue<uint_fast32_t> available_private_positions;
@@ -128,8 +341,24 @@ private:
     // simple clock used to page replacement in the private buffer
     std::vector<uint_fast32_t> private_clock_pos;
 
-    // returns the index of an unpinned page from shared buffer (`buffer_pool`)
-    uint_fast32_t get_buffer_available();
+    // returns the index of an unpinned page from shared buffer (`buffer_pool`) belonging to `partition`.
+    // The partition mutex must be locked by the caller
+    uint_fast32_t get_buffer_available(SharedBufferPartition& partition);
+
+    // chooses a frame for `page_id` in `partition` and inserts it in the page table. The page returned is pinned
+    // and marked as io_pending, its bytes must be read and then finish_page_read() must be called.
+    // The partition mutex must be locked by the caller
+    Page& claim_frame(SharedBufferPartition& partition, PageId page_id);
+
+    static uint_fast32_t compute_partition_count(uint_fast32_t shared_buffer_pool_size);
+
+    // binds the frames of each partition to a NUMA node, must be called before the frames are used
+    void bind_partitions_to_nodes();
+
+    inline SharedBufferPartition& get_partition(PageId page_id) const noexcept {
+        const uint64_t key = (static_cast<uint64_t>(page_id.file_id.id) << 32) | page_id.page_number;
+        return partitions[robin_hood::hash_int(key) & (partition_count - 1)];
+    }
 
     // returns the index of an unpinned page from the private buffer (`private_buffer_pool[thread_number]`)
     uint_fast32_t get_private_buffer_available(uint_fast32_t thread_number);
@@ -4,10 +4,14 @@
 #include <stdexcept>
 
 #include "storage/file_manager.h"
+#include "storage/page.h"
 
 using namespace std;
 
-Catalog::Catalog(const string& filename) {
+Catalog::Catalog(const string& filename) :
+    page_size         (Page::get_size()),
+    compressed_leaves (false)
+{
     auto file_path = file_manager.get_file_path(filename);
     file.open(file_path, ios::out|ios::app);
     if (file.fail()) {
@@ -85,6 +89,63 @@ vector<string> Catalog::read_strvec() {
 }
 
 
+TopValues Catalog::read_top_values() {
+    TopValues res;
+    std::vector<std::pair<uint64_t, uint64_t>> values;
+    const auto size = read_uint64();
+    for (uint64_t i = 0; i < size; ++i) {
+        auto value = read_uint64();
+        auto count = read_uint64();
+        values.push_back({ value, count });
+    }
+    res.set(move(values));
+    return res;
+}
+
+
+EquiDepthHistogram Catalog::read_histogram() {
+    EquiDepthHistogram res;
+    res.min = read_uint64();
+    const auto size = read_uint64();
+    for (uint64_t i = 0; i < size; ++i) {
+        res.bounds.push_back(read_uint64());
+    }
+    return res;
+}
+
+
+void Catalog::read_storage_settings() {
+    if (file.peek() == char_traits<char>::eof()) {
+        file.clear();
+        page_size = Page::MDB_PAGE_SIZE;
+    } else {
+        page_size = read_uint64();
+    }
+
+    if (file.peek() == char_traits<char>::eof()) {
+        file.clear();
+        compressed_leaves = false;
+    } else {
+        compressed_leaves = read_uint64() != 0;
+    }
+}
+
+
+void Catalog::write_storage_settings() {
+    write_uint64(page_size);
+    write_uint64(compressed_leaves ? 1 : 0);
+}
+
+
+bool Catalog::read_finished() {
+    if (file.peek() == char_traits<char>::eof()) {
+        file.clear();
+        return true;
+    }
+    return false;
+}
+
+
 void Catalog::write_uint64(const uint64_t n) {
     uint8_t buf[8];
     for (unsigned int i = 0, shift = 0; i < sizeof(buf); ++i, shift += 8) {
@@ -112,4 +173,22 @@ void Catalog::write_strvec(const vector<string>& strvec) {
     for (const auto& str : strvec) {
         write_string(str);
     }
-}
\ No newline at end of file
+}
+
+
+void Catalog::write_top_values(const TopValues& top_values) {
+    write_uint64(top_values.values.size());
+    for (auto& [value, count] : top_values.values) {
+        write_uint64(value);
+        write_uint64(count);
+    }
+}
+
+
+void Catalog::write_histogram(const EquiDepthHistogram& histogram) {
+    write_uint64(histogram.min);
+    write_uint64(histogram.bounds.size());
+    for (auto bound : histogram.bounds) {
+        write_uint64(bound);
+    }
+}
@@ -4,7 +4,16 @@
 #include <string>
 #include <vector>
 
+#include "storage/catalog/column_stats.h"
+
 class Catalog {
+public:
+    // size of the pages of the database, saved at the end of the catalog
+    uint64_t page_size;
+
+    // true if the B+Trees were imported with compressed leaves, they can't be modified
+    bool compressed_leaves;
+
 protected:
     Catalog(const std::string& filename);
     ~Catalog();
@@ -24,6 +33,21 @@ protected:
     void write_string(const std::string&);
     void write_strvec(const std::vector<std::string>& strvec);
 
+    TopValues read_top_values();
+    EquiDepthHistogram read_histogram();
+
+    void write_top_values(const TopValues&);
+    void write_histogram(const EquiDepthHistogram&);
+
+    // should be called after reading/writing the rest of the catalog. Catalogs of databases created before
+    // these settings existed don't have them and use Page::MDB_PAGE_SIZE and uncompressed leaves
+    void read_storage_settings();
+    void write_storage_settings();
+
+    // true if everything in the catalog was read. The statistics added after the storage settings are missing
+    // in catalogs of older databases.
+    bool read_finished();
+
 private:
     std::fstream file;
 };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// The most frequent values of a column (heavy hitters) with how many times they appear. The values that are not
+// in the list are assumed to be uniformly distributed, so a few very frequent values don't distort the estimation
+// of the rest.
+struct TopValues {
+    // pairs (value, count) ordered by value
+    std::vector<std::pair<uint64_t, uint64_t>> values;
+
+    // sum of the counts of the values
+    uint64_t values_count = 0;
+
+    void set(std::vector<std::pair<uint64_t, uint64_t>>&& _values) {
+        values = std::move(_values);
+        std::sort(values.begin(), values.end());
+        values_count = 0;
+        for (auto& [value, count] : values) {
+            values_count += count;
+        }
+    }
+
+    // returns 0 if value is not a frequent value
+    uint64_t count_of(uint64_t value) const {
+        auto it = std::lower_bound(values.begin(), values.end(), std::make_pair(value, uint64_t(0)));
+        if (it != values.end() && it->first == value) {
+            return it->second;
+        }
+        return 0;
+    }
+
+    // estimated number of times value appears in a column with `count` elements and `distinct` different values
+    double estimate_count(uint64_t value, double count, double distinct) const {
+        const auto frequent_count = count_of(value);
+        if (frequent_count > 0) {
+            return static_cast<double>(frequent_count);
+        }
+        const double rest_count    = count - values_count;
+        const double rest_distinct = distinct - values.size();
+        if (rest_count <= 0 || rest_distinct <= 0) {
+            return 0;
+        }
+        return rest_count / rest_distinct;
+    }
+};
+
+
+// Equi-depth histogram: every bucket has the same number of elements of the column. Used for the values of the
+// properties, whose ObjectIds preserve the order of the integers.
+struct EquiDepthHistogram {
+    // smallest value of the column
+    uint64_t min = 0;
+
+    // bounds[i] is the greatest value of the bucket i
+    std::vector<uint64_t> bounds;
+
+    // estimated fraction of the elements of the column that are in [lo, hi], interpolating linearly the ids inside
+    // the buckets. Returns a negative number if the histogram is empty.
+    double estimate_fraction(uint64_t lo, uint64_t hi) const {
+        if (bounds.empty()) {
+            return -1;
+        }
+        if (lo > hi) {
+            return 0;
+        }
+        double buckets = 0;
+        uint64_t bucket_lo = min;
+        for (auto bucket_hi : bounds) {
+            if (lo <= bucket_hi && hi >= bucket_lo) {
+                if (bucket_hi == bucket_lo) {
+                    buckets += 1;
+                } else {
+                    const auto overlap_lo = std::max(lo, bucket_lo);
+                    const auto overlap_hi = std::min(hi, bucket_hi);
+                    buckets += (static_cast<double>(overlap_hi - overlap_lo) + 1)
+                               / (static_cast<double>(bucket_hi - bucket_lo) + 1);
+                }
+            }
+            bucket_lo = bucket_hi;
+        }
+        return buckets / bounds.size();
+    }
+};
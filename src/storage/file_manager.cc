@@ -1,8 +1,10 @@
 #include "file_manager.h"
 
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <new>         // placement new
@@ -22,7 +24,8 @@ FileManager& file_manager = reinterpret_cast<FileManager&>(file_manager_buf);
 
 
 FileManager::FileManager(const std::string& db_folder) :
-    db_folder(db_folder)
+    db_folder  (db_folder),
+    file_pages (new std::atomic<uint_fast32_t>[MAX_CACHED_FILE_SIZES])
 {
     if (Filesystem::exists(db_folder)) {
         if (!Filesystem::is_directory(db_folder)) {
@@ -40,10 +43,48 @@ void FileManager::init(const std::string& db_folder) {
 }
 
 
+uint_fast32_t FileManager::count_pages(FileId file_id) const noexcept {
+    if (file_id.id < MAX_CACHED_FILE_SIZES) {
+        return file_pages[file_id.id];
+    }
+    struct stat buf;
+    fstat(file_id.id, &buf);
+    return buf.st_size / Page::get_size();
+}
+
+
+void FileManager::cache_file_size(FileId file_id) {
+    if (file_id.id < MAX_CACHED_FILE_SIZES) {
+        struct stat buf;
+        fstat(file_id.id, &buf);
+        file_pages[file_id.id] = buf.st_size / Page::get_size();
+    }
+}
+
+
+void FileManager::extend(FileId file_id, uint_fast32_t page_count) const {
+    std::lock_guard<std::mutex> lck(extend_mutex);
+    // other thread may have extended the file more, files never shrink
+    if (count_pages(file_id) >= page_count) {
+        return;
+    }
+    auto res = ftruncate(file_id.id, static_cast<off_t>(page_count) * Page::get_size());
+    if (res == -1) {
+        throw std::runtime_error("Could not write into file");
+    }
+    if (file_id.id < MAX_CACHED_FILE_SIZES) {
+        file_pages[file_id.id] = page_count;
+    }
+}
+
+
 void FileManager::flush(Page& page) const {
     auto fd = page.page_id.file_id.id;
-    lseek(fd, page.page_id.page_number*Page::MDB_PAGE_SIZE, SEEK_SET);
-    auto write_res = write(fd, page.get_bytes(), Page::MDB_PAGE_SIZE);
+    // positional write, the file offset is shared between threads
+    auto write_res = pwrite(fd,
+                            page.get_bytes(),
+                            Page::get_size(),
+                            static_cast<off_t>(page.page_id.page_number) * Page::get_size());
     if (write_res == -1) {
         throw std::runtime_error("Could not write into file when flushing page");
     }
@@ -51,33 +92,81 @@ void FileManager::flush(Page& page) const {
 }
 
 
-void FileManager::read_page(PageId page_id, char* bytes) const {
-    auto fd = page_id.file_id.id;
-    lseek(fd, 0, SEEK_END);
+void FileManager::flush_pages(Page** pages, uint_fast32_t count) const {
+    iovec iov[MAX_IO_VECTOR];
+    for (uint_fast32_t i = 0; i < count; i += MAX_IO_VECTOR) {
+        const auto batch_size = std::min(MAX_IO_VECTOR, count - i);
+        for (uint_fast32_t j = 0; j < batch_size; j++) {
+            assert(pages[i + j]->page_id.file_id == pages[i]->page_id.file_id);
+            assert(pages[i + j]->page_id.page_number == pages[i]->page_id.page_number + j);
+            iov[j].iov_base = pages[i + j]->get_bytes();
+            iov[j].iov_len  = Page::get_size();
+        }
+        const auto offset = static_cast<off_t>(pages[i]->page_id.page_number) * Page::get_size();
+        const auto expected_size = static_cast<ssize_t>(batch_size * Page::get_size());
+        if (pwritev(pages[i]->page_id.file_id.id, iov, batch_size, offset) != expected_size) {
+            throw std::runtime_error("Could not write into file when flushing pages");
+        }
+        for (uint_fast32_t j = 0; j < batch_size; j++) {
+            pages[i + j]->dirty = false;
+        }
+    }
+}
 
-    struct stat buf;
-    fstat(fd, &buf);
-    uint64_t file_size = buf.st_size;
 
-    lseek(fd, page_id.page_number*Page::MDB_PAGE_SIZE, SEEK_SET);
-    if (file_size/Page::MDB_PAGE_SIZE <= page_id.page_number) {
+void FileManager::read_page(PageId page_id, char* bytes) const {
+    if (page_id.page_number >= count_pages(page_id.file_id)) {
         // new file page, write zeros
-        memset(bytes, 0, Page::MDB_PAGE_SIZE);
-        auto write_res = ftruncate(fd, Page::MDB_PAGE_SIZE*page_id.page_number);
-
-        if (write_res == -1) {
-            throw std::runtime_error("Could not write into file");
-        }
+        memset(bytes, 0, Page::get_size());
+        extend(page_id.file_id, page_id.page_number + 1);
     } else {
         // reading existing file page
-        auto read_res = read(fd, bytes, Page::MDB_PAGE_SIZE);
-        if (read_res == -1) {
+        // positional read, the file offset is shared between threads
+        auto read_res = pread(page_id.file_id.id,
+                              bytes,
+                              Page::get_size(),
+                              static_cast<off_t>(page_id.page_number) * Page::get_size());
+        // the page exists, so reading less than a page means the file was truncated or there was an error
+        if (read_res != static_cast<ssize_t>(Page::get_size())) {
             throw std::runtime_error("Could not read file page");
         }
     }
 }
 
 
+void FileManager::read_pages(FileId file_id, uint_fast32_t first_page, char** bytes, uint_fast32_t count) const {
+    const auto page_count = count_pages(file_id);
+    // pages at the end of the file that doesn't exist yet are handled by read_page
+    const auto existing_pages = first_page >= page_count ? 0 : std::min(count, page_count - first_page);
+
+    iovec iov[MAX_IO_VECTOR];
+    for (uint_fast32_t i = 0; i < existing_pages; i += MAX_IO_VECTOR) {
+        const auto batch_size = std::min(MAX_IO_VECTOR, existing_pages - i);
+        for (uint_fast32_t j = 0; j < batch_size; j++) {
+            iov[j].iov_base = bytes[i + j];
+            iov[j].iov_len  = Page::get_size();
+        }
+        const auto offset = static_cast<off_t>(first_page + i) * Page::get_size();
+        const auto expected_size = static_cast<ssize_t>(batch_size * Page::get_size());
+        if (preadv(file_id.id, iov, batch_size, offset) != expected_size) {
+            throw std::runtime_error("Could not read file pages");
+        }
+    }
+    for (auto i = existing_pages; i < count; i++) {
+        read_page(PageId(file_id, first_page + i), bytes[i]);
+    }
+}
+
+
+void FileManager::advise_will_need(FileId file_id, uint_fast32_t first_page, uint_fast32_t count) const {
+    // only a hint, errors can be ignored
+    posix_fadvise(file_id.id,
+                  static_cast<off_t>(first_page) * Page::get_size(),
+                  static_cast<off_t>(count) * Page::get_size(),
+                  POSIX_FADV_WILLNEED);
+}
+
+
 FileId FileManager::get_file_id(const string& filename) {
     auto search = filename2file_id.find(filename);
     if (search != filename2file_id.end()) {
@@ -90,12 +179,23 @@ FileId FileManager::get_file_id(const string& filename) {
             throw std::runtime_error("Could not open file " + file_path);
         }
         const auto res = FileId(fd);
+        cache_file_size(res);
         filename2file_id.insert({ filename, res });
         return res;
     }
 }
 
 
+std::string FileManager::get_filename(FileId file_id) const {
+    for (auto& [filename, id] : filename2file_id) {
+        if (id == file_id) {
+            return filename;
+        }
+    }
+    return "";
+}
+
+
 TmpFileId FileManager::get_tmp_file_id() {
     std::FILE* tmpf = std::tmpfile();
     auto fd = fileno(tmpf);
@@ -103,6 +203,7 @@ TmpFileId FileManager::get_tmp_file_id() {
         throw std::runtime_error("Could not open temp file");
     }
     const auto file_id = FileId(fd);
+    cache_file_size(file_id);
     return TmpFileId(buffer_manager.get_private_buffer_index(), file_id);
 }
 
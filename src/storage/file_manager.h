@@ -15,13 +15,20 @@
  * needs to call the method FileManager::init(), usually is the responsibility of the model (e.g. RelationalModel)
  * to call it.
  *
+ * Pages are read and written with positional I/O (pread/pwrite and their vectored versions), so threads can
+ * use the same file descriptor at the same time without synchronization. The size in pages of every opened
+ * file is cached, a read of a page beyond the end of the file extends the file instead of reading it.
+ *
  * The instance `file_manager` cannot be destroyed before the BufferManager flushes its dirty pages on exit
  * because BufferManager needs to access the file paths from FileManager.
  */
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unistd.h>
 
@@ -44,33 +51,61 @@ public:
     TmpFileId get_tmp_file_id();
 
     // count how many pages a file have
-    uint_fast32_t count_pages(FileId file_id) const {
-        // We don't need mutex here as long as db is readonly
-        return lseek(file_id.id, 0, SEEK_END) / Page::MDB_PAGE_SIZE;
-    }
+    uint_fast32_t count_pages(FileId file_id) const noexcept;
 
     // // delete the file represented by `tmp_file_id`, pages in private buffer using that tmp_file_id are cleared
     void remove_tmp(TmpFileId tmp_file_id);
 
+    // returns the filename used to get `file_id` or an empty string for temporary files
+    std::string get_filename(FileId file_id) const;
+
     inline const std::string get_file_path(const std::string& filename) const noexcept {
         return db_folder + "/" + filename;
     }
 
 private:
+    // files with a file descriptor greater or equal than this don't have their size cached
+    static constexpr int MAX_CACHED_FILE_SIZES = 4096;
+
+    // max pages written or read by a single vectored I/O syscall
+    static constexpr uint_fast32_t MAX_IO_VECTOR = 256;
+
     // folder where all the used files will be
     const std::string db_folder;
 
     std::map<std::string, FileId> filename2file_id;
 
+    // size in pages of each opened file, indexed by file descriptor
+    std::unique_ptr<std::atomic<uint_fast32_t>[]> file_pages;
+
+    // to extend files, reading pages don't need it
+    mutable std::mutex extend_mutex;
+
     // private constructor, other classes must use the global object `file_manager`
     FileManager(const std::string& db_folder);
 
     // page back to disk
     void flush(Page& page_id) const;
 
+    // write back `count` pages of the same file with consecutive page numbers, in a single syscall
+    // when possible. `pages` must be sorted by page number
+    void flush_pages(Page** pages, uint_fast32_t count) const;
+
     // read a page from disk into memory pointed by `bytes`.
-    // `bytes` must point to the start memory position of `Page::MDB_PAGE_SIZE` allocated bytes
+    // `bytes` must point to the start memory position of `Page::get_size()` allocated bytes
     void read_page(PageId page_id, char* bytes) const;
+
+    // read the pages [first_page, first_page + count) of a file, the page `first_page + i` is read into `bytes[i]`
+    void read_pages(FileId file_id, uint_fast32_t first_page, char** bytes, uint_fast32_t count) const;
+
+    // makes the file have at least `page_count` pages, new pages are filled with zeros
+    void extend(FileId file_id, uint_fast32_t page_count) const;
+
+    // sets the cached size of a file just opened
+    void cache_file_size(FileId file_id);
+
+    // tells the OS that the pages [first_page, first_page + count) will be read soon
+    void advise_will_need(FileId file_id, uint_fast32_t first_page, uint_fast32_t count) const;
 };
 
 extern FileManager& file_manager; // global object
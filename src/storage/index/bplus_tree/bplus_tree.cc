@@ -1,8 +1,10 @@
 #include "bplus_tree.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "base/exceptions.h"
+#include "base/thread/thread_counters.h"
 #include "storage/buffer_manager.h"
 #include "storage/file_manager.h"
 #include "storage/index/ordered_file/ordered_file.h"
@@ -10,11 +12,26 @@
 
 using namespace std;
 
+// the files have to be registered in the buffer manager before getting the root
+static Page& get_root_page(FileId dir_file_id, FileId leaf_file_id) {
+    if (buffer_manager.is_mmap_enabled()) {
+        // directories are accessed by lookups, leaves by lookups and scans (scans advise the pages they will read)
+        buffer_manager.map_file(dir_file_id, MappedFileAccess::random);
+        buffer_manager.map_file(leaf_file_id, MappedFileAccess::normal);
+    } else {
+        // every search goes through the directory
+        buffer_manager.set_hot_file(dir_file_id);
+    }
+    return buffer_manager.get_page(dir_file_id, 0);
+}
+
+
 template <std::size_t N>
 BPlusTree<N>::BPlusTree(const std::string& name) :
     dir_file_id  (file_manager.get_file_id(name + ".dir")),
     leaf_file_id (file_manager.get_file_id(name + ".leaf")),
-    root         (BPlusTreeDir<N>(leaf_file_id, buffer_manager.get_page(dir_file_id, 0))) { }
+    root         (BPlusTreeDir<N>(leaf_file_id, get_root_page(dir_file_id, leaf_file_id))),
+    dir_cache    (dir_file_id) { }
 
 
 template <std::size_t N>
@@ -33,7 +50,7 @@ void BPlusTree<N>::bulk_import(OrderedFile<N>& leaf_provider) {
     if (last_page_number > 0) {
         *first_leaf.next_leaf = 1;
     }
-    first_leaf.page.make_dirty();
+    first_leaf.page->make_dirty();
 
     uint_fast32_t current_page = 1;
     while (current_page <= last_page_number) {
@@ -48,9 +65,10 @@ void BPlusTree<N>::bulk_import(OrderedFile<N>& leaf_provider) {
         }
 
         root.bulk_insert(new_leaf);
-        new_leaf.page.make_dirty();
+        new_leaf.page->make_dirty();
         current_page = next_page;
     }
+    dir_cache.build();
 }
 
 
@@ -58,14 +76,33 @@ template <std::size_t N>
 unique_ptr<BptIter<N>> BPlusTree<N>::get_range(bool* interruption_requested,
                                                const Record<N>& min,
                                                const Record<N>& max) const noexcept {
-    auto leaf_and_pos = root.search_leaf(min);
-    return make_unique<BptIter<N>>(interruption_requested, std::move(leaf_and_pos), max);
+    return make_unique<BptIter<N>>(interruption_requested, search_leaf(min), max);
+}
+
+
+template <std::size_t N>
+SearchLeafResult<N> BPlusTree<N>::search_leaf(const Record<N>& min) const noexcept {
+    ThreadCounters::index_seeks++;
+    auto leaf = make_unique<BPlusTreeLeaf<N>>(buffer_manager.get_page(leaf_file_id,
+                                                                      dir_cache.search_leaf_number(min)));
+    const auto index = leaf->search_index(min);
+    return SearchLeafResult(move(leaf), index);
 }
 
 
 template <std::size_t N>
 void BPlusTree<N>::insert(const Record<N>& record) {
+    const auto dir_pages  = file_manager.count_pages(dir_file_id);
+    const auto leaf_pages = file_manager.count_pages(leaf_file_id);
     root.insert(record);
+
+    // a leaf split adds a key to the directory page in the path of the record, and if that page
+    // also splits new directory pages are created
+    if (file_manager.count_pages(dir_file_id) != dir_pages) {
+        dir_cache.build();
+    } else if (file_manager.count_pages(leaf_file_id) != leaf_pages) {
+        dir_cache.reload_path(record);
+    }
 }
 
 
@@ -83,18 +120,19 @@ BptIter<N>::BptIter(bool* interruption_requested,
     interruption_requested (interruption_requested),
     max                    (max),
     current_pos            (leaf_and_pos.result_index),
-    current_leaf           (move(leaf_and_pos.leaf))
+    current_leaf           (move(leaf_and_pos.leaf)),
+    prefetched_until       (0)
 { }
 
 
 template <std::size_t N>
-unique_ptr<Record<N>> BptIter<N>::next() {
+const Record<N>* BptIter<N>::next() {
     while (true) {
         if (__builtin_expect(!!(*interruption_requested), 0)) {
             throw InterruptedException();
         }
         if (current_pos < current_leaf->get_value_count()) {
-            unique_ptr<Record<N>> res = current_leaf->get_record(current_pos);
+            const Record<N>* res = &current_leaf->get_record(current_pos);
             // check if res is less than max
             for (unsigned int i = 0; i < N; ++i) {
                 if (res->ids[i] < max.ids[i]) {
@@ -110,7 +148,8 @@ unique_ptr<Record<N>> BptIter<N>::next() {
             return res; // res == max
         }
         else if (current_leaf->has_next()) {
-            current_leaf = current_leaf->get_next_leaf();
+            read_ahead(current_leaf->get_next_leaf_number());
+            current_leaf->move_to_next_leaf();
             current_pos = 0;
             // continue while
         }
@@ -120,6 +159,85 @@ unique_ptr<Record<N>> BptIter<N>::next() {
     }
 }
 
+
+template <std::size_t N>
+bool BptIter<N>::seek_in_leaf(const Record<N>& min, const Record<N>& _max) {
+    const auto count = current_leaf->get_value_count();
+    if (count == 0 || min < current_leaf->get_record(0) || current_leaf->get_record(count - 1) < min) {
+        return false;
+    }
+    current_pos = current_leaf->search_index(min);
+    max = _max;
+    return true;
+}
+
+
+template <std::size_t N>
+void BptIter<N>::seek(uint32_t leaf_number, const Record<N>& min, const Record<N>& _max) {
+    ThreadCounters::index_seeks++;
+    current_leaf->move_to_leaf(leaf_number);
+    current_pos = current_leaf->search_index(min);
+    max = _max;
+}
+
+
+template <std::size_t N>
+void BptIter<N>::seek(uint32_t leaf_number, uint_fast32_t pos, const Record<N>& _max) {
+    current_leaf->move_to_leaf(leaf_number);
+    current_pos = pos;
+    max = _max;
+}
+
+
+template <std::size_t N>
+RecordSpan<N> BptIter<N>::next_block() {
+    if (__builtin_expect(!!(*interruption_requested), 0)) {
+        throw InterruptedException();
+    }
+    while (current_pos >= current_leaf->get_value_count()) {
+        if (!current_leaf->has_next()) {
+            return RecordSpan<N> { nullptr, 0 };
+        }
+        read_ahead(current_leaf->get_next_leaf_number());
+        current_leaf->move_to_next_leaf();
+        current_pos = 0;
+    }
+    const auto first = &current_leaf->get_record(current_pos);
+    const auto last  = &current_leaf->get_record(current_leaf->get_value_count() - 1);
+
+    uint_fast32_t count;
+    if (*last <= max) {
+        count = current_leaf->get_value_count() - current_pos;
+    } else {
+        // the range ends in this leaf, search the first record greater than max
+        count = std::upper_bound(first, last, max) - first;
+    }
+    current_pos += count;
+    return RecordSpan<N> { first, count };
+}
+
+
+template <std::size_t N>
+void BptIter<N>::read_ahead(uint32_t leaf_number) {
+    const auto read_ahead_pages = buffer_manager.get_read_ahead_pages();
+    // only sequential scans are prefetched, the first leaf change of the iterator is not prefetched
+    // so short range searches don't read pages they won't use
+    if (read_ahead_pages == 0 || leaf_number != current_leaf->get_page().get_page_number() + 1) {
+        return;
+    }
+    // prefetch again when the scan has consumed half of the prefetched leaves
+    if (prefetched_until == 0) {
+        prefetched_until = leaf_number + 1;
+    } else if (leaf_number + read_ahead_pages/2 >= prefetched_until) {
+        const auto first = std::max(prefetched_until, leaf_number + 1);
+        const auto last  = leaf_number + 1 + read_ahead_pages;
+        if (first < last) {
+            buffer_manager.prefetch(current_leaf->get_page().page_id.file_id, first, last - first);
+        }
+        prefetched_until = last;
+    }
+}
+
 template class BPlusTree<1>;
 template class BPlusTree<2>;
 template class BPlusTree<3>;
@@ -6,28 +6,73 @@
 #include "storage/file_id.h"
 #include "storage/index/bplus_tree/bplus_tree_dir.h"
 #include "storage/index/bplus_tree/bplus_tree_leaf.h"
+#include "storage/index/bplus_tree/bpt_dir_cache.h"
 #include "storage/index/record.h"
 
 template <std::size_t N> class OrderedFile;
 
+// contiguous records of a leaf
+template <std::size_t N> struct RecordSpan {
+    const Record<N>* records;
+    uint_fast32_t    count;
+
+    bool empty()                const noexcept { return count == 0; }
+    const Record<N>* begin()    const noexcept { return records; }
+    const Record<N>* end()      const noexcept { return records + count; }
+    const Record<N>& operator[](uint_fast32_t i) const noexcept { return records[i]; }
+};
+
 template <std::size_t N> class BptIter {
 public:
     BptIter(bool* interruption_requested, SearchLeafResult<N>&& leaf_and_pos, const Record<N>& max) noexcept;
-    std::unique_ptr<Record<N>> next();
+
+    // Returns the next record or nullptr if there are no more records in the range. The record is not copied,
+    // the pointer points to the pinned leaf and is valid until the next call or until the iterator is destroyed
+    const Record<N>* next();
+
+    // Returns the records of the range that were not returned yet from the current leaf, or from the following
+    // leaf if the current one was consumed. An empty span means there are no more records in the range.
+    // Like next() the records point to the pinned leaf and are valid until the following call to next() or
+    // next_block(). Both methods can be mixed.
+    RecordSpan<N> next_block();
+
+    // Starts the iteration of the range [min, max] in the current leaf, without pinning other pages. Returns
+    // false and doesn't change the iterator if min is not between the first and the last records of the leaf.
+    bool seek_in_leaf(const Record<N>& min, const Record<N>& max);
+
+    // Starts the iteration of the range [min, max] from the leaf `leaf_number`, that must be the leaf where the
+    // search of min starts (see BPlusTree::search_leaf_number). The leaf of the iterator is moved there, so the
+    // records of a compressed leaf are decoded into the same buffer
+    void seek(uint32_t leaf_number, const Record<N>& min, const Record<N>& max);
+
+    // Like seek(), but the iteration starts at the position `pos` of the leaf
+    void seek(uint32_t leaf_number, uint_fast32_t pos, const Record<N>& max);
 
 private:
     bool* const interruption_requested;
-    const Record<N> max;
+    Record<N> max;
     uint32_t current_pos;
     std::unique_ptr<BPlusTreeLeaf<N>> current_leaf;
+
+    // leaves before this page number were already prefetched
+    uint32_t prefetched_until;
+
+    // called when the scan moves to the leaf `leaf_number`. When leaves are contiguous on disk (as bulk import
+    // writes them) it prefetches the following leaves, so they are read while the current ones are processed
+    void read_ahead(uint32_t leaf_number);
 };
 
 
 template <std::size_t N> class BPlusTree {
 public:
-    // (MDB_PAGE_SIZE - SIZE_OF(value_count) - SIZE_OF(next_leaf)) / (SIZE_OF(UINT64) * N)
-    static constexpr auto leaf_max_records = (Page::MDB_PAGE_SIZE - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N);
-    static constexpr auto dir_max_records  = (Page::MDB_PAGE_SIZE - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N + sizeof(int32_t));
+    // (page size - SIZE_OF(value_count) - SIZE_OF(next_leaf)) / (SIZE_OF(UINT64) * N)
+    static inline uint_fast32_t leaf_max_records() noexcept {
+        return (Page::get_size() - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N);
+    }
+
+    static inline uint_fast32_t dir_max_records() noexcept {
+        return (Page::get_size() - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N + sizeof(int32_t));
+    }
 
     BPlusTree(const std::string& name);
 
@@ -44,9 +89,32 @@ public:
                                           const Record<N>& min,
                                           const Record<N>& max) const noexcept;
 
+    // returns the leaf and the position of the first record r >= min, like BPlusTreeDir::search_leaf but
+    // the directory is read from dir_cache, only the leaf is pinned
+    SearchLeafResult<N> search_leaf(const Record<N>& min) const noexcept;
+
+    // page number of the leaf where search_leaf would start, to move an existing leaf there
+    uint32_t search_leaf_number(const Record<N>& min) const noexcept { return dir_cache.search_leaf_number(min); }
+
+    // number of directory levels in the path from the root to the leaves
+    uint_fast32_t get_height() const noexcept { return dir_cache.get_height(); }
+
+    // keys of the directory that split [min, max] in at least `count` parts if possible, see
+    // BPTDirCache::get_separators
+    uint_fast32_t get_separators(const Record<N>&        min,
+                                 const Record<N>&        max,
+                                 uint_fast32_t           count,
+                                 std::vector<Record<N>>& separators) const
+    {
+        return dir_cache.get_separators(min, max, count, separators);
+    }
+
     // It doesn't simply return the root, it is an unique_ptr so it pins the page
     std::unique_ptr<BPlusTreeDir<N>> get_root() const noexcept;
 
 private:
     BPlusTreeDir<N> root;
+
+    // copy of the directory pages used by searches
+    BPTDirCache<N> dir_cache;
 };
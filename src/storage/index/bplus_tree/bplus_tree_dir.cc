@@ -7,6 +7,7 @@
 
 #include "storage/index/bplus_tree/bplus_tree_leaf.h"
 #include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_search.h"
 #include "storage/index/record.h"
 
 using namespace std;
@@ -23,12 +24,12 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::bulk_insert(BPlusTreeLeaf<N>
         split = child.bulk_insert(leaf);
     }
     else { // positive number: pointer to leaf
-        split = make_unique<BPlusTreeSplit<N>>(*leaf.get_record(0), leaf.page.get_page_number());
+        split = make_unique<BPlusTreeSplit<N>>(leaf.get_record(0), leaf.page->get_page_number());
     }
 
     if (split != nullptr) {
         // Case 1: no need to split this node
-        if (*key_count < BPlusTree<N>::dir_max_records) {
+        if (*key_count < BPlusTree<N>::dir_max_records()) {
             update_key(*key_count, split->record);
             ++(*key_count);
             update_child(*key_count, split->encoded_page_number);
@@ -115,8 +116,8 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
     if (split != nullptr) {
         uint_fast32_t splitted_index = search_child_index(split->record);
         // Case 1: no need to split this node
-        if (*key_count < BPlusTree<N>::dir_max_records) {
-            shift_right_keys(splitted_index, (*key_count)-1);
+        if (*key_count < BPlusTree<N>::dir_max_records()) {
+            shift_right_keys(splitted_index, static_cast<int_fast32_t>(*key_count) - 1);
             shift_right_children(splitted_index+1, *key_count);
             update_key(splitted_index, split->record);
             update_child(splitted_index+1, split->encoded_page_number);
@@ -166,11 +167,11 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             std::memcpy(
                 new_right_dir.keys,
                 &keys[(middle_index + 1) * N],
-                (BPlusTree<N>::dir_max_records-(middle_index + 1)) * N * sizeof(uint64_t)
+                (BPlusTree<N>::dir_max_records()-(middle_index + 1)) * N * sizeof(uint64_t)
             );
 
             std::memcpy(
-                &new_right_dir.keys[(BPlusTree<N>::dir_max_records - (middle_index + 1)) * N],
+                &new_right_dir.keys[(BPlusTree<N>::dir_max_records() - (middle_index + 1)) * N],
                 last_key.data(),
                 N * sizeof(uint64_t)
             );
@@ -192,7 +193,7 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             // update counts
             (*key_count) = 1;
             *new_left_dir.key_count = middle_index;
-            *new_right_dir.key_count = BPlusTree<N>::dir_max_records - middle_index;
+            *new_right_dir.key_count = BPlusTree<N>::dir_max_records() - middle_index;
 
             // record at middle_index becomes the first and only record of the root
             std::memcpy(
@@ -241,10 +242,10 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             std::memcpy(
                 new_dir.keys,
                 &keys[(middle_index+1)*N],
-                (BPlusTree<N>::dir_max_records - (middle_index+1))*N * sizeof(uint64_t)
+                (BPlusTree<N>::dir_max_records() - (middle_index+1))*N * sizeof(uint64_t)
             );
             std::memcpy(
-                &new_dir.keys[(BPlusTree<N>::dir_max_records - (middle_index+1))*N],
+                &new_dir.keys[(BPlusTree<N>::dir_max_records() - (middle_index+1))*N],
                 last_key.data(),
                 N * sizeof(uint64_t)
             );
@@ -257,7 +258,7 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             new_dir.children[(*key_count) - middle_index] = last_dir;
             // update counts
             *key_count = middle_index;
-            *new_dir.key_count = BPlusTree<N>::dir_max_records - middle_index;
+            *new_dir.key_count = BPlusTree<N>::dir_max_records() - middle_index;
 
             // key at middle_index is returned
             std::array<uint64_t, N> split_key;
@@ -352,28 +353,8 @@ SearchLeafResult<N> BPlusTreeDir<N>::search_leaf(stack< unique_ptr<BPlusTreeDir<
 
 template <std::size_t N>
 size_t BPlusTreeDir<N>::search_child_index(const Record<N>& record) const noexcept {
-    int_fast32_t dir_from = 0;
-    int_fast32_t dir_to = *key_count;
-search_child_index_begin:
-    if (dir_from == dir_to) {
-        return dir_from;
-    }
-    int_fast32_t middle_dir = (dir_from + dir_to + 1) / 2;
-    int_fast32_t middle_record = middle_dir-1;
-
-    for (uint_fast32_t i = 0; i < N; i++) {
-        auto id = keys[middle_record*N + i];
-        if (record.ids[i] < id) {
-            dir_to = middle_record;
-            goto search_child_index_begin;
-        } else if (record.ids[i] > id) {
-            dir_from = middle_record+1;
-            goto search_child_index_begin;
-        }
-        // continue if they were equal
-    }
-    dir_from = middle_record+1;
-    goto search_child_index_begin;
+    // the child is at the right of every key less or equal than record
+    return BPTSearch::upper_bound<N>(keys, *key_count, record);
 }
 
 
@@ -395,7 +376,7 @@ bool BPlusTreeDir<N>::check_range(const Record<N>& r) const {
 
 template <std::size_t N>
 bool BPlusTreeDir<N>::check() const {
-    if (*key_count > BPlusTree<N>::dir_max_records) {
+    if (*key_count > BPlusTree<N>::dir_max_records()) {
         std::cerr << "  ERROR: key_count shouldn't be less than 0\n";
         return false;
     }
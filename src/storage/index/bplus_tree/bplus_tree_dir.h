@@ -19,9 +19,9 @@ public:
     BPlusTreeDir(FileId leaf_file_id, Page& page) :
         keys         (reinterpret_cast<uint64_t*>(page.get_bytes())),
         key_count    (reinterpret_cast<uint32_t*>(page.get_bytes()
-                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N))),
+                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records() * N))),
         children     (reinterpret_cast<int32_t*>(page.get_bytes()
-                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N)
+                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records() * N)
                         + sizeof(uint32_t))),
         page         (page),
         dir_file_id  (page.page_id.file_id),
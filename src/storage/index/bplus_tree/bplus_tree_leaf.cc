@@ -1,31 +1,26 @@
 #include "bplus_tree_leaf.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 
 #include "base/exceptions.h"
 #include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_search.h"
 
 using namespace std;
 
-template <std::size_t N>
-unique_ptr<Record<N>> BPlusTreeLeaf<N>::get_record(uint_fast32_t pos) const {
-    std::array<uint64_t, N> ids;
-    for (uint_fast32_t i = 0; i < N; i++) {
-        ids[i] = records[pos*N + i];
-    }
-    return make_unique<Record<N>>(move(ids));
-}
-
-
 template <std::size_t N>
 unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record) {
+    if (is_compressed()) {
+        throw LogicException("compressed B+Tree leaves are read only");
+    }
     if (*value_count == 0) {
         for (uint_fast32_t i = 0; i < N; i++) {
             records[i] = record.ids[i];
         }
         ++(*value_count);
-        this->page.make_dirty();
+        page->make_dirty();
         return nullptr;
     }
     uint_fast32_t index = search_index(record);
@@ -42,14 +37,14 @@ unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record)
         throw LogicException("Inserting duplicated record into BPlusTree.");
     }
 
-    if ((*value_count) < BPlusTree<N>::leaf_max_records) {
+    if ((*value_count) < BPlusTree<N>::leaf_max_records()) {
         shift_right_records(index, (*value_count)-1);
 
         for (uint_fast32_t i = 0; i < N; i++) {
             records[index*N + i] = record.ids[i];
         }
         ++(*value_count);
-        this->page.make_dirty();
+        page->make_dirty();
         return nullptr;
     }
     else {
@@ -77,7 +72,7 @@ unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record)
         auto new_leaf = BPlusTreeLeaf<N>(new_page);
 
         *new_leaf.next_leaf = *next_leaf;
-        *next_leaf = new_leaf.page.get_page_number();
+        *next_leaf = new_leaf.page->get_page_number();
 
         // write records
         auto middle_index = ((*value_count)+1)/2;
@@ -85,18 +80,18 @@ unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record)
         std::memcpy(
             new_leaf.records,
             &records[middle_index * N],
-            (BPlusTree<N>::leaf_max_records - middle_index) * N * sizeof(uint64_t)
+            (BPlusTree<N>::leaf_max_records() - middle_index) * N * sizeof(uint64_t)
         );
 
         std::memcpy(
-            &new_leaf.records[(BPlusTree<N>::leaf_max_records - middle_index) * N],
+            &new_leaf.records[(BPlusTree<N>::leaf_max_records() - middle_index) * N],
             last_key.data(),
             N * sizeof(uint64_t)
         );
 
         // update counts
         *value_count = middle_index;
-        *new_leaf.value_count = (BPlusTree<N>::leaf_max_records/2) + 1;
+        *new_leaf.value_count = (BPlusTree<N>::leaf_max_records()/2) + 1;
 
         // split_key is the first in the new leaf
         std::array<uint64_t, N> split_key;
@@ -104,7 +99,7 @@ unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record)
             split_key[i] = new_leaf.records[i];
         }
         auto split_record = Record<N>(move(split_key));
-        this->page.make_dirty();
+        page->make_dirty();
         new_page.make_dirty();
 
         return make_unique<BPlusTreeSplit<N>>(split_record, new_page.get_page_number());
@@ -113,39 +108,26 @@ unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record)
 
 
 // returns the position of the minimum key greater or equal than the record given.
-// if there is no such key, returns (to + 1)
+// if there is no such key, returns the value count
 template <std::size_t N>
 uint_fast32_t BPlusTreeLeaf<N>::search_index(const Record<N>& record) const noexcept {
-    int_fast32_t from = 0;
-    int_fast32_t to = static_cast<int_fast32_t>(*value_count)-1;
-search_index_begin:
-    if (from < to) {
-        auto middle = (from + to) / 2;
+    return BPTSearch::lower_bound<N>(records, *value_count, record);
+}
 
-        for (uint_fast32_t i = 0; i < N; i++) {
-            auto id = records[middle*N + i];
-            if (record.ids[i] < id) { // record is smaller
-                to = middle - 1;
-                goto search_index_begin;
-            } else if (record.ids[i] > id) { // record is greater
-                from = middle + 1;
-                goto search_index_begin;
-            }
-        }
-        // record is equal
-        return middle;
-    }
-    // from >= to
-    for (uint_fast32_t i = 0; i < N; ++i) {
-        auto id = records[from*N + i];
-        if (record.ids[i] < id) {
-            return from;
-        } else if (record.ids[i] > id) {
-            return from + 1;
-        }
-        // continue if they were equal
+
+template <std::size_t N>
+uint_fast32_t BPlusTreeLeaf<N>::search_index_from(const Record<N>& record, uint_fast32_t from) const noexcept {
+    // search the first position `from + 2^k - 1` with a record not less than the searched one, then search
+    // between it and the previous one
+    uint_fast32_t step = 1;
+    uint_fast32_t to = from;
+    while (to < *value_count && get_record(to) < record) {
+        from = to + 1;
+        to += step;
+        step *= 2;
     }
-    return from;
+    to = std::min<uint_fast32_t>(to, *value_count);
+    return from + BPTSearch::lower_bound<N>(records + from*N, to - from, record);
 }
 
 
@@ -204,10 +186,10 @@ void BPlusTreeLeaf<N>::print() const {
 template <std::size_t N>
 bool BPlusTreeLeaf<N>::check() const {
     if ((*value_count) == 0) {
-        if (page.get_page_number() == 0) {
+        if (page->get_page_number() == 0) {
             cout << "  WARNING: empty leaf. Ok only if the b+tree is empty.\n";
         } else {
-            cerr << "  ERROR: BPlusTreeLeaf empty (page: " << page.get_page_number() << ")\n";
+            cerr << "  ERROR: BPlusTreeLeaf empty (page: " << page->get_page_number() << ")\n";
             return false;
         }
     } else {
@@ -230,7 +212,7 @@ bool BPlusTreeLeaf<N>::check() const {
                 y[i] = records[current_pos++];
             }
             if (y <= x) {
-                cerr << "  ERROR: bad record order at BPlusTreeLeaf(page: " << page.get_page_number() << ")\n";
+                cerr << "  ERROR: bad record order at BPlusTreeLeaf(page: " << page->get_page_number() << ")\n";
                 for (size_t n = 0; n < N; n++) {
                     cerr << "\t" << x[n];
                 }
@@ -4,6 +4,7 @@
 
 #include "storage/buffer_manager.h"
 #include "storage/index/bplus_tree/bplus_tree_split.h"
+#include "storage/index/bplus_tree/bpt_leaf_codec.h"
 #include "storage/index/record.h"
 #include "storage/page.h"
 
@@ -31,19 +32,24 @@ friend class BPlusTree<N>;
 
 public:
     BPlusTreeLeaf(Page& page) :
-        records      ( reinterpret_cast<uint64_t*>(page.get_bytes() + (2*sizeof(uint32_t)) ) ),
-        value_count  ( reinterpret_cast<uint32_t*>(page.get_bytes()) ),
-        next_leaf    ( reinterpret_cast<uint32_t*>(page.get_bytes() + sizeof(uint32_t)) ),
-        page         (page),
-        leaf_file_id (page.page_id.file_id) { }
+        leaf_file_id (page.page_id.file_id)
+    {
+        set_page(page);
+    }
+
+    // value_count may point to decoded_count
+    BPlusTreeLeaf(const BPlusTreeLeaf&) = delete;
+    BPlusTreeLeaf(BPlusTreeLeaf&&)      = delete;
 
     ~BPlusTreeLeaf() {
-        buffer_manager.unpin(page);
+        buffer_manager.unpin(*page);
     }
 
-    Page& get_page()           const noexcept { return page; }
+    Page& get_page()           const noexcept { return *page; }
     uint32_t get_value_count() const { return *value_count; }
     bool has_next()            const { return *next_leaf != 0; }
+    bool is_compressed()       const { return value_count == &decoded_count; }
+    uint32_t get_next_leaf_number() const { return *next_leaf; }
 
     // returns false if an error in this leaf is found
     bool check() const;
@@ -54,8 +60,8 @@ public:
     std::unique_ptr<BPlusTreeSplit<N>> insert(const Record<N>& record);
 
     std::unique_ptr<BPlusTreeLeaf<N>> duplicate() const {
-        buffer_manager.pin(page);
-        return std::make_unique<BPlusTreeLeaf<N>>(page);
+        buffer_manager.pin(*page);
+        return std::make_unique<BPlusTreeLeaf<N>>(*page);
     }
 
     std::unique_ptr<BPlusTreeLeaf<N>> get_next_leaf() const {
@@ -63,7 +69,27 @@ public:
         return std::make_unique<BPlusTreeLeaf<N>>(new_page);
     }
 
-    std::unique_ptr<Record<N>> get_record(uint_fast32_t pos) const; // asumes pos is valid
+    // Changes this object to the next leaf without allocating a new one, the current page is unpinned.
+    // Asumes has_next() is true
+    void move_to_next_leaf() {
+        move_to_leaf(*next_leaf);
+    }
+
+    // Changes this object to the leaf `leaf_number` without allocating a new one, the current page is unpinned.
+    void move_to_leaf(uint32_t leaf_number) {
+        if (page->get_page_number() == leaf_number) {
+            return;
+        }
+        Page& new_page = buffer_manager.get_page(leaf_file_id, leaf_number);
+        buffer_manager.unpin(*page);
+        set_page(new_page);
+    }
+
+    // The record is not copied, the reference points to the page (or to the decoded records if the leaf is
+    // compressed) and is valid while this leaf is alive and has not moved to another page. Asumes pos is valid
+    const Record<N>& get_record(uint_fast32_t pos) const noexcept {
+        return *reinterpret_cast<const Record<N>*>(records + pos*N);
+    }
 
     // Search for the first record that is equal or greater than the parameter recived.
     // May give an invalid index, meaning there is no such record is on this page.
@@ -71,18 +97,43 @@ public:
     // otherwise the record is not in the B+tree.
     uint_fast32_t search_index(const Record<N>& record) const noexcept;
 
+    // same as search_index but only looks at the positions from `from`, galloping forward so it is faster
+    // when the record is close to `from`
+    uint_fast32_t search_index_from(const Record<N>& record, uint_fast32_t from) const noexcept;
+
     // returns true if min_record <= r <= max_record. If the leaf is empty will return false.
     // used in leapfrog to know if the search can be done from here or from a upper directory in the branch
     bool check_range(const Record<N>& r) const;
 
 private:
-    uint64_t* const records;
-    uint32_t* const value_count;
-    uint32_t* const next_leaf;
+    uint64_t* records;
+    uint32_t* value_count;
+    uint32_t* next_leaf;
 
-    Page& page;
+    Page* page;
     const FileId leaf_file_id;
 
+    // compressed leaves are decoded here when the page is set, the buffer is reused when moving to the next leaf
+    std::unique_ptr<uint64_t[]> decoded_records;
+    uint32_t decoded_count;
+
+    void set_page(Page& new_page) {
+        next_leaf = reinterpret_cast<uint32_t*>(new_page.get_bytes() + sizeof(uint32_t));
+        page      = &new_page;
+        if (BPTLeafCodec<N>::is_compressed(new_page.get_bytes())) {
+            if (decoded_records == nullptr) {
+                decoded_records.reset(new uint64_t[BPTLeafCodec<N>::max_records() * N]);
+            }
+            BPTLeafCodec<N>::decode(new_page.get_bytes(), decoded_records.get());
+            decoded_count = BPTLeafCodec<N>::get_count(new_page.get_bytes());
+            records       = decoded_records.get();
+            value_count   = &decoded_count;
+        } else {
+            records     = reinterpret_cast<uint64_t*>(new_page.get_bytes() + (2*sizeof(uint32_t)));
+            value_count = reinterpret_cast<uint32_t*>(new_page.get_bytes());
+        }
+    }
+
     bool equal_record(const Record<N>& record, uint_fast32_t index);
     void shift_right_records(int_fast32_t from, int_fast32_t to);
 };
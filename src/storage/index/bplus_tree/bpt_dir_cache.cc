@@ -0,0 +1,138 @@
+#include "bpt_dir_cache.h"
+
+#include <cstring>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_search.h"
+
+template <std::size_t N>
+BPTDirCache<N>::BPTDirCache(FileId dir_file_id) :
+    dir_file_id   (dir_file_id),
+    node_capacity (BPlusTree<N>::dir_max_records())
+{
+    build();
+}
+
+
+template <std::size_t N>
+void BPTDirCache<N>::build() {
+    const auto pages = std::max<uint_fast32_t>(1, file_manager.count_pages(dir_file_id));
+    keys.resize(static_cast<size_t>(pages) * node_capacity * N);
+    children.resize(static_cast<size_t>(pages) * (node_capacity + 1));
+    key_counts.resize(pages);
+    for (uint32_t page_number = 0; page_number < pages; page_number++) {
+        load_node(page_number);
+    }
+}
+
+
+template <std::size_t N>
+void BPTDirCache<N>::load_node(uint32_t page_number) {
+    auto& page = buffer_manager.get_page(dir_file_id, page_number);
+    // same layout as BPlusTreeDir
+    const auto page_keys     = reinterpret_cast<const uint64_t*>(page.get_bytes());
+    const auto page_count    = reinterpret_cast<const uint32_t*>(page_keys + node_capacity * N);
+    const auto page_children = reinterpret_cast<const int32_t*>(page_count + 1);
+
+    const auto count = *page_count;
+    key_counts[page_number] = count;
+    std::memcpy(&keys[static_cast<size_t>(page_number) * node_capacity * N],
+                page_keys,
+                count * N * sizeof(uint64_t));
+    std::memcpy(&children[static_cast<size_t>(page_number) * (node_capacity + 1)],
+                page_children,
+                (count + 1) * sizeof(int32_t));
+    buffer_manager.unpin(page);
+}
+
+
+template <std::size_t N>
+void BPTDirCache<N>::reload_path(const Record<N>& record) {
+    uint32_t node = 0;
+    while (true) {
+        load_node(node);
+        const auto count = key_counts[node];
+        const auto index = BPTSearch::upper_bound<N>(&keys[static_cast<size_t>(node) * node_capacity * N],
+                                                     count,
+                                                     record);
+        const auto child = children[static_cast<size_t>(node) * (node_capacity + 1) + index];
+        if (child >= 0) {
+            return;
+        }
+        node = -child;
+    }
+}
+
+
+template <std::size_t N>
+uint32_t BPTDirCache<N>::search_leaf_number(const Record<N>& min) const noexcept {
+    uint32_t node = 0;
+    while (true) {
+        const auto count = key_counts[node];
+        const auto index = BPTSearch::upper_bound<N>(&keys[static_cast<size_t>(node) * node_capacity * N],
+                                                     count,
+                                                     min);
+        const auto child = children[static_cast<size_t>(node) * (node_capacity + 1) + index];
+        if (child >= 0) {
+            return child;
+        }
+        node = -child;
+    }
+}
+
+
+template <std::size_t N>
+uint_fast32_t BPTDirCache<N>::get_height() const noexcept {
+    uint_fast32_t height = 1;
+    auto child = children[0];
+    while (child < 0) {
+        height++;
+        child = children[static_cast<size_t>(-child) * (node_capacity + 1)];
+    }
+    return height;
+}
+
+
+template <std::size_t N>
+uint_fast32_t BPTDirCache<N>::get_separators(const Record<N>&        min,
+                                             const Record<N>&        max,
+                                             uint_fast32_t           count,
+                                             std::vector<Record<N>>& separators) const
+{
+    auto levels_below = get_height() - 1;
+    std::vector<uint32_t> level_nodes = { 0 };
+    std::vector<uint32_t> next_level_nodes;
+    while (true) {
+        separators.clear();
+        next_level_nodes.clear();
+        for (auto node : level_nodes) {
+            const auto node_keys = &keys[static_cast<size_t>(node) * node_capacity * N];
+            const auto key_count = key_counts[node];
+            const auto first = BPTSearch::lower_bound<N>(node_keys, key_count, min);
+            const auto last  = BPTSearch::upper_bound<N>(node_keys, key_count, max);
+            for (auto i = first; i < last; i++) {
+                separators.push_back(*reinterpret_cast<const Record<N>*>(node_keys + i*N));
+            }
+            // children with records in [min, max]
+            const auto node_children = &children[static_cast<size_t>(node) * (node_capacity + 1)];
+            for (auto i = BPTSearch::upper_bound<N>(node_keys, key_count, min); i <= last; i++) {
+                if (node_children[i] < 0) {
+                    next_level_nodes.push_back(-node_children[i]);
+                }
+            }
+        }
+        if (separators.size() >= count || next_level_nodes.empty()) {
+            return levels_below;
+        }
+        levels_below--;
+        std::swap(level_nodes, next_level_nodes);
+    }
+}
+
+
+template class BPTDirCache<1>;
+template class BPTDirCache<2>;
+template class BPTDirCache<3>;
+template class BPTDirCache<4>;
@@ -0,0 +1,63 @@
+/*
+ * BPTDirCache is a copy in memory of the directory of a BPlusTree, used to find the leaf where a record should be
+ * without going through the buffer manager (a hash lookup, a pin and an unpin for every level).
+ *
+ * Every directory page is a node of a B-ary tree with the same keys and children. The nodes are flattened in two
+ * arrays indexed by the directory page number, each node has room for dir_max_records() keys so a page can be
+ * copied again in the same place when an insert modifies it. The keys of a node are contiguous and are searched
+ * with BPTSearch like in the pages.
+ *
+ * It is built when the BPlusTree is opened. Inserts happen with no concurrent searches (the server executes
+ * updates with an exclusive lock), after an insert the BPlusTree reloads the modified pages.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "storage/file_id.h"
+#include "storage/index/record.h"
+
+template <std::size_t N>
+class BPTDirCache {
+public:
+    BPTDirCache(FileId dir_file_id);
+
+    // copies every directory page
+    void build();
+
+    // copies again the directory pages in the path to the leaf of `record`, must be called when
+    // an insert modifies some of them but doesn't add new directory pages
+    void reload_path(const Record<N>& record);
+
+    // returns the page number of the leaf where the first record greater or equal than `min` should be
+    uint32_t search_leaf_number(const Record<N>& min) const noexcept;
+
+    // number of directory levels in the path from the root to the leaves
+    uint_fast32_t get_height() const noexcept;
+
+    // Writes in `separators` the keys in [min, max] of the first directory level (from the root) that has at least
+    // `count` of them, or of the last level if none has. Returns the number of levels below the one used, 0 if the
+    // keys separate leaves.
+    uint_fast32_t get_separators(const Record<N>&         min,
+                                 const Record<N>&         max,
+                                 uint_fast32_t            count,
+                                 std::vector<Record<N>>&  separators) const;
+
+private:
+    const FileId dir_file_id;
+
+    // keys that fit in a node, the same as a directory page
+    const uint_fast32_t node_capacity;
+
+    // node i has its keys in [i*node_capacity*N, (i+1)*node_capacity*N)
+    std::vector<uint64_t> keys;
+
+    // node i has its children in [i*(node_capacity+1), (i+1)*(node_capacity+1)). Like in the pages a negative
+    // number is a directory page and a positive number is a leaf page
+    std::vector<int32_t> children;
+
+    std::vector<uint32_t> key_counts;
+
+    void load_node(uint32_t page_number);
+};
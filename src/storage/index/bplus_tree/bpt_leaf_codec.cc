@@ -0,0 +1,281 @@
+#include "bpt_leaf_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "storage/page.h"
+
+namespace {
+    uint_fast32_t bits_needed(uint64_t value) noexcept {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    // bytes used by `count` values of `width` bits, rounded up to a multiple of 8
+    size_t packed_bytes(uint_fast32_t count, uint_fast32_t width) noexcept {
+        return ((static_cast<size_t>(count) * width + 63) / 64) * sizeof(uint64_t);
+    }
+
+    // `words` must be initialized with zeros
+    void pack(uint64_t* words, uint_fast32_t index, uint_fast32_t width, uint64_t value) noexcept {
+        if (width == 0) {
+            return;
+        }
+        const size_t   bit   = static_cast<size_t>(index) * width;
+        const uint64_t shift = bit % 64;
+        words[bit / 64] |= value << shift;
+        if (shift + width > 64) {
+            words[bit / 64 + 1] |= value >> (64 - shift);
+        }
+    }
+
+    uint64_t unpack(const uint64_t* words, uint_fast32_t index, uint_fast32_t width) noexcept {
+        if (width == 0) {
+            return 0;
+        }
+        const size_t   bit   = static_cast<size_t>(index) * width;
+        const uint64_t shift = bit % 64;
+        uint64_t value = words[bit / 64] >> shift;
+        if (shift + width > 64) {
+            value |= words[bit / 64 + 1] << (64 - shift);
+        }
+        return width == 64 ? value : value & ((uint64_t(1) << width) - 1);
+    }
+}
+
+
+template <std::size_t N>
+uint_fast32_t BPTLeafCodec<N>::max_records() noexcept {
+    // 8 times the records of a regular leaf
+    return 8 * ((Page::get_size() - 2*sizeof(uint32_t)) / (sizeof(uint64_t) * N));
+}
+
+
+template <std::size_t N>
+BPTLeafCodec<N>::BPTLeafCodec() {
+    records.reserve(max_records());
+}
+
+
+template <std::size_t N>
+void BPTLeafCodec<N>::clear() {
+    records.clear();
+}
+
+
+template <std::size_t N>
+void BPTLeafCodec<N>::update_stats(std::array<ColumnStats, N>& stats,
+                                   const std::array<uint64_t, N>* previous,
+                                   const std::array<uint64_t, N>& record) noexcept
+{
+    if (previous == nullptr) {
+        for (uint_fast32_t c = 0; c < N; c++) {
+            stats[c] = ColumnStats { record[c], record[c], record[c], record[c], 0, 1, 1, 1 };
+        }
+        return;
+    }
+    // the first column is always stored as a delta, the records are sorted
+    bool same_prefix = true;
+    for (uint_fast32_t c = 0; c < N; c++) {
+        auto& s = stats[c];
+        const auto value = record[c];
+        s.min = std::min(s.min, value);
+        s.max = std::max(s.max, value);
+
+        if (same_prefix) {
+            s.max_delta = std::max(s.max_delta, value - (*previous)[c]);
+        } else {
+            s.reference_min = std::min(s.reference_min, value);
+            s.reference_max = std::max(s.reference_max, value);
+        }
+
+        if (value == (*previous)[c]) {
+            s.current_run++;
+        } else {
+            s.runs++;
+            s.current_run = 1;
+            same_prefix = false;
+        }
+        s.max_run = std::max(s.max_run, s.current_run);
+    }
+}
+
+
+template <std::size_t N>
+typename BPTLeafCodec<N>::ColumnHeader BPTLeafCodec<N>::get_header(const ColumnStats& stats,
+                                                                   uint_fast32_t count) noexcept
+{
+    ColumnHeader delta;
+    delta.encoding     = Encoding::delta;
+    delta.value_width  = bits_needed(std::max(stats.max_delta, stats.reference_max - stats.reference_min));
+    delta.length_width = 0;
+    delta.unused       = 0;
+    delta.runs         = 0;
+    delta.base         = stats.reference_min;
+
+    ColumnHeader run_length;
+    run_length.encoding     = Encoding::run_length;
+    run_length.value_width  = bits_needed(stats.max - stats.min);
+    run_length.length_width = bits_needed(stats.max_run);
+    run_length.unused       = 0;
+    run_length.runs         = stats.runs;
+    run_length.base         = stats.min;
+
+    const auto delta_size      = packed_bytes(count, delta.value_width);
+    const auto run_length_size = packed_bytes(stats.runs, run_length.value_width)
+                               + packed_bytes(stats.runs, run_length.length_width);
+    return run_length_size < delta_size ? run_length : delta;
+}
+
+
+template <std::size_t N>
+size_t BPTLeafCodec<N>::encoded_size(const std::array<ColumnStats, N>& stats, uint_fast32_t count) noexcept {
+    size_t size = 2*sizeof(uint32_t) + N*sizeof(ColumnHeader);
+    for (uint_fast32_t c = 0; c < N; c++) {
+        const auto header = get_header(stats[c], count);
+        if (header.encoding == Encoding::delta) {
+            size += packed_bytes(count, header.value_width);
+        } else {
+            size += packed_bytes(header.runs, header.value_width) + packed_bytes(header.runs, header.length_width);
+        }
+    }
+    return size;
+}
+
+
+template <std::size_t N>
+bool BPTLeafCodec<N>::try_add(const std::array<uint64_t, N>& record) {
+    if (records.size() == max_records()) {
+        return false;
+    }
+    auto new_stats = stats;
+    update_stats(new_stats, records.empty() ? nullptr : &records.back(), record);
+    if (!records.empty() && encoded_size(new_stats, records.size() + 1) > Page::get_size()) {
+        return false;
+    }
+    stats = new_stats;
+    records.push_back(record);
+    return true;
+}
+
+
+template <std::size_t N>
+void BPTLeafCodec<N>::encode(char* page_bytes, uint32_t next_leaf) const {
+    const uint_fast32_t count = records.size();
+    std::memset(page_bytes, 0, Page::get_size());
+    *reinterpret_cast<uint32_t*>(page_bytes) = count | COMPRESSED_FLAG;
+    *reinterpret_cast<uint32_t*>(page_bytes + sizeof(uint32_t)) = next_leaf;
+
+    auto headers = reinterpret_cast<ColumnHeader*>(page_bytes + 2*sizeof(uint32_t));
+    auto data    = reinterpret_cast<uint64_t*>(headers + N);
+
+    for (uint_fast32_t c = 0; c < N; c++) {
+        const auto header = get_header(stats[c], count);
+        headers[c] = header;
+
+        if (header.encoding == Encoding::delta) {
+            for (uint_fast32_t i = 0; i < count; i++) {
+                bool same_prefix = i > 0;
+                for (uint_fast32_t k = 0; k < c && same_prefix; k++) {
+                    same_prefix = records[i][k] == records[i-1][k];
+                }
+                const auto value = same_prefix ? records[i][c] - records[i-1][c] : records[i][c] - header.base;
+                pack(data, i, header.value_width, value);
+            }
+            data += packed_bytes(count, header.value_width) / sizeof(uint64_t);
+        } else {
+            auto lengths = data + packed_bytes(header.runs, header.value_width) / sizeof(uint64_t);
+            uint_fast32_t run = 0;
+            uint_fast32_t i = 0;
+            while (i < count) {
+                const auto value = records[i][c];
+                uint_fast32_t length = 1;
+                while (i + length < count && records[i + length][c] == value) {
+                    length++;
+                }
+                pack(data, run, header.value_width, value - header.base);
+                pack(lengths, run, header.length_width, length);
+                run++;
+                i += length;
+            }
+            data = lengths + packed_bytes(header.runs, header.length_width) / sizeof(uint64_t);
+        }
+    }
+}
+
+
+template <std::size_t N>
+void BPTLeafCodec<N>::decode(const char* page_bytes, uint64_t* out) {
+    const uint_fast32_t count = get_count(page_bytes);
+
+    auto headers = reinterpret_cast<const ColumnHeader*>(page_bytes + 2*sizeof(uint32_t));
+    auto data    = reinterpret_cast<const uint64_t*>(headers + N);
+
+    // Columns are decoded in order, a value of column c is a delta if the record has the same values as the
+    // previous one in the columns before c. The first column where each record differs from the previous one
+    // is kept in `first_change` so that check is O(1).
+    thread_local std::vector<uint8_t> first_change;
+    first_change.assign(count, N);
+
+    for (uint_fast32_t c = 0; c < N; c++) {
+        const auto& header = headers[c];
+        const uint_fast32_t width = header.value_width;
+        const uint64_t mask = width == 64 ? UINT64_MAX : (uint64_t(1) << width) - 1;
+
+        if (header.encoding == Encoding::delta) {
+            // the values are read sequentially keeping the current word and bit
+            const uint64_t* word = data;
+            uint_fast32_t shift = 0;
+            auto next_value = [&]() {
+                if (width == 0) {
+                    return uint64_t(0);
+                }
+                uint64_t value = *word >> shift;
+                if (shift + width >= 64) {
+                    word++;
+                    if (shift + width > 64) {
+                        value |= *word << (64 - shift);
+                    }
+                    shift = shift + width - 64;
+                } else {
+                    shift += width;
+                }
+                return value & mask;
+            };
+            if (count > 0) {
+                out[c] = header.base + next_value();
+            }
+            for (uint_fast32_t i = 1; i < count; i++) {
+                const auto value = next_value();
+                if (first_change[i] >= c) {
+                    out[i*N + c] = out[(i-1)*N + c] + value;
+                    if (value != 0 && first_change[i] == N) {
+                        first_change[i] = c;
+                    }
+                } else {
+                    out[i*N + c] = header.base + value;
+                }
+            }
+            data += packed_bytes(count, width) / sizeof(uint64_t);
+        } else {
+            auto lengths = data + packed_bytes(header.runs, width) / sizeof(uint64_t);
+            uint_fast32_t i = 0;
+            for (uint_fast32_t run = 0; run < header.runs; run++) {
+                const auto value  = header.base + unpack(data, run, width);
+                const auto length = unpack(lengths, run, header.length_width);
+                if (i > 0 && first_change[i] == N && value != out[(i-1)*N + c]) {
+                    first_change[i] = c;
+                }
+                for (uint_fast32_t j = 0; j < length; j++, i++) {
+                    out[i*N + c] = value;
+                }
+            }
+            data = lengths + packed_bytes(header.runs, header.length_width) / sizeof(uint64_t);
+        }
+    }
+}
+
+
+template class BPTLeafCodec<1>;
+template class BPTLeafCodec<2>;
+template class BPTLeafCodec<3>;
+template class BPTLeafCodec<4>;
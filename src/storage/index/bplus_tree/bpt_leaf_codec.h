@@ -0,0 +1,99 @@
+/*
+ * BPTLeafCodec encodes and decodes the compressed format of the B+Tree leaves.
+ *
+ * A compressed leaf has the same header than a regular leaf (value_count and next_leaf), with COMPRESSED_FLAG set
+ * in value_count. The records are stored by column, every column with the encoding that uses less space:
+ *
+ *  - delta: when the previous columns of a record are equal to the ones of the previous record, the column is
+ *    stored as the difference with the previous value (records are sorted, so it is not negative). Otherwise it is
+ *    stored as the difference with the minimum of those values (frame of reference). A column with the same value
+ *    in every record uses 0 bits.
+ *  - run length: runs of equal values, the values use frame of reference and the lengths are stored after them.
+ *    Used mostly for the leading columns of a permutation.
+ *
+ * Values are bit-packed with the minimum width needed. After the header there is a ColumnHeader for every column
+ * and then the packed data of the columns, each one starting at a multiple of 8 bytes.
+ *
+ * Compressed leaves are written only by the bulk import, the leaf decodes the records when it is loaded so the
+ * rest of the B+Tree works with them as an array of records.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <std::size_t N>
+class BPTLeafCodec {
+public:
+    // set in the value_count of compressed leaves
+    static constexpr uint32_t COMPRESSED_FLAG = 1U << 31;
+
+    static bool is_compressed(const char* page_bytes) noexcept {
+        return (*reinterpret_cast<const uint32_t*>(page_bytes) & COMPRESSED_FLAG) != 0;
+    }
+
+    // number of records of a compressed leaf
+    static uint32_t get_count(const char* page_bytes) noexcept {
+        return *reinterpret_cast<const uint32_t*>(page_bytes) & ~COMPRESSED_FLAG;
+    }
+
+    // the decoded records of a leaf must fit in a buffer of this size (in records)
+    static uint_fast32_t max_records() noexcept;
+
+    // writes the N columns of the `count` records of the compressed leaf `page_bytes` in `records`
+    static void decode(const char* page_bytes, uint64_t* records);
+
+    BPTLeafCodec();
+
+    // adds the record to the leaf being encoded, returns false (and doesn't add it) if the leaf would not
+    // fit in a page. Records must be added in order
+    bool try_add(const std::array<uint64_t, N>& record);
+
+    uint_fast32_t get_record_count() const noexcept { return records.size(); }
+
+    const std::array<uint64_t, N>& get_first_record() const noexcept { return records[0]; }
+
+    // writes the leaf with the records added into `page_bytes` (a buffer of Page::get_size() bytes)
+    void encode(char* page_bytes, uint32_t next_leaf) const;
+
+    // removes the records added, to start a new leaf
+    void clear();
+
+private:
+    enum class Encoding : uint8_t { delta, run_length };
+
+    struct ColumnHeader {
+        Encoding encoding;
+        uint8_t  value_width;
+        uint8_t  length_width;  // only for run_length
+        uint8_t  unused;
+        uint32_t runs;          // only for run_length
+        uint64_t base;
+    };
+
+    // statistics of a column of the records added, used to know the encoded size without encoding them
+    struct ColumnStats {
+        uint64_t min;           // minimum of the values
+        uint64_t max;           // maximum of the values
+        uint64_t reference_min; // minimum of the values not stored as a delta
+        uint64_t reference_max; // maximum of the values not stored as a delta
+        uint64_t max_delta;
+        uint32_t runs;
+        uint32_t current_run;   // length of the last run
+        uint32_t max_run;
+    };
+
+    std::vector<std::array<uint64_t, N>> records;
+
+    std::array<ColumnStats, N> stats;
+
+    static std::size_t encoded_size(const std::array<ColumnStats, N>& stats, uint_fast32_t count) noexcept;
+
+    static ColumnHeader get_header(const ColumnStats& stats, uint_fast32_t count) noexcept;
+
+    static void update_stats(std::array<ColumnStats, N>& stats,
+                             const std::array<uint64_t, N>* previous,
+                             const std::array<uint64_t, N>& record) noexcept;
+};
@@ -8,16 +8,24 @@
 #include <tuple>
 #include <vector>
 
+#include "storage/index/bplus_tree/bpt_leaf_codec.h"
 #include "storage/page.h"
 
+template <std::size_t N> class BPTDirWriter;
+
 template <std::size_t N>
 class BPTLeafWriter {
 public:
-    static constexpr auto max_records = (Page::MDB_PAGE_SIZE - 2*sizeof(int32_t)) / (sizeof(uint64_t)*N);
+    static inline uint_fast32_t max_records() noexcept {
+        return (Page::get_size() - 2*sizeof(int32_t)) / (sizeof(uint64_t)*N);
+    }
 
-    BPTLeafWriter(const std::string& filename) {
+    // if `compressed` is true the leaves written with append() use the format of BPTLeafCodec
+    BPTLeafWriter(const std::string& filename, bool compressed = false) :
+        compressed (compressed)
+    {
         file.open(filename, std::ios::out|std::ios::binary);
-        buffer = new char[Page::MDB_PAGE_SIZE];
+        buffer = new char[Page::get_size()];
     }
 
     ~BPTLeafWriter() {
@@ -29,22 +37,74 @@ public:
         auto value_count = reinterpret_cast<uint32_t*>(buffer);
         auto next_leaf   = reinterpret_cast<uint32_t*>(buffer + sizeof(uint32_t));
 
-        memset(buffer, 0, Page::MDB_PAGE_SIZE);
+        memset(buffer, 0, Page::get_size());
         *value_count = size;
         *next_leaf = next_block;
         std::memcpy(buffer + 2*sizeof(uint32_t), bytes, size*(N*sizeof(uint64_t)));
-        file.write(buffer, Page::MDB_PAGE_SIZE);
+        file.write(buffer, Page::get_size());
     }
 
     void make_empty() {
-        memset(buffer, 0, Page::MDB_PAGE_SIZE);
-        file.write(buffer, Page::MDB_PAGE_SIZE);
+        memset(buffer, 0, Page::get_size());
+        file.write(buffer, Page::get_size());
+    }
+
+    // Appends the next record of the B+Tree, records must be given in order. A leaf is written when the
+    // next record doesn't fit in it, and the first record of every leaf but the first one is inserted
+    // in `dir_writer`
+    void append(const std::array<uint64_t, N>& record, BPTDirWriter<N>& dir_writer) {
+        if (compressed) {
+            if (!codec.try_add(record)) {
+                write_leaf(dir_writer, current_leaf + 1);
+                codec.try_add(record);
+            }
+        } else {
+            if (block.size() == max_records()) {
+                write_leaf(dir_writer, current_leaf + 1);
+            }
+            block.push_back(record);
+        }
+    }
+
+    // writes the last leaf, must be called after appending all the records
+    void finish(BPTDirWriter<N>& dir_writer) {
+        const auto pending = compressed ? codec.get_record_count() : block.size();
+        if (pending > 0) {
+            write_leaf(dir_writer, 0);
+        } else if (current_leaf == 0) {
+            make_empty();
+        }
     }
 
 private:
     std::fstream file;
 
     char* buffer;
+
+    const bool compressed;
+
+    // records of the leaf being written
+    BPTLeafCodec<N> codec;
+    std::vector<std::array<uint64_t, N>> block;
+
+    uint32_t current_leaf = 0;
+
+    void write_leaf(BPTDirWriter<N>& dir_writer, uint32_t next_leaf) {
+        const auto& first_record = compressed ? codec.get_first_record() : block[0];
+        // the first leaf has no key in the directory
+        if (current_leaf > 0) {
+            dir_writer.bulk_insert(&first_record, 0, current_leaf);
+        }
+        if (compressed) {
+            codec.encode(buffer, next_leaf);
+            file.write(buffer, Page::get_size());
+            codec.clear();
+        } else {
+            process_block(reinterpret_cast<char*>(block.data()), block.size(), next_leaf);
+            block.clear();
+        }
+        ++current_leaf;
+    }
 };
 
 template <std::size_t N>
@@ -71,22 +131,23 @@ private:
     std::vector<char*> pages;
 
 public:
-    static constexpr auto max_records = (Page::MDB_PAGE_SIZE - 2*sizeof(int32_t) )
-                                         / (sizeof(uint64_t)*N + sizeof(int32_t));
+    static inline uint_fast32_t max_records() noexcept {
+        return (Page::get_size() - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N + sizeof(int32_t));
+    }
 
     BPTDirWriter(const std::string& filename) {
         file.open(filename, std::ios::out|std::ios::binary);
         if (file.fail()) {
             std::cout << "Error opening file " << filename << std::endl;
         }
-        auto root = new char[Page::MDB_PAGE_SIZE];
-        memset(root, 0, Page::MDB_PAGE_SIZE);
+        auto root = new char[Page::get_size()];
+        memset(root, 0, Page::get_size());
         pages.push_back(root);
     }
 
     ~BPTDirWriter() {
         for (auto page : pages) {
-            file.write(page, Page::MDB_PAGE_SIZE);
+            file.write(page, Page::get_size());
             delete[] page;
         }
         file.close();
@@ -98,12 +159,12 @@ public:
 
     uint32_t* get_key_count(int32_t dir_page_number) {
         return reinterpret_cast<uint32_t*>(pages[dir_page_number]
-                                           + (sizeof(uint64_t) * max_records * N));
+                                           + (sizeof(uint64_t) * max_records() * N));
     }
 
     int32_t* get_children(int32_t dir_page_number) {
         return reinterpret_cast<int32_t*>(pages[dir_page_number]
-                                          + (sizeof(uint64_t) * max_records * N)
+                                          + (sizeof(uint64_t) * max_records() * N)
                                           + sizeof(uint32_t));
     }
 
@@ -127,7 +188,7 @@ public:
 
         if (split_data.need_split) {
             // Case 1: no need to split this node
-            if (*key_count < max_records) {
+            if (*key_count < max_records()) {
                 // update key
                 std::memcpy(&keys[(*key_count)*N],
                             split_data.record->data(),
@@ -141,8 +202,8 @@ public:
             else if (dir_page_number != 0) {
                 // create new dir page
                 int32_t new_page_number = pages.size();
-                auto new_page = new char[Page::MDB_PAGE_SIZE];
-                memset(new_page, 0, Page::MDB_PAGE_SIZE);
+                auto new_page = new char[Page::get_size()];
+                memset(new_page, 0, Page::get_size());
                 pages.push_back(new_page);
 
                 auto new_dir_children = get_children(new_page_number);
@@ -156,17 +217,17 @@ public:
             else {
                 // create 2 new pages (new_lhs, new_rhs)
                 int32_t lhs_page_number = pages.size();
-                auto lhs_page = new char[Page::MDB_PAGE_SIZE];
-                memset(lhs_page, 0, Page::MDB_PAGE_SIZE);
+                auto lhs_page = new char[Page::get_size()];
+                memset(lhs_page, 0, Page::get_size());
                 pages.push_back(lhs_page);
 
                 int32_t rhs_page_number = pages.size();
-                auto rhs_page = new char[Page::MDB_PAGE_SIZE];
-                memset(rhs_page, 0, Page::MDB_PAGE_SIZE);
+                auto rhs_page = new char[Page::get_size()];
+                memset(rhs_page, 0, Page::get_size());
                 pages.push_back(rhs_page);
 
                 // new_lhs has everything previous
-                std::memcpy(lhs_page, pages[dir_page_number], Page::MDB_PAGE_SIZE);
+                std::memcpy(lhs_page, pages[dir_page_number], Page::get_size());
 
                 // new_rhs has 0 keys and 1 record (the splitted record)
                 auto rhs_key_count = get_key_count(rhs_page_number);
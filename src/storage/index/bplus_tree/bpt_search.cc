@@ -0,0 +1,214 @@
+#include "bpt_search.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+using namespace BPTSearch;
+
+namespace {
+    // number of records compared with SIMD after the binary search, about 4 cache lines of records
+    template <std::size_t N>
+    constexpr uint_fast32_t window_size() noexcept {
+        return std::max<std::size_t>(8, 256 / (N * sizeof(uint64_t)));
+    }
+
+    // the functions count_less_* return how many records in [0, count) have the first column smaller than `key`,
+    // count is at most window_size<N>()
+
+    template <std::size_t N>
+    uint_fast32_t count_less_scalar(const uint64_t* records, uint_fast32_t count, uint64_t key) noexcept {
+        uint_fast32_t res = 0;
+        for (uint_fast32_t i = 0; i < count; i++) {
+            res += records[i*N] < key;
+        }
+        return res;
+    }
+
+
+    // Bits of the lanes of a vector of `lanes` values that hold a first column, when the first value of
+    // the vector is at position `phase` (modulo N) of a record. The records are loaded as a contiguous array
+    // of values and only the lanes of the first column are counted.
+    template <std::size_t N, uint_fast32_t lanes>
+    constexpr uint32_t first_column_lanes(uint_fast32_t phase) noexcept {
+        uint32_t res = 0;
+        for (uint_fast32_t lane = 0; lane < lanes; lane++) {
+            if ((phase + lane) % N == 0) {
+                res |= 1U << lane;
+            }
+        }
+        return res;
+    }
+
+
+    template <std::size_t N>
+    __attribute__((target("avx2")))
+    uint_fast32_t count_less_avx2(const uint64_t* records, uint_fast32_t count, uint64_t key) noexcept {
+        // AVX2 only has signed comparisons, flipping the sign bit keeps the unsigned order
+        const __m256i sign      = _mm256_set1_epi64x(INT64_MIN);
+        const __m256i key_value = _mm256_xor_si256(_mm256_set1_epi64x(key), sign);
+
+        const uint_fast32_t values = count * N;
+        uint_fast32_t res = 0;
+        uint_fast32_t i = 0;
+        for (; i + 4 <= values; i += 4) {
+            const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(records + i));
+            const __m256i less  = _mm256_cmpgt_epi64(key_value, _mm256_xor_si256(value, sign));
+            const uint32_t bits = _mm256_movemask_pd(_mm256_castsi256_pd(less));
+            res += __builtin_popcount(bits & first_column_lanes<N, 4>(i % N));
+        }
+        for (; i < values; i++) {
+            res += i % N == 0 && records[i] < key;
+        }
+        return res;
+    }
+
+
+    template <std::size_t N>
+    __attribute__((target("avx512f")))
+    uint_fast32_t count_less_avx512(const uint64_t* records, uint_fast32_t count, uint64_t key) noexcept {
+        const __m512i key_value = _mm512_set1_epi64(key);
+
+        const uint_fast32_t values = count * N;
+        uint_fast32_t res = 0;
+        for (uint_fast32_t i = 0; i < values; i += 8) {
+            // the last iteration only reads the values before the end
+            const __mmask8 in_range = values - i >= 8 ? 0xFF : (1U << (values - i)) - 1;
+            const __mmask8 mask     = in_range & first_column_lanes<N, 8>(i % N);
+            const __m512i value     = _mm512_maskz_loadu_epi64(in_range, records + i);
+            res += __builtin_popcount(_mm512_mask_cmplt_epu64_mask(mask, value, key_value));
+        }
+        return res;
+    }
+
+
+    Isa current_isa = get_best_isa();
+
+
+    // position of the first record with the first column greater or equal than `key`
+    template <std::size_t N, uint_fast32_t (*count_less)(const uint64_t*, uint_fast32_t, uint64_t) noexcept>
+    uint_fast32_t first_column_lower_bound(const uint64_t* records, uint_fast32_t count, uint64_t key) noexcept {
+        // branchless binary search, the position searched is always in [base, base + n]
+        const uint64_t* base = records;
+        uint_fast32_t n = count;
+        while (n > window_size<N>()) {
+            const auto half = n / 2;
+            // the middle of the next iteration is one of these
+            __builtin_prefetch(base + (half / 2) * N);
+            __builtin_prefetch(base + (half + half / 2) * N);
+            base = base[half*N] < key ? base + half*N : base;
+            n -= half;
+        }
+        return (base - records) / N + count_less(base, n, key);
+    }
+
+
+    // number of records in [0, count) less than `key` (less or equal if `upper`), comparing all the columns
+    // without branches
+    template <std::size_t N, bool upper>
+    uint_fast32_t count_before(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept {
+        uint_fast32_t res = 0;
+        for (uint_fast32_t i = 0; i < count; i++) {
+            bool before = upper;
+            for (uint_fast32_t c = N; c-- > 0;) {
+                const auto value = records[i*N + c];
+                before = (value < key.ids[c]) | ((value == key.ids[c]) & before);
+            }
+            res += before;
+        }
+        return res;
+    }
+
+
+    template <std::size_t N, bool upper, uint_fast32_t (*count_less)(const uint64_t*, uint_fast32_t, uint64_t) noexcept>
+    uint_fast32_t search(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept {
+        uint_fast32_t from = first_column_lower_bound<N, count_less>(records, count, key.ids[0]);
+        if (from == count || records[from*N] != key.ids[0]) {
+            return from;
+        }
+
+        // There are records with the same first column as the key, they are usually few so the end of them is
+        // searched galloping and then only those are compared with all the columns
+        uint_fast32_t to = from + 1;
+        uint_fast32_t step = 1;
+        while (to < count && records[to*N] == key.ids[0]) {
+            to += step;
+            step *= 2;
+        }
+        to = std::min(to, count);
+        while (to - from > window_size<N>()) {
+            const auto middle = from + (to - from) / 2;
+            const auto& record = *reinterpret_cast<const Record<N>*>(records + middle*N);
+            const bool go_right = upper ? record <= key : record < key;
+            if (go_right) {
+                from = middle + 1;
+            } else {
+                to = middle;
+            }
+        }
+        return from + count_before<N, upper>(records + from*N, to - from, key);
+    }
+
+
+    template <std::size_t N, bool upper>
+    uint_fast32_t search(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept {
+        switch (current_isa) {
+        case Isa::avx512: return search<N, upper, count_less_avx512<N>>(records, count, key);
+        case Isa::avx2:   return search<N, upper, count_less_avx2<N>>(records, count, key);
+        default:          return search<N, upper, count_less_scalar<N>>(records, count, key);
+        }
+    }
+}
+
+
+Isa BPTSearch::get_best_isa() noexcept {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::avx2;
+    }
+    return Isa::scalar;
+}
+
+
+Isa BPTSearch::get_isa() noexcept {
+    return current_isa;
+}
+
+
+void BPTSearch::set_isa(Isa isa) noexcept {
+    current_isa = isa;
+}
+
+
+const char* BPTSearch::get_isa_name(Isa isa) noexcept {
+    switch (isa) {
+    case Isa::avx512: return "avx512";
+    case Isa::avx2:   return "avx2";
+    default:          return "scalar";
+    }
+}
+
+
+template <std::size_t N>
+uint_fast32_t BPTSearch::lower_bound(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept {
+    return search<N, false>(records, count, key);
+}
+
+
+template <std::size_t N>
+uint_fast32_t BPTSearch::upper_bound(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept {
+    return search<N, true>(records, count, key);
+}
+
+
+template uint_fast32_t BPTSearch::lower_bound<1>(const uint64_t*, uint_fast32_t, const Record<1>&) noexcept;
+template uint_fast32_t BPTSearch::lower_bound<2>(const uint64_t*, uint_fast32_t, const Record<2>&) noexcept;
+template uint_fast32_t BPTSearch::lower_bound<3>(const uint64_t*, uint_fast32_t, const Record<3>&) noexcept;
+template uint_fast32_t BPTSearch::lower_bound<4>(const uint64_t*, uint_fast32_t, const Record<4>&) noexcept;
+
+template uint_fast32_t BPTSearch::upper_bound<1>(const uint64_t*, uint_fast32_t, const Record<1>&) noexcept;
+template uint_fast32_t BPTSearch::upper_bound<2>(const uint64_t*, uint_fast32_t, const Record<2>&) noexcept;
+template uint_fast32_t BPTSearch::upper_bound<3>(const uint64_t*, uint_fast32_t, const Record<3>&) noexcept;
+template uint_fast32_t BPTSearch::upper_bound<4>(const uint64_t*, uint_fast32_t, const Record<4>&) noexcept;
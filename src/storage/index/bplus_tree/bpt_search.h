@@ -0,0 +1,41 @@
+/*
+ * Search of a record in the sorted records of a leaf or the keys of a directory.
+ *
+ * The records are stored by rows, so the first column is read with a stride of N. A branchless binary search over
+ * the first column narrows the search to a window of a few cache lines, which is then compared at once with SIMD
+ * instructions (AVX2 or AVX-512, chosen at runtime with the features of the CPU) counting the values smaller than
+ * the first column of the key. The rest of the columns are compared only when the first column is equal to the
+ * key's, with a regular binary search over the records that have that first value.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "storage/index/record.h"
+
+namespace BPTSearch {
+    enum class Isa {
+        scalar,
+        avx2,
+        avx512,
+    };
+
+    // the best Isa supported by the CPU
+    Isa get_best_isa() noexcept;
+
+    // the Isa used by lower_bound and upper_bound, by default get_best_isa()
+    Isa get_isa() noexcept;
+
+    // used by benchmarks to compare implementations, `isa` must be supported by the CPU
+    void set_isa(Isa isa) noexcept;
+
+    const char* get_isa_name(Isa isa) noexcept;
+
+    // returns the position of the first record greater or equal than `key`, or `count` if there is no such record
+    template <std::size_t N>
+    uint_fast32_t lower_bound(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept;
+
+    // returns the position of the first record greater than `key`, or `count` if there is no such record
+    template <std::size_t N>
+    uint_fast32_t upper_bound(const uint64_t* records, uint_fast32_t count, const Record<N>& key) noexcept;
+}
@@ -14,7 +14,7 @@ DistinctBindingHashBucket<T>::DistinctBindingHashBucket(const TmpFileId file_id,
                                                         std::size_t tuple_size) :
     page        (buffer_manager.get_tmp_page(file_id, bucket_number)),
     tuple_size  (tuple_size),
-    max_tuples  ( (Page::MDB_PAGE_SIZE - sizeof(*tuple_count) - sizeof(local_depth))
+    max_tuples  ( (Page::get_size() - sizeof(*tuple_count) - sizeof(local_depth))
                   / (sizeof(*hashes) + tuple_size*sizeof(T) ) ),
     tuples      (reinterpret_cast<T*>(page.get_bytes())),
     hashes      (reinterpret_cast<uint64_t*>(page.get_bytes() + tuple_size*max_tuples*sizeof(T))),
@@ -15,7 +15,7 @@ template <class K, class V>
 KeyValueHash<K, V>::KeyValueHash(std::size_t key_size, std::size_t value_size) :
     key_size        (key_size),
     value_size      (value_size),
-    max_tuples      ( (Page::MDB_PAGE_SIZE - sizeof(uint64_t)) / (key_size*sizeof(K) + value_size*sizeof(V)) ),
+    max_tuples      ( (Page::get_size() - sizeof(uint64_t)) / (key_size*sizeof(K) + value_size*sizeof(V)) ),
     buckets_file    ( file_manager.get_tmp_file_id())
     { }
 
@@ -0,0 +1,192 @@
+#include "object_id_hash_table.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "storage/index/hash/key_value_hash/key_value_pair_hasher.h"
+
+using namespace std;
+
+namespace {
+    // bit i is set if control[i] == tag, for the GROUP_SIZE control bytes starting at control
+    inline uint32_t match_group(const uint8_t* control, uint8_t tag) noexcept {
+#ifdef __SSE2__
+        const auto group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+        uint32_t res = 0;
+        for (uint_fast32_t i = 0; i < ObjectIdHashTable::GROUP_SIZE; i++) {
+            res |= static_cast<uint32_t>(control[i] == tag) << i;
+        }
+        return res;
+#endif
+    }
+}
+
+
+ObjectIdHashTable::ObjectIdHashTable(uint_fast32_t key_size, uint_fast32_t value_size) :
+    key_size   (key_size),
+    value_size (value_size)
+{
+    clear();
+}
+
+
+void ObjectIdHashTable::clear() {
+    control.assign(GROUP_SIZE + GROUP_SIZE, EMPTY);
+    slots.assign(GROUP_SIZE, 0);
+    mask = GROUP_SIZE - 1;
+    keys.clear();
+    values.clear();
+    value_keys.clear();
+    value_offsets.clear();
+    key_count = 0;
+    row_count = 0;
+}
+
+
+uint64_t ObjectIdHashTable::hash(const ObjectId* key) const noexcept {
+    return hash_function_wrapper(key, key_size);
+}
+
+
+void ObjectIdHashTable::set_control(uint64_t slot, uint8_t tag) noexcept {
+    control[slot] = tag;
+    if (slot < GROUP_SIZE) {
+        control[mask + 1 + slot] = tag;
+    }
+}
+
+
+int64_t ObjectIdHashTable::find_slot(const ObjectId* key, uint64_t key_hash) const noexcept {
+    const uint8_t tag = key_hash & 0x7F;
+    auto pos = (key_hash >> 7) & mask;
+    while (true) {
+        auto matches = match_group(&control[pos], tag);
+        while (matches != 0) {
+            const auto slot = (pos + __builtin_ctz(matches)) & mask;
+            if (memcmp(&keys[slots[slot] * key_size], key, key_size * sizeof(ObjectId)) == 0) {
+                return slot;
+            }
+            matches &= matches - 1;
+        }
+        if (match_group(&control[pos], EMPTY) != 0) {
+            return -1;
+        }
+        pos = (pos + GROUP_SIZE) & mask;
+    }
+}
+
+
+uint32_t ObjectIdHashTable::find_or_insert_key(const ObjectId* key, bool* inserted) {
+    auto key_hash = hash(key);
+    auto slot = find_slot(key, key_hash);
+    if (slot >= 0) {
+        *inserted = false;
+        return slots[slot];
+    }
+    *inserted = true;
+
+    // keep the load factor under 7/8
+    if ((key_count + 1) * 8 > (mask + 1) * 7) {
+        grow();
+    }
+    auto pos = (key_hash >> 7) & mask;
+    uint32_t empty;
+    while ((empty = match_group(&control[pos], EMPTY)) == 0) {
+        pos = (pos + GROUP_SIZE) & mask;
+    }
+    const auto new_slot = (pos + __builtin_ctz(empty)) & mask;
+    set_control(new_slot, key_hash & 0x7F);
+    slots[new_slot] = key_count;
+    keys.insert(keys.end(), key, key + key_size);
+    return key_count++;
+}
+
+
+void ObjectIdHashTable::grow() {
+    const auto capacity = (mask + 1) * 2;
+    control.assign(capacity + GROUP_SIZE, EMPTY);
+    slots.assign(capacity, 0);
+    mask = capacity - 1;
+
+    for (uint64_t i = 0; i < key_count; i++) {
+        const auto key_hash = hash(&keys[i * key_size]);
+        auto pos = (key_hash >> 7) & mask;
+        uint32_t empty;
+        while ((empty = match_group(&control[pos], EMPTY)) == 0) {
+            pos = (pos + GROUP_SIZE) & mask;
+        }
+        const auto slot = (pos + __builtin_ctz(empty)) & mask;
+        set_control(slot, key_hash & 0x7F);
+        slots[slot] = i;
+    }
+}
+
+
+void ObjectIdHashTable::insert(const ObjectId* key, const ObjectId* value) {
+    assert(value_offsets.empty() && "insert after finish_build");
+    bool inserted;
+    value_keys.push_back(find_or_insert_key(key, &inserted));
+    values.insert(values.end(), value, value + value_size);
+    row_count++;
+}
+
+
+void ObjectIdHashTable::finish_build() {
+    // counting sort of the values by key
+    value_offsets.assign(key_count + 1, 0);
+    for (auto key_pos : value_keys) {
+        value_offsets[key_pos + 1]++;
+    }
+    for (uint64_t i = 0; i < key_count; i++) {
+        value_offsets[i + 1] += value_offsets[i];
+    }
+
+    if (value_size > 0) {
+        vector<ObjectId> grouped_values(values.size());
+        vector<uint64_t> next_position(value_offsets.begin(), value_offsets.end() - 1);
+        for (uint64_t row = 0; row < row_count; row++) {
+            const auto position = next_position[value_keys[row]]++;
+            memcpy(&grouped_values[position * value_size],
+                   &values[row * value_size],
+                   value_size * sizeof(ObjectId));
+        }
+        values.swap(grouped_values);
+    }
+    value_keys.clear();
+    value_keys.shrink_to_fit();
+}
+
+
+uint_fast32_t ObjectIdHashTable::find(const ObjectId* key, const ObjectId** found_values) const {
+    assert(value_offsets.size() == key_count + 1 && "find before finish_build");
+    const auto slot = find_slot(key, hash(key));
+    if (slot < 0) {
+        return 0;
+    }
+    const auto key_pos = slots[slot];
+    *found_values = values.data() + value_offsets[key_pos] * value_size;
+    return value_offsets[key_pos + 1] - value_offsets[key_pos];
+}
+
+
+bool ObjectIdHashTable::find_or_insert(const ObjectId* key) {
+    bool inserted;
+    find_or_insert_key(key, &inserted);
+    return !inserted;
+}
+
+
+uint64_t ObjectIdHashTable::memory_bytes() const noexcept {
+    return control.size()
+         + slots.size() * sizeof(uint32_t)
+         + keys.size() * sizeof(ObjectId)
+         + values.size() * sizeof(ObjectId)
+         + value_keys.size() * sizeof(uint32_t)
+         + value_offsets.size() * sizeof(uint64_t);
+}
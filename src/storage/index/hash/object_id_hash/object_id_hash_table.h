@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "base/ids/object_id.h"
+
+// ObjectIdHashTable is an in-memory hash table whose keys and values are tuples of ObjectIds with a size fixed
+// when the table is created. Keys may have many values (the rows of a join with the same key).
+//
+// It uses open addressing: a control byte per slot with 7 bits of the hash (or EMPTY) is checked 16 slots at a
+// time, and only the slots with the same bits compare the key. The distinct keys are saved contiguously in an
+// arena and the slots only have their position. The values are appended in insertion order and finish_build()
+// moves the values of each key together, so enumerating the matches of a key reads consecutive memory.
+// There is no deletion.
+class ObjectIdHashTable {
+public:
+    static constexpr uint_fast32_t GROUP_SIZE = 16;
+
+    ObjectIdHashTable(uint_fast32_t key_size, uint_fast32_t value_size);
+
+    // removes all the keys and values, keeping the allocated memory
+    void clear();
+
+    // adds the row (key, value), value has value_size ObjectIds. finish_build() must be called before find()
+    void insert(const ObjectId* key, const ObjectId* value);
+
+    // groups the values of each key, must be called after the last insert and before find
+    void finish_build();
+
+    // returns how many values the key has, and sets *values to the first one. The values of the key are
+    // consecutive and each one has value_size ObjectIds
+    uint_fast32_t find(const ObjectId* key, const ObjectId** values) const;
+
+    // for tables without values: returns true if the key was already present, inserts it otherwise
+    bool find_or_insert(const ObjectId* key);
+
+    // returns true if the key is present, it doesn't need finish_build()
+    inline bool contains(const ObjectId* key) const { return find_slot(key, hash(key)) >= 0; }
+
+    inline uint64_t size() const noexcept { return row_count; }
+
+    inline uint64_t distinct_keys() const noexcept { return key_count; }
+
+    inline uint_fast32_t get_key_size() const noexcept { return key_size; }
+
+    inline uint_fast32_t get_value_size() const noexcept { return value_size; }
+
+    // bytes used by the table, not counting the capacity reserved by the vectors
+    uint64_t memory_bytes() const noexcept;
+
+private:
+    static constexpr uint8_t EMPTY = 0x80;
+
+    const uint_fast32_t key_size;
+    const uint_fast32_t value_size;
+
+    // the control bytes have capacity + GROUP_SIZE elements, the last group repeats the first one so
+    // a group can be read starting at any slot
+    std::vector<uint8_t> control;
+
+    // key position in `keys` of each slot
+    std::vector<uint32_t> slots;
+
+    // capacity - 1, the capacity is a power of two
+    uint64_t mask;
+
+    // key_count keys of key_size ObjectIds
+    std::vector<ObjectId> keys;
+
+    // the values of the key i are [value_offsets[i], value_offsets[i + 1]), after finish_build()
+    std::vector<uint64_t> value_offsets;
+
+    // row_count values of value_size ObjectIds, grouped by key after finish_build()
+    std::vector<ObjectId> values;
+
+    // key position of each value before finish_build()
+    std::vector<uint32_t> value_keys;
+
+    uint64_t key_count;
+    uint64_t row_count;
+
+    uint64_t hash(const ObjectId* key) const noexcept;
+
+    // returns the position of key in `keys`, inserting it if it is not present. *inserted is set to
+    // true if it was inserted.
+    uint32_t find_or_insert_key(const ObjectId* key, bool* inserted);
+
+    // returns the slot of key, or -1 if it is not present
+    int64_t find_slot(const ObjectId* key, uint64_t hash) const noexcept;
+
+    void set_control(uint64_t slot, uint8_t tag) noexcept;
+
+    // doubles the capacity and inserts again all the keys
+    void grow();
+};
@@ -123,8 +123,8 @@ uint64_t StringsHash::get_or_create_str_id(const std::string& str) {
                     dir[(i << (*bucket.local_depth)) | new_bucket_number] = new_bucket_number;
                 }
 
-                assert(*bucket.key_count + *new_bucket.key_count== StringsHashBucket::MAX_KEYS
-                    && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be MAX_KEYS after a split");
+                assert(*bucket.key_count + *new_bucket.key_count== StringsHashBucket::max_keys()
+                    && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be max_keys() after a split");
 
             } else {
                 assert(suffix == bucket_number && "EXTENDIBLE HASH INCONSISTENCY: suffix != bucket_number");
@@ -145,8 +145,8 @@ uint64_t StringsHash::get_or_create_str_id(const std::string& str) {
                 // update dir for `1|bucket_number`
                 dir[new_bucket_number] = new_bucket_number;
 
-                assert(*bucket.key_count + *new_bucket.key_count== StringsHashBucket::MAX_KEYS
-                    && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be MAX_KEYS after a split");
+                assert(*bucket.key_count + *new_bucket.key_count== StringsHashBucket::max_keys()
+                    && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be max_keys() after a split");
             }
         } else {
             return id;
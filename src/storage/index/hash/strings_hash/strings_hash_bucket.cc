@@ -15,7 +15,7 @@ StringsHashBucket::StringsHashBucket(FileId file_id, uint_fast32_t bucket_number
     key_count   (reinterpret_cast<uint32_t*>(page.get_bytes())),
     local_depth (reinterpret_cast<uint32_t*>(page.get_bytes() + sizeof(uint32_t))),
     hashes      (reinterpret_cast<uint64_t*>(page.get_bytes() + 2*sizeof(uint32_t))),
-    ids         (reinterpret_cast<uint64_t*>(page.get_bytes() + sizeof(uint64_t) + sizeof(uint64_t)*StringsHashBucket::MAX_KEYS)) { }
+    ids         (reinterpret_cast<uint64_t*>(page.get_bytes() + sizeof(uint64_t) + sizeof(uint64_t)*StringsHashBucket::max_keys())) { }
 
 
 StringsHashBucket::~StringsHashBucket() {
@@ -48,7 +48,7 @@ uint64_t StringsHashBucket::get_or_create_str_id(const string& str, uint64_t has
             }
         }
     }
-    if (*key_count == MAX_KEYS) {
+    if (*key_count == max_keys()) {
         *need_split = true;
         return 0; // doesn't matter this returned value, ExtendibleHash needs to try to insert again
     }
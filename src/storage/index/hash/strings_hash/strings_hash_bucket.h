@@ -9,7 +9,9 @@
 class StringsHashBucket {
 friend class StringsHash;
 public:
-    static constexpr auto MAX_KEYS = (Page::MDB_PAGE_SIZE - sizeof(uint64_t) ) / (2*sizeof(uint64_t));
+    static inline uint_fast32_t max_keys() noexcept {
+        return (Page::get_size() - sizeof(uint64_t) ) / (2*sizeof(uint64_t));
+    }
 
     StringsHashBucket(FileId file_id, uint_fast32_t bucket_number);
 
@@ -18,10 +18,10 @@ public:
         key_count   (reinterpret_cast<uint32_t*>(page)),
         local_depth (reinterpret_cast<uint32_t*>(page + sizeof(uint32_t))),
         hashes      (reinterpret_cast<uint64_t*>(page + 2*sizeof(uint32_t))),
-        ids         (reinterpret_cast<uint64_t*>(page + sizeof(uint64_t) + sizeof(uint64_t)*StringsHashBucket::MAX_KEYS)) { }
+        ids         (reinterpret_cast<uint64_t*>(page + sizeof(uint64_t) + sizeof(uint64_t)*StringsHashBucket::max_keys())) { }
 
     void create_id(uint64_t new_id, const uint64_t hash, bool* const need_split) {
-        if (*key_count == StringsHashBucket::MAX_KEYS) {
+        if (*key_count == StringsHashBucket::max_keys()) {
             *need_split = true;
             return;
         }
@@ -74,8 +74,8 @@ public:
         uint_fast32_t dir_size = 1 << global_depth;
         dir = new uint_fast32_t[dir_size];
         for (uint_fast32_t i = 0; i < dir_size; ++i) {
-            auto new_page = new char[Page::MDB_PAGE_SIZE];
-            memset(new_page, 0, Page::MDB_PAGE_SIZE);
+            auto new_page = new char[Page::get_size()];
+            memset(new_page, 0, Page::get_size());
             pages.push_back(new_page);
             StringsHashBulkImportBucket bucket(new_page);
             *bucket.key_count = 0;
@@ -98,7 +98,7 @@ public:
         dir_file.close();
 
         for (auto page : pages) {
-            buckets_file.write(page, Page::MDB_PAGE_SIZE);
+            buckets_file.write(page, Page::get_size());
             delete[](page);
         }
         buckets_file.close();
@@ -119,8 +119,8 @@ public:
             bucket.create_id(id, hash, &need_split);
 
             if (need_split) {
-                auto new_page = new char[Page::MDB_PAGE_SIZE];
-                memset(new_page, 0, Page::MDB_PAGE_SIZE);
+                auto new_page = new char[Page::get_size()];
+                memset(new_page, 0, Page::get_size());
                 auto new_bucket_number = pages.size();
                 pages.push_back(new_page);
                 StringsHashBulkImportBucket new_bucket(new_page);
@@ -143,8 +143,8 @@ public:
                         dir[(i << (*bucket.local_depth)) | new_suffix] = new_bucket_number;
                     }
 
-                    assert(*bucket.key_count + *new_bucket.key_count == StringsHashBucket::MAX_KEYS
-                        && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be MAX_KEYS after a split");
+                    assert(*bucket.key_count + *new_bucket.key_count == StringsHashBucket::max_keys()
+                        && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be max_keys() after a split");
 
                 } else {
                     assert(*bucket.local_depth == global_depth && "EXTENDIBLE HASH INCONSISTENCY: *bucket.local_depth != global_depth");
@@ -161,8 +161,8 @@ public:
                     // update dir for `1|suffix`
                     dir[new_suffix] = new_bucket_number;
 
-                    assert(*bucket.key_count + *new_bucket.key_count == StringsHashBucket::MAX_KEYS
-                        && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be MAX_KEYS after a split");
+                    assert(*bucket.key_count + *new_bucket.key_count == StringsHashBucket::max_keys()
+                        && "EXTENDIBLE HASH INCONSISTENCY: sum of keys must be max_keys() after a split");
                 }
             } else {
                 return;
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "base/exceptions.h"
+#include "base/thread/thread_counters.h"
 #include "storage/buffer_manager.h"
 
 using namespace std;
@@ -17,11 +18,11 @@ LeapfrogBptIter<N>::LeapfrogBptIter(bool*                         interruption_r
     LeapfrogIter (interruption_requested,
                   move(_initial_ranges),
                   move(_intersection_vars),
-                  move(_enumeration_vars))
+                  move(_enumeration_vars)),
+    btree         (btree),
+    current_tuple (array<uint64_t, N>()),
+    cursor_min    (array<uint64_t, N>())
 {
-    auto root = btree.get_root();
-    directory_stack.push( move(root) );
-
     // there is a border case when nothing is done, but enumeration, so we must
     // position at the first record
     array<uint64_t, N> min;
@@ -29,7 +30,7 @@ LeapfrogBptIter<N>::LeapfrogBptIter(bool*                         interruption_r
         min[i] = 0;
     }
 
-    auto leaf_and_pos = directory_stack.top()->search_leaf(directory_stack, min);
+    auto leaf_and_pos = btree.search_leaf(min);
     current_leaf = move(leaf_and_pos.leaf);
     assert(current_leaf != nullptr);
     current_pos_in_leaf = leaf_and_pos.result_index;
@@ -40,16 +41,15 @@ LeapfrogBptIter<N>::LeapfrogBptIter(bool*                         interruption_r
     } else {
         array<uint64_t, N> max;
         for (size_t i = 0; i < N; i++) {
-            min[i] = UINT64_MAX;
+            max[i] = UINT64_MAX;
         }
-        current_tuple = make_unique<Record<N>>(max);
+        current_tuple = Record<N>(max);
     }
 }
 
 
 template <size_t N>
 void LeapfrogBptIter<N>::down() {
-    assert(current_tuple != nullptr);
     level++;
 
     array<uint64_t, N> min;
@@ -57,8 +57,8 @@ void LeapfrogBptIter<N>::down() {
 
     // before the level min and max must be equal to the current_record
     for (int_fast32_t i = 0; i < level; i++) {
-        min[i] = (*current_tuple)[i];
-        max[i] = (*current_tuple)[i];
+        min[i] = current_tuple[i];
+        max[i] = current_tuple[i];
     }
 
     // from level until the end is an open range [0, MAX]
@@ -73,18 +73,17 @@ void LeapfrogBptIter<N>::down() {
 
 template <size_t N>
 bool LeapfrogBptIter<N>::next() {
-    assert(current_tuple != nullptr);
     array<uint64_t, N> min;
     array<uint64_t, N> max;
 
     // before level min and max are equal to the current_record
     for (int_fast32_t i = 0; i < level; i++) {
-        min[i] = (*current_tuple)[i];
-        max[i] = (*current_tuple)[i];
+        min[i] = current_tuple[i];
+        max[i] = current_tuple[i];
     }
 
     // at the same level min is 1 grater than the current record and max is unbound
-    min[level] = (*current_tuple)[level] + 1;
+    min[level] = current_tuple[level] + 1;
     max[level] = UINT64_MAX;
 
     // after level min is 0 and max is unbound
@@ -99,14 +98,13 @@ bool LeapfrogBptIter<N>::next() {
 
 template <size_t N>
 bool LeapfrogBptIter<N>::seek(uint64_t key) {
-    assert(current_tuple != nullptr);
     array<uint64_t, N> min;
     array<uint64_t, N> max;
 
     // before level min and max are equal to the current_record
     for (int_fast32_t i = 0; i < level; i++) {
-        min[i] = (*current_tuple)[i];
-        max[i] = (*current_tuple)[i];
+        min[i] = current_tuple[i];
+        max[i] = current_tuple[i];
     }
 
     min[level] = key;
@@ -121,65 +119,55 @@ bool LeapfrogBptIter<N>::seek(uint64_t key) {
 }
 
 
-// updates current_leaf, current_tuple and current_pos_in_leaf only when returns true;
+// always moves the cursor to the first record greater or equal than min, current_tuple is updated only when
+// returns true
 template <std::size_t N>
 bool LeapfrogBptIter<N>::internal_search(const Record<N>& min, const Record<N>& max) {
     assert(current_leaf != nullptr);
+    ThreadCounters::index_seeks++;
 
-    // if leaf.min <= min <= leaf.max, search inside the leaf and return
-    if (current_leaf->check_range(min)) {
-        auto new_current_pos_in_leaf = current_leaf->search_index(min);
-        // check new_current_pos_in_leaf is a valid position
-        if (new_current_pos_in_leaf < current_leaf->get_value_count()) {
-            auto new_current_tuple = current_leaf->get_record(new_current_pos_in_leaf);
-            if ((*new_current_tuple) <= max) {
-                // current_leaf stays the same
-                current_tuple       = move(new_current_tuple);
-                current_pos_in_leaf = new_current_pos_in_leaf;
-                return true;
-            } else {
-                return false;
-            }
-        } else {
-            return false;
+    if (min < cursor_min) {
+        // the record may be before the cursor (open_terms with a new binding), search the leaf only if
+        // leaf.min <= min <= leaf.max
+        if (!current_leaf->check_range(min)) {
+            current_leaf->move_to_leaf(btree.search_leaf_number(min));
         }
+        current_pos_in_leaf = current_leaf->search_index(min);
     } else {
-        // else search in the stack for a dir where dir.min <= min <= dir.max
-        // a dir may not have records (i.e when having one leaf as child), in that case it will return the a record with zeros
-        // and conditions will be false, so its ok
-        // if we don't find it we stay with the root (lowest item in the stack)
-        while (directory_stack.size() > 1
-               && !directory_stack.top()->check_range(min))
-        {
-            directory_stack.pop();
-        }
-
-        // then search until reaching the leaf_number and index of the record.
-        auto leaf_and_pos = directory_stack.top()->search_leaf(directory_stack, min);
-        auto new_current_leaf = move(leaf_and_pos.leaf);
-        auto new_current_pos_in_leaf = leaf_and_pos.result_index;
-
-        // check new_current_pos_in_leaf is a valid position
-        // we may need to go to the first record of the next leaf
-        if (new_current_pos_in_leaf >= new_current_leaf->get_value_count()) {
-            if (new_current_leaf->has_next()) {
-                new_current_leaf = new_current_leaf->get_next_leaf();
-                new_current_pos_in_leaf = 0;
+        current_pos_in_leaf = current_leaf->search_index_from(min, current_pos_in_leaf);
+
+        // the record is not in this leaf, usually it is close so the next leaf is tried before the root
+        if (current_pos_in_leaf == current_leaf->get_value_count() && current_leaf->has_next()) {
+            current_leaf->move_to_next_leaf();
+            const auto count = current_leaf->get_value_count();
+            if (count > 0 && !(current_leaf->get_record(count - 1) < min)) {
+                current_pos_in_leaf = current_leaf->search_index_from(min, 0);
             } else {
-                return false;
+                // the directory is in memory so only the leaf is read from the buffer
+                current_leaf->move_to_leaf(btree.search_leaf_number(min));
+                current_pos_in_leaf = current_leaf->search_index(min);
             }
         }
+    }
+    cursor_min = min;
 
-        auto new_current_tuple = new_current_leaf->get_record(new_current_pos_in_leaf);
-        if ((*new_current_tuple) <= max) {
-            current_tuple       = move(new_current_tuple);
-            current_leaf        = move(new_current_leaf);
-            current_pos_in_leaf = new_current_pos_in_leaf;
-            return true;
+    // we may need to go to the first record of the next leaf
+    if (current_pos_in_leaf >= current_leaf->get_value_count()) {
+        if (current_leaf->has_next()) {
+            current_leaf->move_to_next_leaf();
+            current_pos_in_leaf = 0;
         } else {
             return false;
         }
     }
+
+    const auto& new_current_tuple = current_leaf->get_record(current_pos_in_leaf);
+    if (new_current_tuple <= max) {
+        current_tuple = new_current_tuple;
+        return true;
+    } else {
+        return false;
+    }
 }
 
 
@@ -188,15 +176,21 @@ void LeapfrogBptIter<N>::begin_enumeration() {
     array<uint64_t, N> max;
 
     for (int_fast32_t i = 0; i <= level; i++) {
-        max[i] = (*current_tuple)[i];
+        max[i] = current_tuple[i];
     }
     for (size_t i = level+1; i < N; i++) {
         max[i] = UINT64_MAX;
     }
 
-    enum_bpt_iter = make_unique<BptIter<N>>(interruption_requested,
-                                            SearchLeafResult<N>(current_leaf->duplicate(), current_pos_in_leaf),
-                                            Record<N>(max));
+    // the leaf of the enumeration is moved instead of duplicating current_leaf, so a compressed leaf
+    // doesn't allocate a new buffer for its records in each enumeration
+    if (enum_bpt_iter != nullptr) {
+        enum_bpt_iter->seek(current_leaf->get_page().get_page_number(), current_pos_in_leaf, Record<N>(max));
+    } else {
+        enum_bpt_iter = make_unique<BptIter<N>>(interruption_requested,
+                                                SearchLeafResult<N>(current_leaf->duplicate(), current_pos_in_leaf),
+                                                Record<N>(max));
+    }
 }
 
 
@@ -224,7 +218,6 @@ bool LeapfrogBptIter<N>::next_enumeration(BindingId& binding) {
 
 template <size_t N>
 bool LeapfrogBptIter<N>::open_terms(BindingId& input_binding) {
-    assert(current_tuple != nullptr);
     array<uint64_t, N> min;
     array<uint64_t, N> max;
 
@@ -244,6 +237,48 @@ bool LeapfrogBptIter<N>::open_terms(BindingId& input_binding) {
     return internal_search(Record<N>(min), Record<N>(max));
 }
 
+
+template <size_t N>
+uint64_t LeapfrogBptIter<N>::get_split_keys(BindingId& input_binding,
+                                            uint_fast32_t count,
+                                            vector<uint64_t>& split_keys)
+{
+    array<uint64_t, N> min;
+    array<uint64_t, N> max;
+
+    // same range as open_terms
+    size_t i = 0;
+    for (; i < initial_ranges.size(); i++) {
+        min[i] = initial_ranges[i]->get_min(input_binding);
+        max[i] = initial_ranges[i]->get_max(input_binding);
+    }
+    for (; i < N; i++) {
+        min[i] = 0;
+        max[i] = UINT64_MAX;
+    }
+    const auto first_intersection_column = initial_ranges.size();
+    if (first_intersection_column >= N) {
+        return 0;
+    }
+
+    vector<Record<N>> separators;
+    const auto levels_below = btree.get_separators(Record<N>(min), Record<N>(max), count, separators);
+    for (auto& separator : separators) {
+        const auto key = separator[first_intersection_column];
+        if (split_keys.empty() || split_keys.back() != key) {
+            split_keys.push_back(key);
+        }
+    }
+
+    // every separator has about half of a full node of records until the next one
+    uint64_t records_per_separator = BPlusTree<N>::leaf_max_records() / 2;
+    for (uint_fast32_t level = 0; level < levels_below; level++) {
+        records_per_separator *= BPlusTree<N>::dir_max_records() / 2;
+    }
+    return (separators.size() + 1) * records_per_separator;
+}
+
+
 template class LeapfrogBptIter<2>;
 template class LeapfrogBptIter<3>;
 template class LeapfrogBptIter<4>;
@@ -11,7 +11,7 @@ public:
                     std::vector<VarId>                      intersection_vars,
                     std::vector<VarId>                      enumeration_vars);
 
-    inline uint64_t get_key() const override { return (*current_tuple)[level]; }
+    inline uint64_t get_key() const override { return current_tuple[level]; }
 
     // Increases the level and sets the current_tuple
     void down() override;
@@ -32,17 +32,29 @@ public:
     // returns true if the terms and parent_binding were found
     bool open_terms(BindingId& input_binding) override;
 
+    // uses the keys of the directory in memory of the B+Tree
+    uint64_t get_split_keys(BindingId& input_binding,
+                            uint_fast32_t count,
+                            std::vector<uint64_t>& split_keys) override;
+
 private:
-    std::unique_ptr<Record<N>> current_tuple;
+    const BPlusTree<N>& btree;
 
-    std::unique_ptr<BPlusTreeLeaf<N>> current_leaf;
+    // copy of the current record, it is valid even after current_leaf moves to another page
+    Record<N> current_tuple;
 
-    std::unique_ptr<BptIter<N>> enum_bpt_iter;
+    // The cursor: current_leaf and current_pos_in_leaf. It is moved in place by the searches, without
+    // allocating a new leaf, and the position is always the first record greater or equal than cursor_min
+    // (or the end of the leaf if that record is the first of the next leaf)
+    std::unique_ptr<BPlusTreeLeaf<N>> current_leaf;
 
     uint32_t current_pos_in_leaf;
 
-    std::stack<std::unique_ptr<BPlusTreeDir<N>>> directory_stack;
+    Record<N> cursor_min;
+
+    std::unique_ptr<BptIter<N>> enum_bpt_iter;
 
-    // search a record in the interval [min, max]
+    // search a record in the interval [min, max]. When min is not less than cursor_min it gallops forward from the
+    // cursor, trying the next leaf before searching from the root
     bool internal_search(const Record<N>& min, const Record<N>& max);
 };
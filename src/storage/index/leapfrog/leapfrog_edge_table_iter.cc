@@ -5,11 +5,12 @@ using namespace std;
 void LeapfrogEdgeTableIter::down() {
     level++;
     if (level == 0) {
-        auto record = edge_table[0];
+        Record<3> record(std::array<uint64_t, 3>{});
+        edge_table.get_record(0, record);
         current_tuple[0] = 1 | ObjectId::MASK_EDGE;
-        current_tuple[1] = (*record)[permutation[0]];
-        current_tuple[2] = (*record)[permutation[1]];
-        current_tuple[3] = (*record)[permutation[2]];
+        current_tuple[1] = record[permutation[0]];
+        current_tuple[2] = record[permutation[1]];
+        current_tuple[3] = record[permutation[2]];
     }
 }
 
@@ -17,14 +18,14 @@ void LeapfrogEdgeTableIter::down() {
 bool LeapfrogEdgeTableIter::next() {
     if (level == 0) {
         auto edge_value = (current_tuple[0] + 1) & ObjectId::VALUE_MASK;
-        auto record = edge_table[edge_value - 1];
-        if (record == nullptr) {
+        Record<3> record(std::array<uint64_t, 3>{});
+        if (!edge_table.get_record(edge_value - 1, record)) {
             return false;
         } else {
             current_tuple[0] = current_tuple[0] + 1;
-            current_tuple[1] = (*record)[permutation[0]];
-            current_tuple[2] = (*record)[permutation[1]];
-            current_tuple[3] = (*record)[permutation[2]];
+            current_tuple[1] = record[permutation[0]];
+            current_tuple[2] = record[permutation[1]];
+            current_tuple[3] = record[permutation[2]];
             return true;
         }
     } else {
@@ -44,14 +45,14 @@ bool LeapfrogEdgeTableIter::seek(uint64_t key) {
             return false;
         }
         auto edge_value = key & ObjectId::VALUE_MASK;
-        auto record = edge_table[edge_value - 1];
-        if (record == nullptr) {
+        Record<3> record(std::array<uint64_t, 3>{});
+        if (!edge_table.get_record(edge_value - 1, record)) {
             return false;
         } else {
             current_tuple[0] = key;
-            current_tuple[1] = (*record)[permutation[0]];
-            current_tuple[2] = (*record)[permutation[1]];
-            current_tuple[3] = (*record)[permutation[2]];
+            current_tuple[1] = record[permutation[0]];
+            current_tuple[2] = record[permutation[1]];
+            current_tuple[3] = record[permutation[2]];
             return true;
         }
     } else {
@@ -64,14 +65,14 @@ bool LeapfrogEdgeTableIter::open_terms(BindingId& input_binding) {
     // cout << "LeapfrogEdgeTableIter::open_terms\n";
     if (initial_ranges.empty()) {
         // initialize with first edge if it exists
-        auto record = edge_table[0];
-        if (record == nullptr) {
+        Record<3> record(std::array<uint64_t, 3>{});
+        if (!edge_table.get_record(0, record)) {
             return false;
         } else {
             current_tuple[0] = 1 | ObjectId::MASK_EDGE;
-            current_tuple[1] = (*record)[permutation[0]];
-            current_tuple[2] = (*record)[permutation[1]];
-            current_tuple[3] = (*record)[permutation[2]];
+            current_tuple[1] = record[permutation[0]];
+            current_tuple[2] = record[permutation[1]];
+            current_tuple[3] = record[permutation[2]];
             return true;
         }
     }
@@ -84,14 +85,14 @@ bool LeapfrogEdgeTableIter::open_terms(BindingId& input_binding) {
         return false;
     }
     auto edge_value = obj & ObjectId::VALUE_MASK;
-    auto record = edge_table[edge_value];
-    if (record == nullptr) {
+    Record<3> record(std::array<uint64_t, 3>{});
+    if (!edge_table.get_record(edge_value, record)) {
         return false;
     } else {
         current_tuple[0] = obj;
-        current_tuple[1] = (*record)[permutation[0]];
-        current_tuple[2] = (*record)[permutation[1]];
-        current_tuple[3] = (*record)[permutation[2]];
+        current_tuple[1] = record[permutation[0]];
+        current_tuple[2] = record[permutation[1]];
+        current_tuple[3] = record[permutation[2]];
 
         // check assigned_vars
         for (std::size_t i = 1; i < initial_ranges.size(); i++) { // skip 0, already checked the edge
@@ -108,15 +109,15 @@ bool LeapfrogEdgeTableIter::open_terms(BindingId& input_binding) {
 bool LeapfrogEdgeTableIter::next_enumeration(BindingId& binding) {
     if (level == -1) {
         current_edge_enum++;
-        auto record = edge_table[current_edge_enum - 1];
-        if (record == nullptr) {
+        Record<3> record(std::array<uint64_t, 3>{});
+        if (!edge_table.get_record(current_edge_enum - 1, record)) {
             return false;
         } else {
             std::array<uint64_t, 4> enum_tuple;
             enum_tuple[0] = current_edge_enum | ObjectId::MASK_EDGE;
-            enum_tuple[1] = (*record)[permutation[0]];
-            enum_tuple[2] = (*record)[permutation[1]];
-            enum_tuple[3] = (*record)[permutation[2]];
+            enum_tuple[1] = record[permutation[0]];
+            enum_tuple[2] = record[permutation[1]];
+            enum_tuple[3] = record[permutation[2]];
             for (size_t i = 0; i < enumeration_vars.size(); i++) {
                 binding.add(enumeration_vars[i],
                             ObjectId(enum_tuple[initial_ranges.size() + intersection_vars.size() + i]));
@@ -26,6 +26,13 @@ public:
     inline const std::vector<VarId>& get_intersection_vars() { return intersection_vars; }
     inline const std::vector<VarId>& get_enumeration_vars()  { return enumeration_vars; }
 
+    // Writes in `split_keys` (ordered) keys of the first intersection variable that split the records
+    // matching the input_binding in about `count` parts of similar size. Returns an estimation of the number of
+    // records split, or 0 if the iterator can't give split keys.
+    virtual uint64_t get_split_keys(BindingId& /*input_binding*/,
+                                    uint_fast32_t /*count*/,
+                                    std::vector<uint64_t>& /*split_keys*/) { return 0; }
+
     virtual void begin_enumeration() = 0;
     virtual void reset_enumeration() = 0;
     virtual bool next_enumeration(BindingId&) = 0;
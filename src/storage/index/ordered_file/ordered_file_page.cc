@@ -15,7 +15,7 @@ OrderedFilePage<N>::OrderedFilePage(Page& page) noexcept :
     // entire page at bulk import, so we skiped space for next_leaf when setting records
     records (reinterpret_cast<uint64_t*>(page.get_bytes() + (2*sizeof(uint32_t)) ))
 {
-    assert(*size <= MAX_RECORDS);
+    assert(*size <= max_records());
 }
 
 
@@ -28,7 +28,7 @@ OrderedFilePage<N>::~OrderedFilePage() {
 
 template <std::size_t N>
 void OrderedFilePage<N>::append_record(const std::array<uint64_t, N>& record) noexcept {
-    assert(*size < MAX_RECORDS);
+    assert(*size < max_records());
     for (uint_fast8_t i = 0; i < N; ++i) {
         records[(*size)*N + i] = record[i];
     }
@@ -52,7 +52,7 @@ void OrderedFilePage<N>::reorder_columns(const std::array<uint_fast8_t, N>& colu
 
 template <std::size_t N>
 void OrderedFilePage<N>::order() noexcept {
-    assert(*size <= MAX_RECORDS);
+    assert(*size <= max_records());
 
     // insertion sort
     for (uint32_t i = 1; i < *size; i++) {
@@ -80,7 +80,7 @@ void OrderedFilePage<N>::order() noexcept {
 
 template <std::size_t N>
 std::array<uint64_t, N> OrderedFilePage<N>::get(const uint_fast32_t pos) const noexcept {
-    assert(pos <= MAX_RECORDS);
+    assert(pos <= max_records());
     std::array<uint64_t, N> res;
     for (size_t i = 0; i < N; ++i) {
         res[i] = records[pos*N + i];
@@ -7,17 +7,13 @@
 template <std::size_t N>
 class OrderedFilePage {
 public:
-    static constexpr auto MAX_RECORDS = BPlusTree<N>::leaf_max_records;
-
-    static_assert(
-        MAX_RECORDS*N*sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint32_t) <= Page::MDB_PAGE_SIZE
-    );
+    static inline uint_fast32_t max_records() noexcept { return BPlusTree<N>::leaf_max_records(); }
 
     OrderedFilePage(Page& page) noexcept;
     ~OrderedFilePage();
 
     inline bool is_full() const noexcept {
-        return *size >= MAX_RECORDS;
+        return *size >= max_records();
     }
 
     inline void clear() noexcept { *size = 0; }
@@ -9,24 +9,24 @@ template <size_t N>
 RandomAccessTable<N>::RandomAccessTable(const string& name) :
     file_id(file_manager.get_file_id(name))
 {
-    // important to call buffer manager twice, so pins = 2
-    last_block    = make_unique<RandomAccessTableBlock<N>>(buffer_manager.get_last_page(file_id));
-    current_block = make_unique<RandomAccessTableBlock<N>>(buffer_manager.get_last_page(file_id));
+    if (buffer_manager.is_mmap_enabled()) {
+        buffer_manager.map_file(file_id, MappedFileAccess::random);
+    }
+    last_block = make_unique<RandomAccessTableBlock<N>>(buffer_manager.get_last_page(file_id));
 }
 
 
 template <size_t N>
-unique_ptr<Record<N>> RandomAccessTable<N>::operator[](uint_fast32_t pos) {
-    auto block        = pos / RandomAccessTableBlock<N>::max_records;
-    auto pos_in_block = pos % RandomAccessTableBlock<N>::max_records;
-
-    if (current_block->page.get_page_number() != block) {
-        current_block = make_unique<RandomAccessTableBlock<N>>(buffer_manager.get_page(file_id, block));
-    }
-    if (pos_in_block < *(current_block->record_count)) {
-        return (*current_block)[pos_in_block];
+bool RandomAccessTable<N>::get_record(uint_fast32_t pos, Record<N>& record) const {
+    auto block_number = pos / RandomAccessTableBlock<N>::max_records();
+    auto pos_in_block = pos % RandomAccessTableBlock<N>::max_records();
+
+    RandomAccessTableBlock<N> block(buffer_manager.get_page(file_id, block_number));
+    if (pos_in_block < *(block.record_count)) {
+        record = *block[pos_in_block];
+        return true;
     } else {
-        return nullptr;
+        return false;
     }
 }
 
@@ -16,12 +16,12 @@ public:
 
     void append_record(Record<N>);
 
-    // in case of out-of-bounds returns nullptr
-    std::unique_ptr<Record<N>> operator[](uint_fast32_t pos);
+    // copies the record at `pos` into `record`, in case of out-of-bounds returns false and `record` is not modified.
+    // The block is pinned only during the call, so the table can be read by many threads at the same time
+    bool get_record(uint_fast32_t pos, Record<N>& record) const;
 
 private:
     const FileId file_id;
 
-    std::unique_ptr<RandomAccessTableBlock<N>> current_block;
     std::unique_ptr<RandomAccessTableBlock<N>> last_block;
 };
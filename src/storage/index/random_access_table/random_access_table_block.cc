@@ -9,7 +9,7 @@ RandomAccessTableBlock<N>::RandomAccessTableBlock(Page& page) :
     page         (page),
     records      (reinterpret_cast<uint64_t*>(page.get_bytes())),
     record_count (reinterpret_cast<uint32_t*>(page.get_bytes()
-                  + (N * sizeof(uint64_t) * RandomAccessTableBlock<N>::max_records)))
+                  + (N * sizeof(uint64_t) * RandomAccessTableBlock<N>::max_records())))
     { }
 
 
@@ -21,7 +21,7 @@ RandomAccessTableBlock<N>::~RandomAccessTableBlock() {
 
 template <std::size_t N>
 bool RandomAccessTableBlock<N>::try_append_record(Record<N> record) {
-    if (*record_count < max_records) {
+    if (*record_count < max_records()) {
         for (std::size_t i = 0; i < N; ++i) {
             records[ (*record_count)*N + i ] = record.ids[i];
         }
@@ -35,13 +35,9 @@ bool RandomAccessTableBlock<N>::try_append_record(Record<N> record) {
 
 
 template <std::size_t N>
-unique_ptr<Record<N>> RandomAccessTableBlock<N>::operator[](uint_fast32_t pos) {
-    if (pos < max_records) {
-        std::array<uint64_t, N> ids;
-        for (uint_fast32_t i = 0; i < N; i++) {
-            ids[i] = records[pos*N + i];
-        }
-        return make_unique<Record<N>>(move(ids));
+const Record<N>* RandomAccessTableBlock<N>::operator[](uint_fast32_t pos) const noexcept {
+    if (pos < max_records()) {
+        return reinterpret_cast<const Record<N>*>(records + pos*N);
     } else {
         return nullptr;
     }
@@ -10,7 +10,9 @@
 // N is the columns of the table
 template <std::size_t N> class RandomAccessTableBlock {
 public:
-    static constexpr auto max_records = (Page::MDB_PAGE_SIZE - sizeof(uint32_t)) / (sizeof(uint64_t) * N);
+    static inline uint_fast32_t max_records() noexcept {
+        return (Page::get_size() - sizeof(uint32_t)) / (sizeof(uint64_t) * N);
+    }
 
     RandomAccessTableBlock(Page& page);
     ~RandomAccessTableBlock();
@@ -18,8 +20,8 @@ public:
     // returns false if record was not inserted
     bool try_append_record(Record<N>);
 
-    // in case of out-of-bounds returns nullptr
-    std::unique_ptr<Record<N>> operator[](uint_fast32_t pos);
+    // in case of out-of-bounds returns nullptr. The record is not copied, the pointer is valid while the block is alive
+    const Record<N>* operator[](uint_fast32_t pos) const noexcept;
 
 // private:
     Page& page;
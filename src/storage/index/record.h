@@ -65,6 +65,12 @@ public:
     }
 };
 
+// pages store a record as N consecutive ids, so a Record can point to the page without copying it
+static_assert(sizeof(Record<1>) == sizeof(uint64_t));
+static_assert(sizeof(Record<2>) == 2 * sizeof(uint64_t));
+static_assert(sizeof(Record<3>) == 3 * sizeof(uint64_t));
+static_assert(sizeof(Record<4>) == 4 * sizeof(uint64_t));
+
 class RecordFactory {
 public:
     inline static Record<1> get(uint64_t a1) noexcept {
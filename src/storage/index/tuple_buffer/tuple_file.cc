@@ -0,0 +1,66 @@
+#include "tuple_file.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+
+using namespace std;
+
+TupleFile::TupleFile(uint_fast32_t tuple_size) :
+    file_id    (file_manager.get_tmp_file_id()),
+    tuple_size (tuple_size),
+    max_tuples (tuple_size == 0 ? UINT32_MAX : Page::get_size() / (tuple_size * sizeof(ObjectId))) { }
+
+
+TupleFile::~TupleFile() {
+    unpin(&write_page);
+    unpin(&read_page);
+    file_manager.remove_tmp(file_id);
+}
+
+
+void TupleFile::unpin(Page** page) {
+    if (*page != nullptr) {
+        buffer_manager.unpin(**page);
+        *page = nullptr;
+    }
+}
+
+
+void TupleFile::append(const ObjectId* tuple) {
+    assert(read_page == nullptr && "append while reading");
+    const auto pos_in_page = tuple_count % max_tuples;
+    if (pos_in_page == 0) {
+        unpin(&write_page);
+        write_page = &buffer_manager.get_tmp_page(file_id, tuple_count / max_tuples);
+    }
+    memcpy(write_page->get_bytes() + pos_in_page * tuple_size * sizeof(ObjectId),
+           tuple,
+           tuple_size * sizeof(ObjectId));
+    write_page->make_dirty();
+    tuple_count++;
+}
+
+
+void TupleFile::begin_read() {
+    unpin(&write_page);
+    unpin(&read_page);
+    read_count = 0;
+}
+
+
+const ObjectId* TupleFile::next() {
+    if (read_count == tuple_count) {
+        unpin(&read_page);
+        return nullptr;
+    }
+    const auto pos_in_page = read_count % max_tuples;
+    if (pos_in_page == 0) {
+        unpin(&read_page);
+        read_page = &buffer_manager.get_tmp_page(file_id, read_count / max_tuples);
+    }
+    read_count++;
+    return reinterpret_cast<const ObjectId*>(read_page->get_bytes() + pos_in_page * tuple_size * sizeof(ObjectId));
+}
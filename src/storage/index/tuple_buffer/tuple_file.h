@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "base/ids/object_id.h"
+#include "storage/file_id.h"
+#include "storage/page.h"
+
+// TupleFile appends tuples of ObjectIds with a fixed size to a temp file and reads them in the same order.
+// Only the page being written and the page being read are pinned, the rest may be evicted from the private
+// buffer of the thread to the file.
+class TupleFile {
+public:
+    TupleFile(uint_fast32_t tuple_size);
+    ~TupleFile();
+
+    inline uint64_t size() const noexcept { return tuple_count; }
+
+    inline uint64_t bytes() const noexcept { return tuple_count * tuple_size * sizeof(ObjectId); }
+
+    void append(const ObjectId* tuple);
+
+    // starts reading from the first tuple, tuples must not be appended while reading
+    void begin_read();
+
+    // returns the next tuple, or nullptr after the last one. The tuple is valid until the next call
+    const ObjectId* next();
+
+private:
+    const TmpFileId file_id;
+    const uint_fast32_t tuple_size;
+    const uint_fast32_t max_tuples; // How many tuples fit in a page
+
+    uint64_t tuple_count = 0;
+    uint64_t read_count  = 0;
+
+    Page* write_page = nullptr;
+    Page* read_page  = nullptr;
+
+    void unpin(Page** page);
+};
@@ -1,6 +1,7 @@
 /* Page represents the content of a disk block in memory.
- * A page is treated as an array of `MDB_PAGE_SIZE` bytes (pointed by `bytes`).
- * For better performance, `MDB_PAGE_SIZE` should be multiple of the operating system's page size.
+ * A page is treated as an array of `get_size()` bytes (pointed by `bytes`).
+ * The page size is chosen when a database is created and saved in its catalog, all the files of a database use
+ * the same page size. It is a multiple of the operating system's page size between MDB_PAGE_SIZE and MAX_PAGE_SIZE.
  * BufferManager is the only class who can construct a Page object. Other classes must get a Page
  * through BufferManager.
  */
@@ -14,23 +15,47 @@
 class Page {
 friend class BufferManager;
 friend class FileManager;
+friend class ClockReplacement;
+friend class TwoQueueReplacement;
 public:
+    // default and minimum page size
     static constexpr size_t MDB_PAGE_SIZE = 4096;
 
+    static constexpr size_t MAX_PAGE_SIZE = 64 * 1024;
+
+    // size of the pages of the current database
+    static inline size_t get_size() noexcept { return size; }
+
+    static inline bool is_valid_size(size_t new_size) noexcept {
+        return new_size >= MDB_PAGE_SIZE && new_size <= MAX_PAGE_SIZE && (new_size & (new_size - 1)) == 0;
+    }
+
+    // must be called before initializing the BufferManager or writing files of a database,
+    // `new_size` must be a power of 2 between MDB_PAGE_SIZE and MAX_PAGE_SIZE
+    static inline void set_size(size_t new_size) noexcept {
+        assert(is_valid_size(new_size));
+        size = new_size;
+    }
+
     // contains file_id and page_number of this page
     PageId page_id;
 
     // mark as dirty so when page is replaced it is written back to disk.
-    inline void make_dirty() noexcept { dirty = true; }
+    inline void make_dirty() noexcept {
+        assert(!mapped && "Cannot modify a page mapped as read only");
+        dirty = true;
+    }
 
-    // get the start memory position of `MDB_PAGE_SIZE` allocated bytes
+    // get the start memory position of `get_size()` allocated bytes
     inline char* get_bytes() const noexcept { return bytes; }
 
     // get page number
     inline uint32_t get_page_number() const noexcept { return page_id.page_number; };
 
 private:
-    // start memory address of the page, of size `MDB_PAGE_SIZE`
+    static inline size_t size = MDB_PAGE_SIZE;
+
+    // start memory address of the page, of size `get_size()`
     char* bytes;
 
     // count of objects using this page, modified only by buffer_manager
@@ -42,12 +67,22 @@ private:
     // true if data in memory is different from disk
     bool dirty;
 
+    // true while the page is being read from disk. Other threads asking for the same page
+    // must wait until it is false before reading `bytes`
+    std::atomic<bool> io_pending;
+
+    // true if `bytes` points to a read-only memory mapping of the file instead of a buffer frame.
+    // Mapped pages are never pinned nor evicted
+    bool mapped;
+
     Page() noexcept :
         page_id(FileId(FileId::UNASSIGNED), 0),
         bytes(nullptr),
         pins(0),
         usage(0),
-        dirty(false) { }
+        dirty(false),
+        io_pending(false),
+        mapped(false) { }
 
     void pin() noexcept {
         pins++;
@@ -67,12 +102,12 @@ private:
         this->pins    = 0;
         this->usage   = 0;
         this->dirty   = false;
+        this->io_pending = false;
     }
 
     void reassign(PageId page_id, char* bytes) noexcept {
         assert(!dirty && "Cannot reassign page if it is dirty");
         assert(pins == 0 && "Cannot reassign page if it is pinned");
-        assert(usage == 0 && "Should not reassign page if usage is not 0");
 
         this->page_id = page_id;
         this->bytes   = bytes;
@@ -14,16 +14,16 @@ struct PageId {
         file_id     (file_id),
         page_number (page_number) { }
 
-    // needed to allow std::map having PageId as key
-    // bool operator<(const PageId& other) const {
-    //     if (this->file_id < other.file_id) {
-    //         return true;
-    //     } else if (other.file_id < this->file_id) {
-    //         return false;
-    //     } else {
-    //         return this->page_number < other.page_number;
-    //     }
-    // }
+    // used to sort pages in file order
+    bool operator<(const PageId& other) const {
+        if (this->file_id < other.file_id) {
+            return true;
+        } else if (other.file_id < this->file_id) {
+            return false;
+        } else {
+            return this->page_number < other.page_number;
+        }
+    }
 
     // needed to allow std::unordered_map having PageId as key
     bool operator==(const PageId& other) const {
@@ -0,0 +1,183 @@
+#include "page_memory.h"
+
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "storage/page.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace {
+    // nodes are represented as a bitmask, machines with more than 64 nodes only use the first 64
+    using NodeMask = unsigned long;
+
+    constexpr unsigned long MAX_NODES = sizeof(NodeMask) * 8;
+
+    // parses /sys/devices/system/node/online, that has a format like "0-3,5"
+    NodeMask read_online_nodes() {
+        std::ifstream file("/sys/devices/system/node/online");
+        std::string ranges;
+        if (!(file >> ranges)) {
+            return 1;
+        }
+        NodeMask mask = 0;
+        size_t pos = 0;
+        while (pos < ranges.size()) {
+            auto end = ranges.find(',', pos);
+            if (end == std::string::npos) {
+                end = ranges.size();
+            }
+            const auto range = ranges.substr(pos, end - pos);
+            const auto dash  = range.find('-');
+            const auto first = std::stoul(range.substr(0, dash));
+            const auto last  = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (auto node = first; node <= last && node < MAX_NODES; node++) {
+                mask |= NodeMask(1) << node;
+            }
+            pos = end + 1;
+        }
+        return mask == 0 ? 1 : mask;
+    }
+
+    NodeMask get_online_nodes() {
+        static const NodeMask online_nodes = read_online_nodes();
+        return online_nodes;
+    }
+
+    // returns the mask of the online node number `index`, nodes may not be numbered consecutively
+    NodeMask get_node(uint_fast32_t index) {
+        auto mask = get_online_nodes();
+        for (uint_fast32_t i = 0; i < index; i++) {
+            mask &= mask - 1;
+        }
+        return mask & -mask;
+    }
+
+    // the kernel ignores the last bit of maxnode
+    void set_memory_policy(char* bytes, size_t size, int mode, NodeMask mask) {
+        syscall(SYS_mbind, bytes, size, mode, &mask, MAX_NODES + 1, 0);
+    }
+
+    size_t round_up(size_t size, size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    // length of the mapping of `size` bytes. Regular mappings are rounded to 2 MB whether madvise succeeded or not,
+    // so free() unmaps the same length after allocate() fell back from transparent huge pages to none
+    size_t mapping_size(size_t size, HugePages huge_pages) {
+        if (huge_pages == HugePages::huge_2mb || huge_pages == HugePages::huge_1gb) {
+            return round_up(size, PageMemory::get_page_size(huge_pages));
+        }
+        return round_up(size, PageMemory::get_page_size(HugePages::transparent));
+    }
+}
+
+
+size_t PageMemory::get_page_size(HugePages huge_pages) {
+    switch (huge_pages) {
+    case HugePages::huge_1gb:
+        return 1024 * 1024 * 1024;
+    case HugePages::huge_2mb:
+    case HugePages::transparent:
+        return 2 * 1024 * 1024;
+    default:
+        return Page::MDB_PAGE_SIZE;
+    }
+}
+
+
+char* PageMemory::allocate(size_t size, HugePages& huge_pages) {
+    if (huge_pages == HugePages::huge_2mb || huge_pages == HugePages::huge_1gb) {
+        const int size_flag = huge_pages == HugePages::huge_2mb ? MAP_HUGE_2MB : MAP_HUGE_1GB;
+        void* bytes = mmap(nullptr,
+                           mapping_size(size, huge_pages),
+                           PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | size_flag,
+                           -1,
+                           0);
+        if (bytes != MAP_FAILED) {
+            return reinterpret_cast<char*>(bytes);
+        }
+        // there are not enough huge pages reserved
+        huge_pages = HugePages::transparent;
+    }
+
+    void* bytes = mmap(nullptr,
+                       mapping_size(size, huge_pages),
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+    if (bytes == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    if (huge_pages == HugePages::transparent && madvise(bytes, size, MADV_HUGEPAGE) != 0) {
+        huge_pages = HugePages::none;
+    }
+    return reinterpret_cast<char*>(bytes);
+}
+
+
+void PageMemory::free(char* bytes, size_t size, HugePages huge_pages) {
+    munmap(bytes, mapping_size(size, huge_pages));
+}
+
+
+uint_fast32_t PageMemory::numa_node_count() {
+    return __builtin_popcountl(get_online_nodes());
+}
+
+
+void PageMemory::interleave(char* bytes, size_t size) {
+    if (numa_node_count() > 1) {
+        set_memory_policy(bytes, size, MPOL_INTERLEAVE, get_online_nodes());
+    }
+}
+
+
+void PageMemory::bind(char* bytes, size_t size, uint_fast32_t node) {
+    if (numa_node_count() > 1) {
+        set_memory_policy(bytes, size, MPOL_BIND, get_node(node));
+    }
+}
+
+
+void PageMemory::set_thread_preferred_node(uint_fast32_t node) {
+    if (numa_node_count() > 1) {
+        NodeMask mask = get_node(node);
+        syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, MAX_NODES + 1);
+    }
+}
+
+
+void PageMemory::reset_thread_policy() {
+    if (numa_node_count() > 1) {
+        syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+    }
+}
+
+
+const char* PageMemory::to_string(HugePages huge_pages) {
+    switch (huge_pages) {
+    case HugePages::none:        return "none";
+    case HugePages::transparent: return "thp";
+    case HugePages::huge_2mb:    return "2mb";
+    case HugePages::huge_1gb:    return "1gb";
+    }
+    return "";
+}
@@ -0,0 +1,58 @@
+/*
+ * PageMemory allocates the memory used for the frames of the buffers.
+ *
+ * Memory is obtained with an anonymous mmap so it can be backed by huge pages, either explicitly reserved
+ * (MAP_HUGETLB, needs pages reserved in /proc/sys/vm/nr_hugepages or the 1 GB pool) or transparent huge pages
+ * requested with madvise. When explicit huge pages are not available the allocation falls back to transparent
+ * huge pages, and the mode actually used is returned so it can be reported.
+ *
+ * On machines with several NUMA nodes the memory can be interleaved between the nodes or bound to a node.
+ * The syscalls are used directly so libnuma is not needed, on a single node machine these functions do nothing.
+ * Memory policies must be set before the memory is touched for the first time.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class HugePages {
+    none,        // regular 4 KB pages
+    transparent, // transparent huge pages requested with madvise
+    huge_2mb,    // explicit 2 MB huge pages
+    huge_1gb,    // explicit 1 GB huge pages
+};
+
+enum class NumaPolicy {
+    none,        // memory is allocated in the node of the thread that touches it first
+    interleave,  // pages are distributed round robin between the nodes
+    partitioned, // each partition of the shared buffer (frames and page table) lives in one node
+};
+
+namespace PageMemory {
+    // Allocates `size` bytes aligned at least to the page size, `huge_pages` is updated to the mode used.
+    // Throws std::bad_alloc if the memory can't be allocated
+    char* allocate(size_t size, HugePages& huge_pages);
+
+    // `size` must be the one given to allocate() and `huge_pages` the mode allocate() returned
+    void free(char* bytes, size_t size, HugePages huge_pages);
+
+    // number of NUMA nodes of the machine, at least 1
+    uint_fast32_t numa_node_count();
+
+    // distributes the pages of the memory range between all the nodes
+    void interleave(char* bytes, size_t size);
+
+    // allocates the pages of the memory range in `node`, nodes are numbered from 0 to numa_node_count() - 1
+    void bind(char* bytes, size_t size, uint_fast32_t node);
+
+    // memory touched for the first time by the current thread will be allocated preferably in `node`
+    void set_thread_preferred_node(uint_fast32_t node);
+
+    // the current thread goes back to the default policy
+    void reset_thread_policy();
+
+    // the allocation granularity of a huge page mode
+    size_t get_page_size(HugePages huge_pages);
+
+    const char* to_string(HugePages huge_pages);
+}
@@ -0,0 +1,39 @@
+#include "clock_replacement.h"
+
+ClockReplacement::ClockReplacement(Page* frames, uint_fast32_t frame_count) :
+    frames      (frames),
+    frame_count (frame_count),
+    clock_pos   (0) { }
+
+
+void ClockReplacement::on_hit(uint_fast32_t frame) {
+    auto& page = frames[frame];
+    if (page.usage < MAX_USAGE) {
+        page.usage++;
+    }
+}
+
+
+void ClockReplacement::on_insert(uint_fast32_t frame, bool hot) {
+    // hot pages survive more turns of the clock
+    frames[frame].usage = hot ? MAX_USAGE : 1;
+}
+
+
+uint_fast32_t ClockReplacement::choose_victim() {
+    while (true) {
+        // when pins == 0 the are no synchronization problems with pins and usage,
+        // pages are only pinned from 0 to 1 while holding the partition mutex
+        auto& page = frames[clock_pos];
+        if (page.pins == 0) {
+            if (page.usage == 0) {
+                break;
+            } else {
+                page.usage--;
+            }
+        }
+        clock_pos++;
+        clock_pos = clock_pos < frame_count ? clock_pos : 0;
+    }
+    return clock_pos;
+}
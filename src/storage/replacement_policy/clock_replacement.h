@@ -0,0 +1,28 @@
+/*
+ * Classic CLOCK: every page has a usage counter that is increased when the page is requested (up to MAX_USAGE)
+ * and decreased when the clock hand passes over it. The first unpinned page found with usage 0 is the victim.
+ */
+#pragma once
+
+#include "storage/replacement_policy/replacement_policy.h"
+
+class ClockReplacement : public ReplacementPolicy {
+public:
+    static constexpr uint32_t MAX_USAGE = 5;
+
+    ClockReplacement(Page* frames, uint_fast32_t frame_count);
+
+    void on_hit(uint_fast32_t frame) override;
+
+    void on_insert(uint_fast32_t frame, bool hot) override;
+
+    uint_fast32_t choose_victim() override;
+
+private:
+    Page* const frames;
+
+    const uint_fast32_t frame_count;
+
+    // goes from 0 to frame_count-1
+    uint_fast32_t clock_pos;
+};
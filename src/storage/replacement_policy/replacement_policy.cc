@@ -0,0 +1,17 @@
+#include "replacement_policy.h"
+
+#include "storage/replacement_policy/clock_replacement.h"
+#include "storage/replacement_policy/two_queue_replacement.h"
+
+std::unique_ptr<ReplacementPolicy> ReplacementPolicy::create(ReplacementPolicyType type,
+                                                             Page*                 frames,
+                                                             uint_fast32_t         frame_count)
+{
+    switch (type) {
+    case ReplacementPolicyType::clock:
+        return std::make_unique<ClockReplacement>(frames, frame_count);
+    case ReplacementPolicyType::two_queue:
+        return std::make_unique<TwoQueueReplacement>(frames, frame_count);
+    }
+    return nullptr;
+}
@@ -0,0 +1,42 @@
+/*
+ * ReplacementPolicy decides which frame of a partition of the shared buffer is reused when a page that is not
+ * in the buffer is requested. Every partition has its own policy object and all the methods are called while
+ * the partition mutex is locked, so implementations don't need any synchronization.
+ *
+ * Frames are identified by their position inside the partition (from 0 to frame_count-1). A frame can be
+ * chosen as victim only if its page is not pinned. If every frame is pinned choose_victim() waits until some
+ * page is unpinned, as unpinning doesn't need the partition mutex.
+ *
+ * Pages of hot files (e.g. B+Tree directories) are inserted with `hot` set to true and policies should keep
+ * them longer than the other pages.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "storage/page.h"
+
+enum class ReplacementPolicyType {
+    clock,     // CLOCK with a saturating usage counter
+    two_queue, // 2Q, scan resistant
+};
+
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() = default;
+
+    // `frames` is the array of `frame_count` pages of the partition
+    static std::unique_ptr<ReplacementPolicy> create(ReplacementPolicyType type,
+                                                     Page*                 frames,
+                                                     uint_fast32_t         frame_count);
+
+    // called when the page stored in `frame` is requested again
+    virtual void on_hit(uint_fast32_t frame) = 0;
+
+    // called when a new page was stored in `frame` (the frame was returned by choose_victim)
+    virtual void on_insert(uint_fast32_t frame, bool hot) = 0;
+
+    // returns a frame with an unpinned page that will be replaced
+    virtual uint_fast32_t choose_victim() = 0;
+};
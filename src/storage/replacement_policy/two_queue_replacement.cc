@@ -0,0 +1,166 @@
+#include "two_queue_replacement.h"
+
+#include <thread>
+
+TwoQueueReplacement::TwoQueueReplacement(Page* frames, uint_fast32_t frame_count) :
+    frames            (frames),
+    frame_count       (frame_count),
+    a1_in_max_size    (std::max<uint_fast32_t>(1, frame_count / 4)),
+    a1_out_max_size   (std::max<uint_fast32_t>(1, frame_count / 2)),
+    prev              (frame_count, NONE),
+    next              (frame_count, NONE),
+    queue             (frame_count, Queue::none),
+    hot               (frame_count, false),
+    second_chance     (frame_count, false),
+    a1_out_insertions (0)
+{
+    free_frames.reserve(frame_count);
+    // reversed so frames are used in order
+    for (uint_fast32_t i = frame_count; i > 0; i--) {
+        free_frames.push_back(i - 1);
+    }
+}
+
+
+void TwoQueueReplacement::on_hit(uint_fast32_t frame) {
+    // pages in a1_in are not moved, a page requested several times in a short period (e.g. a scan going through
+    // a leaf) is not frequently used
+    if (queue[frame] == Queue::am) {
+        remove(am, frame);
+        push_front(am, frame);
+        second_chance[frame] = hot[frame];
+    }
+}
+
+
+void TwoQueueReplacement::on_insert(uint_fast32_t frame, bool is_hot) {
+    hot[frame]           = is_hot;
+    second_chance[frame] = is_hot;
+
+    if (is_hot) {
+        queue[frame] = Queue::am;
+        push_front(am, frame);
+        return;
+    }
+
+    auto ghost = a1_out_pages.find(frames[frame].page_id);
+    if (ghost != a1_out_pages.end()) {
+        // the page was evicted recently from a1_in, so it is requested frequently
+        a1_out_pages.erase(ghost);
+        queue[frame] = Queue::am;
+        push_front(am, frame);
+    } else {
+        queue[frame] = Queue::a1_in;
+        push_front(a1_in, frame);
+    }
+}
+
+
+uint_fast32_t TwoQueueReplacement::choose_victim() {
+    while (true) {
+        auto victim = try_choose_victim();
+        if (victim != NONE) {
+            queue[victim] = Queue::none;
+            return victim;
+        }
+        // every page is pinned, wait until other thread unpins one
+        std::this_thread::yield();
+    }
+}
+
+
+uint32_t TwoQueueReplacement::try_choose_victim() {
+    if (!free_frames.empty()) {
+        auto frame = free_frames.back();
+        free_frames.pop_back();
+        return frame;
+    }
+
+    if (a1_in.size > a1_in_max_size || am.size == 0) {
+        auto frame = find_unpinned(a1_in);
+        if (frame != NONE) {
+            remove(a1_in, frame);
+            remember_evicted(frames[frame].page_id);
+            return frame;
+        }
+    }
+
+    // search from the least recently used page of am, hot pages get a second chance
+    auto frame = am.tail;
+    for (uint_fast32_t visited = 0, size = am.size; frame != NONE && visited < size; visited++) {
+        const auto prev_frame = prev[frame];
+        if (frames[frame].pins == 0) {
+            remove(am, frame);
+            if (second_chance[frame]) {
+                second_chance[frame] = false;
+                push_front(am, frame);
+            } else {
+                return frame;
+            }
+        }
+        frame = prev_frame;
+    }
+
+    // pages of am are pinned or just used their second chance
+    frame = find_unpinned(a1_in);
+    if (frame != NONE) {
+        remove(a1_in, frame);
+        remember_evicted(frames[frame].page_id);
+    }
+    return frame;
+}
+
+
+uint32_t TwoQueueReplacement::find_unpinned(const FrameList& list) const {
+    auto frame = list.tail;
+    while (frame != NONE && frames[frame].pins != 0) {
+        frame = prev[frame];
+    }
+    return frame;
+}
+
+
+void TwoQueueReplacement::remember_evicted(PageId page_id) {
+    a1_out_insertions++;
+    a1_out_pages[page_id] = a1_out_insertions;
+    a1_out_queue.push({ page_id, a1_out_insertions });
+
+    while (a1_out_queue.size() > a1_out_max_size) {
+        const auto& oldest = a1_out_queue.front();
+        auto it = a1_out_pages.find(oldest.first);
+        if (it != a1_out_pages.end() && it->second == oldest.second) {
+            a1_out_pages.erase(it);
+        }
+        a1_out_queue.pop();
+    }
+}
+
+
+void TwoQueueReplacement::push_front(FrameList& list, uint32_t frame) {
+    prev[frame] = NONE;
+    next[frame] = list.head;
+    if (list.head != NONE) {
+        prev[list.head] = frame;
+    } else {
+        list.tail = frame;
+    }
+    list.head = frame;
+    list.size++;
+}
+
+
+void TwoQueueReplacement::remove(FrameList& list, uint32_t frame) {
+    if (prev[frame] != NONE) {
+        next[prev[frame]] = next[frame];
+    } else {
+        list.head = next[frame];
+    }
+    if (next[frame] != NONE) {
+        prev[next[frame]] = prev[frame];
+    } else {
+        list.tail = prev[frame];
+    }
+    prev[frame] = NONE;
+    next[frame] = NONE;
+    list.size--;
+}
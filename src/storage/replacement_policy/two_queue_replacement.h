@@ -0,0 +1,89 @@
+/*
+ * 2Q replacement (Johnson and Shasha, 1994), resistant to scans.
+ *
+ * Pages requested for the first time enter `a1_in`, a FIFO queue with about 25% of the frames. Pages evicted
+ * from `a1_in` are remembered (only their PageId) in the ghost queue `a1_out`. When a page is requested again
+ * while its id is in `a1_out` it is considered frequently used and it is stored in `am`, an LRU list with the
+ * rest of the frames. A scan reads every page once, so it only replaces pages of `a1_in` and the pages of `am`
+ * stay in the buffer.
+ *
+ * Hot pages are inserted directly in `am` and they get a second chance when they reach the end of `am`.
+ */
+#pragma once
+
+#include <queue>
+#include <vector>
+
+#include "storage/page_id.h"
+#include "storage/replacement_policy/replacement_policy.h"
+#include "third_party/robin_hood/robin_hood.h"
+
+class TwoQueueReplacement : public ReplacementPolicy {
+public:
+    TwoQueueReplacement(Page* frames, uint_fast32_t frame_count);
+
+    void on_hit(uint_fast32_t frame) override;
+
+    void on_insert(uint_fast32_t frame, bool hot) override;
+
+    uint_fast32_t choose_victim() override;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    enum class Queue : uint8_t {
+        none, // the frame doesn't have a page yet
+        a1_in,
+        am,
+    };
+
+    // doubly linked list of frames, the head has the most recent pages
+    struct FrameList {
+        uint32_t head = NONE;
+        uint32_t tail = NONE;
+        uint_fast32_t size = 0;
+    };
+
+    Page* const frames;
+
+    const uint_fast32_t frame_count;
+
+    // max size of a1_in
+    const uint_fast32_t a1_in_max_size;
+
+    // max number of page ids remembered in a1_out
+    const uint_fast32_t a1_out_max_size;
+
+    FrameList a1_in;
+    FrameList am;
+
+    // links of the lists, indexed by frame
+    std::vector<uint32_t> prev;
+    std::vector<uint32_t> next;
+
+    std::vector<Queue> queue;
+
+    // hot pages with second_chance are moved to the head of `am` instead of being evicted
+    std::vector<bool> hot;
+    std::vector<bool> second_chance;
+
+    // frames that were never used
+    std::vector<uint32_t> free_frames;
+
+    // ghost queue. The page ids in `a1_out_queue` whose insertion number is not the one in
+    // `a1_out_pages` were removed from a1_out before
+    std::queue<std::pair<PageId, uint64_t>> a1_out_queue;
+    robin_hood::unordered_map<PageId, uint64_t> a1_out_pages;
+    uint64_t a1_out_insertions;
+
+    void push_front(FrameList& list, uint32_t frame);
+    void remove(FrameList& list, uint32_t frame);
+
+    // returns the last frame of the list with an unpinned page or NONE
+    uint32_t find_unpinned(const FrameList& list) const;
+
+    // returns the frame of the victim or NONE if every page of both lists are pinned
+    uint32_t try_choose_victim();
+
+    void remember_evicted(PageId page_id);
+};
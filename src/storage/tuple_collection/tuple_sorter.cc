@@ -0,0 +1,354 @@
+#include "tuple_sorter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "base/exceptions.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+
+using namespace std;
+
+TupleSorter::TupleSorter(uint_fast32_t         _tuple_size,
+                         vector<uint_fast32_t> _order_positions,
+                         vector<bool>          _ascending,
+                         uint64_t              memory_budget,
+                         uint64_t              _limit,
+                         bool*                 _interruption_requested) :
+    tuple_size             (_tuple_size),
+    order_positions        (move(_order_positions)),
+    ascending              (move(_ascending)),
+    limit                  (_limit),
+    interruption_requested (_interruption_requested),
+    max_memory_tuples      (clamp<uint64_t>(memory_budget / memory_tuple_bytes(_tuple_size), 1, UINT32_MAX)),
+    top_k                  (_limit <= min<uint64_t>(memory_budget / (memory_tuple_bytes(_tuple_size) + sizeof(uint64_t)),
+                                                    UINT32_MAX)),
+    page_tuples            (_tuple_size == 0 ? UINT32_MAX : Page::get_size() / (_tuple_size * sizeof(GraphObject)))
+{
+    assert(order_positions.size() == ascending.size());
+    assert(page_tuples > 0 && "a tuple must fit in a page");
+}
+
+
+TupleSorter::~TupleSorter() {
+    end_merge();
+    unpin(&write_page);
+    if (file_id) {
+        file_manager.remove_tmp(*file_id);
+    }
+}
+
+
+void TupleSorter::unpin(Page** page) {
+    if (*page != nullptr) {
+        buffer_manager.unpin(**page);
+        *page = nullptr;
+    }
+}
+
+
+int TupleSorter::compare_value(uint_fast32_t order, const GraphObject& lhs, const GraphObject& rhs) const {
+    // the same object is equal in every model, without calling the comparison of the model
+    if (lhs.type == rhs.type && lhs.encoded_value == rhs.encoded_value) {
+        return 0;
+    }
+    const auto cmp = GraphObject::graph_object_cmp(lhs, rhs);
+    if (cmp == 0) {
+        return 0;
+    }
+    return (cmp < 0) == ascending[order] ? -1 : 1;
+}
+
+
+int TupleSorter::compare(const GraphObject* lhs, const GraphObject* rhs, uint_fast32_t first_order) const {
+    for (size_t i = first_order; i < order_positions.size(); i++) {
+        const auto cmp = compare_value(i, lhs[order_positions[i]], rhs[order_positions[i]]);
+        if (cmp != 0) {
+            return cmp;
+        }
+    }
+    return 0;
+}
+
+
+TupleSorter::SortEntry TupleSorter::make_entry(const GraphObject* tuple, uint32_t pos) const {
+    return { order_positions.empty() ? GraphObject() : tuple[order_positions[0]], pos };
+}
+
+
+bool TupleSorter::memory_less(const SortEntry& lhs, const SortEntry& rhs) const {
+    if (!order_positions.empty()) {
+        auto cmp = compare_value(0, lhs.first_value, rhs.first_value);
+        if (cmp == 0) {
+            cmp = compare(memory_tuple(lhs.pos), memory_tuple(rhs.pos), 1);
+        }
+        if (cmp != 0) {
+            return cmp < 0;
+        }
+    }
+    // the positions of a run are in insertion order, but the heap reuses them
+    return top_k ? sequence[lhs.pos] < sequence[rhs.pos] : lhs.pos < rhs.pos;
+}
+
+
+void TupleSorter::add(const GraphObject* tuple) {
+    tuple_count++;
+    if (top_k) {
+        add_top_k(tuple);
+        return;
+    }
+    if (order.size() == max_memory_tuples) {
+        spill();
+    } else if (order.size() == order.capacity() && order.size() * 2 > max_memory_tuples) {
+        // growing the vectors would go over the budget
+        order.reserve(max_memory_tuples);
+        tuples.reserve(max_memory_tuples * tuple_size);
+    }
+    order.push_back(make_entry(tuple, order.size()));
+    tuples.insert(tuples.end(), tuple, tuple + tuple_size);
+}
+
+
+void TupleSorter::add_top_k(const GraphObject* tuple) {
+    const auto heap_less = [this](const SortEntry& lhs, const SortEntry& rhs) { return memory_less(lhs, rhs); };
+    if (order.size() < limit) {
+        order.push_back(make_entry(tuple, order.size()));
+        sequence.push_back(tuple_count);
+        tuples.insert(tuples.end(), tuple, tuple + tuple_size);
+        push_heap(order.begin(), order.end(), heap_less);
+    }
+    // the top is the worst tuple kept, a tuple equal to it goes after it
+    else if (limit > 0 && compare(tuple, memory_tuple(order.front().pos)) < 0) {
+        pop_heap(order.begin(), order.end(), heap_less);
+        const auto pos = order.back().pos;
+        order.back() = make_entry(tuple, pos);
+        memcpy(&tuples[static_cast<uint64_t>(pos) * tuple_size], tuple, tuple_size * sizeof(GraphObject));
+        sequence[pos] = tuple_count;
+        push_heap(order.begin(), order.end(), heap_less);
+    }
+}
+
+
+void TupleSorter::sort_memory() {
+    std::sort(order.begin(), order.end(), [this](const SortEntry& lhs, const SortEntry& rhs) {
+        return memory_less(lhs, rhs);
+    });
+}
+
+
+void TupleSorter::spill() {
+    if (__builtin_expect(!!(*interruption_requested), 0)) {
+        throw InterruptedException();
+    }
+    sort_memory();
+    if (!file_id) {
+        file_id = file_manager.get_tmp_file_id();
+    }
+    Run run { file_pages, 0 };
+    for (auto& entry : order) {
+        write_tuple(run, memory_tuple(entry.pos));
+    }
+    finish_run();
+    runs.push_back(run);
+    spilled_runs++;
+
+    order.clear();
+    tuples.clear();
+}
+
+
+void TupleSorter::write_tuple(Run& run, const GraphObject* tuple) {
+    const auto pos_in_page = run.tuple_count % page_tuples;
+    if (pos_in_page == 0) {
+        unpin(&write_page);
+        write_page = &buffer_manager.get_tmp_page(*file_id, file_pages++);
+        write_page->make_dirty();
+    }
+    memcpy(write_page->get_bytes() + pos_in_page * tuple_size * sizeof(GraphObject),
+           tuple,
+           tuple_size * sizeof(GraphObject));
+    run.tuple_count++;
+}
+
+
+void TupleSorter::finish_run() {
+    unpin(&write_page);
+}
+
+
+void TupleSorter::finish() {
+    if (top_k) {
+        sort_heap(order.begin(), order.end(), [this](const SortEntry& lhs, const SortEntry& rhs) {
+            return memory_less(lhs, rhs);
+        });
+        return;
+    }
+    if (runs.empty()) {
+        sort_memory();
+        return;
+    }
+    if (!order.empty()) {
+        spill();
+    }
+    vector<GraphObject>().swap(tuples);
+    vector<SortEntry>().swap(order);
+
+    // merge consecutive groups of runs, so the order of equal tuples is kept
+    while (runs.size() > MAX_MERGE_RUNS) {
+        vector<Run> merged_runs;
+        for (uint64_t first = 0; first < runs.size(); first += MAX_MERGE_RUNS) {
+            const auto count = min<uint64_t>(MAX_MERGE_RUNS, runs.size() - first);
+            if (count == 1) {
+                merged_runs.push_back(runs[first]);
+                continue;
+            }
+            Run run { file_pages, 0 };
+            begin_merge(first, count);
+            while (auto tuple = merge_next()) {
+                write_tuple(run, tuple);
+            }
+            end_merge();
+            finish_run();
+            merged_runs.push_back(run);
+            premerged_runs += count;
+        }
+        runs = move(merged_runs);
+    }
+    begin_merge(0, runs.size());
+}
+
+
+const GraphObject* TupleSorter::next() {
+    if (output_count == limit) {
+        return nullptr;
+    }
+    const GraphObject* res;
+    if (runs.empty()) {
+        if (output_count == order.size()) {
+            return nullptr;
+        }
+        res = memory_tuple(order[output_count].pos);
+    } else {
+        res = merge_next();
+        if (res == nullptr) {
+            return nullptr;
+        }
+    }
+    output_count++;
+    return res;
+}
+
+
+void TupleSorter::begin_merge(uint64_t first, uint64_t count) {
+    end_merge();
+    readers.reserve(count);
+    for (uint64_t i = first; i < first + count; i++) {
+        readers.push_back({ runs[i].first_page, runs[i].tuple_count, 0, nullptr, nullptr });
+        advance(readers.back());
+    }
+    loser_tree.assign(count, 0);
+    loser_tree[0] = count == 1 ? 0 : build_loser_tree(1);
+    merge_started = false;
+}
+
+
+void TupleSorter::end_merge() {
+    for (auto& reader : readers) {
+        unpin(&reader.page);
+    }
+    readers.clear();
+}
+
+
+const GraphObject* TupleSorter::merge_next() {
+    // the tuple returned before is valid until now
+    if (merge_started) {
+        const auto winner = loser_tree[0];
+        advance(readers[winner]);
+        replay(winner);
+    } else {
+        merge_started = true;
+    }
+    return readers[loser_tree[0]].current;
+}
+
+
+void TupleSorter::advance(RunReader& reader) {
+    if (reader.remaining == 0) {
+        unpin(&reader.page);
+        reader.current = nullptr;
+        return;
+    }
+    if (reader.page == nullptr || reader.pos_in_page == page_tuples) {
+        if (__builtin_expect(!!(*interruption_requested), 0)) {
+            throw InterruptedException();
+        }
+        unpin(&reader.page);
+        reader.page = &buffer_manager.get_tmp_page(*file_id, reader.next_page++);
+        reader.pos_in_page = 0;
+    }
+    reader.current = reinterpret_cast<const GraphObject*>(reader.page->get_bytes())
+                     + static_cast<uint64_t>(reader.pos_in_page) * tuple_size;
+    reader.pos_in_page++;
+    reader.remaining--;
+}
+
+
+bool TupleSorter::reader_less(uint_fast32_t a, uint_fast32_t b) const {
+    const auto lhs = readers[a].current;
+    const auto rhs = readers[b].current;
+    if (lhs == nullptr) {
+        return false;
+    }
+    if (rhs == nullptr) {
+        return true;
+    }
+    const auto cmp = compare(lhs, rhs);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    // the runs are in insertion order
+    return a < b;
+}
+
+
+// The tree has readers.size() leaves, the node i has the children 2i and 2i + 1 and the leaf of the
+// reader r is the node readers.size() + r. Returns the winner of the subtree of node.
+uint_fast32_t TupleSorter::build_loser_tree(uint_fast32_t node) {
+    const auto leaves = readers.size();
+    if (node >= leaves) {
+        return node - leaves;
+    }
+    const auto left  = build_loser_tree(2 * node);
+    const auto right = build_loser_tree(2 * node + 1);
+    if (reader_less(right, left)) {
+        loser_tree[node] = left;
+        return right;
+    }
+    loser_tree[node] = right;
+    return left;
+}
+
+
+void TupleSorter::replay(uint_fast32_t reader) {
+    auto winner = reader;
+    for (auto node = (reader + readers.size()) / 2; node > 0; node /= 2) {
+        if (reader_less(loser_tree[node], winner)) {
+            swap(loser_tree[node], winner);
+        }
+    }
+    loser_tree[0] = winner;
+}
+
+
+void TupleSorter::analyze(std::ostream& os) const {
+    os << "tuples: " << tuple_count;
+    if (top_k) {
+        os << ", top " << limit << " heap";
+    } else if (spilled_runs == 0) {
+        os << ", sorted in memory";
+    } else {
+        os << ", spilled runs: " << spilled_runs << ", premerged runs: " << premerged_runs;
+    }
+}
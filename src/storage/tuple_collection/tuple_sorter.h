@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "base/graph_object/graph_object.h"
+#include "storage/file_id.h"
+#include "storage/page.h"
+
+// TupleSorter sorts tuples of GraphObjects with a fixed size by some of their positions, keeping at most
+// `memory_budget` bytes of tuples in memory. The order is stable: equal tuples are returned in the order they
+// were added.
+//
+// The tuples are added to an in-memory run and when the run fills the budget it is sorted and written to a temp
+// file. If all the tuples fit in the budget nothing is written and they are returned from memory. Otherwise the
+// last run is written too, and the runs are merged at once with a loser tree while the tuples are returned.
+// Each run being merged pins a page of the private buffer, so if there are more than MAX_MERGE_RUNS runs the
+// first ones are merged into a bigger run before.
+//
+// When only the first `limit` tuples are needed and they fit in the budget, a heap keeps the best `limit` tuples
+// seen and discards the rest, so nothing is written.
+class TupleSorter {
+public:
+    static constexpr uint_fast32_t MAX_MERGE_RUNS = 64;
+
+    // order_positions[i] is the position in the tuple of the i-th value compared, ascending[i] its direction.
+    // limit is how many tuples will be read at most, UINT64_MAX to read all of them
+    TupleSorter(uint_fast32_t              tuple_size,
+                std::vector<uint_fast32_t> order_positions,
+                std::vector<bool>          ascending,
+                uint64_t                   memory_budget,
+                uint64_t                   limit,
+                bool*                      interruption_requested);
+    ~TupleSorter();
+
+    // tuple has tuple_size GraphObjects, it is copied
+    void add(const GraphObject* tuple);
+
+    // must be called after the last add() and before next()
+    void finish();
+
+    // returns the next tuple in order, or nullptr after the last one. The tuple is valid until the next call
+    const GraphObject* next();
+
+    void analyze(std::ostream&) const;
+
+private:
+    // a tuple in memory, with its first order value to sort without reading the tuple
+    struct SortEntry {
+        GraphObject first_value;
+        uint32_t pos;
+    };
+
+    // bytes in memory of a tuple and its entry
+    static constexpr uint64_t memory_tuple_bytes(uint_fast32_t tuple_size) {
+        return tuple_size * sizeof(GraphObject) + sizeof(SortEntry);
+    }
+
+    // a sorted run in the temp file, it starts at the beginning of a page
+    struct Run {
+        uint64_t first_page;
+        uint64_t tuple_count;
+    };
+
+    struct RunReader {
+        uint64_t next_page;
+        uint64_t remaining;
+        uint_fast32_t pos_in_page;
+        Page* page;
+
+        // nullptr when the run is exhausted
+        const GraphObject* current;
+    };
+
+    const uint_fast32_t tuple_size;
+    const std::vector<uint_fast32_t> order_positions;
+    const std::vector<bool> ascending;
+    const uint64_t limit;
+    bool const * interruption_requested;
+
+    // how many tuples fit in the memory budget
+    const uint64_t max_memory_tuples;
+
+    // the top-k heap is used
+    const bool top_k;
+
+    // How many tuples fit in a page
+    const uint_fast32_t page_tuples;
+
+    // tuples in memory, contiguous
+    std::vector<GraphObject> tuples;
+
+    // the tuples in the order they are returned. With top_k it is a heap whose top is the worst tuple
+    std::vector<SortEntry> order;
+
+    // with top_k, the number of the tuple saved in each position of `tuples`, to break ties
+    std::vector<uint64_t> sequence;
+
+    // created when the first run is written
+    std::optional<TmpFileId> file_id;
+    uint64_t file_pages = 0;
+    std::vector<Run> runs;
+
+    // page of the run being written
+    Page* write_page = nullptr;
+
+    std::vector<RunReader> readers;
+
+    // loser_tree[0] is the reader with the smallest tuple, the others are the losers of each match
+    std::vector<uint_fast32_t> loser_tree;
+
+    bool merge_started = false;
+    uint64_t output_count = 0;
+
+    // statistics
+    uint64_t tuple_count     = 0;
+    uint64_t spilled_runs    = 0;
+    uint64_t premerged_runs  = 0;
+
+    // negative if the value lhs of the order-th order var goes before rhs, positive if it goes after and 0 if they
+    // are equal
+    int compare_value(uint_fast32_t order, const GraphObject& lhs, const GraphObject& rhs) const;
+
+    // compare_value() of the order values of the tuples, from the first_order-th one
+    int compare(const GraphObject* lhs, const GraphObject* rhs, uint_fast32_t first_order = 0) const;
+
+    SortEntry make_entry(const GraphObject* tuple, uint32_t pos) const;
+
+    inline const GraphObject* memory_tuple(uint32_t pos) const noexcept {
+        return &tuples[static_cast<uint64_t>(pos) * tuple_size];
+    }
+
+    // equal tuples are ordered by when they were added
+    bool memory_less(const SortEntry& lhs, const SortEntry& rhs) const;
+
+    void add_top_k(const GraphObject* tuple);
+
+    void sort_memory();
+
+    // sorts the tuples in memory, writes them as a new run and frees the memory
+    void spill();
+
+    void write_tuple(Run& run, const GraphObject* tuple);
+
+    void finish_run();
+
+    // prepares the readers of runs [first, first + count) and the loser tree
+    void begin_merge(uint64_t first, uint64_t count);
+
+    // returns the smallest tuple of the readers, or nullptr if all of them are exhausted
+    const GraphObject* merge_next();
+
+    void end_merge();
+
+    void advance(RunReader& reader);
+
+    // true if the current tuple of reader a goes before the one of b. Exhausted readers go last
+    bool reader_less(uint_fast32_t a, uint_fast32_t b) const;
+
+    uint_fast32_t build_loser_tree(uint_fast32_t node);
+
+    void replay(uint_fast32_t reader);
+
+    void unpin(Page** page);
+};
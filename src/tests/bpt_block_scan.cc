@@ -0,0 +1,88 @@
+// BptIter::next_block() must return the same records as BptIter::next(), clipped to the range of the search.
+// Ranges start and end inside leaves, at leaf boundaries and outside of the tree.
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+
+constexpr uint64_t RECORDS = 100000;
+
+// records are (2*i, i)
+void create_bpt(const std::string& name) {
+    BPTLeafWriter<2> leaf_writer(file_manager.get_file_path(name + ".leaf"));
+    BPTDirWriter<2> dir_writer(file_manager.get_file_path(name + ".dir"));
+
+    const auto max_records = BPTLeafWriter<2>::max_records();
+    const uint32_t last_block = (RECORDS / max_records) + (RECORDS % max_records != 0);
+    std::vector<std::array<uint64_t, 2>> block(max_records);
+
+    uint32_t current_block = 0;
+    uint64_t i = 0;
+    while (i < RECORDS) {
+        uint32_t block_size = 0;
+        for (; block_size < max_records && i < RECORDS; block_size++, i++) {
+            block[block_size] = { 2 * i, i };
+        }
+        if (current_block > 0) {
+            dir_writer.bulk_insert(block.data(), 0, current_block);
+        }
+        ++current_block;
+        leaf_writer.process_block(reinterpret_cast<char*>(block.data()),
+                                  block_size,
+                                  current_block < last_block ? current_block : 0);
+    }
+}
+
+int main() {
+    FileManager::init("test_bpt_block_scan");
+    create_bpt("block_scan");
+    BufferManager::init(1024, 1, 1);
+
+    int res = 0;
+    {
+        BPlusTree<2> bpt("block_scan");
+        bool interruption_requested = false;
+        const uint64_t leaf_records = BPlusTree<2>::leaf_max_records();
+
+        const std::vector<std::array<uint64_t, 2>> ranges = {
+            { 0, UINT64_MAX },
+            { 1, 1 },
+            { 10, 11 },
+            { 2 * leaf_records - 2, 2 * leaf_records },
+            { 2 * leaf_records, 6 * leaf_records + 3 },
+            { 2 * RECORDS - 10, UINT64_MAX },
+            { 2 * RECORDS, UINT64_MAX },
+        };
+
+        for (auto& range : ranges) {
+            const Record<2> min({ range[0], 0 });
+            const Record<2> max({ range[1], UINT64_MAX });
+
+            std::vector<uint64_t> expected;
+            auto it = bpt.get_range(&interruption_requested, min, max);
+            for (auto record = it->next(); record != nullptr; record = it->next()) {
+                expected.push_back(record->ids[0]);
+            }
+
+            std::vector<uint64_t> found;
+            it = bpt.get_range(&interruption_requested, min, max);
+            for (auto block = it->next_block(); !block.empty(); block = it->next_block()) {
+                for (auto& record : block) {
+                    found.push_back(record.ids[0]);
+                }
+            }
+
+            if (found != expected) {
+                std::cerr << "range [" << range[0] << ", " << range[1] << "]: expected " << expected.size()
+                          << " records, next_block() returned " << found.size() << "\n";
+                res = 1;
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
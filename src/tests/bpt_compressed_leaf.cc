@@ -0,0 +1,84 @@
+// A B+Tree written with compressed leaves must return the same records as the records given to the writer,
+// both in a full scan and in searches of ranges. The records mix long runs, small deltas and values that need
+// the 64 bits.
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+
+constexpr uint64_t RECORDS = 200000;
+
+std::vector<std::array<uint64_t, 3>> generate_records() {
+    std::mt19937_64 rng(0);
+    std::vector<std::array<uint64_t, 3>> records;
+    records.reserve(RECORDS);
+    for (uint64_t i = 0; i < RECORDS; i++) {
+        const uint64_t type = i % 1000 == 0 ? rng() : rng() % 5;
+        records.push_back({ type, i / 3, i % 10 == 0 ? UINT64_MAX - i : rng() % 100 });
+    }
+    std::sort(records.begin(), records.end());
+    records.erase(std::unique(records.begin(), records.end()), records.end());
+    return records;
+}
+
+
+int main() {
+    FileManager::init("test_bpt_compressed_leaf");
+    const auto records = generate_records();
+    {
+        BPTLeafWriter<3> leaf_writer(file_manager.get_file_path("compressed.leaf"), true);
+        BPTDirWriter<3> dir_writer(file_manager.get_file_path("compressed.dir"));
+        for (auto& record : records) {
+            leaf_writer.append(record, dir_writer);
+        }
+        leaf_writer.finish(dir_writer);
+    }
+    BufferManager::init(1024, 1, 1);
+
+    int res = 0;
+    {
+        BPlusTree<3> bpt("compressed");
+        bool interruption_requested = false;
+
+        std::vector<std::array<uint64_t, 3>> found;
+        auto it = bpt.get_range(&interruption_requested,
+                                Record<3>({ 0, 0, 0 }),
+                                Record<3>({ UINT64_MAX, UINT64_MAX, UINT64_MAX }));
+        for (auto record = it->next(); record != nullptr; record = it->next()) {
+            found.push_back(record->ids);
+        }
+        if (found != records) {
+            std::cerr << "full scan: expected " << records.size() << " records, got " << found.size() << "\n";
+            res = 1;
+        }
+
+        std::mt19937_64 rng(1);
+        for (int i = 0; i < 1000; i++) {
+            const auto& first = records[rng() % records.size()];
+            const std::array<uint64_t, 3> min = { first[0], first[1], 0 };
+            const std::array<uint64_t, 3> max = { first[0], first[1], UINT64_MAX };
+            const auto expected = std::upper_bound(records.begin(), records.end(), max)
+                                - std::lower_bound(records.begin(), records.end(), min);
+            uint64_t count = 0;
+            it = bpt.get_range(&interruption_requested,
+                               Record<3>(min),
+                               Record<3>(max));
+            for (auto record = it->next(); record != nullptr; record = it->next()) {
+                count++;
+            }
+            if (count != static_cast<uint64_t>(expected)) {
+                std::cerr << "range (" << first[0] << ", " << first[1] << "): expected " << expected
+                          << " records, got " << count << "\n";
+                res = 1;
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
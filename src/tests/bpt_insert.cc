@@ -0,0 +1,68 @@
+// Records inserted in a B+Tree must be found by searches after the leaves and directory pages split.
+// BPlusTree searches use a copy of the directory that inserts must keep updated, so the leaf found must be
+// the one that has the record.
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+
+constexpr uint64_t RECORDS = 200000;
+
+int main() {
+    FileManager::init("test_bpt_insert");
+    {
+        // empty B+Tree
+        BPTLeafWriter<2> leaf_writer(file_manager.get_file_path("insert.leaf"));
+        BPTDirWriter<2> dir_writer(file_manager.get_file_path("insert.dir"));
+        leaf_writer.finish(dir_writer);
+    }
+    BufferManager::init(4096, 1, 1);
+
+    int res = 0;
+    {
+        BPlusTree<2> bpt("insert");
+        bool interruption_requested = false;
+
+        std::mt19937_64 rng(0);
+        std::vector<std::array<uint64_t, 2>> records;
+        for (uint64_t i = 0; i < RECORDS; i++) {
+            records.push_back({ rng() % 1000, rng() });
+            bpt.insert(Record<2>(records.back()));
+
+            // search one of the inserted records, it must be in the leaf returned (without moving to the next leaf)
+            const auto& record = records[rng() % records.size()];
+            auto leaf_and_pos = bpt.search_leaf(Record<2>(record));
+            if (leaf_and_pos.result_index >= leaf_and_pos.leaf->get_value_count()
+                || leaf_and_pos.leaf->get_record(leaf_and_pos.result_index).ids != record)
+            {
+                std::cerr << "record " << record[0] << ", " << record[1] << " not found after "
+                          << i + 1 << " inserts\n";
+                res = 1;
+                break;
+            }
+        }
+
+        std::sort(records.begin(), records.end());
+        std::vector<std::array<uint64_t, 2>> found;
+        auto it = bpt.get_range(&interruption_requested, Record<2>({ 0, 0 }), Record<2>({ UINT64_MAX, UINT64_MAX }));
+        for (auto record = it->next(); record != nullptr; record = it->next()) {
+            found.push_back(record->ids);
+        }
+        if (found != records) {
+            std::cerr << "full scan: expected " << records.size() << " records, got " << found.size() << "\n";
+            res = 1;
+        }
+        if (bpt.get_height() < 2) {
+            std::cerr << "the directory was expected to split\n";
+            res = 1;
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
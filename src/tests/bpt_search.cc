@@ -0,0 +1,70 @@
+// BPTSearch::lower_bound and upper_bound must return the same positions as std::lower_bound and std::upper_bound
+// with every implementation supported by the CPU, for record arrays of every size up to a few windows and with
+// many records sharing the first column.
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/index/bplus_tree/bpt_search.h"
+
+template <std::size_t N>
+int check(BPTSearch::Isa isa) {
+    std::mt19937_64 rng(N);
+    int res = 0;
+    for (uint_fast32_t count = 0; count <= 300; count++) {
+        std::vector<std::array<uint64_t, N>> records(count);
+        for (auto& record : records) {
+            for (auto& id : record) {
+                id = rng() % 8;
+            }
+            // values with the most significant bit set must be compared as unsigned
+            if (rng() % 2 == 0) {
+                record[0] |= 1ULL << 63;
+            }
+        }
+        std::sort(records.begin(), records.end());
+
+        for (int i = 0; i < 50; i++) {
+            std::array<uint64_t, N> key;
+            for (auto& id : key) {
+                id = rng() % 9;
+            }
+            if (rng() % 2 == 0) {
+                key[0] |= 1ULL << 63;
+            }
+            const auto data = reinterpret_cast<const uint64_t*>(records.data());
+            const auto expected_lower = std::lower_bound(records.begin(), records.end(), key) - records.begin();
+            const auto expected_upper = std::upper_bound(records.begin(), records.end(), key) - records.begin();
+            const auto lower = BPTSearch::lower_bound<N>(data, count, Record<N>(key));
+            const auto upper = BPTSearch::upper_bound<N>(data, count, Record<N>(key));
+            if (lower != static_cast<uint_fast32_t>(expected_lower)
+                || upper != static_cast<uint_fast32_t>(expected_upper))
+            {
+                std::cerr << BPTSearch::get_isa_name(isa) << " N=" << N << " count=" << count
+                          << ": expected [" << expected_lower << ", " << expected_upper << "), got ["
+                          << lower << ", " << upper << ")\n";
+                res = 1;
+            }
+        }
+    }
+    return res;
+}
+
+
+int main() {
+    int res = 0;
+    const auto best = BPTSearch::get_best_isa();
+    for (auto isa : { BPTSearch::Isa::scalar, BPTSearch::Isa::avx2, BPTSearch::Isa::avx512 }) {
+        if (isa > best) {
+            break;
+        }
+        BPTSearch::set_isa(isa);
+        res |= check<1>(isa);
+        res |= check<2>(isa);
+        res |= check<3>(isa);
+        res |= check<4>(isa);
+    }
+    return res;
+}
@@ -0,0 +1,113 @@
+// An IndexScan with a BoundedVar must return exactly the integers between the bounds: the ObjectIds of negative
+// and positive integers preserve the order, so a comparison with integers is a range of the B+Tree.
+#include <array>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "base/binding/binding_id.h"
+#include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/index_scan.h"
+#include "execution/binding_id_iter/scan_ranges/bounded_var.h"
+#include "execution/binding_id_iter/scan_ranges/term.h"
+#include "execution/binding_id_iter/scan_ranges/unassigned_var.h"
+#include "query_optimizer/quad_model/query_element_to_object_id.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+
+constexpr int64_t MIN_VALUE = -5000;
+constexpr int64_t MAX_VALUE = 5000;
+constexpr uint64_t KEY = 1;
+
+uint64_t int_id(int64_t value) {
+    return QueryElementToObjectId()(value).id;
+}
+
+// records are (key, value, object) with two keys, so the scans must also stop at the end of KEY
+void create_bpt(const std::string& name) {
+    std::vector<std::array<uint64_t, 3>> records;
+    for (uint64_t key = KEY; key <= KEY + 1; key++) {
+        for (int64_t value = MIN_VALUE; value <= MAX_VALUE; value++) {
+            records.push_back({ key, int_id(value), static_cast<uint64_t>(value - MIN_VALUE) });
+        }
+    }
+
+    BPTLeafWriter<3> leaf_writer(file_manager.get_file_path(name + ".leaf"));
+    BPTDirWriter<3> dir_writer(file_manager.get_file_path(name + ".dir"));
+
+    const auto max_records = BPTLeafWriter<3>::max_records();
+    const uint32_t last_block = (records.size() / max_records) + (records.size() % max_records != 0);
+
+    uint32_t current_block = 0;
+    for (size_t i = 0; i < records.size(); i += max_records) {
+        const uint32_t block_size = std::min<size_t>(max_records, records.size() - i);
+        if (current_block > 0) {
+            dir_writer.bulk_insert(&records[i], 0, current_block);
+        }
+        ++current_block;
+        leaf_writer.process_block(reinterpret_cast<char*>(records[i].data()),
+                                  block_size,
+                                  current_block < last_block ? current_block : 0);
+    }
+}
+
+int main() {
+    FileManager::init("test_bpt_value_range");
+    create_bpt("value_range");
+    BufferManager::init(1024, 1, 1);
+
+    int res = 0;
+    {
+        BPlusTree<3> bpt("value_range");
+        ThreadInfo thread_info;
+        const VarId value_var(0);
+        const VarId object_var(1);
+
+        const std::vector<std::array<int64_t, 2>> ranges = {
+            { MIN_VALUE, MAX_VALUE },
+            { -10, 10 },
+            { -1, 0 },
+            { 0, 0 },
+            { 30, 39 },
+            { -4000, -3000 },
+            { MAX_VALUE - 1, MAX_VALUE },
+            { 10, 9 },
+        };
+
+        for (auto& [lo, hi] : ranges) {
+            std::array<std::unique_ptr<ScanRange>, 3> scan_ranges {
+                std::make_unique<Term>(ObjectId(KEY)),
+                std::make_unique<BoundedVar>(value_var, int_id(lo), int_id(hi)),
+                std::make_unique<UnassignedVar>(object_var)
+            };
+            IndexScan<3> scan(bpt, &thread_info, std::move(scan_ranges));
+            BindingId binding(2);
+            scan.begin(binding);
+
+            // the objects are value - MIN_VALUE, so they must be consecutive
+            bool wrong_record = false;
+            int64_t expected = lo;
+            while (scan.next()) {
+                if (binding[value_var].id != int_id(expected)
+                    || binding[object_var].id != static_cast<uint64_t>(expected - MIN_VALUE))
+                {
+                    std::cerr << "range [" << lo << ", " << hi << "]: wrong record, expected value " << expected
+                              << "\n";
+                    wrong_record = true;
+                    res = 1;
+                    break;
+                }
+                expected++;
+            }
+            if (!wrong_record && expected != std::max(lo, hi + 1)) {
+                std::cerr << "range [" << lo << ", " << hi << "]: expected " << std::max<int64_t>(0, hi - lo + 1)
+                          << " records, found " << expected - lo << "\n";
+                res = 1;
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
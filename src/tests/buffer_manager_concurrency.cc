@@ -0,0 +1,67 @@
+// Many threads ask for pages of a file bigger than the shared buffer, so hits, misses and evictions
+// happen concurrently. Every page read must have the content that was written.
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/page.h"
+
+constexpr uint32_t FILE_PAGES  = 8192;
+constexpr uint32_t BUFFER_SIZE = 2048;
+constexpr uint32_t THREADS     = 8;
+constexpr uint32_t FETCHES     = 20000;
+
+int main() {
+    FileManager::init("test_buffer_manager_concurrency");
+    BufferManager::init(BUFFER_SIZE, 1, 1);
+
+    auto file_id = file_manager.get_file_id("pages.dat");
+    for (uint32_t i = 0; i < FILE_PAGES; i++) {
+        auto& page = buffer_manager.get_page(file_id, i);
+        *reinterpret_cast<uint32_t*>(page.get_bytes()) = i;
+        page.make_dirty();
+        buffer_manager.unpin(page);
+    }
+    buffer_manager.flush();
+
+    if (file_manager.count_pages(file_id) != FILE_PAGES) {
+        std::cerr << "file has " << file_manager.count_pages(file_id) << " pages, expected " << FILE_PAGES << "\n";
+        return 1;
+    }
+
+    std::atomic<uint32_t> errors(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rng(t);
+            // half of the fetches go to a small hot set so hits and misses are mixed
+            std::uniform_int_distribution<uint32_t> all_pages(0, FILE_PAGES - 1);
+            std::uniform_int_distribution<uint32_t> hot_pages(0, 63);
+            for (uint32_t i = 0; i < FETCHES; i++) {
+                auto page_number = (i % 2 == 0) ? all_pages(rng) : hot_pages(rng);
+                auto& page = buffer_manager.get_page(file_id, page_number);
+                if (page.get_page_number() != page_number
+                    || *reinterpret_cast<uint32_t*>(page.get_bytes()) != page_number)
+                {
+                    errors++;
+                }
+                buffer_manager.unpin(page);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    buffer_manager.~BufferManager();
+
+    if (errors != 0) {
+        std::cerr << errors << " pages with unexpected content\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// With the 2Q policy a scan bigger than the shared buffer must not evict pages that are used frequently
+// nor pages of hot files. Also checks the hits/misses/evictions counters.
+#include <iostream>
+
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/page.h"
+
+constexpr uint32_t BUFFER_SIZE = 1024;
+constexpr uint32_t HOT_PAGES   = 64;
+constexpr uint32_t WARM_PAGES  = 256;
+constexpr uint32_t SCAN_PAGES  = 8 * BUFFER_SIZE;
+
+void read_pages(FileId file_id, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        buffer_manager.unpin(buffer_manager.get_page(file_id, i));
+    }
+}
+
+int main() {
+    FileManager::init("test_buffer_replacement");
+    BufferManager::init(BUFFER_SIZE, 1, 1, false, ReplacementPolicyType::two_queue);
+
+    auto hot_file  = file_manager.get_file_id("hot.dat");
+    auto warm_file = file_manager.get_file_id("warm.dat");
+    auto fill_file = file_manager.get_file_id("fill.dat");
+    auto scan_file = file_manager.get_file_id("scan.dat");
+    buffer_manager.set_hot_file(hot_file);
+
+    read_pages(hot_file, HOT_PAGES);
+    // pages requested again after being evicted from the first queue are considered frequently used
+    read_pages(warm_file, WARM_PAGES);
+    read_pages(fill_file, BUFFER_SIZE);
+    read_pages(warm_file, WARM_PAGES);
+
+    buffer_manager.reset_stats();
+    read_pages(scan_file, SCAN_PAGES);
+    read_pages(hot_file, HOT_PAGES);
+    read_pages(warm_file, WARM_PAGES);
+
+    auto stats = buffer_manager.get_stats();
+    int res = 0;
+    if (stats[hot_file].misses != 0 || stats[hot_file].hits != HOT_PAGES) {
+        std::cerr << "hot pages were evicted by the scan: " << stats[hot_file].misses << " misses\n";
+        res = 1;
+    }
+    if (stats[warm_file].misses != 0 || stats[warm_file].hits != WARM_PAGES) {
+        std::cerr << "frequently used pages were evicted by the scan: " << stats[warm_file].misses << " misses\n";
+        res = 1;
+    }
+    if (stats[scan_file].hits + stats[scan_file].misses != SCAN_PAGES) {
+        std::cerr << "unexpected number of requests of the scanned file\n";
+        res = 1;
+    }
+    if (stats[scan_file].evictions + stats[fill_file].evictions + stats[warm_file].evictions
+        + stats[hot_file].evictions != stats[scan_file].misses)
+    {
+        std::cerr << "every miss with a full buffer must evict a page\n";
+        res = 1;
+    }
+
+    buffer_manager.~BufferManager();
+    return res;
+}
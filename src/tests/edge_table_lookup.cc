@@ -0,0 +1,79 @@
+// EdgeTableLookup must assign the from/to/type of every edge looked up with the same binding: the variables it
+// assigns still have the values of the previous lookup, that must not be compared with the next edge.
+#include <filesystem>
+#include <iostream>
+
+#include "base/binding/binding_id.h"
+#include "base/ids/object_id.h"
+#include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/edge_table_lookup.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/random_access_table/random_access_table.h"
+
+constexpr uint64_t EDGES = 100;
+
+ObjectId edge_id(uint64_t edge) {
+    return ObjectId(ObjectId::MASK_EDGE | edge);
+}
+
+// edge i (starting at 1) goes from the anonymous node i to i + 1 and has the type i % 3
+Record<3> edge_record(uint64_t edge) {
+    return Record<3>({ ObjectId::MASK_ANON | edge, ObjectId::MASK_ANON | (edge + 1), ObjectId::MASK_ANON | (edge % 3) });
+}
+
+
+int main() {
+    FileManager::init("test_edge_table_lookup");
+    std::filesystem::remove(file_manager.get_file_path("edges.table"));
+    BufferManager::init(1024, 1, 1);
+
+    int res = 0;
+    {
+        RandomAccessTable<3> table("edges.table");
+        for (uint64_t edge = 1; edge <= EDGES; edge++) {
+            table.append_record(edge_record(edge));
+        }
+
+        ThreadInfo thread_info;
+        const VarId edge_var(0);
+        const VarId from_var(1);
+        const VarId to_var(2);
+        const VarId type_var(3);
+        BindingId binding(4);
+
+        // the lookup assigns from, to and type
+        EdgeTableLookup lookup(table, &thread_info, edge_var, from_var, to_var, type_var, false, false, false);
+        for (uint64_t edge = 1; edge <= EDGES; edge++) {
+            binding.add(edge_var, edge_id(edge));
+            lookup.begin(binding);
+            const auto record = edge_record(edge);
+            if (!lookup.next()
+                || binding[from_var] != ObjectId(record.ids[0])
+                || binding[to_var]   != ObjectId(record.ids[1])
+                || binding[type_var] != ObjectId(record.ids[2]))
+            {
+                std::cerr << "edge " << edge << " was not found with unassigned from/to/type\n";
+                res = 1;
+            }
+            if (lookup.next()) {
+                std::cerr << "edge " << edge << " was found twice\n";
+                res = 1;
+            }
+        }
+
+        // type is an input: only the edges with the type of the binding match
+        EdgeTableLookup typed_lookup(table, &thread_info, edge_var, from_var, to_var, type_var, false, false, true);
+        binding.add(type_var, ObjectId(ObjectId::MASK_ANON | 1));
+        for (uint64_t edge = 1; edge <= EDGES; edge++) {
+            binding.add(edge_var, edge_id(edge));
+            typed_lookup.begin(binding);
+            if (typed_lookup.next() != (edge % 3 == 1)) {
+                std::cerr << "edge " << edge << " with assigned type: wrong result\n";
+                res = 1;
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
@@ -0,0 +1,361 @@
+// The hash joins must return the same bindings as a nested loop join, with keys that have many matches and
+// keys without matches on either side, and DistinctIdHash the distinct rows, also when they don't fit in memory.
+// The inputs are vectors of rows, so the test doesn't need a database.
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "base/binding/binding_id_iter.h"
+#include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/distinct_id_hash.h"
+#include "execution/binding_id_iter/hash_join/hash_join_grace.h"
+#include "execution/binding_id_iter/hash_join/hash_join_hybrid.h"
+#include "execution/binding_id_iter/hash_join/hash_join_in_memory.h"
+#include "execution/binding_id_iter/hash_join/join_key_filter.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/hash/object_id_hash/object_id_hash_table.h"
+
+using Rows = std::vector<std::vector<uint64_t>>;
+
+// returns the rows of a vector, row[i] is the value of vars[i]
+class VectorIter : public BindingIdIter {
+public:
+    VectorIter(std::vector<VarId> vars, const Rows& rows) :
+        vars (std::move(vars)),
+        rows (rows) { }
+
+    void begin(BindingId& _parent_binding) override {
+        parent_binding = &_parent_binding;
+        pos = 0;
+    }
+
+    void reset() override {
+        pos = 0;
+    }
+
+    bool next() override {
+        if (pos == rows.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < vars.size(); i++) {
+            parent_binding->add(vars[i], ObjectId(rows[pos][i]));
+        }
+        pos++;
+        return true;
+    }
+
+    void assign_nulls() override {
+        for (auto var : vars) {
+            parent_binding->add(var, ObjectId::get_null());
+        }
+    }
+
+    void analyze(std::ostream& os, int indent = 0) const override {
+        os << std::string(indent, ' ') << "VectorIter()";
+    }
+
+private:
+    std::vector<VarId> vars;
+    const Rows& rows;
+    BindingId* parent_binding;
+    size_t pos;
+};
+
+
+// lhs has the vars (0, 1), rhs (1, 2), the result (0, 1, 2) sorted
+Rows nested_loop_join(const Rows& lhs, const Rows& rhs) {
+    Rows res;
+    for (auto& l : lhs) {
+        for (auto& r : rhs) {
+            if (l[1] == r[0]) {
+                res.push_back({ l[0], l[1], r[1] });
+            }
+        }
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+
+Rows join_results(BindingIdIter& join) {
+    const VarId var0(0), var1(1), var2(2);
+    BindingId binding(3);
+    join.begin(binding);
+    Rows res;
+    while (join.next()) {
+        res.push_back({ binding[var0].id, binding[var1].id, binding[var2].id });
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+
+template <class HashJoin>
+Rows hash_join(const Rows& lhs, const Rows& rhs) {
+    const VarId var0(0), var1(1), var2(2);
+    HashJoin join(std::make_unique<VectorIter>(std::vector<VarId>{ var0, var1 }, lhs),
+                  std::make_unique<VectorIter>(std::vector<VarId>{ var1, var2 }, rhs),
+                  { var0 },
+                  { var1 },
+                  { var2 });
+    return join_results(join);
+}
+
+
+// memory_bytes small enough makes the join spill partitions to temp files
+Rows hybrid_hash_join(const Rows& lhs, const Rows& rhs, uint64_t memory_bytes) {
+    const VarId var0(0), var1(1), var2(2);
+    ThreadInfo thread_info;
+    thread_info.hash_join_memory = memory_bytes;
+    Rows res;
+    {
+        HashJoinHybrid join(std::make_unique<VectorIter>(std::vector<VarId>{ var0, var1 }, lhs),
+                            std::make_unique<VectorIter>(std::vector<VarId>{ var1, var2 }, rhs),
+                            { var0 },
+                            { var1 },
+                            { var2 },
+                            &thread_info);
+        // begin() reads lhs and builds the tables of the partitions in memory
+        BindingId binding(3);
+        join.begin(binding);
+        if (thread_info.hash_join_memory_used > memory_bytes) {
+            std::cerr << "HashJoinHybrid: " << thread_info.hash_join_memory_used << " bytes used with "
+                      << memory_bytes << " bytes\n";
+            return {};
+        }
+        res = join_results(join);
+    }
+    if (thread_info.hash_join_memory_used != 0) {
+        std::cerr << "HashJoinHybrid: " << thread_info.hash_join_memory_used << " bytes were not released\n";
+        return {};
+    }
+    return res;
+}
+
+
+// memory_bytes small enough makes the distinct tuples go to the on-disk hash. The rows are read twice, with a
+// reset() between them
+Rows distinct_id_hash(const Rows& rows, uint64_t memory_bytes) {
+    const VarId var0(0), var1(1);
+    ThreadInfo thread_info;
+    thread_info.hash_join_memory = memory_bytes;
+    Rows res;
+    {
+        DistinctIdHash distinct(std::make_unique<VectorIter>(std::vector<VarId>{ var0, var1 }, rows),
+                                { var0, var1 },
+                                &thread_info);
+        BindingId binding(2);
+        distinct.begin(binding);
+        for (int i = 0; i < 2; i++) {
+            Rows pass;
+            while (distinct.next()) {
+                pass.push_back({ binding[var0].id, binding[var1].id });
+            }
+            std::sort(pass.begin(), pass.end());
+            if (i == 1 && pass != res) {
+                std::cerr << "DistinctIdHash: different result after reset\n";
+                return {};
+            }
+            res = pass;
+            distinct.reset();
+        }
+    }
+    if (thread_info.hash_join_memory_used != 0) {
+        std::cerr << "DistinctIdHash: " << thread_info.hash_join_memory_used << " bytes were not released\n";
+        return {};
+    }
+    return res;
+}
+
+
+// random rows with a key in [1, key_range] and a value, the key is the first or the second column
+Rows random_rows(std::mt19937_64& rng, size_t count, uint64_t key_range, bool key_first) {
+    Rows rows;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key   = 1 + rng() % key_range;
+        uint64_t value = 1 + rng() % 1000000;
+        if (key_first) {
+            rows.push_back({ key, value });
+        } else {
+            rows.push_back({ value, key });
+        }
+    }
+    return rows;
+}
+
+
+int test_hash_table() {
+    std::mt19937_64 rng(42);
+    ObjectIdHashTable table(2, 1);
+    std::vector<std::vector<uint64_t>> counts(300, std::vector<uint64_t>(300, 0));
+    for (int i = 0; i < 100000; i++) {
+        ObjectId key[2] = { ObjectId(rng() % 300), ObjectId(rng() % 300) };
+        ObjectId value(key[0].id * 300 + key[1].id);
+        table.insert(key, &value);
+        counts[key[0].id][key[1].id]++;
+    }
+    table.finish_build();
+
+    for (uint64_t a = 0; a < 300; a++) {
+        for (uint64_t b = 0; b < 300; b++) {
+            ObjectId key[2] = { ObjectId(a), ObjectId(b) };
+            const ObjectId* values;
+            auto found = table.find(key, &values);
+            if (found != counts[a][b]) {
+                std::cerr << "key (" << a << ", " << b << "): expected " << counts[a][b] << " values, found "
+                          << found << "\n";
+                return 1;
+            }
+            for (uint_fast32_t i = 0; i < found; i++) {
+                if (values[i].id != a * 300 + b) {
+                    std::cerr << "key (" << a << ", " << b << "): wrong value\n";
+                    return 1;
+                }
+            }
+        }
+    }
+
+    ObjectIdHashTable set(1, 0);
+    for (uint64_t i = 0; i < 50000; i++) {
+        ObjectId key(i % 20000);
+        if (set.find_or_insert(&key) != (i >= 20000)) {
+            std::cerr << "find_or_insert(" << i % 20000 << ") returned a wrong result\n";
+            return 1;
+        }
+    }
+    if (set.distinct_keys() != 20000) {
+        std::cerr << "expected 20000 distinct keys, found " << set.distinct_keys() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+
+// the filter must contain every id added, and a Bloom filter should discard most of the others
+int test_join_key_filter() {
+    std::mt19937_64 rng(3);
+    for (uint64_t spread : { 2, 1000 }) {
+        JoinKeyFilter filter;
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < 10000; i++) {
+            ids.push_back(1000000 + rng() % (10000 * spread));
+            filter.add(ids.back());
+        }
+        filter.finish_build();
+        const auto expected_type = spread == 2 ? JoinKeyFilter::Type::BITMAP : JoinKeyFilter::Type::BLOOM;
+        if (filter.get_type() != expected_type) {
+            std::cerr << "JoinKeyFilter: expected a " << (spread == 2 ? "bitmap" : "bloom") << " filter\n";
+            return 1;
+        }
+        for (auto id : ids) {
+            if (!filter.contains(id)) {
+                std::cerr << "JoinKeyFilter: id " << id << " was added but it is not contained\n";
+                return 1;
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        uint64_t false_positives = 0;
+        for (uint64_t id = 1000000; id < 1000000 + 10000 * spread; id++) {
+            if (filter.contains(id) && !std::binary_search(ids.begin(), ids.end(), id)) {
+                false_positives++;
+            }
+        }
+        if (false_positives * 50 > 10000 * spread) {
+            std::cerr << "JoinKeyFilter: " << false_positives << " false positives\n";
+            return 1;
+        }
+        if (filter.contains(999999) || filter.contains(1000000 + 10000 * spread)) {
+            std::cerr << "JoinKeyFilter: contains ids out of the range of the ids added\n";
+            return 1;
+        }
+    }
+    JoinKeyFilter empty_filter;
+    if (!empty_filter.contains(42)) {
+        std::cerr << "JoinKeyFilter: a filter that is not built must contain every id\n";
+        return 1;
+    }
+    empty_filter.finish_build();
+    if (empty_filter.contains(0) || empty_filter.contains(42)) {
+        std::cerr << "JoinKeyFilter: a filter without ids must not contain any\n";
+        return 1;
+    }
+
+    // with room for 1000 ids, 100 distinct ids added many times are built, 10000 distinct ids are not
+    for (uint64_t distinct : { 100, 10000 }) {
+        JoinKeyFilter filter;
+        filter.clear(1000 * sizeof(uint64_t));
+        for (int i = 0; i < 50000; i++) {
+            filter.add(1 + rng() % distinct);
+            if (filter.pending_bytes() > 2 * 1000 * sizeof(uint64_t)) {
+                std::cerr << "JoinKeyFilter: " << filter.pending_bytes() << " pending bytes with room for 1000 ids\n";
+                return 1;
+            }
+        }
+        filter.finish_build();
+        const auto expected_type = distinct == 100 ? JoinKeyFilter::Type::BITMAP : JoinKeyFilter::Type::NONE;
+        if (filter.get_type() != expected_type || !filter.contains(1) || !filter.contains(distinct)) {
+            std::cerr << "JoinKeyFilter: wrong filter with " << distinct << " distinct ids and room for 1000\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+int main() {
+    FileManager::init("test_hash_join");
+    BufferManager::init(1024, 4096, 1);
+
+    int res = test_hash_table() | test_join_key_filter();
+
+    std::mt19937_64 rng(7);
+    struct Case { size_t lhs; size_t rhs; uint64_t key_range; };
+    const std::vector<Case> cases = {
+        { 0, 100, 10 },
+        { 100, 0, 10 },
+        { 1, 1000, 5 },
+        { 1000, 1000, 50 },      // many matches per key
+        { 5000, 3000, 100000 },  // most keys without matches
+        { 20000, 500, 2000 },
+        { 4000, 200, 2 },        // a few keys with many rows, they can't be repartitioned
+    };
+    for (auto& c : cases) {
+        auto lhs = random_rows(rng, c.lhs, c.key_range, false);
+        auto rhs = random_rows(rng, c.rhs, c.key_range, true);
+        auto expected = nested_loop_join(lhs, rhs);
+        if (hash_join<HashJoinInMemory>(lhs, rhs) != expected) {
+            std::cerr << "HashJoinInMemory: wrong result joining " << c.lhs << " and " << c.rhs << " rows\n";
+            res = 1;
+        }
+        if (hash_join<HashJoinGrace>(lhs, rhs) != expected) {
+            std::cerr << "HashJoinGrace: wrong result joining " << c.lhs << " and " << c.rhs << " rows\n";
+            res = 1;
+        }
+        for (uint64_t memory_bytes : { 1ULL << 30, 64ULL * 1024, 1024ULL }) {
+            if (hybrid_hash_join(lhs, rhs, memory_bytes) != expected) {
+                std::cerr << "HashJoinHybrid: wrong result joining " << c.lhs << " and " << c.rhs << " rows with "
+                          << memory_bytes << " bytes\n";
+                res = 1;
+            }
+        }
+
+        // every row of lhs twice, the copies come after the table was written to disk with few bytes
+        auto duplicated_rows = lhs;
+        duplicated_rows.insert(duplicated_rows.end(), lhs.begin(), lhs.end());
+        auto distinct_rows = lhs;
+        std::sort(distinct_rows.begin(), distinct_rows.end());
+        distinct_rows.erase(std::unique(distinct_rows.begin(), distinct_rows.end()), distinct_rows.end());
+        for (uint64_t memory_bytes : { 1ULL << 30, 1024ULL }) {
+            if (distinct_id_hash(duplicated_rows, memory_bytes) != distinct_rows) {
+                std::cerr << "DistinctIdHash: wrong result with " << c.lhs << " rows and " << memory_bytes
+                          << " bytes\n";
+                res = 1;
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
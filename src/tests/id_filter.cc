@@ -0,0 +1,126 @@
+// The comparisons of the WHERE evaluated on the ObjectIds below the joins (see IdFilter and FilterPlan) must return
+// the same bindings as the Where evaluating them on GraphObjects. Each query is executed with ThreadInfo::id_filters
+// disabled, and then enabled with and without batch execution.
+// The property v has integers, floats, short and long strings and booleans, so the comparisons mix types.
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/binding/binding_iter.h"
+#include "base/thread/thread_info.h"
+#include "import/quad_model/import.h"
+#include "parser/query/mdb_query_parser.h"
+#include "query_optimizer/quad_model/quad_model.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+
+constexpr uint64_t NODES = 600;
+constexpr uint64_t EDGES = 2400;
+
+void create_db(const std::string& db_folder) {
+    std::filesystem::remove_all(db_folder);
+    std::filesystem::create_directories(db_folder);
+    const auto input_filename = db_folder + "/data.txt";
+    {
+        std::ofstream file(input_filename);
+        for (uint64_t i = 0; i < NODES; i++) {
+            file << 'N' << i << (i % 2 == 0 ? " :P" : " :Q") << " v:";
+            switch (i % 5) {
+            case 0:  file << static_cast<int64_t>(i % 60) - 20; break;
+            case 1:  file << (i % 50) / 2.0 + 0.5; break;
+            case 2:  file << "\"s" << i % 30 << '"'; break;
+            case 3:  file << "\"a longer string value " << i % 30 << '"'; break;
+            default: file << (i % 2 == 0 ? "true" : "false"); break;
+            }
+            // w is missing in most nodes
+            if (i % 3 == 0) {
+                file << " w:" << i % 10;
+            }
+            file << '\n';
+        }
+        std::mt19937_64 rng(5);
+        for (uint64_t i = 0; i < EDGES; i++) {
+            file << 'N' << rng() % NODES << "->N" << rng() % NODES << " :knows since:" << i % 10 << '\n';
+        }
+    }
+    FileManager::init(db_folder);
+    Import::OnDiskImport importer(db_folder, 1);
+    importer.start_import(input_filename);
+}
+
+
+// returns the sorted lines of the results
+std::vector<std::string> execute(const std::string& query, bool id_filters, bool batch_execution) {
+    ThreadInfo thread_info;
+    thread_info.id_filters      = id_filters;
+    thread_info.batch_execution = batch_execution;
+    auto logical_plan  = MDB::QueryParser::get_query_plan(query);
+    auto physical_plan = quad_model.exec(*logical_plan, &thread_info);
+
+    std::stringstream ss;
+    physical_plan->begin(ss);
+    while (physical_plan->next()) { }
+
+    std::vector<std::string> res;
+    std::string line;
+    while (std::getline(ss, line)) {
+        res.push_back(line);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+
+int main() {
+    const std::string db_folder = "test_id_filter";
+    create_db(db_folder);
+
+    const std::vector<std::string> queries = {
+        // integer ranges
+        "MATCH (?x :P) WHERE ?x.v >= 10 AND ?x.v < 30 RETURN ?x, ?x.v",
+        "MATCH (?x) WHERE ?x.v > -5 AND ?x.v <= 5 RETURN ?x, ?x.v",
+        "MATCH (?x)-[?e :knows]->(?y) WHERE ?e.since >= 3 AND ?e.since < 6 AND ?y.v > 20 RETURN ?x, ?y, ?e.since",
+        // equality
+        "MATCH (?x)-[:knows]->(?y) WHERE ?x.v != 0 AND ?y.v == \"s7\" RETURN ?x, ?y, ?x.v",
+        "MATCH (?x) WHERE ?x.v == \"a longer string value 8\" RETURN ?x",
+        "MATCH (?x) WHERE ?x.v == true RETURN ?x",
+        "MATCH (?x) WHERE ?x.v != 12.5 RETURN ?x, ?x.v",
+        // mixed types: the values of v are compared with constants of other types
+        "MATCH (?x) WHERE ?x.v > 2.5 RETURN ?x, ?x.v",
+        "MATCH (?x) WHERE ?x.v <= 7 RETURN ?x, ?x.v",
+        "MATCH (?x) WHERE ?x.v < \"s2\" RETURN ?x, ?x.v",
+        "MATCH (?x) WHERE ?x.v >= \"a longer string value 2\" RETURN ?x, ?x.v",
+        "MATCH (?x) WHERE ?x.v < true RETURN ?x, ?x.v",
+        "MATCH (?x) WHERE 3 < ?x.v RETURN ?x, ?x.v",
+        // properties that may be missing, and conditions on variables of optional patterns
+        "MATCH (?x :Q) WHERE ?x.w < 5 RETURN ?x, ?x.w",
+        "MATCH (?x :P) WHERE ?x.w >= 5 AND ?x.v < 40 RETURN ?x, ?x.w",
+        "MATCH (?x :P) OPTIONAL { (?x)-[:knows]->(?y) } WHERE ?y.v > 10 RETURN ?x, ?y",
+    };
+
+    auto model_destroyer = QuadModel::init(db_folder, BufferManager::DEFAULT_SHARED_BUFFER_POOL_SIZE, 1024, 1);
+
+    int res = 0;
+    for (auto& query : queries) {
+        const auto expected = execute(query, false, false);
+        // the header, its separator and at least one result
+        if (expected.size() < 3) {
+            std::cerr << "query without results: " << query << "\n";
+            res = 1;
+        }
+        for (bool batch_execution : { false, true }) {
+            const auto got = execute(query, true, batch_execution);
+            if (got != expected) {
+                std::cerr << "different results with id filters" << (batch_execution ? " in batches" : "") << ": "
+                          << query << "\n";
+                res = 1;
+            }
+        }
+    }
+    return res;
+}
@@ -0,0 +1,106 @@
+// A ParallelLeapfrogJoin must return the same results as a LeapfrogJoin (in any order), also after a reset().
+// The join lists the triangles R(x,y), S(y,z), T(x,z) of a random graph with many leaves, so the first variable
+// is split in many ranges.
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "execution/binding_id_iter/leapfrog_join.h"
+#include "execution/binding_id_iter/parallel_leapfrog_join.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+#include "storage/index/leapfrog/leapfrog_bpt_iter.h"
+
+constexpr uint64_t NODES   = 2000;
+constexpr uint64_t EDGES   = 60000;
+constexpr int      WORKERS = 3;
+
+using Triangles = std::vector<std::array<uint64_t, 3>>;
+
+Triangles get_triangles(BindingIdIter& join, bool reset) {
+    const VarId x(0);
+    const VarId y(1);
+    const VarId z(2);
+    BindingId binding(3);
+    join.begin(binding);
+    if (reset) {
+        while (join.next()) { }
+        join.reset();
+    }
+
+    Triangles triangles;
+    while (join.next()) {
+        triangles.push_back({ binding[x].id, binding[y].id, binding[z].id });
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+
+int main() {
+    FileManager::init("test_parallel_leapfrog");
+    std::mt19937_64 rng(0);
+    std::vector<std::array<uint64_t, 2>> edges(EDGES);
+    for (auto& edge : edges) {
+        edge = { rng() % NODES, rng() % NODES };
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    {
+        BPTLeafWriter<2> leaf_writer(file_manager.get_file_path("edges.leaf"));
+        BPTDirWriter<2> dir_writer(file_manager.get_file_path("edges.dir"));
+        for (auto& edge : edges) {
+            leaf_writer.append(edge, dir_writer);
+        }
+        leaf_writer.finish(dir_writer);
+    }
+    BufferManager::init(4096, 1, 1);
+
+    int res = 0;
+    {
+        BPlusTree<2> bpt("edges");
+        bool interruption_requested = false;
+
+        auto make_join = [&]() {
+            std::vector<std::unique_ptr<LeapfrogIter>> leapfrog_iters;
+            for (auto [first, second] : { std::pair(0, 1), std::pair(1, 2), std::pair(0, 2) }) {
+                leapfrog_iters.push_back(std::make_unique<LeapfrogBptIter<2>>(
+                    &interruption_requested,
+                    bpt,
+                    std::vector<std::unique_ptr<ScanRange>>(),
+                    std::vector<VarId> { VarId(first), VarId(second) },
+                    std::vector<VarId>()));
+            }
+            return std::make_unique<LeapfrogJoin>(std::move(leapfrog_iters),
+                                                  std::vector<VarId> { VarId(0), VarId(1), VarId(2) },
+                                                  3);
+        };
+        auto make_parallel_join = [&]() {
+            std::vector<std::unique_ptr<LeapfrogJoin>> joins;
+            for (int i = 0; i < WORKERS; i++) {
+                joins.push_back(make_join());
+            }
+            return std::make_unique<ParallelLeapfrogJoin>(std::move(joins));
+        };
+
+        const auto expected = get_triangles(*make_join(), false);
+        if (expected.empty()) {
+            std::cerr << "the graph was expected to have triangles\n";
+            res = 1;
+        }
+        for (bool reset : { false, true }) {
+            const auto triangles = get_triangles(*make_parallel_join(), reset);
+            if (triangles != expected) {
+                std::cerr << "parallel join" << (reset ? " after reset" : "") << ": expected "
+                          << expected.size() << " triangles, got " << triangles.size() << "\n";
+                res = 1;
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
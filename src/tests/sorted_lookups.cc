@@ -0,0 +1,110 @@
+// An IndexNestedLoopJoin with sorted lookups must return the same results as one without them (in other order),
+// also when it is the lhs of another IndexNestedLoopJoin and after reset(). The lookups of the IndexScans reuse
+// the leaf of the previous lookup when they can, so they are checked too.
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "base/binding/binding_id.h"
+#include "base/thread/thread_info.h"
+#include "execution/binding_id_iter/index_nested_loop_join.h"
+#include "execution/binding_id_iter/index_scan.h"
+#include "execution/binding_id_iter/scan_ranges/assigned_var.h"
+#include "execution/binding_id_iter/scan_ranges/unassigned_var.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bpt_mem_import.h"
+
+using Rows = std::vector<std::array<uint64_t, 4>>;
+
+constexpr uint64_t NODES = 5000;
+
+void create_bpt(const std::string& name, uint64_t edge_count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::array<uint64_t, 2>> edges(edge_count);
+    for (auto& edge : edges) {
+        edge[0] = 1 + rng() % NODES;
+        edge[1] = 1 + rng() % NODES;
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    BPTLeafWriter<2> leaf_writer(file_manager.get_file_path(name + ".leaf"));
+    BPTDirWriter<2> dir_writer(file_manager.get_file_path(name + ".dir"));
+    for (auto& edge : edges) {
+        leaf_writer.append(edge, dir_writer);
+    }
+    leaf_writer.finish(dir_writer);
+}
+
+
+std::unique_ptr<IndexScan<2>> scan(BPlusTree<2>& bpt, ThreadInfo& thread_info, VarId from, bool from_assigned,
+                                   VarId to)
+{
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    if (from_assigned) {
+        ranges[0] = std::make_unique<AssignedVar>(from);
+    } else {
+        ranges[0] = std::make_unique<UnassignedVar>(from);
+    }
+    ranges[1] = std::make_unique<UnassignedVar>(to);
+    return std::make_unique<IndexScan<2>>(bpt, &thread_info, std::move(ranges));
+}
+
+
+// the paths w -> x -> y -> z, the first edge in a, the others in b. Each execution is repeated after a reset()
+Rows paths(BPlusTree<2>& a, BPlusTree<2>& b, bool sorted_lookups) {
+    ThreadInfo thread_info;
+    const VarId w(0), x(1), y(2), z(3);
+    auto first_join = std::make_unique<IndexNestedLoopJoin>(scan(a, thread_info, w, false, x),
+                                                            scan(b, thread_info, x, true, y),
+                                                            sorted_lookups);
+    IndexNestedLoopJoin join(std::move(first_join), scan(b, thread_info, y, true, z), sorted_lookups);
+
+    BindingId binding(4);
+    Rows res;
+    join.begin(binding);
+    for (int i = 0; i < 2; i++) {
+        while (join.next()) {
+            res.push_back({ binding[w].id, binding[x].id, binding[y].id, binding[z].id });
+        }
+        // next() after the end must keep returning false
+        if (join.next()) {
+            std::cerr << "next() returned a result after the end\n";
+            return {};
+        }
+        join.reset();
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+
+int main() {
+    FileManager::init("test_sorted_lookups");
+    create_bpt("a", 3000, 1);
+    create_bpt("b", 20000, 2);
+    BufferManager::init(1024, 1, 1);
+
+    int res = 0;
+    {
+        BPlusTree<2> a("a");
+        BPlusTree<2> b("b");
+        const auto expected = paths(a, b, false);
+        const auto sorted   = paths(a, b, true);
+        if (expected.empty()) {
+            std::cerr << "the join without sorted lookups has no results\n";
+            res = 1;
+        } else if (sorted != expected) {
+            std::cerr << "expected " << expected.size() << " results, sorted lookups returned " << sorted.size()
+                      << " different ones\n";
+            res = 1;
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}
@@ -0,0 +1,90 @@
+// TupleSorter must return the same tuples as a stable sort, with tuples in memory, with sorted runs written to
+// temp files (also with more runs than it merges at once) and with a limit that keeps only the first tuples.
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "base/graph_object/graph_object.h"
+#include "execution/graph_object/graph_object_factory.h"
+#include "execution/graph_object/graph_object_manager.h"
+#include "storage/buffer_manager.h"
+#include "storage/file_manager.h"
+#include "storage/tuple_collection/tuple_sorter.h"
+
+// tuples (key, value, number), number is the position in which the tuple is added
+using Tuple = std::array<int64_t, 3>;
+
+// ORDER BY key ASC, value DESC
+bool tuple_less(const Tuple& lhs, const Tuple& rhs) {
+    if (lhs[0] != rhs[0]) {
+        return lhs[0] < rhs[0];
+    }
+    return lhs[1] > rhs[1];
+}
+
+
+int test_sort(const std::vector<Tuple>& tuples, uint64_t memory_budget, uint64_t limit) {
+    auto expected = tuples;
+    std::stable_sort(expected.begin(), expected.end(), tuple_less);
+    if (limit < expected.size()) {
+        expected.resize(limit);
+    }
+
+    bool interruption_requested = false;
+    TupleSorter sorter(3, { 0, 1 }, { true, false }, memory_budget, limit, &interruption_requested);
+    for (auto& tuple : tuples) {
+        GraphObject graph_objects[3];
+        for (int i = 0; i < 3; i++) {
+            graph_objects[i] = GraphObjectFactory::make_int(tuple[i]);
+        }
+        sorter.add(graph_objects);
+    }
+    sorter.finish();
+
+    std::vector<Tuple> res;
+    while (auto graph_objects = sorter.next()) {
+        Tuple tuple;
+        for (int i = 0; i < 3; i++) {
+            tuple[i] = GraphObjectInterpreter::get<int64_t>(graph_objects[i]);
+        }
+        res.push_back(tuple);
+    }
+    if (res != expected) {
+        std::cerr << "sorting " << tuples.size() << " tuples with " << memory_budget << " bytes and limit " << limit
+                  << ": wrong result (";
+        sorter.analyze(std::cerr);
+        std::cerr << ")\n";
+        return 1;
+    }
+    return 0;
+}
+
+
+int main() {
+    FileManager::init("test_tuple_sorter");
+    BufferManager::init(1024, 4096, 1);
+    GraphObject::graph_object_cmp = GraphObjectManager::compare;
+
+    int res = 0;
+    std::mt19937_64 rng(11);
+    for (uint64_t count : { 0, 1, 1000, 100000 }) {
+        for (int64_t key_range : { 3, 1000000 }) {
+            std::vector<Tuple> tuples;
+            for (uint64_t i = 0; i < count; i++) {
+                tuples.push_back({ static_cast<int64_t>(rng() % key_range) - key_range / 2,
+                                   static_cast<int64_t>(rng() % 5),
+                                   static_cast<int64_t>(i) });
+            }
+            // 100000 tuples with 8 KB are more than 600 runs, more than a merge can have
+            for (uint64_t memory_budget : { 1ULL << 30, 64ULL * 1024, 8ULL * 1024 }) {
+                for (uint64_t limit : std::vector<uint64_t>{ UINT64_MAX, 0, 1, 10, 500 }) {
+                    res |= test_sort(tuples, memory_budget, limit);
+                }
+            }
+        }
+    }
+    buffer_manager.~BufferManager();
+    return res;
+}